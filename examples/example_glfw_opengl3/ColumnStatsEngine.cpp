@@ -0,0 +1,603 @@
+#include "ColumnStatsEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <limits>
+#include <numeric>
+
+#include <arrow/api.h>
+
+namespace column_stats {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Rows per parallel task; each task keeps its own digest and fine histogram
+constexpr int64_t kBlockRows = int64_t(1) << 18;
+
+// Buffered points per centroid budget before the digest compresses
+constexpr double kBufferFactor = 16.0;
+
+// Quantiles bounding the core histogram; a manual range inside them is
+// binned at the resolution of the bulk of the data, not of its extremes
+constexpr double kCoreLowQuantile = 0.001;
+constexpr double kCoreHighQuantile = 0.999;
+
+struct Block {
+    const arrow::Array* array = nullptr;
+    int64_t begin = 0;
+    int64_t end = 0;
+};
+
+bool IsSupported(arrow::Type::type type) {
+    return type == arrow::Type::DOUBLE || type == arrow::Type::FLOAT ||
+           type == arrow::Type::INT64 || type == arrow::Type::INT32;
+}
+
+template <typename ArrayType, typename Fn>
+void VisitTyped(const arrow::Array& array, int64_t begin, int64_t end, Fn&& fn) {
+    const auto* values = static_cast<const ArrayType&>(array).raw_values();
+    const bool hasNulls = array.null_count() > 0;
+    for (int64_t i = begin; i < end; ++i) {
+        if (hasNulls && array.IsNull(i)) {
+            continue;
+        }
+        const float value = static_cast<float>(values[i]);
+        if (std::isfinite(value)) {
+            fn(static_cast<double>(value));
+        }
+    }
+}
+
+template <typename Fn>
+void VisitFinite(const Block& block, Fn&& fn) {
+    switch (block.array->type_id()) {
+        case arrow::Type::DOUBLE: VisitTyped<arrow::DoubleArray>(*block.array, block.begin, block.end, fn); break;
+        case arrow::Type::FLOAT: VisitTyped<arrow::FloatArray>(*block.array, block.begin, block.end, fn); break;
+        case arrow::Type::INT64: VisitTyped<arrow::Int64Array>(*block.array, block.begin, block.end, fn); break;
+        case arrow::Type::INT32: VisitTyped<arrow::Int32Array>(*block.array, block.begin, block.end, fn); break;
+        default: break;
+    }
+}
+
+// Float bits mapped so that unsigned order is numeric order
+uint32_t SortKey(double value) {
+    const float narrow = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &narrow, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+double FromSortKey(uint32_t key) {
+    const uint32_t bits = (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+    float narrow;
+    std::memcpy(&narrow, &bits, sizeof(narrow));
+    return static_cast<double>(narrow);
+}
+
+// LSD radix sort in three 11-bit passes; the values are floats already, so
+// this replaces the comparison sort that dominated building the digest
+void RadixSort(std::vector<uint32_t>* keys, std::vector<uint32_t>* scratch) {
+    constexpr int kBits = 11;
+    constexpr uint32_t kRadix = 1u << kBits;
+    scratch->resize(keys->size());
+    std::vector<uint32_t>* from = keys;
+    std::vector<uint32_t>* to = scratch;
+    for (int shift = 0; shift < 32; shift += kBits) {
+        size_t offsets[kRadix] = {};
+        for (uint32_t key : *from) {
+            ++offsets[(key >> shift) & (kRadix - 1)];
+        }
+        size_t position = 0;
+        for (size_t& offset : offsets) {
+            const size_t count = offset;
+            offset = position;
+            position += count;
+        }
+        for (uint32_t key : *from) {
+            (*to)[offsets[(key >> shift) & (kRadix - 1)]++] = key;
+        }
+        std::swap(from, to);
+    }
+    if (from != keys) {
+        keys->swap(*scratch);
+    }
+}
+
+// Counts values into `bins` equal bins over [lo, lo + bins / scale); values
+// outside go to the tail counts
+void CountInto(const Block& block, double lo, double scale, int bins,
+               std::vector<uint64_t>* counts, uint64_t* below, uint64_t* above) {
+    counts->assign(static_cast<size_t>(bins), 0);
+    VisitFinite(block, [&](double value) {
+        const double unit = (value - lo) * scale;
+        if (unit < 0.0) {
+            ++*below;
+        } else if (unit >= bins) {
+            // The top edge belongs to the last bin, as in the coarse histogram
+            if (unit > bins) ++*above; else ++(*counts)[static_cast<size_t>(bins) - 1];
+        } else {
+            ++(*counts)[static_cast<size_t>(unit)];
+        }
+    });
+}
+
+} // namespace
+
+void Moments::Add(double value) {
+    if (count == 0) {
+        min = max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    const double n1 = static_cast<double>(count);
+    ++count;
+    const double n = static_cast<double>(count);
+    const double delta = value - mean;
+    const double deltaN = delta / n;
+    const double deltaN2 = deltaN * deltaN;
+    const double term1 = delta * deltaN * n1;
+    mean += deltaN;
+    m4 += term1 * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m2 - 4.0 * deltaN * m3;
+    m3 += term1 * deltaN * (n - 2.0) - 3.0 * deltaN * m2;
+    m2 += term1;
+}
+
+// Exact central sums of the block around its own mean, then merged: no
+// division per value, and the block mean keeps the sums well conditioned
+void Moments::AddValues(const double* values, size_t valueCount) {
+    if (valueCount == 0) {
+        return;
+    }
+    Moments block;
+    block.count = static_cast<int64_t>(valueCount);
+    block.min = values[0];
+    block.max = values[0];
+    double sum = 0.0;
+    for (size_t i = 0; i < valueCount; ++i) {
+        sum += values[i];
+        block.min = std::min(block.min, values[i]);
+        block.max = std::max(block.max, values[i]);
+    }
+    block.mean = sum / static_cast<double>(valueCount);
+    for (size_t i = 0; i < valueCount; ++i) {
+        const double delta = values[i] - block.mean;
+        const double delta2 = delta * delta;
+        block.m2 += delta2;
+        block.m3 += delta2 * delta;
+        block.m4 += delta2 * delta2;
+    }
+    Merge(block);
+}
+
+void Moments::Merge(const Moments& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    const double na = static_cast<double>(count);
+    const double nb = static_cast<double>(other.count);
+    const double n = na + nb;
+    const double delta = other.mean - mean;
+    const double delta2 = delta * delta;
+    const double delta3 = delta2 * delta;
+    const double delta4 = delta2 * delta2;
+
+    const double combinedM4 = m4 + other.m4
+        + delta4 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+        + 6.0 * delta2 * (na * na * other.m2 + nb * nb * m2) / (n * n)
+        + 4.0 * delta * (na * other.m3 - nb * m3) / n;
+    const double combinedM3 = m3 + other.m3
+        + delta3 * na * nb * (na - nb) / (n * n)
+        + 3.0 * delta * (na * other.m2 - nb * m2) / n;
+    const double combinedM2 = m2 + other.m2 + delta2 * na * nb / n;
+
+    mean += delta * nb / n;
+    m2 = combinedM2;
+    m3 = combinedM3;
+    m4 = combinedM4;
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+double Moments::Skewness() const {
+    if (count == 0 || m2 <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double n = static_cast<double>(count);
+    return std::sqrt(n) * m3 / std::pow(m2, 1.5);
+}
+
+double Moments::Kurtosis() const {
+    if (count == 0 || m2 <= 0.0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double n = static_cast<double>(count);
+    return n * m4 / (m2 * m2) - 3.0;
+}
+
+TDigest::TDigest(double compression)
+    : m_compression(std::max(compression, 20.0)) {
+}
+
+// Largest quantile a centroid starting at q may reach: one unit further
+// along k(q) = compression / (2 pi) * asin(2q - 1)
+double TDigest::QuantileLimit(double q) const {
+    const double k = m_compression / (2.0 * kPi) * std::asin(2.0 * std::clamp(q, 0.0, 1.0) - 1.0) + 1.0;
+    const double angle = std::min(k * 2.0 * kPi / m_compression, kPi / 2.0);
+    return (std::sin(angle) + 1.0) / 2.0;
+}
+
+void TDigest::Add(double value) {
+    if (TotalWeight() == 0.0) {
+        m_min = m_max = value;
+    } else {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+    m_buffer.push_back(Centroid{ value, 1.0 });
+    m_bufferWeight += 1.0;
+    if (static_cast<double>(m_buffer.size()) >= kBufferFactor * m_compression) {
+        Compress();
+    }
+}
+
+void TDigest::AddSorted(const double* values, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const bool empty = TotalWeight() == 0.0;
+    m_min = empty ? values[0] : std::min(m_min, values[0]);
+    m_max = empty ? values[count - 1] : std::max(m_max, values[count - 1]);
+    if (empty) {
+        std::vector<Centroid> points(count);
+        for (size_t i = 0; i < count; ++i) {
+            points[i] = Centroid{ values[i], 1.0 };
+        }
+        Sweep(points, static_cast<double>(count));
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        m_buffer.push_back(Centroid{ values[i], 1.0 });
+    }
+    m_bufferWeight += static_cast<double>(count);
+    Compress();
+}
+
+void TDigest::Merge(const TDigest& other) {
+    if (other.TotalWeight() == 0.0) {
+        return;
+    }
+    if (TotalWeight() == 0.0) {
+        m_min = other.m_min;
+        m_max = other.m_max;
+    } else {
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+    m_buffer.insert(m_buffer.end(), other.m_centroids.begin(), other.m_centroids.end());
+    m_buffer.insert(m_buffer.end(), other.m_buffer.begin(), other.m_buffer.end());
+    m_bufferWeight += other.TotalWeight();
+    Compress();
+}
+
+void TDigest::Compress() {
+    if (m_buffer.empty()) {
+        return;
+    }
+    m_buffer.insert(m_buffer.end(), m_centroids.begin(), m_centroids.end());
+    std::sort(m_buffer.begin(), m_buffer.end(),
+              [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+    Sweep(m_buffer, m_total + m_bufferWeight);
+    m_buffer.clear();
+    m_bufferWeight = 0.0;
+}
+
+// One left-to-right sweep merges neighbours while the merged centroid spans
+// at most one unit of the arcsine scale, which keeps tail centroids small.
+// The weight limit is worked out once per emitted centroid, not per point.
+void TDigest::Sweep(const std::vector<Centroid>& sorted, double total) {
+    m_centroids.clear();
+    Centroid current = sorted.front();
+    double weightBefore = 0.0;
+    double weightLimit = total * QuantileLimit(0.0);
+    for (size_t i = 1; i < sorted.size(); ++i) {
+        const Centroid& next = sorted[i];
+        const double proposed = current.weight + next.weight;
+        if (weightBefore + proposed <= weightLimit) {
+            current.mean += (next.mean - current.mean) * next.weight / proposed;
+            current.weight = proposed;
+            continue;
+        }
+        m_centroids.push_back(current);
+        weightBefore += current.weight;
+        weightLimit = total * QuantileLimit(weightBefore / total);
+        current = next;
+    }
+    m_centroids.push_back(current);
+    m_total = total;
+}
+
+// Interpolates between centroid centres; the outermost half centroids are
+// interpolated against the exact min and max.
+double TDigest::Quantile(double q) const {
+    if (m_centroids.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    if (m_centroids.size() == 1) {
+        return m_centroids.front().mean;
+    }
+    const double index = q * m_total;
+    const Centroid& first = m_centroids.front();
+    if (index < first.weight / 2.0) {
+        if (first.weight <= 1.0) {
+            return m_min;
+        }
+        return m_min + (first.mean - m_min) * index / (first.weight / 2.0);
+    }
+
+    double centre = first.weight / 2.0;
+    for (size_t i = 0; i + 1 < m_centroids.size(); ++i) {
+        const Centroid& left = m_centroids[i];
+        const Centroid& right = m_centroids[i + 1];
+        const double nextCentre = centre + (left.weight + right.weight) / 2.0;
+        if (index <= nextCentre) {
+            const double span = nextCentre - centre;
+            const double t = span > 0.0 ? (index - centre) / span : 0.0;
+            return left.mean + (right.mean - left.mean) * t;
+        }
+        centre = nextCentre;
+    }
+
+    const Centroid& last = m_centroids.back();
+    if (last.weight <= 1.0) {
+        return m_max;
+    }
+    const double t = std::clamp((index - centre) / (last.weight / 2.0), 0.0, 1.0);
+    return last.mean + (m_max - last.mean) * t;
+}
+
+double TDigest::Cdf(double value) const {
+    if (m_centroids.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (value < m_min) return 0.0;
+    if (value >= m_max) return 1.0;
+    if (m_max <= m_min) return 1.0;
+
+    const Centroid& first = m_centroids.front();
+    if (value < first.mean) {
+        const double span = first.mean - m_min;
+        const double t = span > 0.0 ? (value - m_min) / span : 1.0;
+        return t * (first.weight / 2.0) / m_total;
+    }
+
+    double centre = first.weight / 2.0;
+    for (size_t i = 0; i + 1 < m_centroids.size(); ++i) {
+        const Centroid& left = m_centroids[i];
+        const Centroid& right = m_centroids[i + 1];
+        const double nextCentre = centre + (left.weight + right.weight) / 2.0;
+        if (value < right.mean) {
+            const double span = right.mean - left.mean;
+            const double t = span > 0.0 ? (value - left.mean) / span : 1.0;
+            return (centre + (nextCentre - centre) * t) / m_total;
+        }
+        centre = nextCentre;
+    }
+
+    const Centroid& last = m_centroids.back();
+    const double span = m_max - last.mean;
+    const double t = span > 0.0 ? (value - last.mean) / span : 1.0;
+    return std::min(1.0, (centre + t * (last.weight / 2.0)) / m_total);
+}
+
+bool ColumnSummary::DescribesColumn(const std::shared_ptr<arrow::ChunkedArray>& column) const {
+    return column && source.lock() == column;
+}
+
+// Works in fine-bin units: fine bin j covers [j, j + 1]. Edges that land
+// within rounding of a fine boundary are snapped onto it, so aligned bins
+// receive whole fine counts.
+void ColumnSummary::Rebin(double lo, double hi, int bins,
+                          std::vector<double>* counts, double* lowerTail, double* upperTail) const {
+    bins = std::max(bins, 1);
+    counts->assign(static_cast<size_t>(bins), 0.0);
+    *lowerTail = 0.0;
+    *upperTail = 0.0;
+    if (fine_counts.empty() || !(hi > lo)) {
+        return;
+    }
+
+    const double fineWidth = (moments.max - moments.min) / kFineBins;
+    if (!(fineWidth > 0.0)) {
+        // Every value is the same: one point mass
+        const double value = moments.min;
+        const double mass = static_cast<double>(moments.count);
+        if (value < lo) {
+            *lowerTail = mass;
+        } else if (value > hi) {
+            *upperTail = mass;
+        } else {
+            const int bin = std::min(bins - 1, static_cast<int>((value - lo) / ((hi - lo) / bins)));
+            (*counts)[static_cast<size_t>(std::max(bin, 0))] = mass;
+        }
+        return;
+    }
+
+    // A range inside the core is folded from the finer core histogram
+    const bool useCore = !core_counts.empty() && lo >= core_lo && hi <= core_hi;
+    const std::vector<uint64_t>& source = useCore ? core_counts : fine_counts;
+    const double origin = useCore ? core_lo : moments.min;
+    const double width = useCore ? (core_hi - core_lo) / kFineBins : fineWidth;
+    if (useCore) {
+        *lowerTail = static_cast<double>(core_below);
+        *upperTail = static_cast<double>(core_above);
+    }
+
+    std::vector<double> edges(static_cast<size_t>(bins) + 1);
+    for (int k = 0; k <= bins; ++k) {
+        const double value = (k == bins) ? hi : lo + (hi - lo) * k / bins;
+        double unit = (value - origin) / width;
+        const double nearest = std::round(unit);
+        if (std::abs(unit - nearest) < 1e-6) {
+            unit = nearest;
+        }
+        edges[static_cast<size_t>(k)] = unit;
+    }
+    const double start = edges.front();
+    const double stop = edges.back();
+
+    size_t bin = 0;
+    for (int j = 0; j < kFineBins; ++j) {
+        const double mass = static_cast<double>(source[static_cast<size_t>(j)]);
+        if (mass == 0.0) {
+            continue;
+        }
+        const double left = static_cast<double>(j);
+        const double right = left + 1.0;
+        if (right <= start) {
+            *lowerTail += mass;
+            continue;
+        }
+        if (left >= stop) {
+            *upperTail += mass;
+            continue;
+        }
+        if (left < start) {
+            *lowerTail += mass * (start - left);
+        }
+        if (right > stop) {
+            *upperTail += mass * (right - stop);
+        }
+        // Edges only move right as j grows, so the bin cursor never goes back
+        while (bin + 1 < static_cast<size_t>(bins) && edges[bin + 1] <= left) {
+            ++bin;
+        }
+        for (size_t k = bin; k < static_cast<size_t>(bins); ++k) {
+            const double overlap = std::min(right, edges[k + 1]) - std::max(left, edges[k]);
+            if (overlap > 0.0) {
+                (*counts)[k] += mass * overlap;
+            }
+            if (edges[k + 1] >= right) {
+                break;
+            }
+        }
+    }
+}
+
+std::shared_ptr<const ColumnSummary> SummarizeColumn(const std::shared_ptr<arrow::ChunkedArray>& column) {
+    if (!column || !IsSupported(column->type()->id())) {
+        return nullptr;
+    }
+    const auto startTime = std::chrono::steady_clock::now();
+
+    auto summary = std::make_shared<ColumnSummary>();
+    summary->source = column;
+    summary->total_samples = column->length();
+
+    std::vector<Block> blocks;
+    for (const auto& chunk : column->chunks()) {
+        if (!chunk) {
+            continue;
+        }
+        for (int64_t begin = 0; begin < chunk->length(); begin += kBlockRows) {
+            blocks.push_back(Block{ chunk.get(), begin, std::min(chunk->length(), begin + kBlockRows) });
+        }
+    }
+
+    // Pass 1: moments, range and digest per block, merged in block order.
+    // Each block is radix sorted so its digest is built in one sweep.
+    struct BlockStats {
+        Moments moments;
+        TDigest digest;
+    };
+    std::vector<BlockStats> partial(blocks.size());
+    std::vector<size_t> ids(blocks.size());
+    std::iota(ids.begin(), ids.end(), size_t(0));
+    std::for_each(std::execution::par, ids.begin(), ids.end(), [&](size_t id) {
+        std::vector<uint32_t> keys;
+        keys.reserve(static_cast<size_t>(blocks[id].end - blocks[id].begin));
+        VisitFinite(blocks[id], [&](double value) { keys.push_back(SortKey(value)); });
+        std::vector<uint32_t> scratch;
+        RadixSort(&keys, &scratch);
+        std::vector<double> values(keys.size());
+        std::transform(keys.begin(), keys.end(), values.begin(), FromSortKey);
+
+        BlockStats& stats = partial[id];
+        stats.moments.AddValues(values.data(), values.size());
+        stats.digest.AddSorted(values.data(), values.size());
+    });
+    for (const BlockStats& stats : partial) {
+        summary->moments.Merge(stats.moments);
+        summary->digest.Merge(stats.digest);
+    }
+    summary->digest.Compress();
+
+    // Pass 2: fine histograms over the whole range and over the core
+    if (summary->moments.count > 0) {
+        const double minValue = summary->moments.min;
+        const double range = summary->moments.max - minValue;
+        const double scale = range > 0.0 ? ColumnSummary::kFineBins / range : 0.0;
+        const double coreLo = summary->digest.Quantile(kCoreLowQuantile);
+        const double coreHi = summary->digest.Quantile(kCoreHighQuantile);
+        const bool hasCore = range > 0.0 && coreHi > coreLo;
+        const double coreScale = hasCore ? ColumnSummary::kFineBins / (coreHi - coreLo) : 0.0;
+
+        struct BlockCounts {
+            std::vector<uint64_t> fine;
+            std::vector<uint64_t> core;
+            uint64_t below = 0;
+            uint64_t above = 0;
+        };
+        std::vector<BlockCounts> local(blocks.size());
+        std::for_each(std::execution::par, ids.begin(), ids.end(), [&](size_t id) {
+            if (partial[id].moments.count == 0) {
+                return;
+            }
+            BlockCounts& counts = local[id];
+            uint64_t below = 0;
+            uint64_t above = 0;
+            CountInto(blocks[id], minValue, scale, ColumnSummary::kFineBins, &counts.fine, &below, &above);
+            // Only rounding can put a value outside [min, max]
+            counts.fine.front() += below;
+            counts.fine.back() += above;
+            if (hasCore) {
+                CountInto(blocks[id], coreLo, coreScale, ColumnSummary::kFineBins,
+                          &counts.core, &counts.below, &counts.above);
+            }
+        });
+
+        summary->fine_counts.assign(ColumnSummary::kFineBins, 0);
+        if (hasCore) {
+            summary->core_lo = coreLo;
+            summary->core_hi = coreHi;
+            summary->core_counts.assign(ColumnSummary::kFineBins, 0);
+        }
+        for (const BlockCounts& counts : local) {
+            for (size_t j = 0; j < counts.fine.size(); ++j) {
+                summary->fine_counts[j] += counts.fine[j];
+            }
+            for (size_t j = 0; j < counts.core.size(); ++j) {
+                summary->core_counts[j] += counts.core[j];
+            }
+            summary->core_below += counts.below;
+            summary->core_above += counts.above;
+        }
+    }
+
+    summary->compute_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return summary;
+}
+
+} // namespace column_stats
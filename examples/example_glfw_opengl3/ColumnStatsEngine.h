@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace arrow {
+class ChunkedArray;
+}
+
+namespace column_stats {
+
+// Streaming central moments (Welford, with Pébay's update for the third and
+// fourth). Two accumulators built over disjoint parts of a column merge into
+// the accumulator of the whole (Chan et al.), so blocks can be summed in
+// parallel without a second pass over the data.
+struct Moments {
+    int64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double m3 = 0.0;
+    double m4 = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+
+    void Add(double value);
+    void AddValues(const double* values, size_t valueCount);
+    void Merge(const Moments& other);
+
+    // Population statistics, as HistogramWindow has always shown them
+    double Variance() const { return count > 0 ? m2 / static_cast<double>(count) : 0.0; }
+    double Skewness() const;
+    double Kurtosis() const;            // Excess kurtosis
+};
+
+// Merging t-digest (Dunning): a quantile sketch of a few hundred weighted
+// centroids, small near the tails and wide in the middle. Digests of
+// disjoint blocks merge into one with the same accuracy bound. Call
+// Compress() after the last Add() or Merge() before querying.
+class TDigest {
+public:
+    explicit TDigest(double compression = 200.0);
+
+    void Add(double value);
+    void AddSorted(const double* values, size_t count);  // Ascending; no sort needed
+    void Merge(const TDigest& other);
+    void Compress();
+
+    double TotalWeight() const { return m_total + m_bufferWeight; }
+    size_t CentroidCount() const { return m_centroids.size(); }
+
+    double Quantile(double q) const;    // q in [0, 1]
+    double Cdf(double value) const;     // Fraction of weight at or below value
+
+private:
+    struct Centroid {
+        double mean;
+        double weight;
+    };
+
+    double QuantileLimit(double q) const;
+    void Sweep(const std::vector<Centroid>& sorted, double total);
+
+    double m_compression;
+    std::vector<Centroid> m_centroids;  // Sorted by mean after Compress()
+    std::vector<Centroid> m_buffer;
+    double m_total = 0.0;
+    double m_bufferWeight = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+};
+
+// Everything HistogramWindow needs about one numeric column, from two
+// parallel passes: moments, the quantile sketch and fine histograms that any
+// coarser binning is folded from.
+struct ColumnSummary {
+    // 20160 = 2^6 * 3^2 * 5 * 7, so most bin counts split it into whole fine
+    // bins and an auto-range histogram folded from it is exact
+    static constexpr int kFineBins = 20160;
+
+    std::weak_ptr<const arrow::ChunkedArray> source;  // Column the summary describes
+    int64_t total_samples = 0;
+    Moments moments;                    // Over finite values
+    TDigest digest;
+    std::vector<uint64_t> fine_counts;  // Empty when there are no finite values
+
+    // The same number of bins over [core_lo, core_hi], roughly the 0.1% to
+    // 99.9% quantiles, with exact counts either side. Long tails would
+    // otherwise leave a narrow manual range only a handful of fine bins.
+    double core_lo = 0.0;
+    double core_hi = 0.0;
+    std::vector<uint64_t> core_counts;  // Empty when the range is a single value
+    uint64_t core_below = 0;
+    uint64_t core_above = 0;
+    double compute_ms = 0.0;
+
+    bool DescribesColumn(const std::shared_ptr<arrow::ChunkedArray>& column) const;
+
+    // Folds the fine histogram into `bins` equal bins over [lo, hi]. Mass
+    // outside the range goes to the tail counts. A fine bin that straddles
+    // an edge is split in proportion to the overlap.
+    void Rebin(double lo, double hi, int bins,
+               std::vector<double>* counts, double* lowerTail, double* upperTail) const;
+};
+
+// Summarizes DOUBLE, FLOAT, INT64 and INT32 columns; values are taken as
+// float and non-finite ones are skipped, like the histogram always did.
+// Null for other types.
+std::shared_ptr<const ColumnSummary> SummarizeColumn(const std::shared_ptr<arrow::ChunkedArray>& column);
+
+} // namespace column_stats
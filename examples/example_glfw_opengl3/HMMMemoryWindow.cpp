@@ -28,7 +28,9 @@ HMMMemoryWindow::HMMMemoryWindow()
     , m_useGpu(false)
     , m_isRunning(false)
     , m_progress(std::make_shared<std::atomic<double>>(0.0))
+    , m_partialVersion(0)
     , m_hasResults(false)
+    , m_hasPartialResults(false)
     , m_hasError(false) {
 
     m_statusMessage = "Idle";
@@ -58,11 +60,37 @@ void HMMMemoryWindow::UpdateColumnList() {
 
 void HMMMemoryWindow::ResetResults() {
     m_hasResults = false;
+    m_hasPartialResults = false;
+    m_partialVersion = 0;
     m_hasError = false;
     m_errorMessage.clear();
     m_result = hmm::HmmMemoryResult{};
 }
 
+void HMMMemoryWindow::PollPartialResults() {
+    if (!m_partial) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_partial->mutex);
+    if (m_partial->version == m_partialVersion) {
+        return;
+    }
+    m_partialVersion = m_partial->version;
+    const auto& latest = m_partial->result;
+    if (!m_hasPartialResults) {
+        m_result.originalFit = latest.originalFit;
+        m_result.originalLogLikelihood = latest.originalLogLikelihood;
+    }
+    m_result.permutationsCompleted = latest.permutationsCompleted;
+    m_result.pValue = latest.pValue;
+    m_result.meanPermutationLogLikelihood = latest.meanPermutationLogLikelihood;
+    m_result.stdPermutationLogLikelihood = latest.stdPermutationLogLikelihood;
+    m_result.permutationLogLikelihoods.insert(m_result.permutationLogLikelihoods.end(),
+                                              m_partial->pending.begin(), m_partial->pending.end());
+    m_partial->pending.clear();
+    m_hasPartialResults = true;
+}
+
 void HMMMemoryWindow::Draw() {
     if (!m_isVisible) {
         return;
@@ -82,6 +110,10 @@ void HMMMemoryWindow::Draw() {
             m_progress->store(1.0);
         }
         m_isRunning = false;
+        m_hasPartialResults = false;
+        m_partial.reset();
+    } else if (m_isRunning) {
+        PollPartialResults();
     }
 
     ImGui::SetNextWindowSize(ImVec2(960, 700), ImGuiCond_FirstUseEver);
@@ -175,7 +207,7 @@ void HMMMemoryWindow::DrawResultsPanel() {
         return;
     }
 
-    if (!m_hasResults) {
+    if (!m_hasResults && !m_hasPartialResults) {
         if (!m_isRunning) {
             ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1), "Run the memory test to view results.");
         }
@@ -186,6 +218,11 @@ void HMMMemoryWindow::DrawResultsPanel() {
     ImGui::Text("HMM Memory Assessment");
     ImGui::Separator();
 
+    if (!m_hasResults) {
+        ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.2f, 1), "Partial results: %d of %d permutations",
+                           m_result.permutationsCompleted, std::max(0, m_mcptReplications - 1));
+    }
+
     ImGui::Text("Original Log-Likelihood: %.3f", m_result.originalLogLikelihood);
     ImGui::Text("Permutation Mean: %.3f", m_result.meanPermutationLogLikelihood);
     ImGui::Text("Permutation StdDev: %.3f", m_result.stdPermutationLogLikelihood);
@@ -290,6 +327,7 @@ void HMMMemoryWindow::StartAnalysis() {
     ResetResults();
     m_statusMessage = "Running analysis...";
     m_progress->store(0.0);
+    m_partial = std::make_shared<PartialState>();
     m_isRunning = true;
 
     hmm::HmmMemoryConfig config;
@@ -305,11 +343,13 @@ void HMMMemoryWindow::StartAnalysis() {
 
     uint64_t seed = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
     auto progress = m_progress;
+    auto partial = m_partial;
 
     m_future = std::async(std::launch::async,
                           [config,
                            data = std::move(features),
                            progress,
+                           partial,
                            seed]() mutable {
                               hmm::HmmMemoryAnalyzer analyzer(config);
                               std::mt19937_64 rng(seed);
@@ -318,7 +358,22 @@ void HMMMemoryWindow::StartAnalysis() {
                                       progress->store(fraction);
                                   }
                               };
-                              return analyzer.analyze(data, rng, callback);
+                              auto partialCallback = [partial](const hmm::HmmMemoryPartialResult& update) {
+                                  std::lock_guard<std::mutex> lock(partial->mutex);
+                                  auto& result = partial->result;
+                                  if (update.originalFit) {
+                                      result.originalFit = *update.originalFit;
+                                      result.originalLogLikelihood = update.originalFit->logLikelihood;
+                                  } else {
+                                      partial->pending.push_back(update.permutationLogLikelihood);
+                                  }
+                                  result.permutationsCompleted = update.permutationsCompleted;
+                                  result.pValue = update.pValue;
+                                  result.meanPermutationLogLikelihood = update.meanPermutationLogLikelihood;
+                                  result.stdPermutationLogLikelihood = update.stdPermutationLogLikelihood;
+                                  ++partial->version;
+                              };
+                              return analyzer.analyze(data, rng, callback, partialCallback);
                           });
 }
 
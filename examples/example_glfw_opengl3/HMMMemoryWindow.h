@@ -7,6 +7,7 @@
 #include <atomic>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -37,6 +38,16 @@ private:
                      std::string& errorMessage) const;
 
     void ResetResults();
+    void PollPartialResults();
+
+    // Running statistics published by the analyzer thread while permutations are
+    // still running; log-likelihoods queue in pending until the next poll takes them
+    struct PartialState {
+        std::mutex mutex;
+        hmm::HmmMemoryResult result;
+        std::vector<double> pending;
+        int version = 0;
+    };
 
     bool m_isVisible;
     const TimeSeriesWindow* m_dataSource;
@@ -59,8 +70,11 @@ private:
     std::atomic<bool> m_isRunning;
     std::shared_ptr<std::atomic<double>> m_progress;
     std::future<hmm::HmmMemoryResult> m_future;
+    std::shared_ptr<PartialState> m_partial;
+    int m_partialVersion;
     hmm::HmmMemoryResult m_result;
     bool m_hasResults;
+    bool m_hasPartialResults;
     bool m_hasError;
     std::string m_statusMessage;
     std::string m_errorMessage;
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <chrono>
 #include <iomanip>
+#include <iterator>
 #include <random>
 #include <sstream>
 #include <thread>
@@ -66,6 +67,30 @@ void HMMTargetWindow::ResetResults() {
     m_selectedResultIndex = -1;
     m_results.combinations.clear();
     m_results.mcptReplicationsEvaluated = 1;
+    m_partialRows.clear();
+}
+
+void HMMTargetWindow::PollPartialResults() {
+    if (!m_partial) {
+        return;
+    }
+    std::vector<PartialRow> fresh;
+    {
+        std::lock_guard<std::mutex> lock(m_partial->mutex);
+        if (m_partial->rows.empty()) {
+            return;
+        }
+        fresh.swap(m_partial->rows);
+    }
+    // Only rows fitted since the last poll are sorted, then merged into the shown list
+    auto byRSquared = [](const PartialRow& lhs, const PartialRow& rhs) {
+        return lhs.rSquared > rhs.rSquared;
+    };
+    std::sort(fresh.begin(), fresh.end(), byRSquared);
+    const auto shown = static_cast<std::ptrdiff_t>(m_partialRows.size());
+    m_partialRows.insert(m_partialRows.end(), std::make_move_iterator(fresh.begin()),
+                         std::make_move_iterator(fresh.end()));
+    std::inplace_merge(m_partialRows.begin(), m_partialRows.begin() + shown, m_partialRows.end(), byRSquared);
 }
 
 void HMMTargetWindow::Draw() {
@@ -88,6 +113,10 @@ void HMMTargetWindow::Draw() {
             m_progress->store(1.0);
         }
         m_isRunning = false;
+        m_partial.reset();
+        m_partialRows.clear();
+    } else if (m_isRunning) {
+        PollPartialResults();
     }
 
     ImGui::SetNextWindowSize(ImVec2(1280, 780), ImGuiCond_FirstUseEver);
@@ -183,7 +212,9 @@ void HMMTargetWindow::DrawResultsPanel() {
     }
 
     if (!m_hasResults) {
-        if (!m_isRunning) {
+        if (m_isRunning) {
+            DrawPartialResults();
+        } else {
             ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1), "No results yet. Configure the analysis and press Run.");
         }
         ImGui::EndChild();
@@ -239,6 +270,42 @@ void HMMTargetWindow::DrawResultsPanel() {
     ImGui::EndChild();
 }
 
+void HMMTargetWindow::DrawPartialResults() {
+    if (m_partialRows.empty()) {
+        return;
+    }
+
+    ImGui::TextColored(ImVec4(0.8f, 0.8f, 0.2f, 1), "Partial results: %zu combinations fitted (MCPT pending)",
+                       m_partialRows.size());
+
+    if (ImGui::BeginTable("HMMPartialTable", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame | ImGuiTableFlags_ScrollY, ImVec2(0, 260))) {
+        ImGui::TableSetupColumn("Rank", ImGuiTableColumnFlags_WidthFixed, 50);
+        ImGui::TableSetupColumn("Features", ImGuiTableColumnFlags_WidthStretch, 240);
+        ImGui::TableSetupColumn("R^2", ImGuiTableColumnFlags_WidthFixed, 70);
+        ImGui::TableSetupColumn("RMSE", ImGuiTableColumnFlags_WidthFixed, 80);
+        ImGui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(m_partialRows.size()));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                const auto& row = m_partialRows[i];
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%d", i + 1);
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(row.featureLabel.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4f", row.rSquared);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.4f", row.rmse);
+            }
+        }
+
+        ImGui::EndTable();
+    }
+}
+
 void HMMTargetWindow::DrawSelectedModelDetails() {
     if (m_selectedResultIndex < 0 || m_selectedResultIndex >= static_cast<int>(m_results.combinations.size())) {
         ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1), "Select a model to inspect HMM parameters.");
@@ -351,6 +418,7 @@ void HMMTargetWindow::StartAnalysis() {
     ResetResults();
     m_statusMessage = "Running analysis...";
     m_progress->store(0.0);
+    m_partial = std::make_shared<PartialState>();
     m_isRunning = true;
 
     hmm::TargetCorrelationConfig config;
@@ -367,6 +435,7 @@ void HMMTargetWindow::StartAnalysis() {
 
     uint64_t seed = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
     auto progress = m_progress;
+    auto partial = m_partial;
 
     m_future = std::async(std::launch::async,
                           [config,
@@ -374,6 +443,7 @@ void HMMTargetWindow::StartAnalysis() {
                            featureNames = std::move(featureNames),
                            targetData = std::move(targetVec),
                            progress,
+                           partial,
                            seed]() mutable {
                               hmm::TargetCorrelationAnalyzer analyzer(config);
                               std::mt19937_64 rng(seed);
@@ -382,7 +452,18 @@ void HMMTargetWindow::StartAnalysis() {
                                       progress->store(fraction);
                                   }
                               };
-                              return analyzer.analyze(data, featureNames, targetData, rng, callback);
+                              auto partialCallback = [partial](const hmm::TargetCorrelationComboResult& combo) {
+                                  PartialRow row;
+                                  for (std::size_t j = 0; j < combo.featureNames.size(); ++j) {
+                                      if (j > 0) row.featureLabel += ", ";
+                                      row.featureLabel += combo.featureNames[j];
+                                  }
+                                  row.rSquared = combo.rSquared;
+                                  row.rmse = combo.rmse;
+                                  std::lock_guard<std::mutex> lock(partial->mutex);
+                                  partial->rows.push_back(std::move(row));
+                              };
+                              return analyzer.analyze(data, featureNames, targetData, rng, callback, partialCallback);
                           });
 }
 
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,7 @@ private:
     void DrawResultsPanel();
     void DrawStatusBar();
     void DrawSelectedModelDetails();
+    void DrawPartialResults();
     void StartAnalysis();
 
     bool PrepareData(Eigen::MatrixXd& features,
@@ -39,6 +41,20 @@ private:
                      std::string& errorMessage) const;
 
     void ResetResults();
+    void PollPartialResults();
+
+    // Lightweight summary of a fitted combination, shown while the run continues
+    struct PartialRow {
+        std::string featureLabel;
+        double rSquared = 0.0;
+        double rmse = 0.0;
+    };
+
+    // Rows fitted since the last poll; PollPartialResults() takes them
+    struct PartialState {
+        std::mutex mutex;
+        std::vector<PartialRow> rows;
+    };
 
     bool m_isVisible;
     const TimeSeriesWindow* m_dataSource;
@@ -62,6 +78,8 @@ private:
     std::atomic<bool> m_isRunning;
     std::shared_ptr<std::atomic<double>> m_progress;
     std::future<hmm::TargetCorrelationResult> m_future;
+    std::shared_ptr<PartialState> m_partial;
+    std::vector<PartialRow> m_partialRows;
     hmm::TargetCorrelationResult m_results;
     bool m_hasResults;
     bool m_hasError;
@@ -4,9 +4,7 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
-#include <immintrin.h>  // For SIMD intrinsics
 #include <chrono>       // For performance timing
-#include <arrow/scalar.h>
 #include <arrow/type.h>
 #include <arrow/array.h> // For array types
 #include <functional>
@@ -59,6 +57,11 @@ void HistogramWindow::Draw() {
         if (!m_currentIndicator.empty()) {
             auto& settings = GetCurrentSettings();
             
+            // A reloaded data frame replaces the column objects
+            if (IsDataValid() && !IsSummaryCurrent()) {
+                settings.histogramDirty = true;
+                settings.statisticsDirty = true;
+            }
             if (settings.histogramDirty && IsDataValid()) {
                 ComputeHistogram();
             }
@@ -158,6 +161,7 @@ void HistogramWindow::ClearHistogram() {
     
     m_currentIndicator.clear();
     m_currentColumnIndex = 0;
+    m_columnSummaries.clear();
     m_cachedIndicatorName.clear();
     m_cachedDataSize = 0;
     m_cachedDataHash = 0;
@@ -274,13 +278,13 @@ void HistogramWindow::DrawControls() {
             settings.histogramDirty = true;
         }
 
-        // Percentage sliders
+        // Percentile sliders
         if (settings.hasDataBounds && settings.dataMax > settings.dataMin) {
-            ImGui::Text("Range %%:");
+            ImGui::Text("Percentiles:");
             ImGui::SameLine();
             ImGui::SetNextItemWidth(80.0f);
             float minPercent = settings.minRangePercent;
-            if (ImGui::SliderFloat("##MinRangePercent", &minPercent, 0.0f, 100.0f, "%.1f%%")) {
+            if (ImGui::SliderFloat("##MinRangePercent", &minPercent, 0.0f, 100.0f, "P%.1f")) {
                 settings.minRangePercent = std::clamp(minPercent, 0.0f, settings.maxRangePercent - 0.1f);
                 UpdateValuesFromPercentage();
                 settings.histogramDirty = true;
@@ -290,7 +294,7 @@ void HistogramWindow::DrawControls() {
             ImGui::SameLine();
             ImGui::SetNextItemWidth(80.0f);
             float maxPercent = settings.maxRangePercent;
-            if (ImGui::SliderFloat("##MaxRangePercent", &maxPercent, 0.0f, 100.0f, "%.1f%%")) {
+            if (ImGui::SliderFloat("##MaxRangePercent", &maxPercent, 0.0f, 100.0f, "P%.1f")) {
                 settings.maxRangePercent = std::clamp(maxPercent, settings.minRangePercent + 0.1f, 100.0f);
                 UpdateValuesFromPercentage();
                 settings.histogramDirty = true;
@@ -460,45 +464,9 @@ void HistogramWindow::ComputeHistogram() {
     UpdateDataBounds();
 
     auto& settings = GetCurrentSettings();
+    const column_stats::ColumnSummary* summary = GetColumnSummary();
 
-    const chronosflow::AnalyticsDataFrame* dataFrame = m_dataSource->GetDataFrame();
-    auto table = dataFrame->get_cpu_table();
-    auto column = table->column(static_cast<int>(m_currentColumnIndex));
-    size_t dataSize = static_cast<size_t>(column->length());
-
-    std::vector<float> validData;
-    validData.reserve(dataSize);
-
-    // Use the original, syntactically correct GetScalar loop to gather data
-    for (int64_t i = 0; i < column->length(); ++i) {
-        auto scalar_result = column->GetScalar(i);
-        if (scalar_result.ok()) {
-            auto scalar = scalar_result.ValueOrDie();
-            if (scalar->is_valid) {
-                double value = 0.0;
-                // This block handles multiple numeric types
-                if (scalar->type->id() == arrow::Type::DOUBLE) {
-                    value = std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value;
-                }
-                else if (scalar->type->id() == arrow::Type::INT64) {
-                    value = static_cast<double>(std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value);
-                }
-                else if (scalar->type->id() == arrow::Type::FLOAT) {
-                    value = static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
-                }
-                else {
-                    continue; // Skip non-numeric columns
-                }
-
-                float floatValue = static_cast<float>(value);
-                if (std::isfinite(floatValue)) {
-                    validData.push_back(floatValue);
-                }
-            }
-        }
-    }
-
-    if (validData.empty()) {
+    if (!summary || summary->moments.count == 0) {
         settings.binEdges.clear();
         settings.binCounts.clear();
         settings.binCenters.clear();
@@ -512,9 +480,8 @@ void HistogramWindow::ComputeHistogram() {
 
     float minVal, maxVal;
     if (settings.autoRange) {
-        auto [computedMin, computedMax] = ComputeDataRange(validData.data(), validData.size());
-        minVal = computedMin;
-        maxVal = computedMax;
+        minVal = static_cast<float>(summary->moments.min);
+        maxVal = static_cast<float>(summary->moments.max);
     }
     else {
         minVal = settings.manualMin;
@@ -535,44 +502,24 @@ void HistogramWindow::ComputeHistogram() {
     }
     settings.binEdges[settings.binCount] = static_cast<double>(maxVal);
 
-    settings.binCounts.assign(settings.binCount, 0.0);
-    settings.lowerTailCount = 0.0;
-    settings.upperTailCount = 0.0;
+    // Folded from the cached fine histogram; no pass over the column
+    double lowerTail = 0.0;
+    double upperTail = 0.0;
+    summary->Rebin(minVal, maxVal, settings.binCount, &settings.binCounts, &lowerTail, &upperTail);
 
-    // Robust binning loop with tail aggregation
-    for (float value : validData) {
-        if (settings.showTails && !settings.autoRange) {
-            // When showing tails, aggregate values outside manual range
-            if (value < minVal) {
-                settings.lowerTailCount++;
-                continue;
-            }
-            else if (value > maxVal) {
-                settings.upperTailCount++;
-                continue;
-            }
-        }
-        
-        if (value >= minVal && value <= maxVal) {
-            int binIndex = static_cast<int>((value - minVal) / binWidth);
-            // This robustly handles the case where value == maxVal
-            if (binIndex >= settings.binCount) {
-                binIndex = settings.binCount - 1;
-            }
-            settings.binCounts[binIndex]++;
-        }
-    }
+    // Values outside the range only count when tails are shown
+    const bool keepTails = settings.showTails && !settings.autoRange;
+    settings.lowerTailCount = keepTails ? lowerTail : 0.0;
+    settings.upperTailCount = keepTails ? upperTail : 0.0;
 
-    if (settings.normalizeHistogram && !validData.empty()) {
-        double totalCount = static_cast<double>(validData.size());
-        if (totalCount > 0) {
-            for (double& count : settings.binCounts) {
-                count /= totalCount;
-            }
-            // Normalize tail counts too
-            settings.lowerTailCount /= totalCount;
-            settings.upperTailCount /= totalCount;
+    if (settings.normalizeHistogram) {
+        double totalCount = static_cast<double>(summary->moments.count);
+        for (double& count : settings.binCounts) {
+            count /= totalCount;
         }
+        // Normalize tail counts too
+        settings.lowerTailCount /= totalCount;
+        settings.upperTailCount /= totalCount;
     }
 
     settings.binCenters.resize(settings.binCount);
@@ -595,159 +542,40 @@ void HistogramWindow::ComputeStatistics() {
     }
 
     auto& settings = GetCurrentSettings();
+    const column_stats::ColumnSummary* summary = GetColumnSummary();
 
-    const chronosflow::AnalyticsDataFrame* dataFrame = m_dataSource->GetDataFrame();
-    auto table = dataFrame->get_cpu_table();
-    auto column = table->column(static_cast<int>(m_currentColumnIndex));
-    size_t dataSize = static_cast<size_t>(column->length());
-
-    std::vector<float> validData;
-    validData.reserve(dataSize);
-
-    // Use the same robust data gathering logic
-    for (int64_t i = 0; i < column->length(); ++i) {
-        auto scalar_result = column->GetScalar(i);
-        if (scalar_result.ok()) {
-            auto scalar = scalar_result.ValueOrDie();
-            if (scalar->is_valid) {
-                double value = 0.0;
-                if (scalar->type->id() == arrow::Type::DOUBLE) {
-                    value = std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value;
-                }
-                else if (scalar->type->id() == arrow::Type::INT64) {
-                    value = static_cast<double>(std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value);
-                }
-                else if (scalar->type->id() == arrow::Type::FLOAT) {
-                    value = static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
-                }
-                else {
-                    continue;
-                }
-
-                float floatValue = static_cast<float>(value);
-                if (std::isfinite(floatValue)) {
-                    validData.push_back(floatValue);
-                }
-            }
-        }
-    }
-
-    settings.stats.totalSamples = dataSize;
-    settings.stats.validSamples = validData.size();
-
-    if (validData.empty()) {
+    if (!summary || summary->moments.count == 0) {
+        const chronosflow::AnalyticsDataFrame* dataFrame = m_dataSource->GetDataFrame();
+        auto column = dataFrame->get_cpu_table()->column(static_cast<int>(m_currentColumnIndex));
         settings.stats = {}; // Clear all stats
-        settings.stats.totalSamples = dataSize; // Keep total sample count
+        settings.stats.totalSamples = static_cast<size_t>(column->length()); // Keep total sample count
         settings.statisticsDirty = false;
         return;
     }
 
-    ComputeBasicStatistics(validData);
+    const column_stats::Moments& moments = summary->moments;
+    settings.stats.totalSamples = static_cast<size_t>(summary->total_samples);
+    settings.stats.validSamples = static_cast<size_t>(moments.count);
+    settings.stats.mean = static_cast<float>(moments.mean);
+    settings.stats.stdDev = static_cast<float>(std::sqrt(moments.Variance()));
+    settings.stats.min = static_cast<float>(moments.min);
+    settings.stats.max = static_cast<float>(moments.max);
 
-    std::vector<float> sortedData = validData;
-    std::sort(sortedData.begin(), sortedData.end());
+    // Median from the quantile sketch rather than a full sort
+    settings.stats.median = static_cast<float>(summary->digest.Quantile(0.5));
 
-    size_t medianIndex = sortedData.size() / 2;
-    if (sortedData.size() % 2 == 0) {
-        settings.stats.median = (sortedData[medianIndex - 1] + sortedData[medianIndex]) / 2.0f;
+    if (moments.count < 3 || settings.stats.stdDev <= 1e-6f) {
+        settings.stats.skewness = NAN;
+        settings.stats.kurtosis = NAN;
     }
     else {
-        settings.stats.median = sortedData[medianIndex];
+        settings.stats.skewness = static_cast<float>(moments.Skewness());
+        settings.stats.kurtosis = static_cast<float>(moments.Kurtosis());
     }
 
-    ComputeHigherOrderMoments(validData);
-
     settings.statisticsDirty = false;
 }
 
-void HistogramWindow::ComputeBasicStatistics(const std::vector<float>& validData) {
-    if (m_currentIndicator.empty()) return;
-    
-    auto& settings = GetCurrentSettings();
-    if (validData.empty()) {
-        settings.stats.mean = settings.stats.stdDev = settings.stats.min = settings.stats.max = NAN;
-        return;
-    }
-
-    double sum = 0.0;
-    float minVal = validData[0];
-    float maxVal = validData[0];
-
-    for (float value : validData) {
-        sum += value;
-        minVal = std::min(minVal, value);
-        maxVal = std::max(maxVal, value);
-    }
-
-    settings.stats.mean = static_cast<float>(sum / validData.size());
-    settings.stats.min = minVal;
-    settings.stats.max = maxVal;
-
-    double variance = 0.0;
-    for (float value : validData) {
-        double diff = static_cast<double>(value) - settings.stats.mean;
-        variance += diff * diff;
-    }
-
-    settings.stats.stdDev = static_cast<float>(std::sqrt(variance / validData.size()));
-}
-
-std::pair<float, float> HistogramWindow::ComputeDataRange(const float* data, size_t size) {
-    if (!data || size == 0) {
-        return { 0.0f, 0.0f };
-    }
-
-    if (size < 8) {
-        float minVal = data[0];
-        float maxVal = data[0];
-
-        for (size_t i = 1; i < size; ++i) {
-            minVal = std::min(minVal, data[i]);
-            maxVal = std::max(maxVal, data[i]);
-        }
-
-        return { minVal, maxVal };
-    }
-
-    size_t simdSize = size - (size % 8);
-    float minVal = data[0];
-    float maxVal = data[0];
-
-    __m256 minVec = _mm256_set1_ps(data[0]);
-    __m256 maxVec = _mm256_set1_ps(data[0]);
-
-    if (reinterpret_cast<uintptr_t>(data) % 32 == 0) {
-        for (size_t i = 0; i < simdSize; i += 8) {
-            __m256 dataVec = _mm256_load_ps(data + i);
-            minVec = _mm256_min_ps(minVec, dataVec);
-            maxVec = _mm256_max_ps(maxVec, dataVec);
-        }
-    }
-    else {
-        for (size_t i = 0; i < simdSize; i += 8) {
-            __m256 dataVec = _mm256_loadu_ps(data + i);
-            minVec = _mm256_min_ps(minVec, dataVec);
-            maxVec = _mm256_max_ps(maxVec, dataVec);
-        }
-    }
-
-    float minArr[8], maxArr[8];
-    _mm256_storeu_ps(minArr, minVec);
-    _mm256_storeu_ps(maxArr, maxVec);
-
-    for (int i = 0; i < 8; ++i) {
-        minVal = std::min(minVal, minArr[i]);
-        maxVal = std::max(maxVal, maxArr[i]);
-    }
-
-    for (size_t i = simdSize; i < size; ++i) {
-        minVal = std::min(minVal, data[i]);
-        maxVal = std::max(maxVal, data[i]);
-    }
-
-    return { minVal, maxVal };
-}
-
 // UpdateBinEdges function was removed as it is now redundant.
 
 bool HistogramWindow::IsDataValid() const {
@@ -772,6 +600,46 @@ bool HistogramWindow::IsDataValid() const {
     return true;
 }
 
+const column_stats::ColumnSummary* HistogramWindow::GetColumnSummary() {
+    if (!IsDataValid()) {
+        return nullptr;
+    }
+
+    auto table = m_dataSource->GetDataFrame()->get_cpu_table();
+    auto column = table->column(static_cast<int>(m_currentColumnIndex));
+    auto it = m_columnSummaries.find(m_currentColumnIndex);
+    if (it != m_columnSummaries.end() && it->second && it->second->DescribesColumn(column)) {
+        return it->second.get();
+    }
+
+    // A miss usually means the data frame was replaced; summaries of columns
+    // that are no longer in the table only hold on to their histograms
+    for (auto entry = m_columnSummaries.begin(); entry != m_columnSummaries.end();) {
+        const bool current = entry->second && entry->first < static_cast<size_t>(table->num_columns()) &&
+                             entry->second->DescribesColumn(table->column(static_cast<int>(entry->first)));
+        if (current) {
+            ++entry;
+        } else {
+            entry = m_columnSummaries.erase(entry);
+        }
+    }
+    auto summary = column_stats::SummarizeColumn(column);
+    const column_stats::ColumnSummary* result = summary.get();
+    if (summary) {
+        m_columnSummaries[m_currentColumnIndex] = std::move(summary);
+    }
+    return result;
+}
+
+bool HistogramWindow::IsSummaryCurrent() const {
+    auto it = m_columnSummaries.find(m_currentColumnIndex);
+    if (it == m_columnSummaries.end() || !it->second) {
+        return false;
+    }
+    auto column = m_dataSource->GetDataFrame()->get_cpu_table()->column(static_cast<int>(m_currentColumnIndex));
+    return it->second->DescribesColumn(column);
+}
+
 size_t HistogramWindow::ComputeDataHash(const float* data, size_t size) const {
     if (!data || size == 0) {
         return 0;
@@ -787,85 +655,17 @@ size_t HistogramWindow::ComputeDataHash(const float* data, size_t size) const {
     return hash;
 }
 
-void HistogramWindow::ComputeHigherOrderMoments(const std::vector<float>& validData) {
-    if (m_currentIndicator.empty()) return;
-    
-    auto& settings = GetCurrentSettings();
-    if (validData.size() < 3 || settings.stats.stdDev <= 1e-6f) {
-        settings.stats.skewness = NAN;
-        settings.stats.kurtosis = NAN;
-        return;
-    }
-
-    size_t n = validData.size();
-    double mean = settings.stats.mean;
-
-    double m3 = 0.0;
-    double m4 = 0.0;
-
-    for (float value : validData) {
-        double dev = static_cast<double>(value) - mean;
-        double dev2 = dev * dev;
-        m3 += dev2 * dev;
-        m4 += dev2 * dev2;
-    }
-
-    m3 /= n;
-    m4 /= n;
-
-    double var = static_cast<double>(settings.stats.stdDev * settings.stats.stdDev);
-    double var2 = var * var;
-
-    settings.stats.skewness = static_cast<float>(m3 / (var * settings.stats.stdDev));
-    settings.stats.kurtosis = static_cast<float>((m4 / var2) - 3.0);
-}
-
 void HistogramWindow::UpdateDataBounds() {
     if (!IsDataValid() || m_currentIndicator.empty()) {
         return;
     }
 
     auto& settings = GetCurrentSettings();
+    const column_stats::ColumnSummary* summary = GetColumnSummary();
 
-    const chronosflow::AnalyticsDataFrame* dataFrame = m_dataSource->GetDataFrame();
-    auto table = dataFrame->get_cpu_table();
-    auto column = table->column(static_cast<int>(m_currentColumnIndex));
-    size_t dataSize = static_cast<size_t>(column->length());
-
-    std::vector<float> validData;
-    validData.reserve(dataSize);
-
-    for (int64_t i = 0; i < column->length(); ++i) {
-        auto scalar_result = column->GetScalar(i);
-        if (scalar_result.ok()) {
-            auto scalar = scalar_result.ValueOrDie();
-            if (scalar->is_valid) {
-                double value = 0.0;
-                if (scalar->type->id() == arrow::Type::DOUBLE) {
-                    value = std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value;
-                }
-                else if (scalar->type->id() == arrow::Type::INT64) {
-                    value = static_cast<double>(std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value);
-                }
-                else if (scalar->type->id() == arrow::Type::FLOAT) {
-                    value = static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
-                }
-                else {
-                    continue;
-                }
-
-                float floatValue = static_cast<float>(value);
-                if (std::isfinite(floatValue)) {
-                    validData.push_back(floatValue);
-                }
-            }
-        }
-    }
-
-    if (!validData.empty()) {
-        auto [minVal, maxVal] = ComputeDataRange(validData.data(), validData.size());
-        settings.dataMin = minVal;
-        settings.dataMax = maxVal;
+    if (summary && summary->moments.count > 0) {
+        settings.dataMin = static_cast<float>(summary->moments.min);
+        settings.dataMax = static_cast<float>(summary->moments.max);
         settings.hasDataBounds = true;
         
         // Initialize manual range to data bounds if not set
@@ -928,9 +728,12 @@ void HistogramWindow::UpdatePercentageFromValues(IndicatorSettings& settings) {
         return;
     }
     
-    float range = settings.dataMax - settings.dataMin;
-    settings.minRangePercent = ((settings.manualMin - settings.dataMin) / range) * 100.0f;
-    settings.maxRangePercent = ((settings.manualMax - settings.dataMin) / range) * 100.0f;
+    const column_stats::ColumnSummary* summary = GetColumnSummary();
+    if (!summary) {
+        return;
+    }
+    settings.minRangePercent = static_cast<float>(summary->digest.Cdf(settings.manualMin) * 100.0);
+    settings.maxRangePercent = static_cast<float>(summary->digest.Cdf(settings.manualMax) * 100.0);
 }
 
 void HistogramWindow::UpdateValuesFromPercentage() {
@@ -941,11 +744,11 @@ void HistogramWindow::UpdateValuesFromPercentage() {
         return;
     }
     
-    float range = settings.dataMax - settings.dataMin;
-    if (range <= 0.0f) return; // Additional safety check
+    const column_stats::ColumnSummary* summary = GetColumnSummary();
+    if (!summary) return;
     
-    settings.manualMin = settings.dataMin + (settings.minRangePercent / 100.0f) * range;
-    settings.manualMax = settings.dataMin + (settings.maxRangePercent / 100.0f) * range;
+    settings.manualMin = static_cast<float>(summary->digest.Quantile(settings.minRangePercent / 100.0));
+    settings.manualMax = static_cast<float>(summary->digest.Quantile(settings.maxRangePercent / 100.0));
     
     // Ensure the values are still within bounds (floating point precision issues)
     settings.manualMin = std::clamp(settings.manualMin, settings.dataMin, settings.dataMax);
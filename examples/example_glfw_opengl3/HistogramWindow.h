@@ -3,6 +3,7 @@
 #include "imgui.h"
 #include "implot.h"
 #include "TimeSeries.h"
+#include "ColumnStatsEngine.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -36,9 +37,9 @@ struct IndicatorSettings {
     bool normalizeHistogram = false;                ///< Normalize histogram counts
     bool showTails = false;                         ///< Show tails aggregation
     
-    // Range percentage controls
-    float minRangePercent = 0.0f;                   ///< Minimum range as percentage (0-100)
-    float maxRangePercent = 100.0f;                 ///< Maximum range as percentage (0-100)
+    // Range percentile controls
+    float minRangePercent = 0.0f;                   ///< Lower bound of the manual range as a percentile (0-100)
+    float maxRangePercent = 100.0f;                 ///< Upper bound of the manual range as a percentile (0-100)
     
     // Data range bounds (for constraining manual inputs)
     float dataMin = 0.0f;                           ///< Actual minimum value in data
@@ -168,12 +169,17 @@ private:
     // Helper methods
     
     /**
-     * ComputeDataRange - Calculate min/max range of valid (non-NaN) data
-     * @param data - Pointer to data array
-     * @param size - Size of data array
-     * @return Pair of (min, max) values
+     * GetColumnSummary - Summary of the current column, recomputed only when
+     * the column object changed (new data frame or reload)
+     * @return Summary, or nullptr for columns that are not numeric
+     */
+    const column_stats::ColumnSummary* GetColumnSummary();
+    
+    /**
+     * IsSummaryCurrent - Check whether the cached summary still describes the current column
+     * @return true if a cached summary matches the current column
      */
-    std::pair<float, float> ComputeDataRange(const float* data, size_t size);
+    bool IsSummaryCurrent() const;
     
     /**
      * UpdateBinEdges - Calculate bin edge positions based on current range and bin count
@@ -194,18 +200,6 @@ private:
      */
     size_t ComputeDataHash(const float* data, size_t size) const;
     
-    /**
-     * ComputeHigherOrderMoments - Calculate skewness and kurtosis
-     * @param validData - Vector of valid (non-NaN) data values
-     */
-    void ComputeHigherOrderMoments(const std::vector<float>& validData);
-    
-    /**
-     * ComputeBasicStatistics - Calculate basic statistics (mean, std dev, min, max)
-     * @param validData - Vector of valid (non-NaN) data values
-     */
-    void ComputeBasicStatistics(const std::vector<float>& validData);
-    
     /**
      * UpdateDataBounds - Update the data min/max bounds from current data
      */
@@ -217,18 +211,18 @@ private:
     void ConstrainManualRange();
     
     /**
-     * UpdatePercentageFromValues - Update percentage sliders from numeric values
+     * UpdatePercentageFromValues - Update percentile sliders from numeric values
      */
     void UpdatePercentageFromValues();
     
     /**
-     * UpdatePercentageFromValues - Update percentage sliders from numeric values (with settings reference)
+     * UpdatePercentageFromValues - Update percentile sliders from numeric values (with settings reference)
      * @param settings - Reference to settings to update
      */
     void UpdatePercentageFromValues(IndicatorSettings& settings);
     
     /**
-     * UpdateValuesFromPercentage - Update numeric values from percentage sliders
+     * UpdateValuesFromPercentage - Update numeric values from percentile sliders
      */
     void UpdateValuesFromPercentage();
     
@@ -259,6 +253,11 @@ private:
     // Per-indicator settings storage
     std::unordered_map<std::string, IndicatorSettings> m_indicatorSettings;
     
+    // Column summaries by column index; a summary holds a weak reference to
+    // the column it describes, so a replaced data frame invalidates it.
+    // Entries that no longer describe the table are dropped on each miss.
+    std::unordered_map<size_t, std::shared_ptr<const column_stats::ColumnSummary>> m_columnSummaries;
+    
     // Performance optimization
     std::string m_cachedIndicatorName;   ///< Cached indicator name for validation
     size_t m_cachedDataSize;             ///< Cached data size for validation
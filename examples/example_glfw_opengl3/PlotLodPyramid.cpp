@@ -0,0 +1,220 @@
+#include "PlotLodPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace plot_lod {
+
+void MinMaxPyramid::Build(const double* lows, const double* highs, size_t count) {
+    Clear();
+    if (!lows || !highs || count == 0) {
+        return;
+    }
+    m_lows = lows;
+    m_highs = highs;
+    m_count = std::min<size_t>(count, kNoIndex - 1);
+
+    size_t below = m_count;
+    while (below > 1) {
+        const size_t size = (below + 1) / 2;
+        Level level;
+        level.min_index.resize(size);
+        level.max_index.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            const size_t a = 2 * i;
+            const size_t b = std::min(a + 1, below - 1);
+            uint32_t minA, maxA, minB, maxB;
+            BucketExtrema(LevelCount() - 1, a, &minA, &maxA);
+            BucketExtrema(LevelCount() - 1, b, &minB, &maxB);
+            level.min_index[i] = LowerOf(minA, minB);
+            level.max_index[i] = HigherOf(maxA, maxB);
+        }
+        m_levels.push_back(std::move(level));
+        below = size;
+    }
+}
+
+void MinMaxPyramid::Clear() {
+    m_lows = nullptr;
+    m_highs = nullptr;
+    m_count = 0;
+    m_levels.clear();
+}
+
+uint32_t MinMaxPyramid::LowerOf(uint32_t a, uint32_t b) const {
+    if (a == kNoIndex) return b;
+    if (b == kNoIndex) return a;
+    return m_lows[b] < m_lows[a] ? b : a;
+}
+
+uint32_t MinMaxPyramid::HigherOf(uint32_t a, uint32_t b) const {
+    if (a == kNoIndex) return b;
+    if (b == kNoIndex) return a;
+    return m_highs[b] > m_highs[a] ? b : a;
+}
+
+void MinMaxPyramid::BucketExtrema(int level, size_t bucket, uint32_t* minIndex, uint32_t* maxIndex) const {
+    if (level <= 0) {
+        const uint32_t index = static_cast<uint32_t>(bucket);
+        *minIndex = std::isnan(m_lows[bucket]) ? kNoIndex : index;
+        *maxIndex = std::isnan(m_highs[bucket]) ? kNoIndex : index;
+        return;
+    }
+    const Level& stored = m_levels[static_cast<size_t>(level) - 1];
+    *minIndex = stored.min_index[bucket];
+    *maxIndex = stored.max_index[bucket];
+}
+
+// Bottom-up walk: odd edges are taken at the current level, then both ends
+// move up one level, so at most two buckets are read per level.
+bool MinMaxPyramid::RangeMinMax(size_t begin, size_t end, double* minValue, double* maxValue) const {
+    end = std::min(end, m_count);
+    uint32_t lowest = kNoIndex;
+    uint32_t highest = kNoIndex;
+    int level = 0;
+    while (begin < end) {
+        uint32_t minIndex, maxIndex;
+        if (begin & 1) {
+            BucketExtrema(level, begin, &minIndex, &maxIndex);
+            lowest = LowerOf(lowest, minIndex);
+            highest = HigherOf(highest, maxIndex);
+            ++begin;
+        }
+        if (end & 1) {
+            --end;
+            BucketExtrema(level, end, &minIndex, &maxIndex);
+            lowest = LowerOf(lowest, minIndex);
+            highest = HigherOf(highest, maxIndex);
+        }
+        begin >>= 1;
+        end >>= 1;
+        ++level;
+    }
+    if (lowest == kNoIndex || highest == kNoIndex) {
+        return false;
+    }
+    if (minValue) *minValue = m_lows[lowest];
+    if (maxValue) *maxValue = m_highs[highest];
+    return true;
+}
+
+int PickLevel(size_t begin, size_t end, double maxBuckets, int levelCount) {
+    const size_t count = end > begin ? end - begin : 0;
+    const double limit = std::max(maxBuckets, 1.0);
+    int level = 0;
+    while (level + 1 < levelCount) {
+        const size_t size = size_t(1) << level;
+        // A range that is not aligned touches one bucket more
+        const size_t touched = (count + size - 1) / size + (level > 0 ? 1 : 0);
+        if (static_cast<double>(touched) <= limit) {
+            break;
+        }
+        ++level;
+    }
+    return level;
+}
+
+void DecimateLine(const MinMaxPyramid& pyramid,
+                  const double* xs,
+                  const double* ys,
+                  size_t begin,
+                  size_t end,
+                  int level,
+                  std::vector<double>* outX,
+                  std::vector<double>* outY) {
+    end = std::min(end, pyramid.Count());
+    if (begin >= end) {
+        return;
+    }
+    if (level <= 0) {
+        outX->insert(outX->end(), xs + begin, xs + end);
+        outY->insert(outY->end(), ys + begin, ys + end);
+        return;
+    }
+
+    const size_t size = size_t(1) << level;
+    const size_t count = pyramid.Count();
+    const size_t firstBucket = begin >> level;
+    const size_t lastBucket = (end - 1) >> level;
+    outX->reserve(outX->size() + 4 * (lastBucket - firstBucket + 1));
+    outY->reserve(outY->size() + 4 * (lastBucket - firstBucket + 1));
+
+    for (size_t bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+        const size_t first = bucket * size;
+        const size_t last = std::min(first + size, count) - 1;
+        uint32_t minIndex, maxIndex;
+        pyramid.BucketExtrema(level, bucket, &minIndex, &maxIndex);
+
+        size_t points[4];
+        size_t used = 0;
+        points[used++] = first;
+        if (minIndex != MinMaxPyramid::kNoIndex) points[used++] = minIndex;
+        if (maxIndex != MinMaxPyramid::kNoIndex) points[used++] = maxIndex;
+        points[used++] = last;
+        std::sort(points, points + used);
+        used = static_cast<size_t>(std::unique(points, points + used) - points);
+        for (size_t i = 0; i < used; ++i) {
+            outX->push_back(xs[points[i]]);
+            outY->push_back(ys[points[i]]);
+        }
+    }
+}
+
+void OhlcBuckets::Clear() {
+    x.clear();
+    open.clear();
+    high.clear();
+    low.clear();
+    close.clear();
+    volume.clear();
+}
+
+void AggregateOhlc(const MinMaxPyramid& pyramid,
+                   const double* xs,
+                   const double* opens,
+                   const double* closes,
+                   const double* volumePrefix,
+                   size_t begin,
+                   size_t end,
+                   int level,
+                   OhlcBuckets* out) {
+    out->Clear();
+    end = std::min(end, pyramid.Count());
+    if (begin >= end) {
+        return;
+    }
+    level = std::max(level, 0);
+    const size_t size = size_t(1) << level;
+    const size_t count = pyramid.Count();
+    const size_t firstBucket = begin >> level;
+    const size_t lastBucket = (end - 1) >> level;
+    const size_t buckets = lastBucket - firstBucket + 1;
+    out->x.reserve(buckets);
+    out->open.reserve(buckets);
+    out->high.reserve(buckets);
+    out->low.reserve(buckets);
+    out->close.reserve(buckets);
+    if (volumePrefix) {
+        out->volume.reserve(buckets);
+    }
+
+    for (size_t bucket = firstBucket; bucket <= lastBucket; ++bucket) {
+        uint32_t minIndex, maxIndex;
+        pyramid.BucketExtrema(level, bucket, &minIndex, &maxIndex);
+        if (minIndex == MinMaxPyramid::kNoIndex || maxIndex == MinMaxPyramid::kNoIndex) {
+            continue;
+        }
+        const size_t first = bucket * size;
+        const size_t last = std::min(first + size, count) - 1;
+        out->x.push_back(0.5 * (xs[first] + xs[last]));
+        out->open.push_back(opens[first]);
+        out->high.push_back(pyramid.Highs()[maxIndex]);
+        out->low.push_back(pyramid.Lows()[minIndex]);
+        out->close.push_back(closes[last]);
+        if (volumePrefix) {
+            out->volume.push_back(volumePrefix[last + 1] - volumePrefix[first]);
+        }
+    }
+}
+
+} // namespace plot_lod
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace plot_lod {
+
+// Multi-resolution min/max index for a series sorted by x.
+//
+// Level k splits the series into buckets of 2^k points aligned to multiples
+// of 2^k, and keeps the index of the lowest and highest point of each bucket
+// (level 0 is the series itself). First and last of a bucket are its end
+// points, so together a level holds an OHLC aggregate of the series. Bucket
+// boundaries do not move with the view, which keeps a decimated plot from
+// shimmering while it is panned.
+//
+// The pyramid keeps pointers to the series it was built from; rebuild it
+// whenever those arrays change. NaN values are ignored for min/max.
+class MinMaxPyramid {
+public:
+    static constexpr uint32_t kNoIndex = UINT32_MAX;
+
+    // lows and highs may be the same array for a line series
+    void Build(const double* lows, const double* highs, size_t count);
+    void Clear();
+
+    size_t Count() const { return m_count; }
+    bool Empty() const { return m_count == 0; }
+    int LevelCount() const { return static_cast<int>(m_levels.size()) + 1; }
+    const double* Lows() const { return m_lows; }
+    const double* Highs() const { return m_highs; }
+
+    // Min of lows and max of highs over [begin, end) from O(log n) buckets.
+    // False when the range is empty or holds only NaN.
+    bool RangeMinMax(size_t begin, size_t end, double* minValue, double* maxValue) const;
+
+    // Indices of the lowest low and highest high of a bucket, kNoIndex when
+    // the bucket holds only NaN
+    void BucketExtrema(int level, size_t bucket, uint32_t* minIndex, uint32_t* maxIndex) const;
+
+private:
+    struct Level {
+        std::vector<uint32_t> min_index;
+        std::vector<uint32_t> max_index;
+    };
+
+    uint32_t LowerOf(uint32_t a, uint32_t b) const;
+    uint32_t HigherOf(uint32_t a, uint32_t b) const;
+
+    const double* m_lows = nullptr;
+    const double* m_highs = nullptr;
+    size_t m_count = 0;
+    std::vector<Level> m_levels;          // m_levels[k - 1] holds level k
+};
+
+// Lowest level that draws [begin, end) with at most maxBuckets buckets
+int PickLevel(size_t begin, size_t end, double maxBuckets, int levelCount);
+
+// Appends the first, min, max and last point of each level bucket touching
+// [begin, end), in x order and without repeats. At level 0 the points are
+// copied as they are.
+void DecimateLine(const MinMaxPyramid& pyramid,
+                  const double* xs,
+                  const double* ys,
+                  size_t begin,
+                  size_t end,
+                  int level,
+                  std::vector<double>* outX,
+                  std::vector<double>* outY);
+
+struct OhlcBuckets {
+    std::vector<double> x;                // Midpoint of the first and last x
+    std::vector<double> open;
+    std::vector<double> high;
+    std::vector<double> low;
+    std::vector<double> close;
+    std::vector<double> volume;           // Sum over the bucket, when requested
+
+    void Clear();
+    size_t Size() const { return x.size(); }
+};
+
+// Aggregates candles of the level buckets touching [begin, end). The pyramid
+// must be built over (lows, highs). volumePrefix, when given, holds count + 1
+// running sums of volume.
+void AggregateOhlc(const MinMaxPyramid& pyramid,
+                   const double* xs,
+                   const double* opens,
+                   const double* closes,
+                   const double* volumePrefix,
+                   size_t begin,
+                   size_t end,
+                   int level,
+                   OhlcBuckets* out);
+
+} // namespace plot_lod
@@ -1,5 +1,6 @@
 #include "QuestDbDataFrameGateway.h"
 
+#include <arrow/csv/api.h>
 #include <arrow/table.h>
 #include <arrow/scalar.h>
 
@@ -8,12 +9,13 @@
 #include <algorithm>
 #include <chrono>
 #include <ctime>
-#include <filesystem>
-#include <fstream>
 #include <map>
+#include <memory>
 #include <optional>
 #include <sstream>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <cctype>
 #include <cstdlib>
@@ -29,175 +31,20 @@
 #endif
 
 #include "chronosflow.h"
-#include "dataframe_io.h"
+#include "QuestDbIlpEncoder.h"
+#include "QuestDbIlpSender.h"
+#include "QuestDbResponseStream.h"
 
 namespace questdb {
 namespace {
 
+constexpr int64_t kMillisPerDay = 86'400'000LL;
+
 std::string GetEnvOrEmpty(const char* key) {
     const char* value = std::getenv(key);
     return value ? std::string(value) : std::string();
 }
 
-std::string EscapeIdentifier(const std::string& value) {
-    std::string escaped;
-    escaped.reserve(value.size());
-    for (char ch : value) {
-        if (ch == ' ' || ch == ',' || ch == '=') {
-            escaped.push_back('\\');
-        }
-        escaped.push_back(ch);
-    }
-    return escaped;
-}
-
-std::string EscapeStringValue(const std::string& value) {
-    std::string escaped;
-    escaped.reserve(value.size() + 2);
-    escaped.push_back('"');
-    for (char ch : value) {
-        if (ch == '"' || ch == '\\') {
-            escaped.push_back('\\');
-        }
-        escaped.push_back(ch);
-    }
-    escaped.push_back('"');
-    return escaped;
-}
-
-time_t ToUtcTimeT(std::tm* tm) {
-#if defined(_WIN32)
-    return _mkgmtime(tm);
-#else
-    return timegm(tm);
-#endif
-}
-
-std::optional<int64_t> ParseIsoToMillis(const std::string& text) {
-    if (text.size() < 19) {
-        return std::nullopt;
-    }
-    auto ParseInt = [&](size_t pos, size_t len) -> std::optional<int> {
-        if (pos + len > text.size()) return std::nullopt;
-        int value = 0;
-        for (size_t i = 0; i < len; ++i) {
-            char ch = text[pos + i];
-            if (ch < '0' || ch > '9') {
-                return std::nullopt;
-            }
-            value = value * 10 + (ch - '0');
-        }
-        return value;
-    };
-
-    auto year = ParseInt(0, 4);
-    auto month = ParseInt(5, 2);
-    auto day = ParseInt(8, 2);
-    auto hour = ParseInt(11, 2);
-    auto minute = ParseInt(14, 2);
-    auto second = ParseInt(17, 2);
-    if (!year || !month || !day || !hour || !minute || !second) {
-        return std::nullopt;
-    }
-
-    int64_t fractionMillis = 0;
-    auto dotPos = text.find('.', 19);
-    if (dotPos != std::string::npos) {
-        size_t fracStart = dotPos + 1;
-        size_t fracEnd = fracStart;
-        while (fracEnd < text.size() && std::isdigit(static_cast<unsigned char>(text[fracEnd]))) {
-            ++fracEnd;
-        }
-        std::string fraction = text.substr(fracStart, fracEnd - fracStart);
-        while (fraction.size() < 3) fraction.push_back('0');
-        if (fraction.size() > 3) fraction.resize(3);
-        fractionMillis = std::stoi(fraction);
-    }
-
-    std::tm tm = {};
-    tm.tm_year = *year - 1900;
-    tm.tm_mon = *month - 1;
-    tm.tm_mday = *day;
-    tm.tm_hour = *hour;
-    tm.tm_min = *minute;
-    tm.tm_sec = *second;
-    time_t seconds = ToUtcTimeT(&tm);
-    if (seconds == static_cast<time_t>(-1)) {
-        return std::nullopt;
-    }
-    return static_cast<int64_t>(seconds) * 1000LL + fractionMillis;
-}
-
-std::optional<int64_t> ScalarToMillis(const std::shared_ptr<arrow::Scalar>& scalar,
-                                      bool coerce_seconds_to_millis) {
-    if (!scalar || !scalar->is_valid) {
-        return std::nullopt;
-    }
-    switch (scalar->type->id()) {
-        case arrow::Type::INT64: {
-            int64_t value = std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value;
-            if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
-                value *= 1000;
-            }
-            return value;
-        }
-        case arrow::Type::INT32: {
-            int64_t value = std::static_pointer_cast<arrow::Int32Scalar>(scalar)->value;
-            if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
-                value *= 1000;
-            }
-            return value;
-        }
-        case arrow::Type::DOUBLE:
-        case arrow::Type::FLOAT: {
-            double numeric = (scalar->type->id() == arrow::Type::DOUBLE)
-                ? std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value
-                : static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
-            int64_t value = static_cast<int64_t>(std::llround(numeric));
-            if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
-                value *= 1000;
-            }
-            return value;
-        }
-        case arrow::Type::STRING:
-        case arrow::Type::LARGE_STRING: {
-            auto text = scalar->ToString();
-            if (text.empty()) {
-                return std::nullopt;
-            }
-            bool isNumeric = std::all_of(text.begin(), text.end(), [](unsigned char ch) {
-                return std::isdigit(ch) || ch == '-' || ch == '+';
-            });
-            if (isNumeric) {
-                try {
-                    int64_t value = std::stoll(text);
-                    if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
-                        value *= 1000;
-                    }
-                    return value;
-                } catch (...) {
-                }
-            }
-            return ParseIsoToMillis(text);
-        }
-        case arrow::Type::TIMESTAMP: {
-            auto tsScalar = std::static_pointer_cast<arrow::TimestampScalar>(scalar);
-            int64_t value = tsScalar->value;
-            auto type = std::static_pointer_cast<arrow::TimestampType>(tsScalar->type);
-            switch (type->unit()) {
-                case arrow::TimeUnit::SECOND: return value * 1000;
-                case arrow::TimeUnit::MILLI: return value;
-                case arrow::TimeUnit::MICRO: return value / 1000;
-                case arrow::TimeUnit::NANO: return value / 1000000;
-            }
-            break;
-        }
-        default:
-            break;
-    }
-    return std::nullopt;
-}
-
 const char* kTimestampCandidates[] = {
     "timestamp_unix",
     "timestamp",
@@ -224,93 +71,226 @@ std::string DetectTimestampColumn(const std::shared_ptr<arrow::Schema>& schema,
     return {};
 }
 
-struct CurlFileContext {
-    std::ofstream* stream = nullptr;
-    size_t sniff_limit = 4096;
-    std::string sniff;
-    bool errored = false;
-};
+std::string EscapeUrlComponent(const std::string& text) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return {};
+    }
+    std::unique_ptr<char, decltype(&curl_free)> escaped(
+        curl_easy_escape(curl, text.c_str(), static_cast<int>(text.size())), &curl_free);
+    curl_easy_cleanup(curl);
+    return escaped ? std::string(escaped.get()) : std::string();
+}
 
-size_t CurlWriteToFile(void* contents, size_t size, size_t nmemb, void* userp) {
-    size_t total = size * nmemb;
-    if (total == 0) {
-        return 0;
+std::vector<std::string> SplitCsvLine(const std::string& line) {
+    std::vector<std::string> cols;
+    std::string current;
+    bool in_quotes = false;
+    for (char ch : line) {
+        if (ch == '"') {
+            in_quotes = !in_quotes;
+            continue;
+        }
+        if (ch == ',' && !in_quotes) {
+            cols.push_back(current);
+            current.clear();
+            continue;
+        }
+        current.push_back(ch);
+    }
+    cols.push_back(current);
+    return cols;
+}
+
+
+std::string_view TrimLeft(std::string_view text) {
+    size_t start = 0;
+    while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start]))) {
+        ++start;
+    }
+    return text.substr(start);
+}
+
+std::string ExtractJsonMessage(std::string_view json) {
+    size_t errorPos = json.find("\"error\"");
+    if (errorPos == std::string_view::npos) {
+        return std::string(json.substr(0, std::min<size_t>(512, json.size())));
+    }
+    size_t colon = json.find(':', errorPos);
+    if (colon == std::string_view::npos) {
+        return std::string(json.substr(0, std::min<size_t>(512, json.size())));
     }
-    auto* ctx = static_cast<CurlFileContext*>(userp);
-    if (!ctx || !ctx->stream || !ctx->stream->good()) {
-        return 0;
+    size_t start = colon + 1;
+    while (start < json.size() && std::isspace(static_cast<unsigned char>(json[start]))) {
+        ++start;
     }
-    ctx->stream->write(static_cast<const char*>(contents), static_cast<std::streamsize>(total));
-    if (!ctx->stream->good()) {
-        ctx->errored = true;
-        return 0;
+    bool quoted = start < json.size() && json[start] == '"';
+    if (quoted) {
+        ++start;
+    }
+    size_t end = start;
+    while (end < json.size()) {
+        char ch = json[end];
+        if ((quoted && ch == '"') || (!quoted && (ch == '\r' || ch == '\n' || ch == ',' || ch == '}'))) {
+            break;
+        }
+        ++end;
     }
-    if (ctx->sniff.size() < ctx->sniff_limit) {
-        const size_t remaining = ctx->sniff_limit - ctx->sniff.size();
-        ctx->sniff.append(static_cast<const char*>(contents), std::min(total, remaining));
+    if (end <= start) {
+        return std::string(json.substr(0, std::min<size_t>(512, json.size())));
     }
-    return total;
+    return std::string(json.substr(start, end - start));
 }
 
-std::string ReadFilePrefix(const std::filesystem::path& path, size_t maxBytes) {
-    std::string buffer;
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        return buffer;
+// Turns an HTTP error status or a JSON error body into an IOError before
+// any of the response is handed to the CSV reader
+arrow::Status CheckCsvResponse(HttpResponseStream& response) {
+    const std::string peek = response.Peek(4096);
+    const long httpCode = response.ResponseCode();
+    if (peek.empty()) {
+        ARROW_RETURN_NOT_OK(response.TransferStatus());
+        return arrow::Status::IOError("QuestDB returned empty response.");
     }
-    buffer.resize(maxBytes);
-    in.read(buffer.data(), static_cast<std::streamsize>(maxBytes));
-    buffer.resize(static_cast<size_t>(in.gcount()));
-    return buffer;
-}
 
-std::string EscapeTagValue(const std::string& value) {
-    std::string escaped;
-    escaped.reserve(value.size());
-    for (char ch : value) {
-        if (ch == ' ' || ch == ',' || ch == '=' || ch == '\t') {
-            escaped.push_back('\\');
+    std::string_view trimmed = TrimLeft(peek);
+    const bool json = !trimmed.empty() && trimmed.front() == '{';
+    if (httpCode < 400 && !json) {
+        return arrow::Status::OK();
+    }
+
+    std::string message;
+    if (httpCode >= 400) {
+        message = "QuestDB HTTP " + std::to_string(httpCode);
+    }
+    if (json) {
+        std::string jsonMsg = ExtractJsonMessage(trimmed);
+        if (jsonMsg.rfind("QuestDB error:", 0) != 0) {
+            jsonMsg = "QuestDB returned JSON instead of CSV: " + jsonMsg;
         }
-        escaped.push_back(ch);
+        if (!message.empty()) {
+            message += " - ";
+        }
+        message += jsonMsg;
+    }
+    return arrow::Status::IOError(message);
+}
+
+// Arrow type a QuestDB column converts to. Types left out (timestamps,
+// dates, UUIDs, ...) keep Arrow's own inference.
+std::shared_ptr<arrow::DataType> ArrowTypeForQuestDbType(const std::string& questdbType) {
+    std::string type = questdbType;
+    std::transform(type.begin(), type.end(), type.begin(),
+                   [](unsigned char ch) { return static_cast<char>(std::toupper(ch)); });
+    if (type == "BOOLEAN") {
+        return arrow::boolean();
+    }
+    if (type == "BYTE" || type == "SHORT" || type == "INT" || type == "LONG") {
+        return arrow::int64();
+    }
+    if (type == "FLOAT" || type == "DOUBLE") {
+        return arrow::float64();
     }
-    if (escaped.empty()) {
-        escaped = "none";
+    if (type == "SYMBOL" || type == "STRING" || type == "VARCHAR" || type == "CHAR") {
+        return arrow::utf8();
     }
-    return escaped;
+    return nullptr;
 }
 
-std::string BuildStaticTagSuffix(const std::map<std::string, std::string>& tags) {
-    if (tags.empty()) {
-        return {};
+arrow::Result<std::shared_ptr<arrow::Table>> ReadCsvResponse(
+    const std::shared_ptr<arrow::io::InputStream>& input,
+    const std::unordered_map<std::string, std::shared_ptr<arrow::DataType>>& columnTypes,
+    bool streaming) {
+
+    auto readOptions = arrow::csv::ReadOptions::Defaults();
+    readOptions.use_threads = true;
+    readOptions.block_size = 4 << 20;
+
+    auto parseOptions = arrow::csv::ParseOptions::Defaults();
+
+    auto convertOptions = arrow::csv::ConvertOptions::Defaults();
+    convertOptions.include_missing_columns = true;
+    convertOptions.column_types = columnTypes;
+
+    if (!streaming) {
+        ARROW_ASSIGN_OR_RAISE(auto reader, arrow::csv::TableReader::Make(
+            arrow::io::default_io_context(), input, readOptions, parseOptions, convertOptions));
+        return reader->Read();
     }
-    std::ostringstream oss;
-    for (const auto& kv : tags) {
-        if (kv.first.empty()) {
-            continue;
+
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::csv::StreamingReader::Make(
+        arrow::io::default_io_context(), input, readOptions, parseOptions, convertOptions));
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_RETURN_NOT_OK(reader->ReadNext(&batch));
+        if (!batch) {
+            break;
         }
-        oss << ',' << EscapeIdentifier(kv.first) << '=' << EscapeTagValue(kv.second);
+        batches.push_back(std::move(batch));
     }
-    return oss.str();
+    return arrow::Table::FromRecordBatches(reader->schema(), batches);
 }
 
-std::vector<std::string> SplitCsvLine(const std::string& line) {
-    std::vector<std::string> cols;
-    std::string current;
-    bool in_quotes = false;
-    for (char ch : line) {
-        if (ch == '"') {
-            in_quotes = !in_quotes;
+arrow::Result<std::shared_ptr<HttpResponseStream>> OpenCsvExport(const ConnectionOptions& options,
+                                                                 const std::string& query) {
+    const std::string encoded = EscapeUrlComponent(query);
+    if (encoded.empty()) {
+        return arrow::Status::IOError("Failed to encode QuestDB query.");
+    }
+    HttpResponseStream::Options streamOptions;
+    streamOptions.connect_timeout_ms = options.connect_timeout_ms;
+    streamOptions.idle_timeout_ms = options.rest_timeout_ms;
+    streamOptions.buffer_bytes = options.import_buffer_bytes;
+    return HttpResponseStream::Open(options.rest_url + "/exp?query=" + encoded + "&fmt=csv", streamOptions);
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> FetchCsvTable(
+    const ConnectionOptions& options,
+    const std::string& query,
+    const std::unordered_map<std::string, std::shared_ptr<arrow::DataType>>& columnTypes,
+    bool streaming) {
+
+    ARROW_ASSIGN_OR_RAISE(auto response, OpenCsvExport(options, query));
+    ARROW_RETURN_NOT_OK(CheckCsvResponse(*response));
+    auto table = ReadCsvResponse(response, columnTypes, streaming);
+    (void)response->Close();   // Stops the download if parsing gave up early
+    return table;
+}
+
+// Column name -> QuestDB type name, from table_columns()
+arrow::Result<std::map<std::string, std::string>> FetchColumnTypes(const ConnectionOptions& options,
+                                                                   const std::string& tableName) {
+    std::string literal;
+    for (char ch : tableName) {
+        literal.push_back(ch);
+        if (ch == '\'') {
+            literal.push_back(ch);
+        }
+    }
+    ARROW_ASSIGN_OR_RAISE(auto response, OpenCsvExport(options,
+        "SELECT \"column\", \"type\" FROM table_columns('" + literal + "')"));
+    ARROW_RETURN_NOT_OK(CheckCsvResponse(*response));
+    ARROW_ASSIGN_OR_RAISE(std::string body, response->ReadRemaining(1 << 20));
+    ARROW_RETURN_NOT_OK(response->TransferStatus());
+
+    std::map<std::string, std::string> types;
+    std::istringstream lines(body);
+    std::string line;
+    bool header = true;
+    while (std::getline(lines, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (header || line.empty()) {
+            header = false;
             continue;
         }
-        if (ch == ',' && !in_quotes) {
-            cols.push_back(current);
-            current.clear();
-            continue;
+        auto cols = SplitCsvLine(line);
+        if (cols.size() >= 2) {
+            types[cols[0]] = cols[1];
         }
-        current.push_back(ch);
     }
-    cols.push_back(current);
-    return cols;
+    return types;
 }
 
 } // namespace
@@ -329,6 +309,12 @@ DataFrameGateway::DataFrameGateway(ConnectionOptions options)
     if (std::string rest = GetEnvOrEmpty("STAGE1_QUESTDB_REST"); !rest.empty()) {
         m_options.rest_url = rest;
     }
+    if (std::string connections = GetEnvOrEmpty("STAGE1_QUESTDB_ILP_CONNECTIONS"); !connections.empty()) {
+        try {
+            m_options.ilp_connections = std::clamp(std::stoi(connections), 1, 16);
+        } catch (...) {
+        }
+    }
     if (std::string connect_timeout = GetEnvOrEmpty("STAGE1_QUESTDB_CONNECT_TIMEOUT_MS"); !connect_timeout.empty()) {
         try {
             m_options.connect_timeout_ms = std::max<long>(1000, std::stol(connect_timeout));
@@ -365,7 +351,6 @@ bool DataFrameGateway::Export(const chronosflow::AnalyticsDataFrame& dataframe,
         return false;
     }
 
-    const auto sanitizedMeasurement = spec.measurement.empty() ? "measurement" : spec.measurement;
     int64_t rowsSerialized = 0;
 
     auto schema = table->schema();
@@ -376,10 +361,6 @@ bool DataFrameGateway::Export(const chronosflow::AnalyticsDataFrame& dataframe,
         return false;
     }
 
-    // Build ILP payload
-    std::ostringstream lines;
-    lines.setf(std::ios::fixed, std::ios::floatfield);
-
     std::string timestampColumnName = DetectTimestampColumn(schema, spec.timestamp_column);
     if (timestampColumnName.empty()) {
         if (error) {
@@ -387,258 +368,76 @@ bool DataFrameGateway::Export(const chronosflow::AnalyticsDataFrame& dataframe,
         }
         return false;
     }
-    int timestampColumnIndex = schema->GetFieldIndex(timestampColumnName);
-    if (timestampColumnIndex < 0) {
+    if (schema->GetFieldIndex(timestampColumnName) < 0) {
         if (error) {
             *error = "Timestamp column '" + timestampColumnName + "' not found.";
         }
         return false;
     }
-    auto timestampColumn = table->column(timestampColumnIndex);
-    if (!timestampColumn) {
-        if (error) {
-            *error = "Timestamp column '" + timestampColumnName + "' is unavailable.";
-        }
+
+    // Bad timestamps fail the export before anything is sent
+    IlpEncoder encoder(table, spec, timestampColumnName);
+    if (!encoder.CheckTimestamps(error)) {
         return false;
     }
 
-    const auto measurementEscaped = EscapeIdentifier(sanitizedMeasurement);
-    const auto staticTagSuffix = BuildStaticTagSuffix(spec.static_tags);
-
-    struct DynamicTagColumn {
-        int index = -1;
-        std::shared_ptr<arrow::ChunkedArray> data;
-        std::string name;
-    };
-    std::vector<DynamicTagColumn> dynamicTags;
-    std::vector<bool> skipColumn(numColumns, false);
-    if (timestampColumnIndex >= 0 && timestampColumnIndex < numColumns) {
-        skipColumn[timestampColumnIndex] = true;
-    }
-    int timestampFieldColumnIndex = -1;
-    if (spec.emit_timestamp_field && !spec.timestamp_field_name.empty()) {
-        timestampFieldColumnIndex = schema->GetFieldIndex(spec.timestamp_field_name);
-        if (timestampFieldColumnIndex >= 0 && timestampFieldColumnIndex < numColumns) {
-            skipColumn[timestampFieldColumnIndex] = true;
-        }
-    }
-    for (const auto& tagName : spec.tag_columns) {
-        int idx = schema->GetFieldIndex(tagName);
-        if (idx < 0 || idx >= numColumns) {
-            continue;
-        }
-        DynamicTagColumn column;
-        column.index = idx;
-        column.data = table->column(idx);
-        column.name = tagName;
-        dynamicTags.push_back(std::move(column));
-        skipColumn[idx] = true;
-    }
-
-    for (int64_t row = 0; row < numRows; ++row) {
-        std::ostringstream fields;
-        int fieldCount = 0;
-        for (int col = 0; col < numColumns; ++col) {
-            if ((col == timestampColumnIndex) || (col >= 0 && col < numColumns && skipColumn[col])) {
-                continue;
-            }
-
-            auto columnData = table->column(col);
-            auto scalarResult = columnData->GetScalar(row);
-            if (!scalarResult.ok()) {
-                continue;
-            }
-            auto scalar = scalarResult.ValueOrDie();
-            if (!scalar || !scalar->is_valid) {
-                continue;
-            }
-
-            const auto& field = schema->field(col);
-            std::string fieldValue;
-            switch (field->type()->id()) {
-                case arrow::Type::BOOL: {
-                    auto boolScalar = std::static_pointer_cast<arrow::BooleanScalar>(scalar);
-                    fieldValue = boolScalar->value ? "true" : "false";
-                    break;
-                }
-                case arrow::Type::FLOAT:
-                case arrow::Type::DOUBLE: {
-                    double numeric = (field->type()->id() == arrow::Type::FLOAT)
-                        ? static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value)
-                        : std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value;
-                    if (!std::isfinite(numeric)) continue;
-                    std::ostringstream valueStream;
-                    valueStream << std::setprecision(std::numeric_limits<double>::digits10 + 1) << numeric;
-                    fieldValue = valueStream.str();
-                    break;
-                }
-                case arrow::Type::INT8:
-                case arrow::Type::INT16:
-                case arrow::Type::INT32:
-                case arrow::Type::INT64:
-                case arrow::Type::UINT8:
-                case arrow::Type::UINT16:
-                case arrow::Type::UINT32:
-                case arrow::Type::UINT64: {
-                    fieldValue = scalar->ToString();
-                    if (fieldValue.empty()) continue;
-                    fieldValue.push_back('i');
-                    break;
-                }
-                case arrow::Type::STRING:
-                case arrow::Type::LARGE_STRING: {
-                    fieldValue = EscapeStringValue(scalar->ToString());
-                    break;
-                }
-                default: {
-                    std::string asString = scalar->ToString();
-                    if (asString.empty()) continue;
-                    fieldValue = EscapeStringValue(asString);
-                    break;
-                }
-            }
-
-            if (fieldValue.empty()) {
-                continue;
-            }
-
-            if (fieldCount > 0) {
-                fields << ',';
-            }
-            fields << EscapeIdentifier(field->name()) << '=' << fieldValue;
-            ++fieldCount;
-        }
-
-        std::ostringstream measurementWithTags;
-        measurementWithTags << measurementEscaped << staticTagSuffix;
-        for (const auto& tagColumn : dynamicTags) {
-            if (!tagColumn.data) {
-                continue;
-            }
-            auto scalarResult = tagColumn.data->GetScalar(row);
-            if (!scalarResult.ok()) {
-                continue;
-            }
-            auto scalar = scalarResult.ValueOrDie();
-            if (!scalar || !scalar->is_valid) {
-                continue;
-            }
-            measurementWithTags << ',' << EscapeIdentifier(tagColumn.name)
-                                << '=' << EscapeTagValue(scalar->ToString());
-        }
-
-        auto tsScalarResult = timestampColumn->GetScalar(row);
-        if (!tsScalarResult.ok()) {
-            if (error) {
-                *error = "Failed to read timestamp for row " + std::to_string(row) + ": "
-                    + tsScalarResult.status().ToString();
-            }
-            return false;
-        }
-        auto tsScalar = tsScalarResult.ValueOrDie();
-        auto timestampOpt = ScalarToMillis(tsScalar, spec.coerce_seconds_to_millis);
-        if (!timestampOpt || *timestampOpt == 0) {
-            if (error) {
-                *error = "Row " + std::to_string(row) + " is missing a valid timestamp in column '"
-                    + timestampColumnName + "'.";
-            }
-            return false;
-        }
-        int64_t timestampMs = *timestampOpt;
-
-        if (spec.emit_timestamp_field && !spec.timestamp_field_name.empty()) {
-            if (fieldCount > 0) {
-                fields << ',';
-            }
-            fields << EscapeIdentifier(spec.timestamp_field_name) << '='
-                   << timestampMs << 'i';
-            ++fieldCount;
-        }
-
-        if (fieldCount == 0) {
-            continue;
-        }
+    IlpSenderOptions senderOptions;
+    senderOptions.host = m_options.ilp_host;
+    senderOptions.port = m_options.ilp_port;
+    senderOptions.connections = m_options.ilp_connections;
+    senderOptions.queue_depth = m_options.ilp_queue_depth;
+    senderOptions.connect_timeout_ms = m_options.connect_timeout_ms;
+    senderOptions.request_timeout_ms = m_options.request_timeout_ms;
+    senderOptions.send_retry_window_ms = m_options.send_retry_window_ms;
 
-        const int64_t timestampNs = timestampMs * 1000000LL;
-        lines << measurementWithTags.str() << ' ' << fields.str() << ' ' << timestampNs << '\n';
-        ++rowsSerialized;
-    }
-
-    const std::string payload = lines.str();
-    if (rowsSerialized == 0 || payload.empty()) {
-        if (error) *error = "Nothing to export.";
+    IlpSender sender(senderOptions);
+    if (!sender.Open(error)) {
         return false;
     }
 
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        if (error) *error = "Failed to initialize CURL.";
+    // Serializer threads fill ~ilp_buffer_bytes buffers while the sender
+    // drains them. QuestDB partitions tables by day, so buffers are sharded
+    // by measurement and the UTC day of their first row.
+    const std::string shardPrefix = (spec.measurement.empty() ? std::string("measurement") : spec.measurement) + '/';
+    const int64_t rowsPerBlock = encoder.RowsForBlockBytes(m_options.ilp_buffer_bytes);
+    const int serializerThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const size_t window = m_options.ilp_queue_depth * static_cast<size_t>(std::max(1, m_options.ilp_connections));
+
+    std::string encodeError;
+    const bool encoded = encoder.EncodeOrdered(rowsPerBlock, serializerThreads, window,
+        [&](IlpBlock&& block) {
+            IlpBuffer buffer;
+            buffer.rows = block.rows;
+            buffer.shard_key = shardPrefix + std::to_string(block.first_timestamp_ms / kMillisPerDay);
+            buffer.data = std::move(block.data);
+            return sender.Submit(std::move(buffer));
+        },
+        &rowsSerialized, &encodeError);
+
+    IlpSendStats stats;
+    std::string sendError;
+    if (!sender.Close(&stats, &sendError)) {
+        if (error) *error = sendError;
         return false;
     }
-
-    std::ostringstream url;
-    url << "telnet://" << m_options.ilp_host << ':' << m_options.ilp_port;
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.str().c_str());
-    curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
-    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, m_options.connect_timeout_ms);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, m_options.connect_timeout_ms + m_options.request_timeout_ms);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        if (error) {
-            *error = std::string("QuestDB connection failed: ") + curl_easy_strerror(res);
-        }
-        curl_easy_cleanup(curl);
+    if (!encoded) {
+        if (error) *error = encodeError.empty() ? "ILP encoding stopped early." : encodeError;
         return false;
     }
-
-    const char* buffer = payload.c_str();
-    size_t total = payload.size();
-    size_t sentTotal = 0;
-    const auto retryBudget = std::chrono::milliseconds(m_options.send_retry_window_ms);
-    auto deadline = std::chrono::steady_clock::now() + retryBudget;
-
-    while (sentTotal < total) {
-        size_t sent = 0;
-        res = curl_easy_send(curl, buffer + sentTotal, total - sentTotal, &sent);
-        if (res == CURLE_AGAIN) {
-            if (std::chrono::steady_clock::now() > deadline) {
-                if (error) {
-                    *error = "QuestDB send timed out.";
-                }
-                curl_easy_cleanup(curl);
-                return false;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            continue;
-        }
-        if (res != CURLE_OK) {
-            if (error) {
-                *error = std::string("QuestDB send failed: ") + curl_easy_strerror(res);
-            }
-            curl_easy_cleanup(curl);
-            return false;
-        }
-        if (sent == 0) {
-            if (std::chrono::steady_clock::now() > deadline) {
-                if (error) {
-                    *error = "QuestDB send stalled.";
-                }
-                curl_easy_cleanup(curl);
-                return false;
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            continue;
-        }
-        sentTotal += sent;
-        deadline = std::chrono::steady_clock::now() + retryBudget;
+    if (rowsSerialized == 0) {
+        if (error) *error = "Nothing to export.";
+        return false;
     }
 
-    curl_easy_cleanup(curl);
     if (result) {
         result->rows_serialized = rowsSerialized;
+        result->bytes_sent = stats.bytes;
+        result->seconds = stats.seconds;
+        result->connections = stats.connections;
+        if (stats.seconds > 0.0) {
+            result->rows_per_second = static_cast<double>(stats.rows) / stats.seconds;
+            result->megabytes_per_second = static_cast<double>(stats.bytes) / (1024.0 * 1024.0) / stats.seconds;
+        }
     }
     return true;
 }
@@ -653,151 +452,40 @@ bool DataFrameGateway::Export(const chronosflow::AnalyticsDataFrame& dataframe,
 }
 
 arrow::Result<chronosflow::AnalyticsDataFrame> DataFrameGateway::Import(const ImportSpec& spec) const {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        return arrow::Status::IOError("Failed to initialize CURL for QuestDB fetch.");
-    }
-
     std::string query;
     if (!spec.sql_query.empty()) {
         query = spec.sql_query;
     } else if (!spec.table_name.empty()) {
         query = "SELECT * FROM \"" + spec.table_name + "\"";
     } else {
-        curl_easy_cleanup(curl);
         return arrow::Status::Invalid("ImportSpec requires either table_name or sql_query.");
     }
 
-    std::unique_ptr<char, decltype(&curl_free)> encodedQuery(
-        curl_easy_escape(curl, query.c_str(), static_cast<int>(query.size())), &curl_free);
-    if (!encodedQuery) {
-        curl_easy_cleanup(curl);
-        return arrow::Status::IOError("Failed to encode QuestDB query.");
-    }
-
-    std::string url = m_options.rest_url + "/exp?query=";
-    url += encodedQuery.get();
-    url += "&fmt=csv";
-
-    auto tempDir = std::filesystem::temp_directory_path();
-    auto uniqueSuffix = std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
-    std::filesystem::path tempFile = tempDir / ("questdb_import_" + uniqueSuffix + ".csv");
-
-    std::ofstream out(tempFile, std::ios::binary);
-    if (!out) {
-        curl_easy_cleanup(curl);
-        return arrow::Status::IOError("Failed to create temp file for QuestDB import.");
-    }
-
-    CurlFileContext ctx;
-    ctx.stream = &out;
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, CurlWriteToFile);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &ctx);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, m_options.connect_timeout_ms);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, m_options.rest_timeout_ms);
-
-    CURLcode res = curl_easy_perform(curl);
-    long httpCode = 0;
-    if (res == CURLE_OK) {
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    }
-    curl_easy_cleanup(curl);
-    out.close();
-
-    auto cleanupTemp = [&]() {
-        std::error_code ec;
-        std::filesystem::remove(tempFile, ec);
-    };
-
-    if (ctx.errored) {
-        cleanupTemp();
-        return arrow::Status::IOError("QuestDB fetch failed: could not write response.");
-    }
-    if (res != CURLE_OK) {
-        cleanupTemp();
-        return arrow::Status::IOError(std::string("QuestDB fetch failed: ") + curl_easy_strerror(res));
-    }
-
-    std::error_code sizeEc;
-    auto fileSizeResult = std::filesystem::file_size(tempFile, sizeEc);
-    if (sizeEc || fileSizeResult == 0) {
-        cleanupTemp();
-        return arrow::Status::IOError("QuestDB returned empty response.");
-    }
-
-    auto ltrim = [](const std::string& text) -> std::string_view {
-        size_t start = 0;
-        while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start]))) {
-            ++start;
-        }
-        return std::string_view(text).substr(start);
-    };
-
-    auto ExtractJsonMessage = [](std::string_view json) -> std::string {
-        size_t errorPos = json.find("\"error\"");
-        if (errorPos == std::string_view::npos) {
-            return std::string(json.substr(0, std::min<size_t>(512, json.size())));
-        }
-        size_t colon = json.find(':', errorPos);
-        if (colon == std::string_view::npos) {
-            return std::string(json.substr(0, std::min<size_t>(512, json.size())));
-        }
-        size_t start = colon + 1;
-        while (start < json.size() && std::isspace(static_cast<unsigned char>(json[start]))) {
-            ++start;
-        }
-        bool quoted = start < json.size() && json[start] == '"';
-        if (quoted) {
-            ++start;
-        }
-        size_t end = start;
-        while (end < json.size()) {
-            char ch = json[end];
-            if ((quoted && ch == '"') || (!quoted && (ch == '\r' || ch == '\n' || ch == ',' || ch == '}'))) {
-                break;
-            }
-            ++end;
-        }
-        if (end <= start) {
-            return std::string(json.substr(0, std::min<size_t>(512, json.size())));
+    // Pinned types skip inference and keep every block of a column on the
+    // same type. The schema lookup is only an optimisation.
+    std::map<std::string, std::string> questdbTypes = spec.column_types;
+    if (questdbTypes.empty() && spec.sql_query.empty() && spec.pin_table_schema) {
+        auto fetched = FetchColumnTypes(m_options, spec.table_name);
+        if (fetched.ok()) {
+            questdbTypes = std::move(fetched).ValueOrDie();
         }
-        return std::string(json.substr(start, end - start));
-    };
-
-    std::string peek = ctx.sniff.empty() ? ReadFilePrefix(tempFile, 4096) : ctx.sniff;
-    std::string_view trimmed = ltrim(peek);
-    if (httpCode >= 400 || (!trimmed.empty() && trimmed.front() == '{')) {
-        std::string message;
-        if (httpCode >= 400) {
-            message = "QuestDB HTTP " + std::to_string(httpCode);
-        }
-        if (!trimmed.empty() && trimmed.front() == '{') {
-            std::string jsonMsg = ExtractJsonMessage(trimmed);
-            if (jsonMsg.rfind("QuestDB error:", 0) != 0) {
-                jsonMsg = "QuestDB returned JSON instead of CSV: " + jsonMsg;
-            }
-            if (!message.empty()) {
-                message += " - ";
-            }
-            message += jsonMsg;
-        }
-        if (message.empty()) {
-            message = "QuestDB returned error response.";
+    }
+    std::unordered_map<std::string, std::shared_ptr<arrow::DataType>> columnTypes;
+    for (const auto& [name, type] : questdbTypes) {
+        if (auto arrowType = ArrowTypeForQuestDbType(type)) {
+            columnTypes[name] = std::move(arrowType);
         }
-        cleanupTemp();
-        return arrow::Status::IOError(message);
     }
 
-    chronosflow::TSSBReadOptions options;
-    options.auto_detect_delimiter = true;
-    options.has_header = true;
-
-    auto dataframeResult = chronosflow::DataFrameIO::read_tssb(tempFile.string(), options);
-    cleanupTemp();
-    return dataframeResult;
+    auto table = FetchCsvTable(m_options, query, columnTypes, /*streaming=*/true);
+    if (!table.ok() && table.status().IsInvalid()) {
+        // The streaming reader fixes an inferred column type from the first
+        // block; a column that widens later (e.g. empty at first) needs the
+        // whole-table reader, which re-converts earlier blocks
+        table = FetchCsvTable(m_options, query, columnTypes, /*streaming=*/false);
+    }
+    ARROW_RETURN_NOT_OK(table.status());
+    return chronosflow::AnalyticsDataFrame(std::move(table).ValueOrDie());
 }
 
 arrow::Result<chronosflow::AnalyticsDataFrame> DataFrameGateway::Import(const std::string& table_name) const {
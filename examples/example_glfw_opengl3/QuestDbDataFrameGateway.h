@@ -20,11 +20,20 @@ struct ConnectionOptions {
     long connect_timeout_ms = 5000;
     long request_timeout_ms = 15000;
     long send_retry_window_ms = 10000;
-    long rest_timeout_ms = 60000;
+    long rest_timeout_ms = 60000;       // Longest silence while a REST response streams in
+    int ilp_connections = 2;            // Parallel ILP sockets
+    size_t ilp_buffer_bytes = 1 << 20;  // Target size of one send buffer
+    size_t ilp_queue_depth = 4;         // Buffers queued per socket
+    size_t import_buffer_bytes = 4 << 20; // Download read-ahead while parsing
 };
 
 struct ExportResult {
     int64_t rows_serialized = 0;
+    int64_t bytes_sent = 0;
+    double seconds = 0.0;               // Connect to last byte sent
+    double rows_per_second = 0.0;
+    double megabytes_per_second = 0.0;
+    int connections = 0;
 };
 
 struct ExportSpec {
@@ -40,6 +49,13 @@ struct ExportSpec {
 struct ImportSpec {
     std::string table_name;
     std::string sql_query;
+
+    // QuestDB type names (e.g. "DOUBLE", "SYMBOL") for columns whose CSV
+    // conversion should be pinned rather than inferred
+    std::map<std::string, std::string> column_types;
+
+    // Table imports without column_types look them up in table_columns()
+    bool pin_table_schema = true;
 };
 
 class DataFrameGateway {
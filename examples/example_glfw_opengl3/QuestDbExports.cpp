@@ -4,145 +4,17 @@
 
 #include <cmath>
 #include <cstdint>
-#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "QuestDbDataFrameGateway.h"
+#include "QuestDbPredictionCodec.h"
 #include "chronosflow.h"
 
 namespace questdb {
 namespace {
 
-arrow::Status AppendMaybeNull(arrow::DoubleBuilder& builder, double value) {
-    if (std::isfinite(value)) {
-        return builder.Append(value);
-    }
-    return builder.AppendNull();
-}
-
-arrow::Result<chronosflow::AnalyticsDataFrame> BuildWalkforwardDataFrame(
-    const simulation::SimulationRun& run,
-    const Stage1MetadataWriter::WalkforwardRecord& record) {
-    if (run.all_test_predictions.empty() || run.all_test_timestamps.empty()) {
-        return arrow::Status::Invalid("Simulation run contains no predictions to export.");
-    }
-
-    const int totalPreds = static_cast<int>(run.all_test_predictions.size());
-
-    arrow::Int64Builder timestamp_builder;
-    arrow::Int64Builder bar_index_builder;
-    arrow::Int32Builder fold_builder;
-    arrow::DoubleBuilder prediction_builder;
-    arrow::DoubleBuilder actual_builder;
-    arrow::DoubleBuilder long_threshold_builder;
-    arrow::DoubleBuilder short_threshold_builder;
-    arrow::DoubleBuilder roc_threshold_builder;
-    arrow::DoubleBuilder short_entry_threshold_builder;
-    arrow::DoubleBuilder fold_score_builder;
-    arrow::DoubleBuilder fold_profit_factor_builder;
-
-    ARROW_RETURN_NOT_OK(timestamp_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(bar_index_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(fold_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(prediction_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(actual_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(long_threshold_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(short_threshold_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(roc_threshold_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(short_entry_threshold_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(fold_score_builder.Reserve(totalPreds));
-    ARROW_RETURN_NOT_OK(fold_profit_factor_builder.Reserve(totalPreds));
-
-    const auto offsets = run.fold_prediction_offsets;
-    size_t appended_rows = 0;
-
-    for (size_t foldIndex = 0; foldIndex < run.foldResults.size(); ++foldIndex) {
-        if (foldIndex >= offsets.size()) {
-            break;
-        }
-        const auto& fold = run.foldResults[foldIndex];
-
-        const int start = offsets[foldIndex];
-        const int end = (foldIndex + 1 < offsets.size()) ? offsets[foldIndex + 1] : totalPreds;
-
-        for (int idx = start; idx < end && idx < totalPreds; ++idx) {
-            if (idx >= static_cast<int>(run.all_test_timestamps.size())) {
-                break;
-            }
-
-            const int64_t timestampMs = run.all_test_timestamps[idx];
-            if (timestampMs <= 0) {
-                continue;
-            }
-
-            const double prediction = run.all_test_predictions[idx];
-            const double actual = (idx < static_cast<int>(run.all_test_actuals.size()))
-                                      ? run.all_test_actuals[idx]
-                                      : std::numeric_limits<double>::quiet_NaN();
-            if (!std::isfinite(prediction) || !std::isfinite(actual)) {
-                continue;
-            }
-
-            ARROW_RETURN_NOT_OK(timestamp_builder.Append(timestampMs));
-            ARROW_RETURN_NOT_OK(bar_index_builder.Append(static_cast<int64_t>(fold.test_start + (idx - start))));
-            ARROW_RETURN_NOT_OK(fold_builder.Append(fold.fold_number));
-            ARROW_RETURN_NOT_OK(prediction_builder.Append(prediction));
-            ARROW_RETURN_NOT_OK(actual_builder.Append(actual));
-            ARROW_RETURN_NOT_OK(AppendMaybeNull(long_threshold_builder, fold.long_threshold_optimal));
-            ARROW_RETURN_NOT_OK(AppendMaybeNull(short_threshold_builder, fold.short_threshold_optimal));
-            ARROW_RETURN_NOT_OK(AppendMaybeNull(roc_threshold_builder, fold.prediction_threshold_original));
-            ARROW_RETURN_NOT_OK(AppendMaybeNull(short_entry_threshold_builder, fold.short_threshold_original));
-            ARROW_RETURN_NOT_OK(AppendMaybeNull(fold_score_builder, fold.best_score));
-            ARROW_RETURN_NOT_OK(AppendMaybeNull(fold_profit_factor_builder, fold.profit_factor_test));
-
-            ++appended_rows;
-        }
-    }
-
-    if (appended_rows == 0) {
-        return arrow::Status::Invalid("No valid prediction rows were available for export.");
-    }
-
-    std::vector<std::shared_ptr<arrow::Field>> fields = {
-        arrow::field("timestamp_unix", arrow::int64()),
-        arrow::field("bar_index", arrow::int64()),
-        arrow::field("fold_number", arrow::int32()),
-        arrow::field("prediction", arrow::float64()),
-        arrow::field("target_value", arrow::float64()),
-        arrow::field("long_threshold", arrow::float64()),
-        arrow::field("short_threshold", arrow::float64()),
-        arrow::field("roc_threshold", arrow::float64()),
-        arrow::field("short_entry_threshold", arrow::float64()),
-        arrow::field("fold_score", arrow::float64()),
-        arrow::field("fold_profit_factor", arrow::float64())
-    };
-
-    std::vector<std::shared_ptr<arrow::Array>> arrays;
-    ARROW_RETURN_NOT_OK(timestamp_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(bar_index_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(fold_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(prediction_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(actual_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(long_threshold_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(short_threshold_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(roc_threshold_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(short_entry_threshold_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(fold_score_builder.Finish(&arrays.emplace_back()));
-    ARROW_RETURN_NOT_OK(fold_profit_factor_builder.Finish(&arrays.emplace_back()));
-
-    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-    columns.reserve(arrays.size());
-    for (const auto& array : arrays) {
-        columns.push_back(std::make_shared<arrow::ChunkedArray>(array));
-    }
-
-    auto table = arrow::Table::Make(arrow::schema(fields), columns);
-    chronosflow::AnalyticsDataFrame dataframe(table);
-    return dataframe;
-}
-
 arrow::Status AppendTimestampOrNull(arrow::Int64Builder& builder, double value) {
     if (value > 0) {
         return builder.Append(static_cast<int64_t>(std::llround(value)));
@@ -254,10 +126,10 @@ bool ExportWalkforwardPredictions(const simulation::SimulationRun& run,
         return true;
     }
 
-    auto dataframeResult = BuildWalkforwardDataFrame(run, record);
-    if (!dataframeResult.ok()) {
+    auto tableResult = EncodeWalkforwardPredictions(run);
+    if (!tableResult.ok()) {
         if (error) {
-            *error = dataframeResult.status().ToString();
+            *error = tableResult.status().ToString();
         }
         return false;
     }
@@ -269,7 +141,7 @@ bool ExportWalkforwardPredictions(const simulation::SimulationRun& run,
         : run.prediction_measurement;
 
     ExportResult exportResult;
-    if (!gateway.Export(dataframeResult.ValueOrDie(), spec, &exportResult, error)) {
+    if (!gateway.Export(chronosflow::AnalyticsDataFrame(tableResult.MoveValueUnsafe()), spec, &exportResult, error)) {
         if (error && error->empty()) {
             *error = "QuestDB export failed for walkforward predictions.";
         }
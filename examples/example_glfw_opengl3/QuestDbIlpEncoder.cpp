@@ -0,0 +1,732 @@
+#include "QuestDbIlpEncoder.h"
+
+#include <arrow/array.h>
+#include <arrow/chunked_array.h>
+#include <arrow/scalar.h>
+#include <arrow/table.h>
+#include <arrow/type.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <execution>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <string_view>
+#include <thread>
+
+namespace questdb {
+namespace {
+
+constexpr int kDoublePrecision = std::numeric_limits<double>::digits10 + 1;
+
+std::string EscapeIdentifier(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char ch : value) {
+        if (ch == ' ' || ch == ',' || ch == '=') {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(ch);
+    }
+    return escaped;
+}
+
+void AppendStringValue(std::string& out, std::string_view value) {
+    out.push_back('"');
+    for (char ch : value) {
+        if (ch == '"' || ch == '\\') {
+            out.push_back('\\');
+        }
+        out.push_back(ch);
+    }
+    out.push_back('"');
+}
+
+void AppendTagValue(std::string& out, std::string_view value) {
+    if (value.empty()) {
+        out.append("none");
+        return;
+    }
+    for (char ch : value) {
+        if (ch == ' ' || ch == ',' || ch == '=' || ch == '\t') {
+            out.push_back('\\');
+        }
+        out.push_back(ch);
+    }
+}
+
+std::string BuildStaticTagSuffix(const std::map<std::string, std::string>& tags) {
+    std::string suffix;
+    for (const auto& kv : tags) {
+        if (kv.first.empty()) {
+            continue;
+        }
+        suffix.push_back(',');
+        suffix += EscapeIdentifier(kv.first);
+        suffix.push_back('=');
+        AppendTagValue(suffix, kv.second);
+    }
+    return suffix;
+}
+
+template <typename T>
+void AppendInteger(std::string& out, T value) {
+    char buffer[24];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, ptr);
+}
+
+// Same digits as an ostream with setprecision(16), i.e. %.16g
+void AppendDouble(std::string& out, double value) {
+    char buffer[32];
+    auto [ptr, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value,
+                                   std::chars_format::general, kDoublePrecision);
+    out.append(buffer, ptr);
+}
+
+time_t ToUtcTimeT(std::tm* tm) {
+#if defined(_WIN32)
+    return _mkgmtime(tm);
+#else
+    return timegm(tm);
+#endif
+}
+
+std::optional<int64_t> ParseIsoToMillis(const std::string& text) {
+    if (text.size() < 19) {
+        return std::nullopt;
+    }
+    auto ParseInt = [&](size_t pos, size_t len) -> std::optional<int> {
+        if (pos + len > text.size()) return std::nullopt;
+        int value = 0;
+        for (size_t i = 0; i < len; ++i) {
+            char ch = text[pos + i];
+            if (ch < '0' || ch > '9') {
+                return std::nullopt;
+            }
+            value = value * 10 + (ch - '0');
+        }
+        return value;
+    };
+
+    auto year = ParseInt(0, 4);
+    auto month = ParseInt(5, 2);
+    auto day = ParseInt(8, 2);
+    auto hour = ParseInt(11, 2);
+    auto minute = ParseInt(14, 2);
+    auto second = ParseInt(17, 2);
+    if (!year || !month || !day || !hour || !minute || !second) {
+        return std::nullopt;
+    }
+
+    int64_t fractionMillis = 0;
+    auto dotPos = text.find('.', 19);
+    if (dotPos != std::string::npos) {
+        size_t fracStart = dotPos + 1;
+        size_t fracEnd = fracStart;
+        while (fracEnd < text.size() && std::isdigit(static_cast<unsigned char>(text[fracEnd]))) {
+            ++fracEnd;
+        }
+        std::string fraction = text.substr(fracStart, fracEnd - fracStart);
+        while (fraction.size() < 3) fraction.push_back('0');
+        if (fraction.size() > 3) fraction.resize(3);
+        fractionMillis = std::stoi(fraction);
+    }
+
+    std::tm tm = {};
+    tm.tm_year = *year - 1900;
+    tm.tm_mon = *month - 1;
+    tm.tm_mday = *day;
+    tm.tm_hour = *hour;
+    tm.tm_min = *minute;
+    tm.tm_sec = *second;
+    time_t seconds = ToUtcTimeT(&tm);
+    if (seconds == static_cast<time_t>(-1)) {
+        return std::nullopt;
+    }
+    return static_cast<int64_t>(seconds) * 1000LL + fractionMillis;
+}
+
+std::optional<int64_t> ScalarToMillis(const std::shared_ptr<arrow::Scalar>& scalar,
+                                      bool coerce_seconds_to_millis) {
+    if (!scalar || !scalar->is_valid) {
+        return std::nullopt;
+    }
+    switch (scalar->type->id()) {
+        case arrow::Type::INT64: {
+            int64_t value = std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value;
+            if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
+                value *= 1000;
+            }
+            return value;
+        }
+        case arrow::Type::INT32: {
+            int64_t value = std::static_pointer_cast<arrow::Int32Scalar>(scalar)->value;
+            if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
+                value *= 1000;
+            }
+            return value;
+        }
+        case arrow::Type::DOUBLE:
+        case arrow::Type::FLOAT: {
+            double numeric = (scalar->type->id() == arrow::Type::DOUBLE)
+                ? std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value
+                : static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
+            int64_t value = static_cast<int64_t>(std::llround(numeric));
+            if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
+                value *= 1000;
+            }
+            return value;
+        }
+        case arrow::Type::STRING:
+        case arrow::Type::LARGE_STRING: {
+            auto text = scalar->ToString();
+            if (text.empty()) {
+                return std::nullopt;
+            }
+            bool isNumeric = std::all_of(text.begin(), text.end(), [](unsigned char ch) {
+                return std::isdigit(ch) || ch == '-' || ch == '+';
+            });
+            if (isNumeric) {
+                try {
+                    int64_t value = std::stoll(text);
+                    if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
+                        value *= 1000;
+                    }
+                    return value;
+                } catch (...) {
+                }
+            }
+            return ParseIsoToMillis(text);
+        }
+        case arrow::Type::TIMESTAMP: {
+            auto tsScalar = std::static_pointer_cast<arrow::TimestampScalar>(scalar);
+            int64_t value = tsScalar->value;
+            auto type = std::static_pointer_cast<arrow::TimestampType>(tsScalar->type);
+            switch (type->unit()) {
+                case arrow::TimeUnit::SECOND: return value * 1000;
+                case arrow::TimeUnit::MILLI: return value;
+                case arrow::TimeUnit::MICRO: return value / 1000;
+                case arrow::TimeUnit::NANO: return value / 1000000;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return std::nullopt;
+}
+
+int64_t CoerceToMillis(int64_t value, bool coerce_seconds_to_millis) {
+    if (coerce_seconds_to_millis && std::llabs(value) < 4'000'000'000LL) {
+        value *= 1000;
+    }
+    return value;
+}
+
+// Fast path of ScalarToMillis for the common physical types
+std::optional<int64_t> CellToMillis(const arrow::Array& array, int64_t index, IlpCellKind kind,
+                                    bool coerce_seconds_to_millis) {
+    if (array.IsNull(index)) {
+        return std::nullopt;
+    }
+    switch (kind) {
+        case IlpCellKind::Int64:
+            return CoerceToMillis(static_cast<const arrow::Int64Array&>(array).Value(index), coerce_seconds_to_millis);
+        case IlpCellKind::Int32:
+            return CoerceToMillis(static_cast<const arrow::Int32Array&>(array).Value(index), coerce_seconds_to_millis);
+        case IlpCellKind::Double:
+            return CoerceToMillis(static_cast<int64_t>(std::llround(static_cast<const arrow::DoubleArray&>(array).Value(index))),
+                                  coerce_seconds_to_millis);
+        case IlpCellKind::Float:
+            return CoerceToMillis(static_cast<int64_t>(std::llround(static_cast<double>(
+                                      static_cast<const arrow::FloatArray&>(array).Value(index)))),
+                                  coerce_seconds_to_millis);
+        case IlpCellKind::Timestamp: {
+            const int64_t value = static_cast<const arrow::TimestampArray&>(array).Value(index);
+            switch (static_cast<const arrow::TimestampType&>(*array.type()).unit()) {
+                case arrow::TimeUnit::SECOND: return value * 1000;
+                case arrow::TimeUnit::MILLI: return value;
+                case arrow::TimeUnit::MICRO: return value / 1000;
+                case arrow::TimeUnit::NANO: return value / 1000000;
+            }
+            return std::nullopt;
+        }
+        default: {
+            auto scalar = array.GetScalar(index);
+            if (!scalar.ok()) {
+                return std::nullopt;
+            }
+            return ScalarToMillis(scalar.ValueOrDie(), coerce_seconds_to_millis);
+        }
+    }
+}
+
+// Appends the ILP field value of one cell; false when the cell is omitted
+bool AppendFieldValue(std::string& out, const arrow::Array& array, int64_t index, IlpCellKind kind) {
+    switch (kind) {
+        case IlpCellKind::Bool:
+            out.append(static_cast<const arrow::BooleanArray&>(array).Value(index) ? "true" : "false");
+            return true;
+        case IlpCellKind::Float:
+        case IlpCellKind::Double: {
+            const double value = kind == IlpCellKind::Float
+                ? static_cast<double>(static_cast<const arrow::FloatArray&>(array).Value(index))
+                : static_cast<const arrow::DoubleArray&>(array).Value(index);
+            if (!std::isfinite(value)) {
+                return false;
+            }
+            AppendDouble(out, value);
+            return true;
+        }
+        case IlpCellKind::Int8:
+            AppendInteger(out, static_cast<int64_t>(static_cast<const arrow::Int8Array&>(array).Value(index)));
+            break;
+        case IlpCellKind::Int16:
+            AppendInteger(out, static_cast<int64_t>(static_cast<const arrow::Int16Array&>(array).Value(index)));
+            break;
+        case IlpCellKind::Int32:
+            AppendInteger(out, static_cast<int64_t>(static_cast<const arrow::Int32Array&>(array).Value(index)));
+            break;
+        case IlpCellKind::Int64:
+            AppendInteger(out, static_cast<const arrow::Int64Array&>(array).Value(index));
+            break;
+        case IlpCellKind::UInt8:
+            AppendInteger(out, static_cast<uint64_t>(static_cast<const arrow::UInt8Array&>(array).Value(index)));
+            break;
+        case IlpCellKind::UInt16:
+            AppendInteger(out, static_cast<uint64_t>(static_cast<const arrow::UInt16Array&>(array).Value(index)));
+            break;
+        case IlpCellKind::UInt32:
+            AppendInteger(out, static_cast<uint64_t>(static_cast<const arrow::UInt32Array&>(array).Value(index)));
+            break;
+        case IlpCellKind::UInt64:
+            AppendInteger(out, static_cast<const arrow::UInt64Array&>(array).Value(index));
+            break;
+        case IlpCellKind::String:
+            AppendStringValue(out, static_cast<const arrow::StringArray&>(array).GetView(index));
+            return true;
+        case IlpCellKind::LargeString:
+            AppendStringValue(out, static_cast<const arrow::LargeStringArray&>(array).GetView(index));
+            return true;
+        case IlpCellKind::Timestamp:
+        case IlpCellKind::Other: {
+            auto scalar = array.GetScalar(index);
+            if (!scalar.ok() || !scalar.ValueOrDie()->is_valid) {
+                return false;
+            }
+            const std::string text = scalar.ValueOrDie()->ToString();
+            if (text.empty()) {
+                return false;
+            }
+            AppendStringValue(out, text);
+            return true;
+        }
+    }
+    out.push_back('i');
+    return true;
+}
+
+// Appends ",name=value" for one tag cell; false when the cell is omitted
+bool AppendTag(std::string& out, const std::string& prefix, const arrow::Array& array, int64_t index,
+               IlpCellKind kind) {
+    switch (kind) {
+        case IlpCellKind::String:
+            out += prefix;
+            AppendTagValue(out, static_cast<const arrow::StringArray&>(array).GetView(index));
+            return true;
+        case IlpCellKind::LargeString:
+            out += prefix;
+            AppendTagValue(out, static_cast<const arrow::LargeStringArray&>(array).GetView(index));
+            return true;
+        case IlpCellKind::Int32:
+            out += prefix;
+            AppendInteger(out, static_cast<const arrow::Int32Array&>(array).Value(index));
+            return true;
+        case IlpCellKind::Int64:
+            out += prefix;
+            AppendInteger(out, static_cast<const arrow::Int64Array&>(array).Value(index));
+            return true;
+        default: {
+            auto scalar = array.GetScalar(index);
+            if (!scalar.ok() || !scalar.ValueOrDie()->is_valid) {
+                return false;
+            }
+            out += prefix;
+            AppendTagValue(out, scalar.ValueOrDie()->ToString());
+            return true;
+        }
+    }
+}
+
+IlpCellKind KindOf(const arrow::DataType& type) {
+    switch (type.id()) {
+        case arrow::Type::BOOL: return IlpCellKind::Bool;
+        case arrow::Type::FLOAT: return IlpCellKind::Float;
+        case arrow::Type::DOUBLE: return IlpCellKind::Double;
+        case arrow::Type::INT8: return IlpCellKind::Int8;
+        case arrow::Type::INT16: return IlpCellKind::Int16;
+        case arrow::Type::INT32: return IlpCellKind::Int32;
+        case arrow::Type::INT64: return IlpCellKind::Int64;
+        case arrow::Type::UINT8: return IlpCellKind::UInt8;
+        case arrow::Type::UINT16: return IlpCellKind::UInt16;
+        case arrow::Type::UINT32: return IlpCellKind::UInt32;
+        case arrow::Type::UINT64: return IlpCellKind::UInt64;
+        case arrow::Type::STRING: return IlpCellKind::String;
+        case arrow::Type::LARGE_STRING: return IlpCellKind::LargeString;
+        case arrow::Type::TIMESTAMP: return IlpCellKind::Timestamp;
+        default: return IlpCellKind::Other;
+    }
+}
+
+// Row position inside a chunked column, advanced one row at a time
+struct ChunkCursor {
+    const arrow::ChunkedArray* data = nullptr;
+    int chunk = 0;
+    int64_t index = 0;
+    const arrow::Array* array = nullptr;
+
+    void Seek(const arrow::ChunkedArray& column, int64_t row) {
+        data = &column;
+        chunk = 0;
+        while (chunk < data->num_chunks() && row >= data->chunk(chunk)->length()) {
+            row -= data->chunk(chunk)->length();
+            ++chunk;
+        }
+        index = row;
+        array = chunk < data->num_chunks() ? data->chunk(chunk).get() : nullptr;
+    }
+
+    void Advance() {
+        if (++index < array->length()) {
+            return;
+        }
+        index = 0;
+        do {
+            ++chunk;
+        } while (chunk < data->num_chunks() && data->chunk(chunk)->length() == 0);
+        array = chunk < data->num_chunks() ? data->chunk(chunk).get() : nullptr;
+    }
+};
+
+} // namespace
+
+IlpEncoder::IlpEncoder(std::shared_ptr<arrow::Table> table,
+                       const ExportSpec& spec,
+                       const std::string& timestampColumn)
+    : m_table(std::move(table)),
+      m_timestampColumnName(timestampColumn),
+      m_coerceSecondsToMillis(spec.coerce_seconds_to_millis) {
+    const auto schema = m_table->schema();
+    const int numColumns = schema->num_fields();
+    std::vector<bool> skipColumn(numColumns, false);
+
+    const std::string measurement = spec.measurement.empty() ? "measurement" : spec.measurement;
+    m_linePrefix = EscapeIdentifier(measurement) + BuildStaticTagSuffix(spec.static_tags);
+
+    const int timestampIndex = schema->GetFieldIndex(timestampColumn);
+    if (timestampIndex >= 0) {
+        m_timestamp.data = m_table->column(timestampIndex);
+        m_timestamp.kind = KindOf(*schema->field(timestampIndex)->type());
+        skipColumn[timestampIndex] = true;
+    }
+
+    if (spec.emit_timestamp_field && !spec.timestamp_field_name.empty()) {
+        m_timestampFieldPrefix = EscapeIdentifier(spec.timestamp_field_name) + "=";
+        const int index = schema->GetFieldIndex(spec.timestamp_field_name);
+        if (index >= 0) {
+            skipColumn[index] = true;
+        }
+    }
+
+    for (const auto& tagName : spec.tag_columns) {
+        const int index = schema->GetFieldIndex(tagName);
+        if (index < 0) {
+            continue;
+        }
+        m_tags.push_back({m_table->column(index), KindOf(*schema->field(index)->type()),
+                          "," + EscapeIdentifier(tagName) + "="});
+        skipColumn[index] = true;
+    }
+
+    m_rowSizeHint = m_linePrefix.size() + m_timestampFieldPrefix.size() + 48;
+    for (int col = 0; col < numColumns; ++col) {
+        if (skipColumn[col]) {
+            continue;
+        }
+        const auto& field = schema->field(col);
+        m_fields.push_back({m_table->column(col), KindOf(*field->type()), EscapeIdentifier(field->name()) + "="});
+        m_rowSizeHint += m_fields.back().prefix.size() + 12;
+    }
+    for (const auto& tag : m_tags) {
+        m_rowSizeHint += tag.prefix.size() + 8;
+    }
+}
+
+bool IlpEncoder::EncodeRows(int64_t begin,
+                            int64_t end,
+                            std::string* out,
+                            int64_t* rowsSerialized,
+                            std::string* error,
+                            int64_t* firstTimestampMs) const {
+    if (!m_timestamp.data) {
+        if (error) *error = "Timestamp column '" + m_timestampColumnName + "' not found.";
+        return false;
+    }
+    end = std::min(end, m_table->num_rows());
+    if (begin >= end) {
+        return true;
+    }
+    out->reserve(out->size() + static_cast<size_t>(end - begin) * m_rowSizeHint);
+
+    ChunkCursor timestampCursor;
+    timestampCursor.Seek(*m_timestamp.data, begin);
+    std::vector<ChunkCursor> tagCursors(m_tags.size());
+    std::vector<ChunkCursor> fieldCursors(m_fields.size());
+    for (size_t i = 0; i < m_tags.size(); ++i) tagCursors[i].Seek(*m_tags[i].data, begin);
+    for (size_t i = 0; i < m_fields.size(); ++i) fieldCursors[i].Seek(*m_fields[i].data, begin);
+
+    int64_t serialized = 0;
+    for (int64_t row = begin; row < end; ++row) {
+        // Timestamps are checked first: a bad one fails the export even when
+        // the row itself would have been skipped for having no fields
+        auto timestampMs = CellToMillis(*timestampCursor.array, timestampCursor.index,
+                                        m_timestamp.kind, m_coerceSecondsToMillis);
+        if (!timestampMs || *timestampMs == 0) {
+            if (error) {
+                *error = "Row " + std::to_string(row) + " is missing a valid timestamp in column '"
+                    + m_timestampColumnName + "'.";
+            }
+            return false;
+        }
+
+        const size_t lineStart = out->size();
+        out->append(m_linePrefix);
+        for (size_t i = 0; i < m_tags.size(); ++i) {
+            const auto& cursor = tagCursors[i];
+            if (!cursor.array->IsNull(cursor.index)) {
+                AppendTag(*out, m_tags[i].prefix, *cursor.array, cursor.index, m_tags[i].kind);
+            }
+        }
+        out->push_back(' ');
+
+        int fieldCount = 0;
+        for (size_t i = 0; i < m_fields.size(); ++i) {
+            const auto& cursor = fieldCursors[i];
+            if (cursor.array->IsNull(cursor.index)) {
+                continue;
+            }
+            const size_t fieldStart = out->size();
+            if (fieldCount > 0) {
+                out->push_back(',');
+            }
+            out->append(m_fields[i].prefix);
+            if (AppendFieldValue(*out, *cursor.array, cursor.index, m_fields[i].kind)) {
+                ++fieldCount;
+            } else {
+                out->resize(fieldStart);
+            }
+        }
+        if (!m_timestampFieldPrefix.empty()) {
+            if (fieldCount > 0) {
+                out->push_back(',');
+            }
+            out->append(m_timestampFieldPrefix);
+            AppendInteger(*out, *timestampMs);
+            out->push_back('i');
+            ++fieldCount;
+        }
+
+        if (fieldCount == 0) {
+            out->resize(lineStart);
+        } else {
+            out->push_back(' ');
+            AppendInteger(*out, *timestampMs * 1000000LL);
+            out->push_back('\n');
+            if (serialized == 0 && firstTimestampMs) {
+                *firstTimestampMs = *timestampMs;
+            }
+            ++serialized;
+        }
+
+        timestampCursor.Advance();
+        for (auto& cursor : tagCursors) cursor.Advance();
+        for (auto& cursor : fieldCursors) cursor.Advance();
+    }
+
+    if (rowsSerialized) {
+        *rowsSerialized += serialized;
+    }
+    return true;
+}
+
+bool IlpEncoder::Encode(std::vector<std::string>* blocks,
+                        int64_t* rowsSerialized,
+                        std::string* error,
+                        int64_t rowsPerBlock) const {
+    const int64_t numRows = m_table->num_rows();
+    const int64_t blockRows = std::max<int64_t>(1, rowsPerBlock);
+    const int64_t numBlocks = (numRows + blockRows - 1) / blockRows;
+
+    std::vector<std::string> encoded(static_cast<size_t>(numBlocks));
+    std::vector<int64_t> counts(static_cast<size_t>(numBlocks), 0);
+    std::vector<std::string> errors(static_cast<size_t>(numBlocks));
+    std::vector<char> failed(static_cast<size_t>(numBlocks), 0);
+    std::vector<int64_t> blockIds(static_cast<size_t>(numBlocks));
+    std::iota(blockIds.begin(), blockIds.end(), 0);
+
+    std::for_each(std::execution::par, blockIds.begin(), blockIds.end(), [&](int64_t block) {
+        const int64_t begin = block * blockRows;
+        const int64_t end = std::min(numRows, begin + blockRows);
+        failed[block] = !EncodeRows(begin, end, &encoded[block], &counts[block], &errors[block]);
+    });
+
+    // Report the earliest failing row, as a sequential pass would
+    for (int64_t block = 0; block < numBlocks; ++block) {
+        if (failed[block]) {
+            if (error) *error = errors[block];
+            return false;
+        }
+    }
+
+    int64_t total = 0;
+    for (int64_t block = 0; block < numBlocks; ++block) {
+        total += counts[block];
+        if (!encoded[block].empty()) {
+            blocks->push_back(std::move(encoded[block]));
+        }
+    }
+    if (rowsSerialized) {
+        *rowsSerialized = total;
+    }
+    return true;
+}
+
+bool IlpEncoder::CheckTimestamps(std::string* error) const {
+    if (!m_timestamp.data) {
+        if (error) *error = "Timestamp column '" + m_timestampColumnName + "' not found.";
+        return false;
+    }
+    int64_t row = 0;
+    for (const auto& chunk : m_timestamp.data->chunks()) {
+        for (int64_t i = 0; i < chunk->length(); ++i, ++row) {
+            auto timestampMs = CellToMillis(*chunk, i, m_timestamp.kind, m_coerceSecondsToMillis);
+            if (!timestampMs || *timestampMs == 0) {
+                if (error) {
+                    *error = "Row " + std::to_string(row) + " is missing a valid timestamp in column '"
+                        + m_timestampColumnName + "'.";
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int64_t IlpEncoder::RowsForBlockBytes(size_t targetBytes) const {
+    return std::max<int64_t>(256, static_cast<int64_t>(targetBytes / std::max<size_t>(1, m_rowSizeHint)));
+}
+
+bool IlpEncoder::EncodeOrdered(int64_t rowsPerBlock,
+                               int threads,
+                               size_t window,
+                               const std::function<bool(IlpBlock&&)>& sink,
+                               int64_t* rowsSerialized,
+                               std::string* error) const {
+    const int64_t numRows = m_table->num_rows();
+    const int64_t blockRows = std::max<int64_t>(1, rowsPerBlock);
+    const int64_t numBlocks = (numRows + blockRows - 1) / blockRows;
+    const int64_t maxAhead = static_cast<int64_t>(std::max<size_t>(1, window));
+
+    std::mutex mutex;
+    std::condition_variable progress;
+    int64_t nextClaim = 0;      // Next block to encode
+    int64_t nextEmit = 0;       // Next block the sink expects
+    bool emitting = false;
+    bool stopped = false;
+    int64_t failedBlock = numBlocks;
+    std::string firstError;
+    std::map<int64_t, IlpBlock> ready;
+    int64_t total = 0;
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            progress.wait(lock, [&]() {
+                return stopped || nextClaim >= numBlocks || nextClaim < nextEmit + maxAhead;
+            });
+            if (stopped || nextClaim >= numBlocks) {
+                return;
+            }
+            const int64_t block = nextClaim++;
+            lock.unlock();
+
+            IlpBlock encoded;
+            std::string blockError;
+            const int64_t begin = block * blockRows;
+            const bool ok = EncodeRows(begin, std::min(numRows, begin + blockRows), &encoded.data,
+                                       &encoded.rows, &blockError, &encoded.first_timestamp_ms);
+
+            lock.lock();
+            if (!ok) {
+                if (block < failedBlock) {
+                    failedBlock = block;
+                    firstError = blockError;
+                }
+                stopped = true;
+                progress.notify_all();
+                return;
+            }
+            ready.emplace(block, std::move(encoded));
+
+            // One thread at a time feeds the sink, in block order
+            while (!emitting && !stopped && !ready.empty() && ready.begin()->first == nextEmit) {
+                emitting = true;
+                IlpBlock next = std::move(ready.begin()->second);
+                ready.erase(ready.begin());
+                lock.unlock();
+                const int64_t rows = next.rows;
+                const bool accepted = next.data.empty() || sink(std::move(next));
+                lock.lock();
+                emitting = false;
+                ++nextEmit;
+                if (accepted) {
+                    total += rows;
+                } else {
+                    stopped = true;
+                }
+                progress.notify_all();
+            }
+        }
+    };
+
+    const int workerCount = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(threads, numBlocks)));
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount - 1);
+    for (int i = 1; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    if (rowsSerialized) {
+        *rowsSerialized = total;
+    }
+    if (failedBlock < numBlocks) {
+        if (error) *error = firstError;
+        return false;
+    }
+    return nextEmit == numBlocks;
+}
+
+} // namespace questdb
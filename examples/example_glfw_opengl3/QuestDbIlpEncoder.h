@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "QuestDbDataFrameGateway.h"
+
+namespace arrow {
+class Array;
+class ChunkedArray;
+class Table;
+}
+
+namespace questdb {
+
+// Physical layout of a column as the encoder reads it
+enum class IlpCellKind {
+    Bool,
+    Float,
+    Double,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    String,
+    LargeString,
+    Timestamp,
+    Other       // Formatted through arrow::Scalar::ToString
+};
+
+// Consecutive encoded rows
+struct IlpBlock {
+    std::string data;
+    int64_t rows = 0;
+    int64_t first_timestamp_ms = 0;
+};
+
+// InfluxDB line protocol encoder for Arrow tables.
+//
+// Column kinds, escaped names and the measurement/static-tag prefix are
+// resolved once. Rows are then written straight from the typed column
+// buffers into per-block byte buffers, numbers formatted with std::to_chars,
+// and blocks are encoded in parallel. The output matches the previous
+// per-cell scalar encoder byte for byte: floating point as %.16g, integers
+// with an 'i' suffix, nulls and non-finite values omitted, and rows without
+// any field skipped.
+class IlpEncoder {
+public:
+    IlpEncoder(std::shared_ptr<arrow::Table> table,
+               const ExportSpec& spec,
+               const std::string& timestampColumn);
+
+    // Encodes every row; blocks hold consecutive row ranges in row order.
+    // Fails on the first row without a usable timestamp.
+    bool Encode(std::vector<std::string>* blocks,
+                int64_t* rowsSerialized,
+                std::string* error,
+                int64_t rowsPerBlock = 16384) const;
+
+    // Appends the lines of rows [begin, end) to out
+    bool EncodeRows(int64_t begin,
+                    int64_t end,
+                    std::string* out,
+                    int64_t* rowsSerialized,
+                    std::string* error,
+                    int64_t* firstTimestampMs = nullptr) const;
+
+    // Checks every row's timestamp without encoding anything, so a bad row
+    // can be reported before the first block is sent
+    bool CheckTimestamps(std::string* error) const;
+
+    // Block length in rows for blocks of roughly targetBytes
+    int64_t RowsForBlockBytes(size_t targetBytes) const;
+
+    // Encodes row blocks on `threads` workers and passes them to sink in row
+    // order. At most `window` encoded blocks exist at once, so a sink that
+    // blocks (back-pressure) also holds the encoders back. Stops early when
+    // sink returns false.
+    bool EncodeOrdered(int64_t rowsPerBlock,
+                       int threads,
+                       size_t window,
+                       const std::function<bool(IlpBlock&&)>& sink,
+                       int64_t* rowsSerialized,
+                       std::string* error) const;
+
+private:
+    struct Column {
+        std::shared_ptr<arrow::ChunkedArray> data;
+        IlpCellKind kind = IlpCellKind::Other;
+        std::string prefix;     // Escaped "name=" for fields, ",name=" for tags
+    };
+
+    std::shared_ptr<arrow::Table> m_table;
+    std::string m_linePrefix;           // Escaped measurement and static tags
+    std::vector<Column> m_tags;
+    std::vector<Column> m_fields;
+    Column m_timestamp;
+    std::string m_timestampColumnName;
+    std::string m_timestampFieldPrefix; // Empty unless the spec emits it
+    bool m_coerceSecondsToMillis = true;
+    size_t m_rowSizeHint = 64;          // Reservation per encoded row
+};
+
+} // namespace questdb
@@ -0,0 +1,246 @@
+#include "QuestDbIlpSender.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+namespace questdb {
+
+struct IlpSender::Connection {
+    CURL* curl = nullptr;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<IlpBuffer> queue;
+    bool closing = false;
+    int64_t rows = 0;
+    int64_t bytes = 0;
+    std::thread worker;
+};
+
+IlpSender::IlpSender(IlpSenderOptions options)
+    : m_options(std::move(options)) {
+    m_options.connections = std::max(1, m_options.connections);
+    m_options.queue_depth = std::max<size_t>(1, m_options.queue_depth);
+}
+
+IlpSender::~IlpSender() {
+    if (m_open) {
+        Fail("ILP sender closed before all buffers were sent.");
+    }
+    Shutdown();
+}
+
+bool IlpSender::Connect(Connection& connection, std::string* error) {
+    if (connection.curl) {
+        curl_easy_cleanup(connection.curl);
+    }
+    connection.curl = curl_easy_init();
+    if (!connection.curl) {
+        if (error) *error = "Failed to initialize CURL.";
+        return false;
+    }
+
+    std::ostringstream url;
+    url << "telnet://" << m_options.host << ':' << m_options.port;
+
+    curl_easy_setopt(connection.curl, CURLOPT_URL, url.str().c_str());
+    curl_easy_setopt(connection.curl, CURLOPT_CONNECT_ONLY, 1L);
+    curl_easy_setopt(connection.curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(connection.curl, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(connection.curl, CURLOPT_CONNECTTIMEOUT_MS, m_options.connect_timeout_ms);
+    curl_easy_setopt(connection.curl, CURLOPT_TIMEOUT_MS, m_options.connect_timeout_ms + m_options.request_timeout_ms);
+
+    CURLcode res = curl_easy_perform(connection.curl);
+    if (res != CURLE_OK) {
+        if (error) {
+            *error = std::string("QuestDB connection failed: ") + curl_easy_strerror(res);
+        }
+        curl_easy_cleanup(connection.curl);
+        connection.curl = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool IlpSender::Open(std::string* error) {
+    m_started = std::chrono::steady_clock::now();
+    for (int i = 0; i < m_options.connections; ++i) {
+        auto connection = std::make_unique<Connection>();
+        if (!Connect(*connection, error)) {
+            Shutdown();
+            return false;
+        }
+        m_connections.push_back(std::move(connection));
+    }
+    for (auto& connection : m_connections) {
+        Connection* target = connection.get();
+        connection->worker = std::thread([this, target]() { Drain(*target); });
+    }
+    m_open = true;
+    return true;
+}
+
+bool IlpSender::Submit(IlpBuffer buffer) {
+    if (m_failed.load()) {
+        return false;
+    }
+    if (buffer.data.empty() || m_connections.empty()) {
+        return !m_connections.empty();
+    }
+
+    const size_t shard = std::hash<std::string>{}(buffer.shard_key) % m_connections.size();
+    Connection& connection = *m_connections[shard];
+    std::unique_lock<std::mutex> lock(connection.mutex);
+    connection.changed.wait(lock, [&]() {
+        return m_failed.load() || connection.queue.size() < m_options.queue_depth;
+    });
+    if (m_failed.load()) {
+        return false;
+    }
+    connection.queue.push_back(std::move(buffer));
+    lock.unlock();
+    connection.changed.notify_all();
+    return true;
+}
+
+void IlpSender::Drain(Connection& connection) {
+    while (true) {
+        IlpBuffer buffer;
+        {
+            std::unique_lock<std::mutex> lock(connection.mutex);
+            connection.changed.wait(lock, [&]() {
+                return m_failed.load() || connection.closing || !connection.queue.empty();
+            });
+            if (m_failed.load()) {
+                connection.queue.clear();
+                return;
+            }
+            if (connection.queue.empty()) {
+                return;   // Closing and drained
+            }
+            buffer = std::move(connection.queue.front());
+            connection.queue.pop_front();
+        }
+        connection.changed.notify_all();
+
+        std::string error;
+        if (!SendBuffer(connection, buffer, &error)) {
+            Fail(error);
+            return;
+        }
+        connection.rows += buffer.rows;
+        connection.bytes += static_cast<int64_t>(buffer.data.size());
+    }
+}
+
+bool IlpSender::SendBuffer(Connection& connection, const IlpBuffer& buffer, std::string* error) {
+    const char* data = buffer.data.data();
+    const size_t total = buffer.data.size();
+    size_t sentTotal = 0;
+    const auto retryBudget = std::chrono::milliseconds(m_options.send_retry_window_ms);
+    auto deadline = std::chrono::steady_clock::now() + retryBudget;
+
+    while (sentTotal < total) {
+        if (m_failed.load()) {
+            return false;
+        }
+        size_t sent = 0;
+        CURLcode res = connection.curl
+            ? curl_easy_send(connection.curl, data + sentTotal, total - sentTotal, &sent)
+            : CURLE_SEND_ERROR;
+        if (res == CURLE_AGAIN) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                if (error) *error = "QuestDB send timed out.";
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (res != CURLE_OK) {
+            // Resending is only safe while none of this buffer has gone out
+            if (sentTotal == 0 && std::chrono::steady_clock::now() < deadline) {
+                std::string reconnectError;
+                if (!Connect(connection, &reconnectError)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+                continue;
+            }
+            if (error) {
+                *error = std::string("QuestDB send failed: ") + curl_easy_strerror(res);
+            }
+            return false;
+        }
+        if (sent == 0) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                if (error) *error = "QuestDB send stalled.";
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        sentTotal += sent;
+        deadline = std::chrono::steady_clock::now() + retryBudget;
+    }
+    return true;
+}
+
+void IlpSender::Fail(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        if (m_failed.load()) {
+            return;
+        }
+        m_error = error;
+        m_failed.store(true);
+    }
+    for (auto& connection : m_connections) {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        connection->changed.notify_all();
+    }
+}
+
+void IlpSender::Shutdown() {
+    for (auto& connection : m_connections) {
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            connection->closing = true;
+        }
+        connection->changed.notify_all();
+    }
+    for (auto& connection : m_connections) {
+        if (connection->worker.joinable()) {
+            connection->worker.join();
+        }
+        if (connection->curl) {
+            curl_easy_cleanup(connection->curl);
+            connection->curl = nullptr;
+        }
+    }
+    m_open = false;
+}
+
+bool IlpSender::Close(IlpSendStats* stats, std::string* error) {
+    Shutdown();
+
+    if (stats) {
+        *stats = IlpSendStats{};
+        for (const auto& connection : m_connections) {
+            stats->rows += connection->rows;
+            stats->bytes += connection->bytes;
+        }
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_started).count();
+        stats->connections = static_cast<int>(m_connections.size());
+    }
+    m_connections.clear();
+
+    if (m_failed.load()) {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        if (error) *error = m_error;
+        return false;
+    }
+    return true;
+}
+
+} // namespace questdb
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace questdb {
+
+struct IlpSenderOptions {
+    std::string host = "127.0.0.1";
+    int port = 9009;
+    int connections = 2;
+    size_t queue_depth = 4;             // Buffers waiting per connection
+    long connect_timeout_ms = 5000;
+    long request_timeout_ms = 15000;
+    long send_retry_window_ms = 10000;  // Per buffer, reset on progress
+};
+
+// One encoded run of complete ILP lines
+struct IlpBuffer {
+    std::string data;
+    int64_t rows = 0;
+    std::string shard_key;              // Buffers with equal keys share a connection
+};
+
+struct IlpSendStats {
+    int64_t rows = 0;
+    int64_t bytes = 0;
+    double seconds = 0.0;
+    int connections = 0;
+};
+
+// Sends ILP buffers over several TCP connections, each drained by its own
+// thread from a bounded queue. Submit() blocks while the target queue is
+// full, so producers never run more than queue_depth buffers ahead.
+//
+// A buffer goes to connection hash(shard_key) % connections; buffers that
+// share a key keep their submission order. A stalled send is retried until
+// send_retry_window_ms passes without progress. A connection that fails
+// before any byte of the current buffer was accepted is reopened and the
+// buffer resent; after a partial send the buffer is not repeated (the
+// server may already have committed its leading lines) and the export fails.
+class IlpSender {
+public:
+    explicit IlpSender(IlpSenderOptions options);
+    ~IlpSender();
+
+    IlpSender(const IlpSender&) = delete;
+    IlpSender& operator=(const IlpSender&) = delete;
+
+    bool Open(std::string* error);
+
+    // False once any connection has failed
+    bool Submit(IlpBuffer buffer);
+
+    // Sends everything queued, closes the connections and reports totals
+    bool Close(IlpSendStats* stats, std::string* error);
+
+private:
+    struct Connection;
+
+    void Drain(Connection& connection);
+    bool SendBuffer(Connection& connection, const IlpBuffer& buffer, std::string* error);
+    bool Connect(Connection& connection, std::string* error);
+    void Fail(const std::string& error);
+    void Shutdown();
+
+    IlpSenderOptions m_options;
+    std::vector<std::unique_ptr<Connection>> m_connections;
+
+    std::mutex m_errorMutex;
+    std::string m_error;
+    std::atomic<bool> m_failed{false};
+    bool m_open = false;
+
+    std::chrono::steady_clock::time_point m_started;
+};
+
+} // namespace questdb
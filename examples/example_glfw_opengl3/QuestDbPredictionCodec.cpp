@@ -0,0 +1,336 @@
+#include "QuestDbPredictionCodec.h"
+
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace questdb {
+namespace {
+
+using Entry = WalkforwardPredictionSeries::Entry;
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// Columns holding one value per fold, in schema order
+constexpr std::array<const char*, 6> kFoldColumnNames = {
+    "long_threshold",
+    "short_threshold",
+    "roc_threshold",
+    "short_entry_threshold",
+    "fold_score",
+    "fold_profit_factor",
+};
+
+std::array<double, 6> FoldColumnValues(const simulation::FoldResult& fold) {
+    return {
+        fold.long_threshold_optimal,
+        fold.short_threshold_optimal,
+        fold.prediction_threshold_original,
+        fold.short_threshold_original,
+        fold.best_score,
+        fold.profit_factor_test,
+    };
+}
+
+template <typename T>
+arrow::Result<std::shared_ptr<arrow::Buffer>> AllocateValues(int64_t length) {
+    ARROW_ASSIGN_OR_RAISE(std::unique_ptr<arrow::Buffer> buffer,
+                          arrow::AllocateBuffer(length * static_cast<int64_t>(sizeof(T))));
+    return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+}
+
+template <typename T>
+T* MutableValues(const std::shared_ptr<arrow::Buffer>& buffer) {
+    return reinterpret_cast<T*>(buffer->mutable_data());
+}
+
+void ClearBits(uint8_t* bitmap, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+        bitmap[i >> 3] &= static_cast<uint8_t>(~(1u << (i & 7)));
+    }
+}
+
+int ResolveFieldIndex(const std::shared_ptr<arrow::Schema>& schema,
+                      std::initializer_list<const char*> candidates) {
+    for (const char* candidate : candidates) {
+        const int idx = schema->GetFieldIndex(candidate);
+        if (idx >= 0) {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+std::string JoinSchemaFields(const std::shared_ptr<arrow::Schema>& schema) {
+    std::string out;
+    for (int i = 0; i < schema->num_fields(); ++i) {
+        if (i > 0) out += ", ";
+        out += schema->field(i)->name();
+    }
+    return out;
+}
+
+// Epoch values of today's dates are ~1.7e9 in seconds, ~1.7e12 in ms,
+// ~1.7e15 in microseconds and ~1.7e18 in nanoseconds
+int64_t NormalizeTimestampMs(int64_t raw) {
+    if (raw <= 0) {
+        return raw;
+    }
+    if (raw >= 100'000'000'000'000'000LL) { // nanoseconds
+        return raw / 1'000'000LL;
+    }
+    if (raw >= 100'000'000'000'000LL) { // microseconds
+        return raw / 1'000LL;
+    }
+    if (raw < 100'000'000'000LL) { // seconds
+        return raw * 1000LL;
+    }
+    return raw;
+}
+
+template <typename ArrayType, typename Member>
+void CopyChunk(const arrow::Array& chunk,
+               int64_t firstRow,
+               Member Entry::* member,
+               Member nullValue,
+               std::vector<Entry>* rows) {
+    using Value = typename ArrayType::value_type;
+    const auto& typed = static_cast<const ArrayType&>(chunk);
+    const Value* values = typed.raw_values();
+    const bool hasNulls = typed.null_count() > 0;
+    Entry* out = rows->data() + firstRow;
+    for (int64_t i = 0; i < typed.length(); ++i) {
+        Member value = nullValue;
+        if (!hasNulls || typed.IsValid(i)) {
+            if constexpr (std::is_integral_v<Member> && std::is_floating_point_v<Value>) {
+                if (std::isfinite(values[i])) {
+                    value = static_cast<Member>(std::llround(values[i]));
+                }
+            } else {
+                value = static_cast<Member>(values[i]);
+            }
+        }
+        out[i].*member = value;
+    }
+}
+
+// Writes the column into one member of every entry. Types the exporter never
+// produces decode as nullValue.
+template <typename Member>
+void DecodeColumn(const std::shared_ptr<arrow::ChunkedArray>& column,
+                  Member Entry::* member,
+                  Member nullValue,
+                  std::vector<Entry>* rows) {
+    int64_t firstRow = 0;
+    for (const auto& chunk : column->chunks()) {
+        switch (chunk->type_id()) {
+            case arrow::Type::DOUBLE:
+                CopyChunk<arrow::DoubleArray>(*chunk, firstRow, member, nullValue, rows);
+                break;
+            case arrow::Type::FLOAT:
+                CopyChunk<arrow::FloatArray>(*chunk, firstRow, member, nullValue, rows);
+                break;
+            case arrow::Type::INT64:
+                CopyChunk<arrow::Int64Array>(*chunk, firstRow, member, nullValue, rows);
+                break;
+            case arrow::Type::INT32:
+                CopyChunk<arrow::Int32Array>(*chunk, firstRow, member, nullValue, rows);
+                break;
+            case arrow::Type::TIMESTAMP:
+                CopyChunk<arrow::TimestampArray>(*chunk, firstRow, member, nullValue, rows);
+                break;
+            default:
+                for (int64_t i = 0; i < chunk->length(); ++i) {
+                    (*rows)[static_cast<size_t>(firstRow + i)].*member = nullValue;
+                }
+                break;
+        }
+        firstRow += chunk->length();
+    }
+}
+
+} // namespace
+
+arrow::Result<std::shared_ptr<arrow::Table>> EncodeWalkforwardPredictions(
+    const simulation::SimulationRun& run) {
+    if (run.all_test_predictions.empty() || run.all_test_timestamps.empty()) {
+        return arrow::Status::Invalid("Simulation run contains no predictions to export.");
+    }
+
+    const int64_t totalPreds = static_cast<int64_t>(run.all_test_predictions.size());
+    const int64_t usablePreds = std::min<int64_t>(totalPreds, static_cast<int64_t>(run.all_test_timestamps.size()));
+    const int64_t actualCount = static_cast<int64_t>(run.all_test_actuals.size());
+    const auto& offsets = run.fold_prediction_offsets;
+    const size_t foldCount = std::min(run.foldResults.size(), offsets.size());
+
+    auto foldRange = [&](size_t foldIndex) {
+        const int64_t start = std::max<int64_t>(offsets[foldIndex], 0);
+        const int64_t end = (foldIndex + 1 < offsets.size()) ? offsets[foldIndex + 1] : totalPreds;
+        return std::make_pair(start, std::min(end, usablePreds));
+    };
+    auto keep = [&](int64_t idx) {
+        return run.all_test_timestamps[idx] > 0 &&
+               idx < actualCount &&
+               std::isfinite(run.all_test_predictions[idx]) &&
+               std::isfinite(run.all_test_actuals[idx]);
+    };
+
+    int64_t rows = 0;
+    for (size_t foldIndex = 0; foldIndex < foldCount; ++foldIndex) {
+        const auto [start, end] = foldRange(foldIndex);
+        for (int64_t idx = start; idx < end; ++idx) {
+            rows += keep(idx) ? 1 : 0;
+        }
+    }
+    if (rows == 0) {
+        return arrow::Status::Invalid("No valid prediction rows were available for export.");
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto timestampBuffer, AllocateValues<int64_t>(rows));
+    ARROW_ASSIGN_OR_RAISE(auto barIndexBuffer, AllocateValues<int64_t>(rows));
+    ARROW_ASSIGN_OR_RAISE(auto foldBuffer, AllocateValues<int32_t>(rows));
+    ARROW_ASSIGN_OR_RAISE(auto predictionBuffer, AllocateValues<double>(rows));
+    ARROW_ASSIGN_OR_RAISE(auto actualBuffer, AllocateValues<double>(rows));
+    std::array<std::shared_ptr<arrow::Buffer>, kFoldColumnNames.size()> foldValueBuffers;
+    std::array<std::shared_ptr<arrow::Buffer>, kFoldColumnNames.size()> foldValidityBuffers;
+    std::array<int64_t, kFoldColumnNames.size()> foldNullCounts{};
+    const int64_t bitmapBytes = (rows + 7) / 8;
+    for (size_t c = 0; c < kFoldColumnNames.size(); ++c) {
+        ARROW_ASSIGN_OR_RAISE(foldValueBuffers[c], AllocateValues<double>(rows));
+        ARROW_ASSIGN_OR_RAISE(foldValidityBuffers[c], AllocateValues<uint8_t>(bitmapBytes));
+        std::memset(foldValidityBuffers[c]->mutable_data(), 0xFF, static_cast<size_t>(bitmapBytes));
+    }
+
+    int64_t* timestamps = MutableValues<int64_t>(timestampBuffer);
+    int64_t* barIndices = MutableValues<int64_t>(barIndexBuffer);
+    int32_t* folds = MutableValues<int32_t>(foldBuffer);
+    double* predictions = MutableValues<double>(predictionBuffer);
+    double* actuals = MutableValues<double>(actualBuffer);
+
+    int64_t row = 0;
+    for (size_t foldIndex = 0; foldIndex < foldCount; ++foldIndex) {
+        const auto& fold = run.foldResults[foldIndex];
+        const auto [start, end] = foldRange(foldIndex);
+        const int64_t foldFirstRow = row;
+        for (int64_t idx = start; idx < end; ++idx) {
+            if (!keep(idx)) {
+                continue;
+            }
+            timestamps[row] = run.all_test_timestamps[idx];
+            barIndices[row] = static_cast<int64_t>(fold.test_start) + (idx - start);
+            predictions[row] = run.all_test_predictions[idx];
+            actuals[row] = run.all_test_actuals[idx];
+            ++row;
+        }
+        if (row == foldFirstRow) {
+            continue;
+        }
+
+        std::fill(folds + foldFirstRow, folds + row, static_cast<int32_t>(fold.fold_number));
+        const auto values = FoldColumnValues(fold);
+        for (size_t c = 0; c < values.size(); ++c) {
+            double* out = MutableValues<double>(foldValueBuffers[c]);
+            if (std::isfinite(values[c])) {
+                std::fill(out + foldFirstRow, out + row, values[c]);
+            } else {
+                std::fill(out + foldFirstRow, out + row, 0.0);
+                ClearBits(foldValidityBuffers[c]->mutable_data(), foldFirstRow, row);
+                foldNullCounts[c] += row - foldFirstRow;
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> fields = {
+        arrow::field("timestamp_unix", arrow::int64()),
+        arrow::field("bar_index", arrow::int64()),
+        arrow::field("fold_number", arrow::int32()),
+        arrow::field("prediction", arrow::float64()),
+        arrow::field("target_value", arrow::float64()),
+    };
+    std::vector<std::shared_ptr<arrow::Array>> arrays = {
+        std::make_shared<arrow::Int64Array>(rows, timestampBuffer),
+        std::make_shared<arrow::Int64Array>(rows, barIndexBuffer),
+        std::make_shared<arrow::Int32Array>(rows, foldBuffer),
+        std::make_shared<arrow::DoubleArray>(rows, predictionBuffer),
+        std::make_shared<arrow::DoubleArray>(rows, actualBuffer),
+    };
+    for (size_t c = 0; c < kFoldColumnNames.size(); ++c) {
+        fields.push_back(arrow::field(kFoldColumnNames[c], arrow::float64()));
+        arrays.push_back(std::make_shared<arrow::DoubleArray>(
+            rows,
+            foldValueBuffers[c],
+            foldNullCounts[c] > 0 ? foldValidityBuffers[c] : nullptr,
+            foldNullCounts[c]));
+    }
+    return arrow::Table::Make(arrow::schema(fields), arrays, rows);
+}
+
+arrow::Status DecodeWalkforwardPredictions(const std::shared_ptr<arrow::Table>& table,
+                                           WalkforwardPredictionSeries* series) {
+    series->rows.clear();
+    if (!table) {
+        return arrow::Status::Invalid("No prediction table to decode.");
+    }
+
+    const auto schema = table->schema();
+    const int tsIndex = ResolveFieldIndex(schema, {"timestamp_unix", "timestamp", "ts"});
+    const int predictionIndex = ResolveFieldIndex(schema, {"prediction", "prediction_value"});
+    if (tsIndex < 0 || predictionIndex < 0) {
+        return arrow::Status::Invalid("missing required columns (needs at least timestamp + prediction). "
+                                      "Available columns: [", JoinSchemaFields(schema), "]");
+    }
+    const int barIndex = ResolveFieldIndex(schema, {"bar_index", "index"});
+    const int foldIndex = ResolveFieldIndex(schema, {"fold_number", "fold"});
+
+    const std::pair<int, double Entry::*> doubleColumns[] = {
+        {predictionIndex, &Entry::prediction},
+        {ResolveFieldIndex(schema, {"target_value", "target"}), &Entry::target},
+        {ResolveFieldIndex(schema, {"long_threshold"}), &Entry::long_threshold},
+        {ResolveFieldIndex(schema, {"short_threshold"}), &Entry::short_threshold},
+        {ResolveFieldIndex(schema, {"roc_threshold", "prediction_threshold"}), &Entry::roc_threshold},
+        {ResolveFieldIndex(schema, {"short_entry_threshold"}), &Entry::short_entry_threshold},
+        {ResolveFieldIndex(schema, {"fold_score", "best_score"}), &Entry::fold_score},
+        {ResolveFieldIndex(schema, {"fold_profit_factor"}), &Entry::fold_profit_factor},
+    };
+
+    // Columns that are missing stay at these values
+    Entry blank;
+    for (const auto& [index, member] : doubleColumns) {
+        blank.*member = kNaN;
+    }
+    const int64_t totalRows = table->num_rows();
+    series->rows.assign(static_cast<size_t>(totalRows), blank);
+
+    DecodeColumn<int64_t>(table->column(tsIndex), &Entry::timestamp_ms, 0, &series->rows);
+    for (auto& entry : series->rows) {
+        entry.timestamp_ms = NormalizeTimestampMs(entry.timestamp_ms);
+    }
+    if (barIndex >= 0) {
+        DecodeColumn<int64_t>(table->column(barIndex), &Entry::bar_index, 0, &series->rows);
+    } else {
+        for (int64_t row = 0; row < totalRows; ++row) {
+            series->rows[static_cast<size_t>(row)].bar_index = row;
+        }
+    }
+    if (foldIndex >= 0) {
+        DecodeColumn<int32_t>(table->column(foldIndex), &Entry::fold_number, 0, &series->rows);
+    }
+    for (const auto& [index, member] : doubleColumns) {
+        if (index >= 0) {
+            DecodeColumn<double>(table->column(index), member, kNaN, &series->rows);
+        }
+    }
+    return arrow::Status::OK();
+}
+
+} // namespace questdb
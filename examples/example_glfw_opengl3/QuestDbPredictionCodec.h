@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+
+#include <arrow/result.h>
+#include <arrow/status.h>
+
+#include "QuestDbImports.h"
+#include "simulation/SimulationTypes.h"
+
+namespace arrow {
+class Table;
+}
+
+namespace questdb {
+
+// Columnar codec between walk-forward runs and their QuestDB prediction
+// measurement (timestamp_unix, bar_index, fold_number, prediction,
+// target_value, fold thresholds and scores).
+//
+// Encoding sizes every column from one counting pass over the fold offsets
+// and writes the values straight into Arrow buffers; fold-level columns are
+// filled a fold range at a time. Decoding reads each column through its
+// typed chunk buffers instead of one arrow::Scalar per cell. Rows without a
+// timestamp, or with a non-finite prediction or target, are not exported,
+// and fold values that are not finite are exported as nulls.
+
+arrow::Result<std::shared_ptr<arrow::Table>> EncodeWalkforwardPredictions(
+    const simulation::SimulationRun& run);
+
+// Accepts the column aliases older exports used. Missing optional columns
+// decode as NaN (bar_index as the row number, fold_number as 0).
+arrow::Status DecodeWalkforwardPredictions(const std::shared_ptr<arrow::Table>& table,
+                                           WalkforwardPredictionSeries* series);
+
+} // namespace questdb
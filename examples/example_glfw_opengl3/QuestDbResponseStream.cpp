@@ -0,0 +1,257 @@
+#include "QuestDbResponseStream.h"
+
+#include <arrow/buffer.h>
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace questdb {
+
+// --- ResponsePipe ---
+
+ResponsePipe::ResponsePipe(size_t capacity)
+    : m_ring(std::max<size_t>(capacity, 64 * 1024)) {}
+
+bool ResponsePipe::Write(const char* data, size_t size) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (size > 0) {
+        m_writable.wait(lock, [&]() { return m_cancelled || m_size < m_ring.size(); });
+        if (m_cancelled) {
+            return false;
+        }
+        const size_t tail = (m_head + m_size) % m_ring.size();
+        const size_t chunk = std::min({ size, m_ring.size() - m_size, m_ring.size() - tail });
+        std::memcpy(m_ring.data() + tail, data, chunk);
+        m_size += chunk;
+        data += chunk;
+        size -= chunk;
+        m_readable.notify_one();
+    }
+    return true;
+}
+
+size_t ResponsePipe::Read(char* out, size_t size) {
+    size_t copied = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (copied < size) {
+        m_readable.wait(lock, [&]() { return m_size > 0 || m_finished; });
+        if (m_size == 0) {
+            break;
+        }
+        const size_t chunk = std::min({ size - copied, m_size, m_ring.size() - m_head });
+        std::memcpy(out + copied, m_ring.data() + m_head, chunk);
+        m_head = (m_head + chunk) % m_ring.size();
+        m_size -= chunk;
+        copied += chunk;
+        m_writable.notify_one();
+    }
+    return copied;
+}
+
+std::string ResponsePipe::Peek(size_t size) {
+    size = std::min(size, m_ring.size());
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_readable.wait(lock, [&]() { return m_size >= size || m_finished; });
+
+    std::string prefix;
+    const size_t count = std::min(size, m_size);
+    prefix.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        prefix.push_back(m_ring[(m_head + i) % m_ring.size()]);
+    }
+    return prefix;
+}
+
+void ResponsePipe::Finish(std::string error) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_finished = true;
+        m_error = std::move(error);
+    }
+    m_readable.notify_all();
+}
+
+void ResponsePipe::Cancel() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled = true;
+    }
+    m_writable.notify_all();
+}
+
+bool ResponsePipe::Cancelled() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cancelled;
+}
+
+bool ResponsePipe::Finished() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_finished;
+}
+
+std::string ResponsePipe::Error() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_error;
+}
+
+// --- HttpResponseStream ---
+
+HttpResponseStream::HttpResponseStream(size_t bufferBytes)
+    : m_pipe(bufferBytes) {}
+
+HttpResponseStream::~HttpResponseStream() {
+    (void)Close();
+}
+
+arrow::Result<std::shared_ptr<HttpResponseStream>> HttpResponseStream::Open(const std::string& url,
+                                                                            const Options& options) {
+    std::shared_ptr<HttpResponseStream> stream(new HttpResponseStream(options.buffer_bytes));
+    HttpResponseStream* self = stream.get();
+    stream->m_worker = std::thread([self, url, options]() { self->Download(url, options); });
+    return stream;
+}
+
+size_t HttpResponseStream::WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    auto* self = static_cast<HttpResponseStream*>(userp);
+    const size_t total = size * nmemb;
+    if (self->m_responseCode.load() == 0) {
+        long code = 0;
+        curl_easy_getinfo(static_cast<CURL*>(self->m_curl), CURLINFO_RESPONSE_CODE, &code);
+        self->m_responseCode.store(code);
+    }
+    // Returning short aborts the transfer once the reader has gone away
+    return self->m_pipe.Write(static_cast<const char*>(contents), total) ? total : 0;
+}
+
+// curl calls this while waiting on the network too (about once a second),
+// which is the only way to stop a stalled transfer from outside it
+int HttpResponseStream::ProgressCallback(void* userp, int64_t, int64_t downloaded, int64_t, int64_t) {
+    auto* self = static_cast<HttpResponseStream*>(userp);
+    if (self->m_pipe.Cancelled()) {
+        return 1;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (downloaded != self->m_downloaded) {
+        // Also covers the time WriteCallback spent blocked on the reader
+        self->m_downloaded = downloaded;
+        self->m_lastByte = now;
+        return 0;
+    }
+    if (self->m_idleTimeoutMs > 0 &&
+        now - self->m_lastByte > std::chrono::milliseconds(self->m_idleTimeoutMs)) {
+        self->m_idleTimedOut = true;
+        return 1;
+    }
+    return 0;
+}
+
+void HttpResponseStream::Download(std::string url, Options options) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        m_pipe.Finish("Failed to initialize CURL.");
+        return;
+    }
+    m_curl = curl;
+
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &HttpResponseStream::WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, this);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, options.connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &HttpResponseStream::ProgressCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+
+    m_idleTimeoutMs = options.idle_timeout_ms;
+    m_lastByte = std::chrono::steady_clock::now();
+    const CURLcode res = curl_easy_perform(curl);
+    long code = 0;
+    if (curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code) == CURLE_OK && code != 0) {
+        m_responseCode.store(code);
+    }
+    m_curl = nullptr;
+    curl_easy_cleanup(curl);
+
+    if (res == CURLE_OK) {
+        m_pipe.Finish(std::string());
+    } else if (m_idleTimedOut) {
+        m_pipe.Finish("no data received for " + std::to_string(m_idleTimeoutMs) + " ms");
+    } else {
+        m_pipe.Finish(curl_easy_strerror(res));
+    }
+}
+
+std::string HttpResponseStream::Peek(size_t size) {
+    return m_pipe.Peek(size);
+}
+
+arrow::Status HttpResponseStream::TransferStatus() {
+    const std::string error = m_pipe.Error();
+    if (!error.empty()) {
+        return arrow::Status::IOError("QuestDB fetch failed: ", error);
+    }
+    return arrow::Status::OK();
+}
+
+arrow::Result<std::string> HttpResponseStream::ReadRemaining(size_t maxBytes) {
+    std::string body;
+    char chunk[16 * 1024];
+    while (body.size() < maxBytes) {
+        const size_t got = m_pipe.Read(chunk, std::min(sizeof(chunk), maxBytes - body.size()));
+        if (got == 0) {
+            break;
+        }
+        body.append(chunk, got);
+        m_position += static_cast<int64_t>(got);
+    }
+    return body;
+}
+
+arrow::Status HttpResponseStream::Close() {
+    if (m_closed) {
+        return arrow::Status::OK();
+    }
+    m_closed = true;
+    m_pipe.Cancel();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+    return arrow::Status::OK();
+}
+
+bool HttpResponseStream::closed() const {
+    return m_closed;
+}
+
+arrow::Result<int64_t> HttpResponseStream::Tell() const {
+    return m_position;
+}
+
+arrow::Result<int64_t> HttpResponseStream::Read(int64_t nbytes, void* out) {
+    if (m_closed) {
+        return arrow::Status::Invalid("Response stream is closed.");
+    }
+    if (nbytes <= 0) {
+        return 0;
+    }
+    // Fill the whole request like a file read would, so the CSV reader
+    // sees full-sized blocks rather than whatever curl last delivered
+    const size_t got = m_pipe.Read(static_cast<char*>(out), static_cast<size_t>(nbytes));
+    m_position += static_cast<int64_t>(got);
+    if (got < static_cast<size_t>(nbytes)) {
+        ARROW_RETURN_NOT_OK(TransferStatus());
+    }
+    return static_cast<int64_t>(got);
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>> HttpResponseStream::Read(int64_t nbytes) {
+    ARROW_ASSIGN_OR_RAISE(auto buffer, arrow::AllocateResizableBuffer(nbytes));
+    ARROW_ASSIGN_OR_RAISE(int64_t bytesRead, Read(nbytes, buffer->mutable_data()));
+    ARROW_RETURN_NOT_OK(buffer->Resize(bytesRead));
+    return std::shared_ptr<arrow::Buffer>(std::move(buffer));
+}
+
+} // namespace questdb
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <arrow/io/interfaces.h>
+#include <arrow/result.h>
+#include <arrow/status.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace questdb {
+
+// Bounded byte ring between one writer (a curl download thread) and one
+// reader. Write() blocks while the ring is full, which stalls curl and lets
+// TCP flow control hold the server back; Read() blocks until it has filled
+// the request or the writer has finished.
+class ResponsePipe {
+public:
+    explicit ResponsePipe(size_t capacity);
+
+    // False once the reader has cancelled
+    bool Write(const char* data, size_t size);
+
+    // Short only at the end of the stream
+    size_t Read(char* out, size_t size);
+
+    // Up to `size` unread bytes, without consuming them. Short only at the
+    // end of the stream; size is capped at the ring capacity.
+    std::string Peek(size_t size);
+
+    // Marks the end of the stream; a non-empty error means it was cut short
+    void Finish(std::string error);
+
+    // Makes pending and future writes fail
+    void Cancel();
+
+    bool Finished();
+    bool Cancelled();
+    std::string Error();
+
+private:
+    std::vector<char> m_ring;
+    size_t m_head = 0;                  // Next byte to read
+    size_t m_size = 0;                  // Unread bytes
+    bool m_finished = false;
+    bool m_cancelled = false;
+    std::string m_error;
+
+    std::mutex m_mutex;
+    std::condition_variable m_readable;
+    std::condition_variable m_writable;
+};
+
+// HTTP GET body exposed as an Arrow input stream. The transfer runs on its
+// own thread from Open() on, so the consumer parses while the rest of the
+// response is still arriving and nothing is spooled to disk. A transfer
+// that fails part way surfaces as an IOError from Read().
+//
+// There is no limit on the whole transfer, only on how long the server may
+// go without sending anything; time the download spends waiting for the
+// consumer does not count. Close() also stops a transfer that is stalled
+// on the network.
+class HttpResponseStream : public arrow::io::InputStream {
+public:
+    struct Options {
+        long connect_timeout_ms = 5000;
+        long idle_timeout_ms = 60000;   // Longest gap between received bytes
+        size_t buffer_bytes = 4 << 20;  // Read-ahead held in memory
+    };
+
+    static arrow::Result<std::shared_ptr<HttpResponseStream>> Open(const std::string& url,
+                                                                   const Options& options);
+    ~HttpResponseStream() override;
+
+    HttpResponseStream(const HttpResponseStream&) = delete;
+    HttpResponseStream& operator=(const HttpResponseStream&) = delete;
+
+    // First bytes of the body; waits for them to arrive
+    std::string Peek(size_t size);
+
+    // HTTP status, known once the first body byte or the end has arrived
+    long ResponseCode() const { return m_responseCode.load(); }
+
+    // Error of a finished transfer
+    arrow::Status TransferStatus();
+
+    // Remaining body as a string, at most maxBytes
+    arrow::Result<std::string> ReadRemaining(size_t maxBytes);
+
+    // --- arrow::io::InputStream ---
+    arrow::Status Close() override;
+    bool closed() const override;
+    arrow::Result<int64_t> Tell() const override;
+    arrow::Result<int64_t> Read(int64_t nbytes, void* out) override;
+    arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t nbytes) override;
+
+private:
+    explicit HttpResponseStream(size_t bufferBytes);
+
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static int ProgressCallback(void* userp, int64_t downloadTotal, int64_t downloaded,
+                                int64_t uploadTotal, int64_t uploaded);
+    void Download(std::string url, Options options);
+
+    ResponsePipe m_pipe;
+    std::thread m_worker;
+    std::atomic<long> m_responseCode{0};
+    void* m_curl = nullptr;             // Owned by m_worker while it runs
+
+    // Touched by m_worker only
+    long m_idleTimeoutMs = 0;
+    int64_t m_downloaded = 0;
+    std::chrono::steady_clock::time_point m_lastByte;
+    bool m_idleTimedOut = false;
+    int64_t m_position = 0;
+    bool m_closed = false;
+};
+
+} // namespace questdb
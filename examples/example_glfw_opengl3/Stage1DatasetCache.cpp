@@ -0,0 +1,324 @@
+#include "Stage1DatasetCache.h"
+#include "Stage1DatasetDownloader.h"
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/api.h>
+#include <arrow/util/key_value_metadata.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace stage1 {
+
+namespace {
+
+constexpr const char* kCacheFormatVersion = "1";
+constexpr const char* kEntryExtension = ".arrow";
+
+const char* PartName(DatasetPart part) {
+    return part == DatasetPart::Ohlcv ? "ohlcv" : "indicators";
+}
+
+std::string EntryPrefix(const std::string& datasetId, DatasetPart part) {
+    std::string prefix;
+    for (char ch : datasetId) {
+        prefix.push_back(std::isalnum(static_cast<unsigned char>(ch)) || ch == '-' ? ch : '_');
+    }
+    return prefix + '_' + PartName(part) + '_';
+}
+
+uint64_t Fnv1a(const std::string& text) {
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char ch : text) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::unordered_map<std::string, std::string> EntryKey(const DatasetFingerprint& fingerprint,
+                                                      DatasetPart part) {
+    return {
+        {"stage1.cache_version", kCacheFormatVersion},
+        {"stage1.dataset_id", fingerprint.dataset_id},
+        {"stage1.part", PartName(part)},
+        {"stage1.updated_at", fingerprint.updated_at},
+        {"stage1.row_count", std::to_string(fingerprint.row_count)},
+    };
+}
+
+// Stored fingerprint of an entry; false if the file is not a readable entry
+bool ReadFingerprint(const std::filesystem::path& path, DatasetPart part, DatasetFingerprint* fingerprint) {
+    auto file = arrow::io::ReadableFile::Open(path.string());
+    if (!file.ok()) {
+        return false;
+    }
+    auto reader = arrow::ipc::RecordBatchFileReader::Open(*file);
+    if (!reader.ok()) {
+        return false;
+    }
+    auto metadata = (*reader)->schema()->metadata();
+    if (!metadata) {
+        return false;
+    }
+    auto version = metadata->Get("stage1.cache_version");
+    auto storedPart = metadata->Get("stage1.part");
+    auto datasetId = metadata->Get("stage1.dataset_id");
+    auto updatedAt = metadata->Get("stage1.updated_at");
+    auto rowCount = metadata->Get("stage1.row_count");
+    if (!version.ok() || *version != kCacheFormatVersion ||
+        !storedPart.ok() || *storedPart != PartName(part) ||
+        !datasetId.ok() || !updatedAt.ok() || !rowCount.ok()) {
+        return false;
+    }
+    fingerprint->dataset_id = *datasetId;
+    fingerprint->updated_at = *updatedAt;
+    fingerprint->row_count = std::strtoll(rowCount->c_str(), nullptr, 10);
+    return true;
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> MapEntry(const std::filesystem::path& path) {
+    ARROW_ASSIGN_OR_RAISE(auto mapped, arrow::io::MemoryMappedFile::Open(path.string(), arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(mapped));
+
+    // Uncompressed batches reference the mapped pages directly
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    batches.reserve(reader->num_record_batches());
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(i));
+        batches.push_back(std::move(batch));
+    }
+    return arrow::Table::FromRecordBatches(reader->schema()->RemoveMetadata(), batches);
+}
+
+void Touch(const std::filesystem::path& path) {
+    std::error_code ec;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+}
+
+} // namespace
+
+DatasetCache& DatasetCache::Instance() {
+    static DatasetCache instance;
+    return instance;
+}
+
+DatasetCache::DatasetCache() {
+    if (const char* dir = std::getenv("STAGE1_CACHE_DIR")) {
+        m_config.directory = dir;
+    }
+    if (const char* maxMb = std::getenv("STAGE1_CACHE_MAX_MB")) {
+        const long long value = std::strtoll(maxMb, nullptr, 10);
+        if (value > 0) {
+            m_config.max_bytes = static_cast<uint64_t>(value) << 20;
+        }
+    }
+    if (m_config.directory.empty()) {
+        std::error_code ec;
+        auto temp = std::filesystem::temp_directory_path(ec);
+        if (!ec) {
+            m_config.directory = (temp / "stage1_cache").string();
+        }
+    }
+}
+
+void DatasetCache::Configure(DatasetCacheConfig config) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = std::move(config);
+}
+
+DatasetCacheConfig DatasetCache::Config() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+std::string DatasetCache::EntryPath(const DatasetFingerprint& fingerprint, DatasetPart part) const {
+    std::ostringstream key;
+    key << fingerprint.dataset_id << '|' << PartName(part) << '|'
+        << fingerprint.updated_at << '|' << fingerprint.row_count;
+    std::ostringstream name;
+    name << EntryPrefix(fingerprint.dataset_id, part)
+         << std::hex << std::setw(16) << std::setfill('0') << Fnv1a(key.str())
+         << kEntryExtension;
+    return (std::filesystem::path(m_config.directory) / name.str()).string();
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> DatasetCache::Load(const DatasetFingerprint& fingerprint,
+                                                                DatasetPart part) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_config.directory.empty() || fingerprint.dataset_id.empty()) {
+        return std::shared_ptr<arrow::Table>();
+    }
+    const std::filesystem::path path = EntryPath(fingerprint, part);
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) {
+        return std::shared_ptr<arrow::Table>();
+    }
+
+    // The name is only a hash; the stored key settles collisions
+    DatasetFingerprint stored;
+    if (!ReadFingerprint(path, part, &stored) ||
+        stored.dataset_id != fingerprint.dataset_id ||
+        stored.updated_at != fingerprint.updated_at ||
+        stored.row_count != fingerprint.row_count) {
+        return std::shared_ptr<arrow::Table>();
+    }
+    ARROW_ASSIGN_OR_RAISE(auto table, MapEntry(path));
+    Touch(path);
+    return table;
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> DatasetCache::LoadLatest(const std::string& datasetId,
+                                                                      DatasetPart part,
+                                                                      int64_t maxRows,
+                                                                      DatasetFingerprint* fingerprint) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_config.directory.empty() || datasetId.empty()) {
+        return std::shared_ptr<arrow::Table>();
+    }
+
+    const std::string prefix = EntryPrefix(datasetId, part);
+    std::filesystem::path best;
+    std::filesystem::file_time_type bestTime;
+    DatasetFingerprint bestFingerprint;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(m_config.directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0 || entry.path().extension() != kEntryExtension) {
+            continue;
+        }
+        DatasetFingerprint stored;
+        if (!ReadFingerprint(entry.path(), part, &stored) || stored.dataset_id != datasetId) {
+            continue;
+        }
+        if (maxRows > 0 && stored.row_count >= maxRows) {
+            continue;
+        }
+        const auto modified = entry.last_write_time(ec);
+        if (best.empty() || modified > bestTime) {
+            best = entry.path();
+            bestTime = modified;
+            bestFingerprint = stored;
+        }
+    }
+    if (best.empty()) {
+        return std::shared_ptr<arrow::Table>();
+    }
+    ARROW_ASSIGN_OR_RAISE(auto table, MapEntry(best));
+    Touch(best);
+    if (fingerprint) {
+        *fingerprint = bestFingerprint;
+    }
+    return table;
+}
+
+arrow::Status DatasetCache::Store(const DatasetFingerprint& fingerprint,
+                                  DatasetPart part,
+                                  const std::shared_ptr<arrow::Table>& table) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_config.directory.empty()) {
+        return arrow::Status::Invalid("No dataset cache directory.");
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(m_config.directory, ec);
+    if (ec) {
+        return arrow::Status::IOError("Cannot create dataset cache directory ", m_config.directory,
+                                      ": ", ec.message());
+    }
+
+    const std::filesystem::path path = EntryPath(fingerprint, part);
+    const std::string tempPath = path.string() + ".tmp";
+    auto schema = table->schema()->WithMetadata(
+        std::make_shared<arrow::KeyValueMetadata>(EntryKey(fingerprint, part)));
+    {
+        ARROW_ASSIGN_OR_RAISE(auto output, arrow::io::FileOutputStream::Open(tempPath));
+        ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(
+            output, schema, arrow::ipc::IpcWriteOptions::Defaults()));
+        arrow::TableBatchReader batches(*table);
+        std::shared_ptr<arrow::RecordBatch> batch;
+        while (true) {
+            ARROW_RETURN_NOT_OK(batches.ReadNext(&batch));
+            if (!batch) break;
+            ARROW_ASSIGN_OR_RAISE(auto tagged, batch->ReplaceSchema(schema));
+            ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*tagged));
+        }
+        ARROW_RETURN_NOT_OK(writer->Close());
+        ARROW_RETURN_NOT_OK(output->Close());
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return arrow::Status::IOError("Failed to move cache entry into place: ", path.string());
+    }
+
+    // Older versions are superseded; one still mapped elsewhere is left
+    // for eviction to retry. The prefix is lossy ("a.b" and "a_b" share
+    // it), so only entries whose stored id matches are removed.
+    const std::string prefix = EntryPrefix(fingerprint.dataset_id, part);
+    for (const auto& entry : std::filesystem::directory_iterator(m_config.directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0 || entry.path().extension() != kEntryExtension || entry.path() == path) {
+            continue;
+        }
+        DatasetFingerprint stored;
+        if (!ReadFingerprint(entry.path(), part, &stored) || stored.dataset_id != fingerprint.dataset_id) {
+            continue;
+        }
+        std::error_code removeError;
+        std::filesystem::remove(entry.path(), removeError);
+    }
+
+    EvictLocked();
+    return arrow::Status::OK();
+}
+
+void DatasetCache::EvictLocked() {
+    struct Entry {
+        std::filesystem::path path;
+        std::filesystem::file_time_type modified;
+        uint64_t size = 0;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(m_config.directory, ec)) {
+        if (!item.is_regular_file(ec) || item.path().extension() != kEntryExtension) {
+            continue;
+        }
+        Entry entry;
+        entry.path = item.path();
+        entry.modified = item.last_write_time(ec);
+        entry.size = item.file_size(ec);
+        total += entry.size;
+        entries.push_back(std::move(entry));
+    }
+    if (total <= m_config.max_bytes) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.modified < b.modified;
+    });
+    for (const auto& entry : entries) {
+        if (total <= m_config.max_bytes) {
+            break;
+        }
+        std::error_code removeError;
+        if (std::filesystem::remove(entry.path, removeError)) {
+            total -= entry.size;
+            std::cout << "[Stage1DatasetCache] Evicted " << entry.path.filename().string()
+                      << " (" << entry.size << " bytes)" << std::endl;
+        }
+    }
+}
+
+} // namespace stage1
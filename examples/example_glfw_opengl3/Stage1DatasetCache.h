@@ -0,0 +1,74 @@
+#pragma once
+
+#include <arrow/result.h>
+#include <arrow/status.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace arrow {
+class Table;
+}
+
+namespace stage1 {
+
+enum class DatasetPart;
+
+// What the Stage1 summary says about one part of a dataset. Two loads with
+// the same fingerprint see the same rows.
+struct DatasetFingerprint {
+    std::string dataset_id;
+    std::string updated_at;
+    int64_t row_count = 0;
+};
+
+struct DatasetCacheConfig {
+    std::string directory;              // Empty: <temp>/stage1_cache
+    uint64_t max_bytes = 2ull << 30;    // Least recently used entries go first
+};
+
+// On-disk cache of downloaded dataset parts as Arrow IPC files.
+//
+// Entries are named by a hash of their fingerprint, so a changed dataset
+// never matches an old file. Hits are memory-mapped. An entry for the same
+// dataset with fewer rows is kept around as the base for a tail fetch until
+// the new version is stored. Each hit refreshes the entry's modification
+// time, which is what eviction orders by.
+//
+// STAGE1_CACHE_DIR and STAGE1_CACHE_MAX_MB override the defaults.
+class DatasetCache {
+public:
+    static DatasetCache& Instance();
+
+    void Configure(DatasetCacheConfig config);
+    DatasetCacheConfig Config() const;
+
+    // Null table when there is no entry for exactly this fingerprint
+    arrow::Result<std::shared_ptr<arrow::Table>> Load(const DatasetFingerprint& fingerprint,
+                                                      DatasetPart part);
+
+    // Newest entry of the dataset part with fewer than maxRows rows, for a
+    // tail fetch; with maxRows <= 0, the newest entry of any size
+    arrow::Result<std::shared_ptr<arrow::Table>> LoadLatest(const std::string& datasetId,
+                                                            DatasetPart part,
+                                                            int64_t maxRows,
+                                                            DatasetFingerprint* fingerprint);
+
+    // Replaces every older entry of the dataset part, then evicts down to max_bytes
+    arrow::Status Store(const DatasetFingerprint& fingerprint,
+                        DatasetPart part,
+                        const std::shared_ptr<arrow::Table>& table);
+
+private:
+    DatasetCache();
+
+    std::string EntryPath(const DatasetFingerprint& fingerprint, DatasetPart part) const;
+    void EvictLocked();
+
+    mutable std::mutex m_mutex;
+    DatasetCacheConfig m_config;
+};
+
+} // namespace stage1
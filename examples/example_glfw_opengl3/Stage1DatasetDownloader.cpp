@@ -0,0 +1,653 @@
+#include "Stage1DatasetDownloader.h"
+#include "Stage1DatasetCache.h"
+#include "Stage1RestClient.h"
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/api.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace stage1 {
+
+namespace {
+
+const char* PartName(DatasetPart part) {
+    return part == DatasetPart::Ohlcv ? "ohlcv" : "indicators";
+}
+
+// "<dataset id>_<part>_", shared by every spill layout of that part. Bytes
+// other than [A-Za-z0-9-] are escaped as "_XX" (hex), so the escaped id
+// is lossless and the '_' before the part name, never followed by two hex
+// digits, ends it: no other dataset's directories share the prefix.
+std::string SpillPrefix(const std::string& datasetId, DatasetPart part) {
+    static constexpr char kHex[] = "0123456789ABCDEF";
+    std::string prefix;
+    for (char ch : datasetId) {
+        const auto byte = static_cast<unsigned char>(ch);
+        if (std::isalnum(byte) || ch == '-') {
+            prefix.push_back(ch);
+        } else {
+            prefix.push_back('_');
+            prefix.push_back(kHex[byte >> 4]);
+            prefix.push_back(kHex[byte & 0x0F]);
+        }
+    }
+    return prefix + '_' + PartName(part) + '_';
+}
+
+// Pages probed before the remaining pages are fetched in parallel
+constexpr int64_t kProbePages = 2;
+
+uint64_t Fnv1a(const std::string& text) {
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char ch : text) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Exclusive lock on one file for the lifetime of the object. The OS drops it
+// when the process exits, so a crashed run never blocks the next one.
+class SpillLock {
+public:
+    explicit SpillLock(const std::string& path) {
+#if defined(_WIN32)
+        if (_sopen_s(&m_fd, path.c_str(), _O_CREAT | _O_RDWR, _SH_DENYRW, _S_IREAD | _S_IWRITE) != 0) {
+            m_fd = -1;
+        }
+#else
+        m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (m_fd >= 0 && flock(m_fd, LOCK_EX | LOCK_NB) != 0) {
+            close(m_fd);
+            m_fd = -1;
+        }
+#endif
+    }
+
+    ~SpillLock() {
+        if (m_fd >= 0) {
+#if defined(_WIN32)
+            _close(m_fd);
+#else
+            close(m_fd);
+#endif
+        }
+    }
+
+    SpillLock(const SpillLock&) = delete;
+    SpillLock& operator=(const SpillLock&) = delete;
+
+    bool Held() const { return m_fd >= 0; }
+
+private:
+    int m_fd = -1;
+};
+
+std::string PageFileName(int64_t index) {
+    std::ostringstream name;
+    name << "page_" << std::setw(6) << std::setfill('0') << index << ".arrow";
+    return name.str();
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> ReadSpilledPage(const std::string& path) {
+    ARROW_ASSIGN_OR_RAISE(auto file, arrow::io::ReadableFile::Open(path));
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(file));
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    batches.reserve(reader->num_record_batches());
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(i));
+        batches.push_back(std::move(batch));
+    }
+    ARROW_RETURN_NOT_OK(file->Close());
+    return arrow::Table::FromRecordBatches(reader->schema(), batches);
+}
+
+arrow::Status WriteSpilledPage(const std::string& path, const arrow::Table& page) {
+    const std::string tempPath = path + ".tmp";
+    {
+        ARROW_ASSIGN_OR_RAISE(auto output, arrow::io::FileOutputStream::Open(tempPath));
+        ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(
+            output, page.schema(), arrow::ipc::IpcWriteOptions::Defaults()));
+        ARROW_RETURN_NOT_OK(writer->WriteTable(page));
+        ARROW_RETURN_NOT_OK(writer->Close());
+        ARROW_RETURN_NOT_OK(output->Close());
+    }
+    // A resumed run never sees a half-written page
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return arrow::Status::IOError("Failed to move page into place: ", path);
+    }
+    return arrow::Status::OK();
+}
+
+// First and last timestamp_ms of a page, if it has them
+bool PageTimestampRange(const arrow::Table& page, int64_t* first, int64_t* last) {
+    auto column = page.GetColumnByName("timestamp_ms");
+    if (!column || column->length() == 0 || column->type()->id() != arrow::Type::INT64) {
+        return false;
+    }
+    auto head = column->GetScalar(0);
+    auto tail = column->GetScalar(column->length() - 1);
+    if (!head.ok() || !tail.ok() || !(*head)->is_valid || !(*tail)->is_valid) {
+        return false;
+    }
+    *first = std::static_pointer_cast<arrow::Int64Scalar>(*head)->value;
+    *last = std::static_pointer_cast<arrow::Int64Scalar>(*tail)->value;
+    return true;
+}
+
+// True when each page starts at or after the end of the one before it.
+// A server that ignores the offset returns the first page every time.
+bool PagesInOrder(const std::vector<std::shared_ptr<arrow::Table>>& pages) {
+    bool havePrevious = false;
+    int64_t previousLast = 0;
+    for (const auto& page : pages) {
+        int64_t first = 0;
+        int64_t last = 0;
+        if (!PageTimestampRange(*page, &first, &last)) {
+            continue;
+        }
+        if (havePrevious && first < previousLast) {
+            return false;
+        }
+        havePrevious = true;
+        previousLast = last;
+    }
+    return true;
+}
+
+// Pages decoded from JSON type each column by its first non-null value, so
+// a column that is all null on one page comes back as float64 there. The
+// type is taken from the first page with real values, and other pages are
+// padded or cast to it before concatenation.
+arrow::Result<std::shared_ptr<arrow::Table>> AssemblePages(const std::vector<std::shared_ptr<arrow::Table>>& pages) {
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::shared_ptr<arrow::DataType>> types;
+    std::unordered_map<std::string, bool> decided;
+    for (const auto& page : pages) {
+        for (int i = 0; i < page->num_columns(); ++i) {
+            const auto& field = page->schema()->field(i);
+            const auto& column = page->column(i);
+            const bool hasValues = column->null_count() < column->length();
+            auto it = types.find(field->name());
+            if (it == types.end()) {
+                names.push_back(field->name());
+                types.emplace(field->name(), field->type());
+                decided[field->name()] = hasValues;
+            } else if (!decided[field->name()] && hasValues) {
+                it->second = field->type();
+                decided[field->name()] = true;
+            }
+        }
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    fields.reserve(names.size());
+    for (const auto& name : names) {
+        fields.push_back(arrow::field(name, types[name]));
+    }
+    auto schema = arrow::schema(fields);
+
+    std::vector<std::shared_ptr<arrow::Table>> aligned;
+    aligned.reserve(pages.size());
+    for (const auto& page : pages) {
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+        columns.reserve(names.size());
+        for (const auto& field : fields) {
+            auto column = page->GetColumnByName(field->name());
+            if (!column || column->null_count() == column->length()) {
+                ARROW_ASSIGN_OR_RAISE(auto nulls, arrow::MakeArrayOfNull(field->type(), page->num_rows()));
+                columns.push_back(std::make_shared<arrow::ChunkedArray>(nulls));
+            } else if (!column->type()->Equals(field->type())) {
+                ARROW_ASSIGN_OR_RAISE(auto cast, arrow::compute::Cast(column, field->type()));
+                columns.push_back(cast.chunked_array());
+            } else {
+                columns.push_back(column);
+            }
+        }
+        aligned.push_back(arrow::Table::Make(schema, std::move(columns), page->num_rows()));
+    }
+    return arrow::ConcatenateTables(aligned);
+}
+
+} // namespace
+
+DatasetDownloader::DatasetDownloader(std::string datasetId,
+                                     DatasetPart part,
+                                     DatasetDownloadOptions options)
+    : m_datasetId(std::move(datasetId)),
+      m_part(part),
+      m_options(std::move(options)) {
+    m_options.page_rows = std::max(m_options.page_rows, 1);
+    m_options.parallel_pages = std::max(m_options.parallel_pages, 1);
+}
+
+DatasetDownloadProgress DatasetDownloader::Progress() const {
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    return m_progress;
+}
+
+bool DatasetDownloader::FetchPage(int64_t offset, int limit,
+                                  std::shared_ptr<arrow::Table>* page, std::string* error) {
+    RestClient& api = RestClient::Instance();
+    const bool ok = m_part == DatasetPart::Ohlcv
+        ? api.FetchDatasetOhlcvTable(m_datasetId, page, error, limit, offset)
+        : api.FetchDatasetIndicatorTable(m_datasetId, page, error, limit, offset);
+    // Timing is per thread, so this is the request just made here
+    const int64_t bytes = RestClient::LastRequestTiming().bytes_received;
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    m_progress.bytes_received += bytes;
+    return ok;
+}
+
+bool DatasetDownloader::LoadOrFetchPage(const std::string& spillDir, int64_t index, int64_t offset,
+                                        std::shared_ptr<arrow::Table>* page, std::string* error) {
+    const std::string path = spillDir.empty()
+        ? std::string()
+        : (std::filesystem::path(spillDir) / PageFileName(index)).string();
+
+    std::error_code ec;
+    if (!path.empty() && std::filesystem::exists(path, ec)) {
+        auto spilled = ReadSpilledPage(path);
+        if (spilled.ok()) {
+            *page = std::move(spilled).ValueOrDie();
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            ++m_progress.pages_resumed;
+            return true;
+        }
+        std::cerr << "[Stage1DatasetDownloader] Discarding unreadable page " << path << ": "
+                  << spilled.status().ToString() << std::endl;
+        std::filesystem::remove(path, ec);
+    }
+
+    if (!FetchPage(offset, m_options.page_rows, page, error)) {
+        return false;
+    }
+    if (!path.empty()) {
+        auto status = WriteSpilledPage(path, **page);
+        if (!status.ok()) {
+            // Only resume is lost; the page itself is fine
+            std::cerr << "[Stage1DatasetDownloader] Failed to spill page " << index << ": "
+                      << status.ToString() << std::endl;
+        }
+    }
+    return true;
+}
+
+std::string DatasetDownloader::SpillDirectory(int64_t rowsTotal, int64_t startRow,
+                                              const std::string& updatedAt) const {
+    std::filesystem::path root(m_options.spill_directory);
+    if (root.empty()) {
+        std::error_code ec;
+        root = std::filesystem::temp_directory_path(ec);
+        if (ec) {
+            return {};
+        }
+        root /= "stage1_spill";
+    }
+
+    // The layout and the dataset version are part of the name, so pages from
+    // a run with a different row count, start row or page size, or of a
+    // dataset rewritten since, are never mixed in
+    std::ostringstream leaf;
+    leaf << SpillPrefix(m_datasetId, m_part) << rowsTotal << "r_";
+    if (startRow > 0) {
+        leaf << startRow << "s_";
+    }
+    leaf << m_options.page_rows << "p_"
+         << std::hex << std::setw(16) << std::setfill('0') << Fnv1a(updatedAt);
+    return (root / leaf.str()).string();
+}
+
+bool DatasetDownloader::Run(std::shared_ptr<arrow::Table>* table, std::string* error) {
+    if (!table) {
+        if (error) *error = "Table container is null.";
+        return false;
+    }
+    m_cancelled.store(false);
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_progress = DatasetDownloadProgress();
+        m_progress.active = true;
+    }
+    auto finish = [this](bool ok) {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_progress.active = false;
+        return ok;
+    };
+
+    RestClient& api = RestClient::Instance();
+    DatasetSummary summary;
+    std::string summaryError;
+    const bool haveSummary = api.FetchDataset(m_datasetId, &summary, &summaryError);
+    int64_t rowsTotal = 0;
+    if (haveSummary) {
+        rowsTotal = m_part == DatasetPart::Ohlcv ? summary.ohlcv_row_count : summary.indicator_row_count;
+    }
+
+    DatasetCache& cache = DatasetCache::Instance();
+    DatasetFingerprint fingerprint;
+    fingerprint.dataset_id = m_datasetId;
+    fingerprint.updated_at = summary.updated_at;
+    fingerprint.row_count = rowsTotal;
+    const bool cacheable = m_options.use_cache && haveSummary && rowsTotal > 0;
+
+    auto serveCached = [&](std::shared_ptr<arrow::Table> cached, const char* what) {
+        *table = std::move(cached);
+        {
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            m_progress.rows_total = (*table)->num_rows();
+            m_progress.rows_done = m_progress.rows_total;
+            m_progress.rows_cached = m_progress.rows_total;
+        }
+        std::cout << "[Stage1DatasetDownloader] " << m_datasetId << ' ' << PartName(m_part) << ": "
+                  << (*table)->num_rows() << " rows from " << what << std::endl;
+        return finish(true);
+    };
+
+    if (cacheable) {
+        auto hit = cache.Load(fingerprint, m_part);
+        if (!hit.ok()) {
+            std::cerr << "[Stage1DatasetDownloader] Ignoring cache entry: " << hit.status().ToString() << std::endl;
+        } else if (*hit) {
+            return serveCached(std::move(hit).ValueOrDie(), "the local cache");
+        }
+    } else if (!haveSummary) {
+        if (m_options.use_cache) {
+            auto latest = cache.LoadLatest(m_datasetId, m_part, 0, nullptr);
+            if (latest.ok() && *latest) {
+                std::cerr << "[Stage1DatasetDownloader] No summary for " << m_datasetId << " ("
+                          << summaryError << "); using the last cached copy" << std::endl;
+                return serveCached(std::move(latest).ValueOrDie(), "a possibly stale cache entry");
+            }
+        }
+        std::cerr << "[Stage1DatasetDownloader] No summary for " << m_datasetId << " ("
+                  << summaryError << "); fetching in one request" << std::endl;
+    }
+
+    auto storeInCache = [&]() {
+        if (!cacheable) {
+            return;
+        }
+        auto status = cache.Store(fingerprint, m_part, *table);
+        if (!status.ok()) {
+            std::cerr << "[Stage1DatasetDownloader] Failed to cache " << m_datasetId << ": "
+                      << status.ToString() << std::endl;
+        }
+    };
+
+    auto fetchWhole = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            m_progress.pages_total = 1;
+            m_progress.pages_done = 0;
+            m_progress.rows_total = rowsTotal;
+            m_progress.rows_done = 0;
+            m_progress.rows_cached = 0;
+        }
+        if (!FetchPage(0, 0, table, error)) {
+            return finish(false);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            m_progress.pages_done = 1;
+            m_progress.rows_done = (*table)->num_rows();
+            m_progress.rows_total = std::max(rowsTotal, m_progress.rows_done);
+        }
+        storeInCache();
+        return finish(true);
+    };
+
+    // Appended rows only: an older copy with fewer rows is the prefix, and
+    // the pages below start where it ends
+    std::shared_ptr<arrow::Table> base;
+    if (cacheable) {
+        auto prior = cache.LoadLatest(m_datasetId, m_part, rowsTotal, nullptr);
+        if (prior.ok() && *prior && (*prior)->num_rows() > 0 && (*prior)->num_rows() < rowsTotal) {
+            base = std::move(prior).ValueOrDie();
+        }
+    }
+    const int64_t startRow = base ? base->num_rows() : 0;
+
+    const int pageRows = m_options.page_rows;
+    if (!base && rowsTotal <= pageRows) {
+        return fetchWhole();
+    }
+
+    const int64_t pagesTotal = (rowsTotal - startRow + pageRows - 1) / pageRows;
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_progress.pages_total = pagesTotal;
+        m_progress.rows_total = rowsTotal;
+        m_progress.rows_done = startRow;
+        m_progress.rows_cached = startRow;
+    }
+
+    // Only the run holding the part's lock file reads, writes or removes
+    // its spill directories; a concurrent run of the same part goes without
+    std::string spillDir = SpillDirectory(rowsTotal, startRow, summary.updated_at);
+    std::unique_ptr<SpillLock> spillLock;
+    if (!spillDir.empty()) {
+        std::error_code ec;
+        const std::filesystem::path dir(spillDir);
+        const std::string prefix = SpillPrefix(m_datasetId, m_part);
+        const std::string lockName = prefix + "lock";
+        std::filesystem::create_directories(dir, ec);
+        if (!ec) {
+            spillLock = std::make_unique<SpillLock>((dir.parent_path() / lockName).string());
+        }
+        if (ec) {
+            std::cerr << "[Stage1DatasetDownloader] Spill disabled, cannot create " << spillDir
+                      << ": " << ec.message() << std::endl;
+            spillDir.clear();
+        } else if (!spillLock->Held()) {
+            std::cerr << "[Stage1DatasetDownloader] Spill disabled, another download of "
+                      << m_datasetId << ' ' << PartName(m_part) << " holds " << lockName << std::endl;
+            spillDir.clear();
+        } else {
+            // Pages of an older layout of this dataset can never be resumed
+            for (const auto& entry : std::filesystem::directory_iterator(dir.parent_path(), ec)) {
+                const std::string name = entry.path().filename().string();
+                if (name != dir.filename().string() && name != lockName && name.rfind(prefix, 0) == 0) {
+                    std::filesystem::remove_all(entry.path(), ec);
+                }
+            }
+        }
+    }
+
+    auto discardSpill = [&]() {
+        if (!spillDir.empty()) {
+            std::error_code ec;
+            std::filesystem::remove_all(spillDir, ec);
+        }
+    };
+
+    std::vector<std::shared_ptr<arrow::Table>> pages(static_cast<size_t>(pagesTotal));
+
+    // Every planned page but the last holds exactly page_rows rows, and the
+    // last at least the remainder. A server that caps limit, or a short
+    // page, would otherwise leave a silent gap PagesInOrder cannot see.
+    auto firstShortPage = [&](int64_t count) -> int64_t {
+        for (int64_t index = 0; index < count; ++index) {
+            const int64_t rows = pages[static_cast<size_t>(index)]->num_rows();
+            const bool complete = index + 1 < pagesTotal
+                ? rows == pageRows
+                : rows >= rowsTotal - startRow - index * pageRows;
+            if (!complete) {
+                return index;
+            }
+        }
+        return -1;
+    };
+    auto refetchShort = [&](int64_t index) {
+        std::cerr << "[Stage1DatasetDownloader] Page " << (index + 1) << " of " << pagesTotal << " holds "
+                  << pages[static_cast<size_t>(index)]->num_rows() << " rows, expected "
+                  << std::min<int64_t>(pageRows, rowsTotal - startRow - index * pageRows)
+                  << ". Fetching " << m_datasetId << " in one request" << std::endl;
+        discardSpill();
+        return fetchWhole();
+    };
+
+    // The first pages go alone: a server that ignores offset, or a cached
+    // prefix that was rewritten, shows up here before the rest is fetched
+    const int64_t probePages = std::min(pagesTotal, kProbePages);
+    for (int64_t index = 0; index < probePages; ++index) {
+        std::string pageError;
+        if (!LoadOrFetchPage(spillDir, index, startRow + index * pageRows, &pages[static_cast<size_t>(index)], &pageError)) {
+            if (error) {
+                *error = "Page " + std::to_string(index + 1) + " of " + std::to_string(pagesTotal) + ": " + pageError;
+            }
+            return finish(false);
+        }
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        ++m_progress.pages_done;
+        m_progress.rows_done += pages[static_cast<size_t>(index)]->num_rows();
+    }
+    std::vector<std::shared_ptr<arrow::Table>> probed(pages.begin(), pages.begin() + probePages);
+    if (base) {
+        probed.insert(probed.begin(), base);
+    }
+    if (!PagesInOrder(probed)) {
+        std::cerr << "[Stage1DatasetDownloader] Pages overlap"
+                  << (base ? " the cached rows" : "; the server does not honour offset")
+                  << ". Fetching " << m_datasetId << " in one request" << std::endl;
+        discardSpill();
+        return fetchWhole();
+    }
+    if (const int64_t shortPage = firstShortPage(probePages); shortPage >= 0) {
+        return refetchShort(shortPage);
+    }
+
+    std::atomic<int64_t> nextPage{ probePages };
+    std::atomic<bool> failed{ false };
+    std::mutex errorMutex;
+    std::string firstError;
+
+    auto worker = [&]() {
+        while (!failed.load() && !m_cancelled.load()) {
+            const int64_t index = nextPage.fetch_add(1);
+            if (index >= pagesTotal) {
+                return;
+            }
+            std::shared_ptr<arrow::Table> page;
+            std::string pageError;
+            const int64_t offset = startRow + index * pageRows;
+            if (!LoadOrFetchPage(spillDir, index, offset, &page, &pageError)) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!failed.exchange(true)) {
+                    firstError = "Page " + std::to_string(index + 1) + " of " +
+                                 std::to_string(pagesTotal) + ": " + pageError;
+                }
+                return;
+            }
+            const int64_t rows = page->num_rows();
+            pages[static_cast<size_t>(index)] = std::move(page);
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            ++m_progress.pages_done;
+            m_progress.rows_done += rows;
+        }
+    };
+
+    const int64_t threadCount = std::min<int64_t>(m_options.parallel_pages, pagesTotal - probePages);
+    std::vector<std::thread> threads;
+    threads.reserve(static_cast<size_t>(threadCount));
+    for (int64_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (failed.load() || m_cancelled.load()) {
+        if (error) {
+            *error = failed.load() ? firstError : std::string("Download cancelled.");
+            if (!spillDir.empty()) {
+                *error += " Finished pages are kept in " + spillDir + " for the next attempt.";
+            }
+        }
+        return finish(false);
+    }
+
+    if (const int64_t shortPage = firstShortPage(pagesTotal); shortPage >= 0) {
+        return refetchShort(shortPage);
+    }
+    if (base) {
+        pages.insert(pages.begin(), base);
+    }
+    if (!PagesInOrder(pages)) {
+        // The probe passed, so the data changed underneath the download
+        std::cerr << "[Stage1DatasetDownloader] Pages overlap after the first " << probePages
+                  << ". Fetching " << m_datasetId << " in one request" << std::endl;
+        discardSpill();
+        return fetchWhole();
+    }
+
+    // Rows appended since the summary was read land after the last planned page
+    while (pages.back()->num_rows() == pageRows && !m_cancelled.load()) {
+        std::shared_ptr<arrow::Table> page;
+        const int64_t offset = startRow + static_cast<int64_t>(pages.size() - (base ? 1 : 0)) * pageRows;
+        if (!FetchPage(offset, pageRows, &page, error)) {
+            return finish(false);
+        }
+        if (page->num_rows() == 0) {
+            break;
+        }
+        pages.push_back(std::move(page));
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        ++m_progress.pages_total;
+        ++m_progress.pages_done;
+        m_progress.rows_done += pages.back()->num_rows();
+        m_progress.rows_total = std::max(m_progress.rows_total, m_progress.rows_done);
+    }
+
+    auto assembled = AssemblePages(pages);
+    if (!assembled.ok()) {
+        if (error) *error = "Failed to assemble pages: " + assembled.status().ToString();
+        return finish(false);
+    }
+    *table = std::move(assembled).ValueOrDie();
+    if ((*table)->num_rows() < rowsTotal) {
+        std::cerr << "[Stage1DatasetDownloader] Assembled " << (*table)->num_rows() << " of " << rowsTotal
+                  << " rows. Fetching " << m_datasetId << " in one request" << std::endl;
+        discardSpill();
+        return fetchWhole();
+    }
+    storeInCache();
+
+    if (!m_options.keep_spill) {
+        discardSpill();
+    }
+
+    const auto progress = Progress();
+    std::cout << "[Stage1DatasetDownloader] " << m_datasetId << ' ' << PartName(m_part) << ": "
+              << (*table)->num_rows() << " rows in " << progress.pages_done << " pages ("
+              << progress.rows_cached << " rows cached, " << progress.pages_resumed << " pages resumed, "
+              << progress.bytes_received << " bytes)" << std::endl;
+    return finish(true);
+}
+
+} // namespace stage1
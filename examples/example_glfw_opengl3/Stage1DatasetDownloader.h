@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace arrow {
+class Table;
+}
+
+namespace stage1 {
+
+enum class DatasetPart { Ohlcv, Indicators };
+
+struct DatasetDownloadOptions {
+    int page_rows = 50000;
+    int parallel_pages = 4;             // Pages in flight at once
+    std::string spill_directory;        // Empty: <temp>/stage1_spill
+    bool keep_spill = false;            // Keep page files after a successful run
+    bool use_cache = true;              // Serve and store through DatasetCache
+};
+
+struct DatasetDownloadProgress {
+    bool active = false;
+    int64_t pages_total = 0;            // 0 until the row count is known
+    int64_t pages_done = 0;
+    int64_t pages_resumed = 0;          // Read back from the spill directory
+    int64_t rows_total = 0;
+    int64_t rows_done = 0;              // Includes rows_cached
+    int64_t rows_cached = 0;            // Served from the local dataset cache
+    int64_t bytes_received = 0;
+};
+
+// Downloads one part of a Stage1 dataset as offset pages.
+//
+// The row count from the dataset summary decides the page layout. Pages are
+// fetched and decoded on parallel_pages threads over the RestClient's pooled
+// connections, and each decoded page is written to the spill directory as an
+// Arrow IPC file. A run that fails or is cancelled leaves those files behind,
+// and the next run for the same dataset version (updated_at) and layout
+// reads them back instead of fetching again. The spill files of a dataset
+// part belong to whichever run holds its lock file; a concurrent run of the
+// same part downloads without spilling. The first two pages are fetched and
+// checked before the others, so a server that ignores offset or caps limit
+// costs two pages, not a full extra download; a short page found later also
+// falls back to a single request. Progress() may be polled from another
+// thread while Run() is working.
+//
+// With use_cache, a summary that matches a cached copy is served from disk
+// without downloading anything. When the dataset only grew, the cached rows
+// are kept and just the new tail is downloaded.
+class DatasetDownloader {
+public:
+    DatasetDownloader(std::string datasetId,
+                      DatasetPart part,
+                      DatasetDownloadOptions options = DatasetDownloadOptions());
+
+    // Blocks until every page is assembled, in row order, into one table
+    bool Run(std::shared_ptr<arrow::Table>* table, std::string* error);
+
+    void Cancel() { m_cancelled.store(true); }
+    DatasetDownloadProgress Progress() const;
+
+private:
+    bool FetchPage(int64_t offset, int limit,
+                   std::shared_ptr<arrow::Table>* page, std::string* error);
+    bool LoadOrFetchPage(const std::string& spillDir, int64_t index, int64_t offset,
+                         std::shared_ptr<arrow::Table>* page, std::string* error);
+    std::string SpillDirectory(int64_t rowsTotal, int64_t startRow, const std::string& updatedAt) const;
+
+    std::string m_datasetId;
+    DatasetPart m_part;
+    DatasetDownloadOptions m_options;
+    std::atomic<bool> m_cancelled{ false };
+
+    mutable std::mutex m_progressMutex;
+    DatasetDownloadProgress m_progress;
+};
+
+} // namespace stage1
@@ -2,6 +2,7 @@
 
 #include "Stage1DatasetManifest.h"
 #include "Stage1RestClient.h"
+#include "Stage1RowUploader.h"
 #include "TimeSeriesWindow.h"
 #include "candlestick_chart.h"
 #include "stage1_metadata_writer.h"
@@ -10,6 +11,9 @@
 #include <arrow/table.h>
 #include <arrow/scalar.h>
 #include <arrow/type.h>
+#include <arrow/array.h>
+#include <arrow/array/concatenate.h>
+#include <arrow/compute/api.h>
 #include <cstring>
 #include <cstdio>
 #include <cctype>
@@ -22,8 +26,10 @@
 #include <sstream>
 #include <exception>
 #include <unordered_set>
-#include <json/json.h>
 #include <array>
+#include <algorithm>
+#include <charconv>
+#include <memory>
 
 namespace {
 
@@ -196,50 +202,6 @@ std::optional<int64_t> ScalarToMillis(const std::shared_ptr<arrow::Scalar>& scal
     return std::nullopt;
 }
 
-bool ScalarToDouble(const std::shared_ptr<arrow::Scalar>& scalar, double* out) {
-    if (!scalar || !scalar->is_valid || !out) {
-        return false;
-    }
-    switch (scalar->type->id()) {
-        case arrow::Type::DOUBLE:
-            *out = std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value;
-            return std::isfinite(*out);
-        case arrow::Type::FLOAT:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
-            return std::isfinite(*out);
-        case arrow::Type::INT64:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::INT32:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::Int32Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::INT16:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::Int16Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::INT8:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::Int8Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::UINT64:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::UInt64Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::UINT32:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::UInt32Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::UINT16:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::UInt16Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::UINT8:
-            *out = static_cast<double>(std::static_pointer_cast<arrow::UInt8Scalar>(scalar)->value);
-            return true;
-        case arrow::Type::BOOL:
-            *out = std::static_pointer_cast<arrow::BooleanScalar>(scalar)->value ? 1.0 : 0.0;
-            return true;
-        default:
-            break;
-    }
-    return false;
-}
-
 std::optional<int64_t> ComputeBarIntervalMs(const CandlestickChart* chart) {
     if (!chart) {
         return std::nullopt;
@@ -342,20 +304,136 @@ std::filesystem::path ManifestDirectory(const std::string& slug) {
     return base / slug;
 }
 
-constexpr std::size_t kStage1AppendBatchSize = 10000;
+void AppendJsonKey(std::string* out, const std::string& name) {
+    out->push_back('"');
+    for (char ch : name) {
+        switch (ch) {
+            case '"': out->append("\\\""); break;
+            case '\\': out->append("\\\\"); break;
+            case '\n': out->append("\\n"); break;
+            case '\r': out->append("\\r"); break;
+            case '\t': out->append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(ch));
+                    out->append(escaped);
+                } else {
+                    out->push_back(ch);
+                }
+        }
+    }
+    out->append("\":");
+}
 
-bool FlushRowBatch(const std::string& datasetId,
-                   Json::Value* rows,
-                   stage1::RestClient::AppendTarget target,
-                   std::string* error) {
-    if (!rows || !rows->isArray() || rows->empty()) {
-        return true;
+void AppendInt(std::string* out, int64_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out->append(buffer, result.ptr);
+}
+
+// Shortest text that reads back as the same double
+void AppendDouble(std::string* out, double value) {
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out->append(buffer, result.ptr);
+}
+
+// JSON has no nan or inf; those go out as null
+void AppendNumberOrNull(std::string* out, double value) {
+    if (std::isfinite(value)) {
+        AppendDouble(out, value);
+    } else {
+        out->append("null");
     }
-    Json::Value payload(Json::objectValue);
-    payload["rows"] = *rows;
-    bool ok = stage1::RestClient::Instance().AppendDatasetRows(datasetId, payload, target, error);
-    *rows = Json::Value(Json::arrayValue);
-    return ok;
+}
+
+// Indicator columns resolved once, so batches are written straight from the
+// column buffers instead of through a Scalar per cell
+struct IndicatorUploadColumns {
+    std::vector<int64_t> timestamps;    // 0 where the row has none
+    struct Values {
+        std::string key;                // Already quoted, with the colon
+        std::shared_ptr<arrow::DoubleArray> data;
+    };
+    std::vector<Values> values;
+};
+
+arrow::Result<std::shared_ptr<arrow::Array>> CombinedChunks(const std::shared_ptr<arrow::ChunkedArray>& column) {
+    if (column->num_chunks() == 1) {
+        return column->chunk(0);
+    }
+    if (column->num_chunks() == 0) {
+        return arrow::MakeArrayOfNull(column->type(), 0);
+    }
+    return arrow::Concatenate(column->chunks());
+}
+
+arrow::Status ResolveIndicatorUploadColumns(const std::shared_ptr<arrow::Table>& table,
+                                            int timestampIdx,
+                                            const std::vector<int>& valueColumns,
+                                            IndicatorUploadColumns* resolved) {
+    const int64_t rows = table->num_rows();
+    resolved->timestamps.assign(static_cast<size_t>(rows), 0);
+    ARROW_ASSIGN_OR_RAISE(auto timestamps, CombinedChunks(table->column(timestampIdx)));
+    switch (timestamps->type_id()) {
+        case arrow::Type::INT64:
+        case arrow::Type::INT32:
+        case arrow::Type::TIMESTAMP: {
+            int64_t scale = 1;
+            int64_t divisor = 1;
+            if (timestamps->type_id() == arrow::Type::TIMESTAMP) {
+                switch (std::static_pointer_cast<arrow::TimestampType>(timestamps->type())->unit()) {
+                    case arrow::TimeUnit::SECOND: scale = 1000; break;
+                    case arrow::TimeUnit::MILLI: break;
+                    case arrow::TimeUnit::MICRO: divisor = 1000; break;
+                    case arrow::TimeUnit::NANO: divisor = 1000000; break;
+                }
+            }
+            ARROW_ASSIGN_OR_RAISE(auto asInt, arrow::compute::Cast(timestamps, arrow::int64(),
+                                                                   arrow::compute::CastOptions::Unsafe()));
+            auto ints = std::static_pointer_cast<arrow::Int64Array>(asInt);
+            for (int64_t i = 0; i < rows; ++i) {
+                if (ints->IsValid(i)) {
+                    resolved->timestamps[static_cast<size_t>(i)] = ints->Value(i) * scale / divisor;
+                }
+            }
+            break;
+        }
+        case arrow::Type::DOUBLE:
+        case arrow::Type::FLOAT: {
+            ARROW_ASSIGN_OR_RAISE(auto asDouble, arrow::compute::Cast(timestamps, arrow::float64()));
+            auto doubles = std::static_pointer_cast<arrow::DoubleArray>(asDouble);
+            for (int64_t i = 0; i < rows; ++i) {
+                if (doubles->IsValid(i) && std::isfinite(doubles->Value(i))) {
+                    resolved->timestamps[static_cast<size_t>(i)] = static_cast<int64_t>(std::llround(doubles->Value(i)));
+                }
+            }
+            break;
+        }
+        default:
+            // Text timestamps need parsing anyway; take the per-cell path
+            for (int64_t i = 0; i < rows; ++i) {
+                ARROW_ASSIGN_OR_RAISE(auto scalar, timestamps->GetScalar(i));
+                if (auto millis = ScalarToMillis(scalar)) {
+                    resolved->timestamps[static_cast<size_t>(i)] = *millis;
+                }
+            }
+            break;
+    }
+
+    const auto& schema = table->schema();
+    resolved->values.clear();
+    resolved->values.reserve(valueColumns.size());
+    for (int colIndex : valueColumns) {
+        ARROW_ASSIGN_OR_RAISE(auto combined, CombinedChunks(table->column(colIndex)));
+        ARROW_ASSIGN_OR_RAISE(auto asDouble, arrow::compute::Cast(combined, arrow::float64()));
+        IndicatorUploadColumns::Values values;
+        AppendJsonKey(&values.key, schema->field(colIndex)->name());
+        values.data = std::static_pointer_cast<arrow::DoubleArray>(asDouble);
+        resolved->values.push_back(std::move(values));
+    }
+    return arrow::Status::OK();
 }
 
 } // namespace
@@ -456,6 +534,51 @@ void Stage1DatasetManager::Draw() {
         ImGui::TextDisabled("(Load both OHLCV + indicator data first)");
     }
 
+    stage1::DatasetDownloadProgress download;
+    if (m_timeSeriesWindow && m_timeSeriesWindow->GetStage1DownloadProgress(&download)) {
+        const float fraction = download.rows_total > 0
+            ? static_cast<float>(static_cast<double>(download.rows_done) / static_cast<double>(download.rows_total))
+            : 0.0f;
+        char overlay[192];
+        std::snprintf(overlay, sizeof(overlay), "Indicators: page %lld/%lld, %lld/%lld rows (%lld cached), %.1f MB",
+                      static_cast<long long>(download.pages_done),
+                      static_cast<long long>(download.pages_total),
+                      static_cast<long long>(download.rows_done),
+                      static_cast<long long>(download.rows_total),
+                      static_cast<long long>(download.rows_cached),
+                      static_cast<double>(download.bytes_received) / (1024.0 * 1024.0));
+        ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-1.0f, 0.0f), overlay);
+        if (download.pages_resumed > 0) {
+            ImGui::TextDisabled("%lld page(s) resumed from the spill directory",
+                                static_cast<long long>(download.pages_resumed));
+        }
+    }
+
+    std::shared_ptr<stage1::RowUploader> upload;
+    std::string uploadLabel;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        upload = m_activeUpload;
+        uploadLabel = m_activeUploadLabel;
+    }
+    if (upload) {
+        const auto progress = upload->Progress();
+        const double seconds = std::max(progress.elapsed_seconds, 1e-3);
+        const float fraction = progress.rows_total > 0
+            ? static_cast<float>(static_cast<double>(progress.rows_serialized) / static_cast<double>(progress.rows_total))
+            : 0.0f;
+        char overlay[192];
+        std::snprintf(overlay, sizeof(overlay), "Uploading %s: %lld rows sent, %.1f MB/s, %.0f rows/s",
+                      uploadLabel.c_str(),
+                      static_cast<long long>(progress.rows_sent),
+                      static_cast<double>(progress.bytes_sent) / (1024.0 * 1024.0) / seconds,
+                      static_cast<double>(progress.rows_sent) / seconds);
+        ImGui::ProgressBar(std::min(fraction, 1.0f), ImVec2(-1.0f, 0.0f), overlay);
+        if (progress.retries > 0) {
+            ImGui::TextDisabled("%lld batch retries", static_cast<long long>(progress.retries));
+        }
+    }
+
     if (!m_statusMessage.empty()) {
         const ImVec4 color = m_statusSuccess
             ? ImVec4(0.2f, 0.8f, 0.2f, 1.0f)
@@ -970,65 +1093,44 @@ bool Stage1DatasetManager::UploadOhlcvRowsToStage1(const std::string& datasetId,
         return false;
     }
 
-    Json::Value rows(Json::arrayValue);
-    size_t appended = 0;
-    size_t totalRows = raw.size();
+    const size_t totalRows = raw.size();
     std::cout << "[UploadOhlcvRows] Starting upload of " << totalRows << " OHLCV rows..." << std::endl;
 
-    // Debug: Check what unit candle.time is in
-    if (!raw.empty()) {
-        double firstTime = raw.front().time;
-        double lastTime = raw.back().time;
-        std::cout << "[UploadOhlcvRows] First candle.time: " << std::fixed << firstTime << std::endl;
-        std::cout << "[UploadOhlcvRows] Last candle.time: " << std::fixed << lastTime << std::endl;
-
-        // Check if it looks like seconds (< 10 billion) or milliseconds (> 100 billion)
-        if (firstTime > 100'000'000'000.0) {
-            std::cout << "[UploadOhlcvRows] WARNING: candle.time appears to be in milliseconds already!" << std::endl;
-        } else if (firstTime > 1'000'000'000.0 && firstTime < 10'000'000'000.0) {
-            std::cout << "[UploadOhlcvRows] candle.time appears to be in seconds (expected)" << std::endl;
-        } else {
-            std::cout << "[UploadOhlcvRows] WARNING: candle.time has unexpected magnitude!" << std::endl;
-        }
-    }
-
-    for (const auto& candle : raw) {
-        Json::Value row(Json::objectValue);
-
-        // IMPORTANT: Check if candle.time is already in milliseconds
-        // If candle.time > 100 billion, it's likely already milliseconds
-        int64_t timestampMs;
-        if (candle.time > 100'000'000'000.0) {
-            // Already in milliseconds, don't multiply
-            timestampMs = static_cast<int64_t>(candle.time);
-            if (appended == 0) {
-                std::cout << "[UploadOhlcvRows] Using candle.time as-is (already milliseconds)" << std::endl;
-            }
-        } else {
-            // In seconds, convert to milliseconds
-            timestampMs = static_cast<int64_t>(candle.time) * 1000LL;
-            if (appended == 0) {
-                std::cout << "[UploadOhlcvRows] Converting candle.time from seconds to milliseconds" << std::endl;
+    // candle.time is normally seconds; a value past 100 billion is already ms
+    std::cout << "[UploadOhlcvRows] " << (raw.front().time > 100'000'000'000LL
+        ? "Using candle.time as-is (already milliseconds)"
+        : "Converting candle.time from seconds to milliseconds") << std::endl;
+
+    stage1::RowBatchSerializer serialize = [&raw](int64_t begin, int64_t end,
+                                                  std::string* out, std::string*) -> int64_t {
+        for (int64_t i = begin; i < end; ++i) {
+            const auto& candle = raw[static_cast<size_t>(i)];
+            const int64_t timestampMs = candle.time > 100'000'000'000LL
+                ? static_cast<int64_t>(candle.time)
+                : static_cast<int64_t>(candle.time) * 1000LL;
+            if (i > begin) {
+                out->push_back(',');
             }
+            out->append("{\"timestamp\":");
+            AppendInt(out, timestampMs);
+            out->append(",\"open\":");
+            AppendNumberOrNull(out, candle.open);
+            out->append(",\"high\":");
+            AppendNumberOrNull(out, candle.high);
+            out->append(",\"low\":");
+            AppendNumberOrNull(out, candle.low);
+            out->append(",\"close\":");
+            AppendNumberOrNull(out, candle.close);
+            out->append(",\"volume\":");
+            AppendNumberOrNull(out, candle.volume);
+            out->push_back('}');
         }
+        return end - begin;
+    };
 
-        row["timestamp"] = static_cast<Json::Int64>(timestampMs);
-        row["open"] = candle.open;
-        row["high"] = candle.high;
-        row["low"] = candle.low;
-        row["close"] = candle.close;
-        row["volume"] = candle.volume;
-        rows.append(row);
-        ++appended;
-        if (rows.size() >= kStage1AppendBatchSize) {
-            std::cout << "[UploadOhlcvRows] Uploading batch " << (appended / kStage1AppendBatchSize)
-                      << " (" << appended << "/" << totalRows << " rows)..." << std::endl;
-            if (!FlushRowBatch(datasetId, &rows, stage1::RestClient::AppendTarget::Ohlcv, error)) {
-                return false;
-            }
-        }
-    }
-    if (!FlushRowBatch(datasetId, &rows, stage1::RestClient::AppendTarget::Ohlcv, error)) {
+    int64_t appended = 0;
+    if (!RunRowUpload("OHLCV", stage1::RestClient::AppendTarget::Ohlcv, datasetId,
+                      static_cast<int64_t>(totalRows), serialize, &appended, error)) {
         return false;
     }
     if (appended == 0) {
@@ -1109,69 +1211,57 @@ bool Stage1DatasetManager::UploadIndicatorRowsToStage1(const std::string& datase
         return false;
     }
 
-    Json::Value rows(Json::arrayValue);
-    int64_t totalRows = table->num_rows();
-    size_t appended = 0;
+    IndicatorUploadColumns columns;
+    auto resolved = ResolveIndicatorUploadColumns(table, timestampIdx, valueColumns, &columns);
+    if (!resolved.ok()) {
+        if (error) *error = "Failed to read indicator columns: " + resolved.ToString();
+        return false;
+    }
+    const int64_t totalRows = table->num_rows();
     std::cout << "[UploadIndicatorRows] Starting upload of up to " << totalRows << " indicator rows..." << std::endl;
 
-    for (int64_t rowIndex = 0; rowIndex < totalRows; ++rowIndex) {
-        auto tsScalarResult = timestampData->GetScalar(rowIndex);
-        if (!tsScalarResult.ok()) {
-            if (error) {
-                *error = "Failed to read indicator timestamp at row "
-                    + std::to_string(rowIndex) + ": " + tsScalarResult.status().ToString();
-            }
-            return false;
-        }
-        auto tsScalar = tsScalarResult.ValueOrDie();
-        auto timestampMs = ScalarToMillis(tsScalar);
-        if (!timestampMs || *timestampMs <= 0) {
-            continue;
-        }
-
-        Json::Value row(Json::objectValue);
-        row["timestamp"] = static_cast<Json::Int64>(*timestampMs);
-        bool hasField = false;
-        for (int colIndex : valueColumns) {
-            auto column = table->column(colIndex);
-            if (!column) {
+    // Rows without a timestamp or without a single finite value are skipped
+    stage1::RowBatchSerializer serialize = [&columns](int64_t begin, int64_t end,
+                                                      std::string* out, std::string*) -> int64_t {
+        int64_t written = 0;
+        for (int64_t i = begin; i < end; ++i) {
+            const int64_t timestampMs = columns.timestamps[static_cast<size_t>(i)];
+            if (timestampMs <= 0) {
                 continue;
             }
-            auto scalarResult = column->GetScalar(rowIndex);
-            if (!scalarResult.ok()) {
-                continue;
-            }
-            auto scalar = scalarResult.ValueOrDie();
-            double numeric = 0.0;
-            if (!ScalarToDouble(scalar, &numeric)) {
-                continue;
+            const size_t rowStart = out->size();
+            if (written > 0) {
+                out->push_back(',');
             }
-            if (!std::isfinite(numeric)) {
-                continue;
+            out->append("{\"timestamp\":");
+            AppendInt(out, timestampMs);
+            bool hasField = false;
+            for (const auto& values : columns.values) {
+                if (values.data->IsNull(i)) {
+                    continue;
+                }
+                const double value = values.data->Value(i);
+                if (!std::isfinite(value)) {
+                    continue;
+                }
+                out->push_back(',');
+                out->append(values.key);
+                AppendDouble(out, value);
+                hasField = true;
             }
-            const std::string& name = schema->field(colIndex)->name();
-            if (name == timestampColumn) {
+            if (!hasField) {
+                out->resize(rowStart);
                 continue;
             }
-            row[name] = numeric;
-            hasField = true;
+            out->push_back('}');
+            ++written;
         }
-        if (!hasField) {
-            continue;
-        }
-
-        rows.append(row);
-        ++appended;
-        if (rows.size() >= kStage1AppendBatchSize) {
-            std::cout << "[UploadIndicatorRows] Uploading batch " << (appended / kStage1AppendBatchSize)
-                      << " (" << appended << "/" << totalRows << " rows processed)..." << std::endl;
-            if (!FlushRowBatch(datasetId, &rows, stage1::RestClient::AppendTarget::Indicators, error)) {
-                return false;
-            }
-        }
-    }
+        return written;
+    };
 
-    if (!FlushRowBatch(datasetId, &rows, stage1::RestClient::AppendTarget::Indicators, error)) {
+    int64_t appended = 0;
+    if (!RunRowUpload("indicator", stage1::RestClient::AppendTarget::Indicators, datasetId,
+                      totalRows, serialize, &appended, error)) {
         return false;
     }
     if (appended == 0) {
@@ -1182,6 +1272,25 @@ bool Stage1DatasetManager::UploadIndicatorRowsToStage1(const std::string& datase
     return true;
 }
 
+bool Stage1DatasetManager::RunRowUpload(const char* label,
+                                        stage1::RestClient::AppendTarget target,
+                                        const std::string& datasetId,
+                                        int64_t sourceRows,
+                                        const stage1::RowBatchSerializer& serialize,
+                                        int64_t* rowsSent,
+                                        std::string* error) {
+    auto uploader = std::make_shared<stage1::RowUploader>(target);
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        m_activeUpload = uploader;
+        m_activeUploadLabel = label;
+    }
+    const bool ok = uploader->Upload(datasetId, sourceRows, serialize, rowsSent, error);
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    m_activeUpload.reset();
+    return ok;
+}
+
 bool Stage1DatasetManager::EnsureStage1DatasetReady(const std::string& preferredId,
                                                     const std::string& slug,
                                                     std::string* resolvedId,
@@ -6,6 +6,9 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <memory>
+
+#include "Stage1RowUploader.h"
 
 class CandlestickChart;
 
@@ -57,6 +60,13 @@ private:
     bool UploadIndicatorRowsToStage1(const std::string& datasetId,
                                      const std::string& timestampColumn,
                                      std::string* error);
+    bool RunRowUpload(const char* label,
+                      stage1::RestClient::AppendTarget target,
+                      const std::string& datasetId,
+                      int64_t sourceRows,
+                      const stage1::RowBatchSerializer& serialize,
+                      int64_t* rowsSent,
+                      std::string* error);
     bool EnsureStage1DatasetReady(const std::string& preferredId,
                                   const std::string& slug,
                                   std::string* resolvedId,
@@ -79,6 +89,9 @@ private:
     std::thread m_exportThread;
     std::atomic<bool> m_exportInProgress{false};
     std::mutex m_statusMutex;
+    std::mutex m_uploadMutex;
+    std::shared_ptr<stage1::RowUploader> m_activeUpload;
+    std::string m_activeUploadLabel;
     void ExportCurrentDatasetAsync();
     void UpdateStatus(const std::string& message, bool success);
 };
@@ -28,6 +28,7 @@ struct CliOptions {
     std::string date_column = "Date";
     std::string time_column = "Time";
     std::string time_format = "hhmm";
+    bool prewarm_cache = false;
 };
 
 void PrintUsage(const char* exe) {
@@ -39,7 +40,8 @@ void PrintUsage(const char* exe) {
               << "  --ohlcv-measurement <name>       QuestDB table for OHLCV bars\n"
               << "  --date-column <name>             TSSB date column name (default: Date)\n"
               << "  --time-column <name>             TSSB time column name (default: Time)\n"
-              << "  --time-format <hhmm|hhmmss>      TSSB time encoding (default: hhmm)\n";
+              << "  --time-format <hhmm|hhmmss>      TSSB time encoding (default: hhmm)\n"
+              << "  --prewarm-cache                  Only build the Arrow IPC caches of the input files\n";
 }
 
 bool ParseArgs(int argc, char** argv, CliOptions* out) {
@@ -71,6 +73,8 @@ bool ParseArgs(int argc, char** argv, CliOptions* out) {
             options.time_column = requireValue(arg);
         } else if (arg == "--time-format") {
             options.time_format = requireValue(arg);
+        } else if (arg == "--prewarm-cache") {
+            options.prewarm_cache = true;
         } else if (arg == "--help" || arg == "-h") {
             PrintUsage(argv[0]);
             return false;
@@ -79,6 +83,15 @@ bool ParseArgs(int argc, char** argv, CliOptions* out) {
         }
     }
 
+    if (options.prewarm_cache) {
+        if (options.indicator_path.empty() && options.ohlcv_path.empty()) {
+            PrintUsage(argv[0]);
+            throw std::runtime_error("--prewarm-cache needs --indicator and/or --ohlcv.");
+        }
+        *out = options;
+        return true;
+    }
+
     if (options.indicator_path.empty() || options.ohlcv_path.empty() || options.dataset_slug.empty()) {
         PrintUsage(argv[0]);
         throw std::runtime_error("indicator, ohlcv, and slug arguments are required.");
@@ -110,15 +123,34 @@ chronosflow::TimeFormat ParseTimeFormat(const std::string& text) {
     return chronosflow::TimeFormat::HHMM;
 }
 
-arrow::Result<chronosflow::AnalyticsDataFrame> LoadTssbFrame(const std::string& path,
-                                                             const CliOptions& options) {
+chronosflow::TSSBReadOptions MakeReadOptions(const CliOptions& options) {
     chronosflow::TSSBReadOptions readOptions;
     readOptions.auto_detect_delimiter = true;
     readOptions.has_header = true;
     readOptions.date_column = options.date_column;
     readOptions.time_column = options.time_column;
+    return readOptions;
+}
+
+void PrewarmCaches(const CliOptions& options) {
+    const auto readOptions = MakeReadOptions(options);
+    for (const auto& path : {options.indicator_path, options.ohlcv_path}) {
+        if (path.empty()) {
+            continue;
+        }
+        auto status = chronosflow::DataFrameIO::warm_tssb_cache(path, readOptions);
+        if (!status.ok()) {
+            throw std::runtime_error("Failed to cache '" + path + "': " + status.ToString());
+        }
+        std::cout << "Cached " << path << " -> " << chronosflow::DataFrameIO::cache_path_for(path) << "\n";
+    }
+}
 
-    ARROW_ASSIGN_OR_RAISE(auto frame, chronosflow::DataFrameIO::read_tssb(path, readOptions));
+arrow::Result<chronosflow::AnalyticsDataFrame> LoadTssbFrame(const std::string& path,
+                                                             const CliOptions& options) {
+    const auto readOptions = MakeReadOptions(options);
+
+    ARROW_ASSIGN_OR_RAISE(auto frame, chronosflow::DataFrameIO::read_tssb_cached(path, readOptions));
     frame.set_tssb_metadata(options.date_column, options.time_column);
     ARROW_ASSIGN_OR_RAISE(auto withUnix,
                           frame.with_unix_timestamp("timestamp_unix", ParseTimeFormat(options.time_format)));
@@ -228,7 +260,9 @@ void ExportFrameToQuestDb(const chronosflow::AnalyticsDataFrame& frame,
     if (!gateway.Export(frame, spec, &result, &error)) {
         throw std::runtime_error("QuestDB export failed for measurement '" + measurement + "': " + error);
     }
-    std::cout << "Exported " << result.rows_serialized << " rows to measurement '" << measurement << "'.\n";
+    std::cout << "Exported " << result.rows_serialized << " rows to measurement '" << measurement << "' in "
+              << result.seconds << " s (" << static_cast<int64_t>(result.rows_per_second) << " rows/s, "
+              << result.megabytes_per_second << " MB/s, " << result.connections << " connections).\n";
 }
 
 }  // namespace
@@ -239,6 +273,10 @@ int main(int argc, char** argv) {
         if (!ParseArgs(argc, argv, &options)) {
             return 0;
         }
+        if (options.prewarm_cache) {
+            PrewarmCaches(options);
+            return 0;
+        }
 
         auto indicatorFrameResult = LoadTssbFrame(options.indicator_path, options);
         if (!indicatorFrameResult.ok()) {
@@ -0,0 +1,480 @@
+#include "Stage1DatasetTable.h"
+
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+#include <charconv>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace stage1 {
+
+namespace {
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t DaysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<int64_t>(era) * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+bool ParseFixed(std::string_view text, size_t pos, size_t width, int* value) {
+    if (pos + width > text.size()) {
+        return false;
+    }
+    int result = 0;
+    for (size_t i = pos; i < pos + width; ++i) {
+        const char ch = text[i];
+        if (ch < '0' || ch > '9') {
+            return false;
+        }
+        result = result * 10 + (ch - '0');
+    }
+    *value = result;
+    return true;
+}
+
+// Unix ms from an ISO timestamp or a plain integer string
+bool ParseTimestampText(std::string_view text, int64_t* millis) {
+    if (DatasetTableDecoder::ParseIsoMillis(text, millis)) {
+        return true;
+    }
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, *millis);
+    return ec == std::errc() && ptr == end;
+}
+
+// Largest double magnitude that converts to int64 without overflow
+constexpr double kMaxMillis = 9223372036854774784.0;
+
+bool IsTimestampKey(std::string_view key) {
+    return key == "timestamp_ms" || key == "timestamp";
+}
+
+// SAX handler for {"rows": [{...}, ...]}. Values go straight into Arrow
+// builders; no DOM and no per-cell strings are created.
+class JsonRowsHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JsonRowsHandler> {
+public:
+    bool Null() { return true; }   // Gaps are padded with nulls
+
+    bool Bool(bool value) {
+        Column* column = RowColumn();
+        if (!column) return true;
+        if (column->kind == Kind::Pending) Settle(*column, Kind::Number);
+        switch (column->kind) {
+            case Kind::Number: return Check(column->numbers.Append(value ? 1.0 : 0.0), *column);
+            case Kind::Text: return Check(column->texts.Append(value ? "true" : "false"), *column);
+            default: return Check(column->times.AppendNull(), *column);
+        }
+    }
+
+    bool Int(int value) { return Integer(value); }
+    bool Uint(unsigned value) { return Integer(value); }
+    bool Int64(int64_t value) { return Integer(value); }
+    bool Uint64(uint64_t value) { return Integer(value); }
+
+    bool Double(double value) {
+        Column* column = RowColumn();
+        if (!column) return true;
+        if (column->kind == Kind::Pending) Settle(*column, Kind::Number);
+        switch (column->kind) {
+            case Kind::Number: return Check(column->numbers.Append(value), *column);
+            case Kind::Timestamp:
+                // Also false for NaN
+                if (!(value >= -kMaxMillis && value <= kMaxMillis)) {
+                    return OutOfRange(*column);
+                }
+                return Check(column->times.Append(static_cast<int64_t>(value)), *column);
+            default: {
+                char buffer[32];
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                return Check(column->texts.Append(buffer, static_cast<int32_t>(result.ptr - buffer)), *column);
+            }
+        }
+    }
+
+    bool String(const char* str, rapidjson::SizeType length, bool) {
+        const std::string_view text(str, length);
+        if (m_depth == 1) {
+            m_rowsKeyPending = false;
+            return true;
+        }
+        Column* column = RowColumn();
+        if (!column) return true;
+        if (column->kind == Kind::Pending) Settle(*column, Kind::Text);
+        switch (column->kind) {
+            case Kind::Text:
+                return Check(column->texts.Append(str, static_cast<int32_t>(length)), *column);
+            case Kind::Timestamp: {
+                int64_t millis = 0;
+                return Check(ParseTimestampText(text, &millis) ? column->times.Append(millis)
+                                                               : column->times.AppendNull(), *column);
+            }
+            default: {
+                // Numeric column holding a quoted number
+                double value = 0.0;
+                auto [ptr, ec] = std::from_chars(str, str + length, value);
+                const bool numeric = ec == std::errc() && ptr == str + length && length > 0;
+                return Check(numeric ? column->numbers.Append(value) : column->numbers.AppendNull(), *column);
+            }
+        }
+    }
+
+    bool Key(const char* str, rapidjson::SizeType length, bool) {
+        const std::string_view key(str, length);
+        if (m_depth == 1) {
+            m_rowsKeyPending = key == "rows";
+        } else if (m_inRows && m_depth == 3) {
+            m_current = Resolve(key);
+        }
+        return true;
+    }
+
+    bool StartObject() {
+        ++m_depth;
+        if (m_inRows && m_depth == 3) {
+            m_inRow = true;
+            m_guess = 0;
+        }
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        if (m_inRow && m_depth == 3) {
+            m_inRow = false;
+            m_current = nullptr;
+            ++m_rows;
+        }
+        --m_depth;
+        return true;
+    }
+
+    bool StartArray() {
+        ++m_depth;
+        if (m_depth == 2 && m_rowsKeyPending) {
+            m_inRows = true;
+            m_sawRows = true;
+        }
+        m_rowsKeyPending = false;
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        if (m_inRows && m_depth == 2) {
+            m_inRows = false;
+        }
+        --m_depth;
+        return true;
+    }
+
+    const arrow::Status& status() const { return m_status; }
+    bool saw_rows() const { return m_sawRows; }
+
+    arrow::Result<std::shared_ptr<arrow::Table>> Finish() {
+        std::vector<std::shared_ptr<arrow::Field>> fields;
+        std::vector<std::shared_ptr<arrow::Array>> arrays;
+        for (auto& column : m_columns) {
+            ARROW_RETURN_NOT_OK(PadTo(*column, m_rows));
+            std::shared_ptr<arrow::Array> array;
+            switch (column->kind) {
+                case Kind::Pending: {
+                    ARROW_ASSIGN_OR_RAISE(array, arrow::MakeArrayOfNull(arrow::float64(), m_rows));
+                    break;
+                }
+                case Kind::Number:
+                    ARROW_RETURN_NOT_OK(column->numbers.Finish(&array));
+                    break;
+                case Kind::Text:
+                    ARROW_RETURN_NOT_OK(column->texts.Finish(&array));
+                    break;
+                case Kind::Timestamp:
+                    ARROW_RETURN_NOT_OK(column->times.Finish(&array));
+                    break;
+            }
+            fields.push_back(arrow::field(column->name, array->type()));
+            arrays.push_back(std::move(array));
+        }
+        return arrow::Table::Make(arrow::schema(std::move(fields)), std::move(arrays), m_rows);
+    }
+
+private:
+    enum class Kind { Pending, Number, Text, Timestamp };
+
+    struct Column {
+        std::string name;
+        Kind kind = Kind::Pending;
+        int64_t length = 0;             // Rows with a value or null recorded
+        int64_t pending_nulls = 0;      // Nulls before the kind was known
+        arrow::DoubleBuilder numbers;
+        arrow::StringBuilder texts;
+        arrow::Int64Builder times;
+    };
+
+    template <typename T>
+    bool Integer(T value) {
+        Column* column = RowColumn();
+        if (!column) return true;
+        if (column->kind == Kind::Pending) Settle(*column, Kind::Number);
+        switch (column->kind) {
+            case Kind::Number: return Check(column->numbers.Append(static_cast<double>(value)), *column);
+            case Kind::Timestamp:
+                if constexpr (std::is_same_v<T, uint64_t>) {
+                    if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                        return OutOfRange(*column);
+                    }
+                }
+                return Check(column->times.Append(static_cast<int64_t>(value)), *column);
+            default: {
+                char buffer[24];
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+                return Check(column->texts.Append(buffer, static_cast<int32_t>(result.ptr - buffer)), *column);
+            }
+        }
+    }
+
+    // Column of the current row value, padded up to this row; null when
+    // the value is not a direct member of a row or repeats a key
+    Column* RowColumn() {
+        if (!m_inRow || m_depth != 3 || !m_current) {
+            return nullptr;
+        }
+        Column* column = m_current;
+        m_current = nullptr;
+        if (column->length > m_rows) {
+            return nullptr;
+        }
+        if (!PadTo(*column, m_rows).ok()) {
+            return nullptr;
+        }
+        return column;
+    }
+
+    Column* Resolve(std::string_view key) {
+        // Rows usually repeat the same key order
+        if (m_guess < m_columns.size() && m_columns[m_guess]->name == key) {
+            return m_columns[m_guess++].get();
+        }
+        auto it = m_index.find(std::string(key));
+        if (it != m_index.end()) {
+            m_guess = it->second + 1;
+            return m_columns[it->second].get();
+        }
+        auto column = std::make_unique<Column>();
+        column->name = std::string(key);
+        if (IsTimestampKey(key)) {
+            column->kind = Kind::Timestamp;
+        }
+        m_index.emplace(column->name, m_columns.size());
+        m_columns.push_back(std::move(column));
+        m_guess = m_columns.size();
+        return m_columns.back().get();
+    }
+
+    void Settle(Column& column, Kind kind) {
+        column.kind = kind;
+        const int64_t nulls = column.pending_nulls;
+        column.pending_nulls = 0;
+        if (nulls > 0) {
+            (void)AppendNulls(column, nulls);
+        }
+    }
+
+    arrow::Status AppendNulls(Column& column, int64_t count) {
+        switch (column.kind) {
+            case Kind::Pending: column.pending_nulls += count; return arrow::Status::OK();
+            case Kind::Number: return column.numbers.AppendNulls(count);
+            case Kind::Text: return column.texts.AppendNulls(count);
+            case Kind::Timestamp: return column.times.AppendNulls(count);
+        }
+        return arrow::Status::OK();
+    }
+
+    arrow::Status PadTo(Column& column, int64_t rows) {
+        if (column.length >= rows) {
+            return arrow::Status::OK();
+        }
+        const int64_t gap = rows - column.length;
+        column.length = rows;
+        return AppendNulls(column, gap);
+    }
+
+    // A timestamp that does not fit int64 milliseconds fails the decode
+    // rather than wrapping to a bogus date
+    bool OutOfRange(const Column& column) {
+        m_status = arrow::Status::Invalid("Timestamp in column '", column.name, "' of row ", m_rows,
+                                          " is outside the int64 millisecond range.");
+        return false;
+    }
+
+    bool Check(const arrow::Status& status, Column& column) {
+        if (!status.ok()) {
+            m_status = status;
+            return false;
+        }
+        ++column.length;
+        return true;
+    }
+
+    std::vector<std::unique_ptr<Column>> m_columns;
+    std::unordered_map<std::string, size_t> m_index;
+    size_t m_guess = 0;
+    Column* m_current = nullptr;
+    int64_t m_rows = 0;
+    int m_depth = 0;
+    bool m_rowsKeyPending = false;
+    bool m_inRows = false;
+    bool m_inRow = false;
+    bool m_sawRows = false;
+    arrow::Status m_status;
+};
+
+template <typename ArrayType>
+arrow::Status ParseTimestampChunk(const ArrayType& array, arrow::Int64Builder* builder) {
+    for (int64_t i = 0; i < array.length(); ++i) {
+        int64_t millis = 0;
+        if (array.IsValid(i) && ParseTimestampText(array.GetView(i), &millis)) {
+            ARROW_RETURN_NOT_OK(builder->Append(millis));
+        } else {
+            ARROW_RETURN_NOT_OK(builder->AppendNull());
+        }
+    }
+    return arrow::Status::OK();
+}
+
+} // namespace
+
+bool DatasetTableDecoder::ParseIsoMillis(std::string_view text, int64_t* millis) {
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    if (text.size() < 19 ||
+        !ParseFixed(text, 0, 4, &year) || text[4] != '-' ||
+        !ParseFixed(text, 5, 2, &month) || text[7] != '-' ||
+        !ParseFixed(text, 8, 2, &day) || (text[10] != 'T' && text[10] != ' ') ||
+        !ParseFixed(text, 11, 2, &hour) || text[13] != ':' ||
+        !ParseFixed(text, 14, 2, &minute) || text[16] != ':' ||
+        !ParseFixed(text, 17, 2, &second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+
+    int64_t fraction = 0;
+    size_t pos = 19;
+    if (pos < text.size() && text[pos] == '.') {
+        int digits = 0;
+        for (++pos; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; ++pos) {
+            if (digits < 3) {
+                fraction = fraction * 10 + (text[pos] - '0');
+                ++digits;
+            }
+        }
+        for (; digits < 3; ++digits) {
+            fraction *= 10;
+        }
+    }
+
+    const int64_t days = DaysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    *millis = ((days * 24 + hour) * 60 + minute) * 60000LL + second * 1000LL + fraction;
+    return true;
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> DatasetTableDecoder::FromArrowStream(std::string body) {
+    auto input = std::make_shared<arrow::io::BufferReader>(arrow::Buffer::FromString(std::move(body)));
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchStreamReader::Open(input));
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    while (true) {
+        std::shared_ptr<arrow::RecordBatch> batch;
+        ARROW_RETURN_NOT_OK(reader->ReadNext(&batch));
+        if (!batch) {
+            break;
+        }
+        batches.push_back(std::move(batch));
+    }
+    ARROW_ASSIGN_OR_RAISE(auto table, arrow::Table::FromRecordBatches(reader->schema(), batches));
+    return NormalizeTimestamps(std::move(table));
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> DatasetTableDecoder::FromJsonRows(std::string body) {
+    // In-situ parsing decodes strings inside body instead of copying them
+    JsonRowsHandler handler;
+    rapidjson::Reader reader;
+    rapidjson::InsituStringStream stream(body.data());
+    const rapidjson::ParseResult parsed = reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
+    ARROW_RETURN_NOT_OK(handler.status());
+    if (parsed.IsError()) {
+        return arrow::Status::Invalid("Failed to parse JSON response: ",
+                                      rapidjson::GetParseError_En(parsed.Code()),
+                                      " (offset ", parsed.Offset(), ")");
+    }
+    if (!handler.saw_rows()) {
+        return arrow::Status::Invalid("Response missing 'rows' array.");
+    }
+    ARROW_ASSIGN_OR_RAISE(auto table, handler.Finish());
+    return NormalizeTimestamps(std::move(table));
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> DatasetTableDecoder::NormalizeTimestamps(
+    std::shared_ptr<arrow::Table> table) {
+
+    int index = table->schema()->GetFieldIndex("timestamp_ms");
+    if (index < 0) {
+        index = table->schema()->GetFieldIndex("timestamp");
+    }
+    if (index < 0) {
+        return table;
+    }
+
+    auto source = table->column(index);
+    const auto unsafe = arrow::compute::CastOptions::Unsafe(arrow::int64());
+    std::shared_ptr<arrow::ChunkedArray> millis;
+    switch (source->type()->id()) {
+        case arrow::Type::INT64:
+            millis = source;
+            break;
+        case arrow::Type::TIMESTAMP: {
+            ARROW_ASSIGN_OR_RAISE(auto ms, arrow::compute::Cast(arrow::Datum(source),
+                arrow::compute::CastOptions::Unsafe(arrow::timestamp(arrow::TimeUnit::MILLI))));
+            ARROW_ASSIGN_OR_RAISE(auto raw, arrow::compute::Cast(ms, unsafe));
+            millis = raw.chunked_array();
+            break;
+        }
+        case arrow::Type::STRING:
+        case arrow::Type::LARGE_STRING: {
+            arrow::Int64Builder builder;
+            ARROW_RETURN_NOT_OK(builder.Reserve(source->length()));
+            for (const auto& chunk : source->chunks()) {
+                if (chunk->type_id() == arrow::Type::STRING) {
+                    ARROW_RETURN_NOT_OK(ParseTimestampChunk(static_cast<const arrow::StringArray&>(*chunk), &builder));
+                } else {
+                    ARROW_RETURN_NOT_OK(ParseTimestampChunk(static_cast<const arrow::LargeStringArray&>(*chunk), &builder));
+                }
+            }
+            std::shared_ptr<arrow::Array> array;
+            ARROW_RETURN_NOT_OK(builder.Finish(&array));
+            millis = std::make_shared<arrow::ChunkedArray>(array);
+            break;
+        }
+        default: {
+            ARROW_ASSIGN_OR_RAISE(auto raw, arrow::compute::Cast(arrow::Datum(source), unsafe));
+            millis = raw.chunked_array();
+            break;
+        }
+    }
+
+    auto field = arrow::field("timestamp_ms", arrow::int64());
+    if (table->schema()->field(index)->name() == "timestamp_ms") {
+        return table->SetColumn(index, field, millis);
+    }
+    return table->AddColumn(table->num_columns(), field, millis);
+}
+
+} // namespace stage1
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <arrow/result.h>
+#include <arrow/table.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace stage1 {
+
+// Content type the Stage1 API uses for Arrow IPC stream responses
+constexpr const char* kArrowStreamContentType = "application/vnd.apache.arrow.stream";
+
+// Decodes dataset rows into a typed table; either way the result carries an
+// int64 "timestamp_ms" column when the rows have a timestamp_ms or
+// timestamp field.
+class DatasetTableDecoder {
+public:
+    // Arrow IPC stream body
+    static arrow::Result<std::shared_ptr<arrow::Table>> FromArrowStream(std::string body);
+
+    // {"rows": [{...}, ...]} body, read with a SAX parser straight into
+    // column builders. Numbers become float64 and strings utf8, by each
+    // column's first non-null value; missing keys are nulls.
+    static arrow::Result<std::shared_ptr<arrow::Table>> FromJsonRows(std::string body);
+
+    // "2024-11-28T22:00:00.000000Z" (or a space instead of 'T') as unix ms.
+    // Fractions below a millisecond are truncated.
+    static bool ParseIsoMillis(std::string_view text, int64_t* millis);
+
+private:
+    static arrow::Result<std::shared_ptr<arrow::Table>> NormalizeTimestamps(std::shared_ptr<arrow::Table> table);
+};
+
+} // namespace stage1
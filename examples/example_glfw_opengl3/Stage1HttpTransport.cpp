@@ -0,0 +1,333 @@
+#include "Stage1HttpTransport.h"
+
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace stage1 {
+
+namespace {
+
+size_t AppendToString(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    auto* buffer = static_cast<std::string*>(userdata);
+    const size_t realSize = size * nmemb;
+    buffer->append(ptr, realSize);
+    return realSize;
+}
+
+double SecondsToMs(double seconds) {
+    return seconds * 1000.0;
+}
+
+} // namespace
+
+// Per-request state that must outlive curl_easy_perform
+struct HttpTransport::Transfer {
+    std::string body;
+    curl_slist* headers = nullptr;
+
+    ~Transfer() {
+        if (headers) {
+            curl_slist_free_all(headers);
+        }
+    }
+};
+
+HttpTransport::HttpTransport(HttpTransportOptions options)
+    : m_options(std::move(options)) {
+    CURLSH* share = curl_share_init();
+    if (share) {
+        curl_share_setopt(share, CURLSHOPT_LOCKFUNC, &HttpTransport::LockShare);
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, &HttpTransport::UnlockShare);
+        curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        // Connections stay per handle: curl does not support sharing the
+        // connection cache between threads that transfer concurrently.
+    }
+    m_share = share;
+
+    CURLM* multi = curl_multi_init();
+    if (multi) {
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, m_options.http2 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, std::max(1L, m_options.max_host_connections));
+    }
+    m_multi = multi;
+}
+
+HttpTransport::~HttpTransport() {
+    for (void* handle : m_idle) {
+        curl_easy_cleanup(static_cast<CURL*>(handle));
+    }
+    m_idle.clear();
+    if (m_multi) {
+        curl_multi_cleanup(static_cast<CURLM*>(m_multi));
+    }
+    if (m_share) {
+        curl_share_cleanup(static_cast<CURLSH*>(m_share));
+    }
+}
+
+void HttpTransport::LockShare(void*, int data, int, void* userptr) {
+    auto* self = static_cast<HttpTransport*>(userptr);
+    self->m_shareLocks[static_cast<size_t>(data) % 8].lock();
+}
+
+void HttpTransport::UnlockShare(void*, int data, void* userptr) {
+    auto* self = static_cast<HttpTransport*>(userptr);
+    self->m_shareLocks[static_cast<size_t>(data) % 8].unlock();
+}
+
+void* HttpTransport::AcquireHandle() {
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (!m_idle.empty()) {
+            void* handle = m_idle.back();
+            m_idle.pop_back();
+            return handle;
+        }
+    }
+    return curl_easy_init();
+}
+
+void HttpTransport::ReleaseHandle(void* handle) {
+    if (!handle) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (m_idle.size() < m_options.max_idle_handles) {
+            m_idle.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(static_cast<CURL*>(handle));
+}
+
+bool HttpTransport::Prepare(void* handle, const HttpRequest& request, Transfer* transfer) {
+    CURL* curl = static_cast<CURL*>(handle);
+    // Clears options from the previous request but keeps its connection
+    curl_easy_reset(curl);
+
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, AppendToString);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->body);
+    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    if (m_share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, static_cast<CURLSH*>(m_share));
+    }
+    if (m_options.compression) {
+        curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    }
+    if (m_options.http2) {
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    }
+    if (m_options.connect_timeout_ms > 0) {
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, m_options.connect_timeout_ms);
+    }
+    if (request.timeout_ms > 0) {
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, request.timeout_ms);
+    }
+
+    for (const auto& header : request.headers) {
+        transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+    }
+    if (transfer->headers) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->headers);
+    }
+
+    if (request.method == "POST") {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+    } else if (request.method != "GET") {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+        if (!request.body.empty()) {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+        }
+    }
+    return true;
+}
+
+void HttpTransport::Complete(void* handle, int result, Transfer* transfer, HttpResponse* response) {
+    CURL* curl = static_cast<CURL*>(handle);
+    const CURLcode res = static_cast<CURLcode>(result);
+
+    HttpResponse out;
+    if (res != CURLE_OK) {
+        out.error = curl_easy_strerror(res);
+    }
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &out.status);
+    char* contentType = nullptr;
+    if (curl_easy_getinfo(curl, CURLINFO_CONTENT_TYPE, &contentType) == CURLE_OK && contentType) {
+        out.content_type = contentType;
+    }
+
+    // curl reports cumulative phase end times; turn them into durations
+    double dns = 0.0, connect = 0.0, tls = 0.0, firstByte = 0.0, total = 0.0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &dns);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &tls);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &firstByte);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total);
+    out.timing.dns_ms = SecondsToMs(dns);
+    out.timing.connect_ms = SecondsToMs(std::max(0.0, connect - dns));
+    out.timing.tls_ms = tls > 0.0 ? SecondsToMs(std::max(0.0, tls - connect)) : 0.0;
+    out.timing.first_byte_ms = SecondsToMs(firstByte);
+    out.timing.total_ms = SecondsToMs(total);
+
+    curl_off_t uploaded = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &uploaded);
+    out.timing.bytes_sent = static_cast<int64_t>(uploaded);
+    out.timing.bytes_received = static_cast<int64_t>(transfer->body.size());
+
+    long newConnections = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &newConnections);
+    out.timing.reused_connection = res == CURLE_OK && newConnections == 0;
+
+    long version = 0;
+    curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &version);
+    switch (version) {
+        case CURL_HTTP_VERSION_1_0:
+        case CURL_HTTP_VERSION_1_1: out.timing.http_version = 1; break;
+        case CURL_HTTP_VERSION_2_0: out.timing.http_version = 2; break;
+        case CURL_HTTP_VERSION_3:   out.timing.http_version = 3; break;
+        default:                    out.timing.http_version = 0; break;
+    }
+
+    out.body = std::move(transfer->body);
+
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        ++m_stats.requests;
+        if (res != CURLE_OK) ++m_stats.failures;
+        if (out.timing.reused_connection) ++m_stats.reused_connections;
+        m_stats.bytes_sent += out.timing.bytes_sent;
+        m_stats.bytes_received += out.timing.bytes_received;
+        m_stats.total_ms += out.timing.total_ms;
+    }
+
+    if (response) {
+        *response = std::move(out);
+    }
+}
+
+bool HttpTransport::Perform(const HttpRequest& request, HttpResponse* response) {
+    void* handle = AcquireHandle();
+    if (!handle) {
+        if (response) {
+            *response = HttpResponse{};
+            response->error = "Failed to initialize CURL.";
+        }
+        return false;
+    }
+
+    Transfer transfer;
+    Prepare(handle, request, &transfer);
+    const CURLcode res = curl_easy_perform(static_cast<CURL*>(handle));
+
+    HttpResponse local;
+    HttpResponse* out = response ? response : &local;
+    Complete(handle, res, &transfer, out);
+
+    if (res == CURLE_OK) {
+        ReleaseHandle(handle);
+    } else {
+        // Do not hand a possibly broken connection to the next caller
+        curl_easy_cleanup(static_cast<CURL*>(handle));
+    }
+    return res == CURLE_OK;
+}
+
+bool HttpTransport::PerformAll(const std::vector<HttpRequest>& requests,
+                               std::vector<HttpResponse>* responses) {
+    if (responses) {
+        responses->assign(requests.size(), HttpResponse{});
+    }
+    if (requests.empty()) {
+        return true;
+    }
+    if (!m_multi) {
+        bool ok = true;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            ok = Perform(requests[i], responses ? &(*responses)[i] : nullptr) && ok;
+        }
+        return ok;
+    }
+
+    std::lock_guard<std::mutex> multiLock(m_multiMutex);
+    CURLM* multi = static_cast<CURLM*>(m_multi);
+
+    std::vector<void*> handles(requests.size(), nullptr);
+    std::vector<std::unique_ptr<Transfer>> transfers(requests.size());
+    bool ok = true;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        handles[i] = AcquireHandle();
+        transfers[i] = std::make_unique<Transfer>();
+        if (!handles[i]) {
+            if (responses) (*responses)[i].error = "Failed to initialize CURL.";
+            ok = false;
+            continue;
+        }
+        Prepare(handles[i], requests[i], transfers[i].get());
+        curl_easy_setopt(static_cast<CURL*>(handles[i]), CURLOPT_PRIVATE, reinterpret_cast<char*>(i));
+        curl_multi_add_handle(multi, static_cast<CURL*>(handles[i]));
+    }
+
+    int running = 0;
+    do {
+        CURLMcode mc = curl_multi_perform(multi, &running);
+        if (mc == CURLM_OK && running > 0) {
+            mc = curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+        if (mc != CURLM_OK) {
+            break;
+        }
+
+        int pending = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi, &pending)) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            CURL* curl = message->easy_handle;
+            char* privateData = nullptr;
+            curl_easy_getinfo(curl, CURLINFO_PRIVATE, &privateData);
+            const size_t index = reinterpret_cast<size_t>(privateData);
+            const CURLcode res = message->data.result;
+
+            curl_multi_remove_handle(multi, curl);
+            Complete(curl, res, transfers[index].get(), responses ? &(*responses)[index] : nullptr);
+            if (res == CURLE_OK) {
+                ReleaseHandle(curl);
+            } else {
+                ok = false;
+                curl_easy_cleanup(curl);
+            }
+            handles[index] = nullptr;
+        }
+    } while (running > 0);
+
+    // Anything still attached after a multi error is abandoned
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (!handles[i]) {
+            continue;
+        }
+        curl_multi_remove_handle(multi, static_cast<CURL*>(handles[i]));
+        curl_easy_cleanup(static_cast<CURL*>(handles[i]));
+        if (responses) (*responses)[i].error = "Transfer aborted.";
+        ok = false;
+    }
+    return ok;
+}
+
+HttpTransportStats HttpTransport::Stats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
+
+} // namespace stage1
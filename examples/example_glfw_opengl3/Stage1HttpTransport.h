@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace stage1 {
+
+struct HttpRequest {
+    std::string method = "GET";
+    std::string url;
+    std::string body;
+    std::vector<std::string> headers;
+    long timeout_ms = 0;                // 0: no overall limit
+};
+
+// Phases of one request, from curl's transfer info
+struct HttpTiming {
+    double dns_ms = 0.0;
+    double connect_ms = 0.0;
+    double tls_ms = 0.0;
+    double first_byte_ms = 0.0;
+    double total_ms = 0.0;
+    int64_t bytes_sent = 0;
+    int64_t bytes_received = 0;         // After content decoding
+    bool reused_connection = false;
+    long http_version = 0;              // 1, 2 or 3; 0 if no response
+};
+
+struct HttpResponse {
+    long status = 0;
+    std::string body;
+    std::string content_type;
+    std::string error;                  // Transport error; empty on success
+    HttpTiming timing;
+};
+
+struct HttpTransportOptions {
+    size_t max_idle_handles = 8;        // Warm handles (and their connections) kept
+    long max_host_connections = 6;      // Concurrency cap for PerformAll
+    long connect_timeout_ms = 0;        // 0: curl default
+    bool compression = true;            // Accept-Encoding for every decoder curl has
+    bool http2 = true;                  // HTTP/2 over TLS, multiplexed in PerformAll
+};
+
+struct HttpTransportStats {
+    int64_t requests = 0;
+    int64_t failures = 0;
+    int64_t reused_connections = 0;
+    int64_t bytes_sent = 0;
+    int64_t bytes_received = 0;
+    double total_ms = 0.0;
+};
+
+// Keep-alive HTTP transport shared by every Stage1 REST call.
+//
+// Easy handles are pooled: a finished request returns its handle, and with
+// it the open connection, so the next request to the same host skips the
+// TCP and TLS handshakes. DNS results and TLS sessions are shared between
+// handles. Perform() may run on many threads at once, each on its own
+// handle. PerformAll() runs a batch concurrently on one multi handle, where
+// HTTP/2 streams to the same host share a single connection.
+class HttpTransport {
+public:
+    explicit HttpTransport(HttpTransportOptions options = HttpTransportOptions());
+    ~HttpTransport();
+
+    HttpTransport(const HttpTransport&) = delete;
+    HttpTransport& operator=(const HttpTransport&) = delete;
+
+    // False on a transport error (response->error); HTTP errors return true
+    bool Perform(const HttpRequest& request, HttpResponse* response);
+
+    // Responses in request order; false if any request had a transport error
+    bool PerformAll(const std::vector<HttpRequest>& requests,
+                    std::vector<HttpResponse>* responses);
+
+    HttpTransportStats Stats() const;
+
+private:
+    struct Transfer;
+
+    void* AcquireHandle();
+    void ReleaseHandle(void* handle);
+    bool Prepare(void* handle, const HttpRequest& request, Transfer* transfer);
+    void Complete(void* handle, int result, Transfer* transfer, HttpResponse* response);
+
+    static void LockShare(void* handle, int data, int access, void* userptr);
+    static void UnlockShare(void* handle, int data, void* userptr);
+
+    HttpTransportOptions m_options;
+    void* m_share = nullptr;            // CURLSH: DNS cache and TLS sessions
+    void* m_multi = nullptr;            // CURLM for PerformAll
+    std::mutex m_shareLocks[8];         // One per curl_lock_data
+    std::mutex m_multiMutex;
+
+    std::mutex m_poolMutex;
+    std::vector<void*> m_idle;
+
+    mutable std::mutex m_statsMutex;
+    HttpTransportStats m_stats;
+};
+
+} // namespace stage1
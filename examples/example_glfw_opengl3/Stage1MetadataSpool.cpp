@@ -0,0 +1,293 @@
+#include "Stage1MetadataSpool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace stage1 {
+
+namespace {
+
+// Entries taken per drain, so one write never grows without bound
+constexpr size_t kMaxEntriesPerDrain = 4096;
+
+} // namespace
+
+MetadataSpool::MetadataSpool(std::string path, MetadataSpoolOptions options)
+    : m_path(std::move(path)),
+      m_options(std::move(options)) {
+    m_options.sync_interval_ms = std::max(m_options.sync_interval_ms, 1);
+    m_options.max_rows_per_insert = std::max(m_options.max_rows_per_insert, 1);
+    Node* stub = new Node();
+    m_head.store(stub);
+    m_tail = stub;
+}
+
+MetadataSpool::~MetadataSpool() {
+    Shutdown();
+    Node* node = m_tail;
+    while (node) {
+        Node* next = node->next.load();
+        delete node;
+        node = next;
+    }
+}
+
+void MetadataSpool::AppendStatement(std::string sql) {
+    Entry entry;
+    entry.kind = Entry::Kind::Statement;
+    entry.sql = std::move(sql);
+    Push(std::move(entry));
+}
+
+void MetadataSpool::AppendRows(SpoolRows rows) {
+    if (rows.rows.empty()) {
+        return;
+    }
+    Entry entry;
+    entry.kind = Entry::Kind::Rows;
+    entry.rows = std::move(rows);
+    Push(std::move(entry));
+}
+
+void MetadataSpool::Post(std::function<void()> task) {
+    Entry entry;
+    entry.kind = Entry::Kind::Task;
+    entry.task = std::move(task);
+    Push(std::move(entry));
+}
+
+void MetadataSpool::Push(Entry entry) {
+    Node* node = new Node();
+    node->entry = std::move(entry);
+    Node* previous = m_head.exchange(node);
+    previous->next.store(node);
+
+    EnsureStarted();
+    if (m_sleeping.load()) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wake.notify_one();
+    }
+}
+
+// Writer thread only. A producer that has swapped the head but not linked
+// its node yet leaves the queue looking empty; its node is taken next time.
+bool MetadataSpool::Pop(Entry* entry) {
+    Node* tail = m_tail;
+    Node* next = tail->next.load();
+    if (!next) {
+        return false;
+    }
+    *entry = std::move(next->entry);
+    m_tail = next;
+    delete tail;
+    return true;
+}
+
+bool MetadataSpool::QueueEmpty() const {
+    return m_tail->next.load() == nullptr;
+}
+
+void MetadataSpool::EnsureStarted() {
+    if (m_running.load()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    if (m_running.load()) {
+        return;
+    }
+    m_running.store(true);
+    m_thread = std::thread(&MetadataSpool::Run, this);
+}
+
+void MetadataSpool::Shutdown() {
+    std::lock_guard<std::mutex> lock(m_threadMutex);
+    while (m_running.load()) {
+        m_stopping.store(true);
+        {
+            std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+            m_wake.notify_one();
+        }
+        m_thread.join();
+        m_stopping.store(false);
+        m_running.store(false);
+
+        // A producer that still saw the writer running has linked its node
+        // by now, or will see it stopped and start a new one itself
+        if (QueueEmpty()) {
+            break;
+        }
+        m_running.store(true);
+        m_thread = std::thread(&MetadataSpool::Run, this);
+    }
+}
+
+void MetadataSpool::Run() {
+    using Clock = std::chrono::steady_clock;
+    const auto interval = std::chrono::milliseconds(m_options.sync_interval_ms);
+    auto lastSync = Clock::now();
+    bool dirty = false;
+    std::string buffer;
+
+    while (true) {
+        const bool stopping = m_stopping.load();
+        buffer.clear();
+        std::vector<std::function<void()>> tasks;
+        const size_t drained = Drain(&buffer, &tasks);
+        if (!buffer.empty()) {
+            WriteBuffer(buffer);
+            dirty = true;
+        }
+        for (auto& task : tasks) {
+            task();
+        }
+
+        const auto now = Clock::now();
+        if (dirty && (now - lastSync >= interval || (stopping && drained == 0))) {
+            SyncFile();
+            dirty = false;
+            lastSync = now;
+        }
+        if (drained > 0) {
+            continue;
+        }
+        if (stopping) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleeping.store(true);
+        if (QueueEmpty() && !m_stopping.load()) {
+            if (dirty) {
+                m_wake.wait_until(lock, lastSync + interval);
+            } else {
+                m_wake.wait(lock);
+            }
+        }
+        m_sleeping.store(false);
+    }
+
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+// Appends queued SQL to buffer. Stops after a task so that the task runs
+// once everything queued before it is written.
+size_t MetadataSpool::Drain(std::string* buffer, std::vector<std::function<void()>>* tasks) {
+    const SpoolRows* open = nullptr;       // Rows whose INSERT is still open
+    SpoolRows openRows;
+    size_t openCount = 0;
+    std::unordered_set<std::string> openKeys;
+
+    auto closeInsert = [&]() {
+        if (open) {
+            buffer->append("\n");
+            buffer->append(open->conflict_clause);
+            open = nullptr;
+            openCount = 0;
+            openKeys.clear();
+        }
+    };
+
+    size_t drained = 0;
+    Entry entry;
+    while (drained < kMaxEntriesPerDrain && Pop(&entry)) {
+        ++drained;
+        if (entry.kind == Entry::Kind::Task) {
+            tasks->push_back(std::move(entry.task));
+            break;
+        }
+        if (entry.kind == Entry::Kind::Statement) {
+            closeInsert();
+            buffer->append(entry.sql);
+            continue;
+        }
+
+        const bool sameInsert = open &&
+            open->insert_prefix == entry.rows.insert_prefix &&
+            open->conflict_clause == entry.rows.conflict_clause;
+        if (!sameInsert) {
+            closeInsert();
+        }
+        // Keep prefix and clause alive for as long as the INSERT is open
+        openRows.insert_prefix = std::move(entry.rows.insert_prefix);
+        openRows.conflict_clause = std::move(entry.rows.conflict_clause);
+        for (auto& row : entry.rows.rows) {
+            if (open && (openCount >= static_cast<size_t>(m_options.max_rows_per_insert) ||
+                         openKeys.count(row.first) != 0)) {
+                closeInsert();
+            }
+            if (!open) {
+                open = &openRows;
+                buffer->append(openRows.insert_prefix);
+            } else {
+                buffer->append(",\n");
+            }
+            buffer->append("  ");
+            buffer->append(row.second);
+            openKeys.insert(std::move(row.first));
+            ++openCount;
+        }
+    }
+    closeInsert();
+    return drained;
+}
+
+bool MetadataSpool::OpenFile() {
+    if (m_file) {
+        return true;
+    }
+    std::error_code ec;
+    const std::filesystem::path path(m_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    const bool created = !std::filesystem::exists(path, ec);
+    m_file = std::fopen(m_path.c_str(), "ab");
+    if (!m_file) {
+        std::cerr << "[Stage1MetadataSpool] Cannot open " << m_path << " for appending." << std::endl;
+        return false;
+    }
+    if (created && !m_options.header.empty()) {
+        std::fwrite(m_options.header.data(), 1, m_options.header.size(), m_file);
+    }
+    return true;
+}
+
+void MetadataSpool::WriteBuffer(const std::string& buffer) {
+    if (!OpenFile()) {
+        std::cerr << "[Stage1MetadataSpool] Dropped " << buffer.size() << " bytes of SQL." << std::endl;
+        return;
+    }
+    const size_t written = std::fwrite(buffer.data(), 1, buffer.size(), m_file);
+    if (written != buffer.size() || std::fflush(m_file) != 0) {
+        std::cerr << "[Stage1MetadataSpool] Short write to " << m_path << " (" << written
+                  << " of " << buffer.size() << " bytes); reopening." << std::endl;
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+void MetadataSpool::SyncFile() {
+    if (!m_file || std::fflush(m_file) != 0) {
+        return;
+    }
+#if defined(_WIN32)
+    _commit(_fileno(m_file));
+#else
+    fsync(fileno(m_file));
+#endif
+}
+
+} // namespace stage1
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace stage1 {
+
+struct MetadataSpoolOptions {
+    int sync_interval_ms = 1000;        // fsync at most this often while writes keep coming
+    int max_rows_per_insert = 500;
+    std::string header;                 // Written when the spool file is created
+};
+
+// Rows for one table that share a column list and conflict clause. Rows of
+// consecutive appends with the same prefix and clause end up in one INSERT.
+struct SpoolRows {
+    std::string insert_prefix;          // "INSERT INTO t (a, b)\nVALUES\n"
+    std::string conflict_clause;        // "ON CONFLICT (a) DO UPDATE SET ...;\n\n"
+    // Conflict key and "(...)" tuple. A key seen twice starts a new INSERT,
+    // since ON CONFLICT DO UPDATE cannot touch the same row twice in one.
+    std::vector<std::pair<std::string, std::string>> rows;
+};
+
+// Write-behind spool for the pending Postgres inserts file.
+//
+// Producers push onto a lock-free multi-producer queue and return at once.
+// One writer thread, started on the first append, drains everything queued,
+// folds consecutive row appends into multi-row INSERTs and writes them
+// through a file handle it keeps open. The file is flushed after each drain
+// and fsynced at most every sync_interval_ms. Queued tasks run on the same
+// thread after the SQL queued before them is written. Shutdown() drains the
+// queue and syncs before it returns; the destructor calls it.
+class MetadataSpool {
+public:
+    explicit MetadataSpool(std::string path, MetadataSpoolOptions options = MetadataSpoolOptions());
+    ~MetadataSpool();
+
+    MetadataSpool(const MetadataSpool&) = delete;
+    MetadataSpool& operator=(const MetadataSpool&) = delete;
+
+    void AppendStatement(std::string sql);
+    void AppendRows(SpoolRows rows);
+    void Post(std::function<void()> task);
+
+    void Shutdown();
+
+private:
+    struct Entry {
+        enum class Kind { Statement, Rows, Task };
+        Kind kind = Kind::Statement;
+        std::string sql;
+        SpoolRows rows;
+        std::function<void()> task;
+    };
+
+    struct Node {
+        std::atomic<Node*> next{ nullptr };
+        Entry entry;
+    };
+
+    void Push(Entry entry);
+    bool Pop(Entry* entry);
+    bool QueueEmpty() const;
+    void EnsureStarted();
+    void Run();
+    size_t Drain(std::string* buffer, std::vector<std::function<void()>>* tasks);
+    bool OpenFile();
+    void WriteBuffer(const std::string& buffer);
+    void SyncFile();
+
+    std::string m_path;
+    MetadataSpoolOptions m_options;
+
+    // Vyukov queue: producers swap m_head, the writer alone advances m_tail
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+
+    std::mutex m_threadMutex;           // Starting and stopping the writer
+    std::thread m_thread;
+    std::atomic<bool> m_running{ false };
+    std::atomic<bool> m_stopping{ false };
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_sleeping{ false };
+
+    FILE* m_file = nullptr;             // Writer thread only
+};
+
+} // namespace stage1
@@ -1,5 +1,7 @@
 #include "Stage1RestClient.h"
+#include "Stage1DatasetTable.h"
 
+#include <arrow/table.h>
 #include <curl/curl.h>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
@@ -22,13 +24,7 @@ namespace {
 constexpr const char* kDefaultBaseUrl = "https://agenticresearch.info";
 constexpr const char* kBaseUrlEnv = "STAGE1_API_BASE_URL";
 constexpr const char* kTokenEnv = "STAGE1_API_TOKEN";
-
-size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata) {
-    auto* buffer = static_cast<std::string*>(userdata);
-    const size_t realSize = size * nmemb;
-    buffer->append(ptr, realSize);
-    return realSize;
-}
+constexpr const char* kTimingEnv = "STAGE1_HTTP_TIMING";
 
 std::string JsonEscape(const std::string& value) {
     std::ostringstream oss;
@@ -301,6 +297,8 @@ bool ParseDatasetSummaryNode(const rapidjson::Value& item,
 
 namespace stage1 {
 
+static thread_local HttpTiming t_lastTiming;
+
 RestClient& RestClient::Instance() {
     static RestClient client;
     return client;
@@ -313,10 +311,15 @@ RestClient::RestClient() {
     if (token && *token) {
         m_apiToken = token;
     }
+    const char* timing = std::getenv(kTimingEnv);
+    m_logTiming = timing && *timing && std::string(timing) != "0";
     curl_global_init(CURL_GLOBAL_DEFAULT);
+    m_transport = std::make_unique<HttpTransport>();
 }
 
 RestClient::~RestClient() {
+    // Pooled handles must go before libcurl is torn down
+    m_transport.reset();
     curl_global_cleanup();
 }
 
@@ -456,78 +459,31 @@ bool RestClient::FetchRunDetail(const std::string& runId,
     return true;
 }
 
-bool RestClient::FetchDatasetOhlcv(const std::string& datasetId,
-                                   Json::Value* rows,
-                                   std::string* error,
-                                   int limit) {
-    if (!rows) {
-        if (error) *error = "Rows container is null.";
-        return false;
-    }
-    if (datasetId.empty()) {
-        if (error) *error = "Dataset ID is required.";
-        return false;
-    }
-
-    std::ostringstream path;
-    path << "/api/datasets/" << datasetId << "/ohlcv";
-    if (limit > 0) {
-        path << "?limit=" << limit;
-    }
-
-    long status = 0;
-    std::string response;
-    if (!Execute("GET", path.str(), "", {}, &status, &response, error)) {
-        return false;
-    }
-
-    if (status < 200 || status >= 300) {
-        if (error) {
-            std::ostringstream msg;
-            msg << "Stage1 API returned HTTP " << status << " while fetching OHLCV.";
-            if (!response.empty()) {
-                msg << " Body: " << response;
-            }
-            *error = msg.str();
-        }
-        return false;
-    }
-
-    // Parse JSON response
-    Json::CharReaderBuilder builder;
-    Json::CharReader* reader = builder.newCharReader();
-    Json::Value root;
-    std::string parseError;
-
-    bool parsed = reader->parse(
-        response.c_str(),
-        response.c_str() + response.size(),
-        &root,
-        &parseError
-    );
-    delete reader;
-
-    if (!parsed) {
-        if (error) *error = "Failed to parse JSON response: " + parseError;
-        return false;
-    }
-
-    if (!root.isMember("rows") || !root["rows"].isArray()) {
-        if (error) *error = "Response missing 'rows' array.";
-        return false;
-    }
+bool RestClient::FetchDatasetOhlcvTable(const std::string& datasetId,
+                                        std::shared_ptr<arrow::Table>* table,
+                                        std::string* error,
+                                        int limit,
+                                        int64_t offset) {
+    return FetchDatasetTable(datasetId, "ohlcv", "OHLCV", limit, offset, table, error);
+}
 
-    *rows = root["rows"];
-    std::cout << "[Stage1RestClient] Fetched " << rows->size() << " OHLCV rows" << std::endl;
-    return true;
+bool RestClient::FetchDatasetIndicatorTable(const std::string& datasetId,
+                                            std::shared_ptr<arrow::Table>* table,
+                                            std::string* error,
+                                            int limit,
+                                            int64_t offset) {
+    return FetchDatasetTable(datasetId, "indicators", "indicator", limit, offset, table, error);
 }
 
-bool RestClient::FetchDatasetIndicators(const std::string& datasetId,
-                                        Json::Value* rows,
-                                        std::string* error,
-                                        int limit) {
-    if (!rows) {
-        if (error) *error = "Rows container is null.";
+bool RestClient::FetchDatasetTable(const std::string& datasetId,
+                                   const char* part,
+                                   const char* label,
+                                   int limit,
+                                   int64_t offset,
+                                   std::shared_ptr<arrow::Table>* table,
+                                   std::string* error) {
+    if (!table) {
+        if (error) *error = "Table container is null.";
         return false;
     }
     if (datasetId.empty()) {
@@ -536,55 +492,44 @@ bool RestClient::FetchDatasetIndicators(const std::string& datasetId,
     }
 
     std::ostringstream path;
-    path << "/api/datasets/" << datasetId << "/indicators";
+    path << "/api/datasets/" << datasetId << '/' << part;
+    char separator = '?';
     if (limit > 0) {
-        path << "?limit=" << limit;
+        path << separator << "limit=" << limit;
+        separator = '&';
+    }
+    if (offset > 0) {
+        path << separator << "offset=" << offset;
     }
 
-    long status = 0;
-    std::string response;
-    if (!Execute("GET", path.str(), "", {}, &status, &response, error)) {
+    const std::string accept = std::string("Accept: ") + kArrowStreamContentType + ", application/json;q=0.5";
+    HttpResponse response;
+    if (!Send("GET", path.str(), "", { accept }, &response, error)) {
         return false;
     }
-
-    if (status < 200 || status >= 300) {
+    if (response.status < 200 || response.status >= 300) {
         if (error) {
             std::ostringstream msg;
-            msg << "Stage1 API returned HTTP " << status << " while fetching indicators.";
-            if (!response.empty()) {
-                msg << " Body: " << response;
+            msg << "Stage1 API returned HTTP " << response.status << " while fetching " << label << " rows.";
+            if (!response.body.empty()) {
+                msg << " Body: " << response.body;
             }
             *error = msg.str();
         }
         return false;
     }
 
-    // Parse JSON response
-    Json::CharReaderBuilder builder;
-    Json::CharReader* reader = builder.newCharReader();
-    Json::Value root;
-    std::string parseError;
-
-    bool parsed = reader->parse(
-        response.c_str(),
-        response.c_str() + response.size(),
-        &root,
-        &parseError
-    );
-    delete reader;
-
-    if (!parsed) {
-        if (error) *error = "Failed to parse JSON response: " + parseError;
-        return false;
-    }
-
-    if (!root.isMember("rows") || !root["rows"].isArray()) {
-        if (error) *error = "Response missing 'rows' array.";
+    const bool arrowStream = response.content_type.rfind(kArrowStreamContentType, 0) == 0;
+    auto decoded = arrowStream
+        ? DatasetTableDecoder::FromArrowStream(std::move(response.body))
+        : DatasetTableDecoder::FromJsonRows(std::move(response.body));
+    if (!decoded.ok()) {
+        if (error) *error = decoded.status().message();
         return false;
     }
-
-    *rows = root["rows"];
-    std::cout << "[Stage1RestClient] Fetched " << rows->size() << " indicator rows" << std::endl;
+    *table = std::move(decoded).ValueOrDie();
+    std::cout << "[Stage1RestClient] Fetched " << (*table)->num_rows() << ' ' << label << " rows ("
+              << (arrowStream ? "Arrow IPC" : "JSON") << ")" << std::endl;
     return true;
 }
 
@@ -798,20 +743,35 @@ bool RestClient::AppendDatasetRows(const std::string& datasetId,
                                    const Json::Value& payload,
                                    AppendTarget target,
                                    std::string* error) {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    long status = 0;
+    return AppendDatasetRowBatch(datasetId, Json::writeString(builder, payload), target, {}, &status, error);
+}
+
+bool RestClient::AppendDatasetRowBatch(const std::string& datasetId,
+                                       const std::string& body,
+                                       AppendTarget target,
+                                       const std::string& idempotencyKey,
+                                       long* httpStatus,
+                                       std::string* error) {
+    if (httpStatus) *httpStatus = 0;
     if (datasetId.empty()) {
         if (error) *error = "dataset_id is required for append.";
         return false;
     }
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "";
-    std::string body = Json::writeString(builder, payload);
     std::string path = "/api/datasets/" + datasetId;
     path += (target == AppendTarget::Ohlcv) ? "/ohlcv/append" : "/indicators/append";
+    std::vector<std::string> headers;
+    if (!idempotencyKey.empty()) {
+        headers.push_back("Idempotency-Key: " + idempotencyKey);
+    }
     long status = 0;
     std::string response;
-    if (!Execute("POST", path, body, {}, &status, &response, error)) {
+    if (!Execute("POST", path, body, headers, &status, &response, error)) {
         return false;
     }
+    if (httpStatus) *httpStatus = status;
     if (status < 200 || status >= 300) {
         if (error) {
             std::ostringstream oss;
@@ -1047,68 +1007,69 @@ bool RestClient::Execute(const std::string& method,
                          long* httpStatus,
                          std::string* responseBody,
                          std::string* error) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        if (error) *error = "Failed to initialize CURL.";
+    HttpResponse response;
+    if (!Send(method, path, body, extraHeaders, &response, error)) {
         return false;
     }
+    if (httpStatus) {
+        *httpStatus = response.status;
+    }
+    if (responseBody) {
+        *responseBody = std::move(response.body);
+    }
+    return true;
+}
 
-    std::string fullUrl = m_baseUrl;
+bool RestClient::Send(const std::string& method,
+                      const std::string& path,
+                      const std::string& body,
+                      const std::vector<std::string>& extraHeaders,
+                      HttpResponse* response,
+                      std::string* error) {
+    HttpRequest request;
+    request.method = method;
+    request.url = m_baseUrl;
     if (!path.empty() && path.front() != '/') {
-        fullUrl.push_back('/');
+        request.url.push_back('/');
     }
-    fullUrl += path;
-
-    curl_easy_setopt(curl, CURLOPT_URL, fullUrl.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
-
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
+    request.url += path;
+    request.body = body;
+    request.headers.reserve(extraHeaders.size() + 2);
+    request.headers.push_back("Content-Type: application/json");
     if (!m_apiToken.empty()) {
-        std::string tokenHeader = "X-Stage1-Token: " + m_apiToken;
-        headers = curl_slist_append(headers, tokenHeader.c_str());
-    }
-    for (const auto& hdr : extraHeaders) {
-        headers = curl_slist_append(headers, hdr.c_str());
-    }
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    if (method == "POST") {
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, body.size());
-    } else if (method != "GET") {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
-        if (!body.empty()) {
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, body.size());
-        }
-    }
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        if (error) *error = curl_easy_strerror(res);
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
+        request.headers.push_back("X-Stage1-Token: " + m_apiToken);
+    }
+    request.headers.insert(request.headers.end(), extraHeaders.begin(), extraHeaders.end());
+
+    const bool ok = m_transport->Perform(request, response);
+    const HttpTiming& timing = response->timing;
+    t_lastTiming = timing;
+    if (m_logTiming) {
+        std::cout << "[Stage1RestClient] " << method << ' ' << path
+                  << " -> " << response->status
+                  << " in " << std::fixed << std::setprecision(1) << timing.total_ms << " ms"
+                  << " (dns " << timing.dns_ms
+                  << ", connect " << timing.connect_ms
+                  << ", tls " << timing.tls_ms
+                  << ", first byte " << timing.first_byte_ms << ")"
+                  << std::defaultfloat
+                  << ", HTTP/" << timing.http_version
+                  << (timing.reused_connection ? ", reused" : ", new connection")
+                  << ", " << timing.bytes_received << " bytes" << std::endl;
+    }
+    if (!ok) {
+        if (error) *error = response->error;
         return false;
     }
+    return true;
+}
 
-    long status = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
-    if (httpStatus) {
-        *httpStatus = status;
-    }
-    if (responseBody) {
-        *responseBody = std::move(response);
-    }
+HttpTiming RestClient::LastRequestTiming() {
+    return t_lastTiming;
+}
 
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-    return true;
+HttpTransportStats RestClient::GetTransportStats() const {
+    return m_transport->Stats();
 }
 
 bool RestClient::ParseDatasets(const std::string& json,
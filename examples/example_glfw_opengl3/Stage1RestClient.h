@@ -1,11 +1,18 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <optional>
 #include <json/json.h>
 
+#include "Stage1HttpTransport.h"
+
+namespace arrow {
+class Table;
+}
+
 namespace stage1 {
 
 struct DatasetSummary {
@@ -133,15 +140,20 @@ public:
                         RunDetail* detail,
                         std::string* error);
 
-    bool FetchDatasetOhlcv(const std::string& datasetId,
-                           Json::Value* rows,
-                           std::string* error,
-                           int limit = 0);
-
-    bool FetchDatasetIndicators(const std::string& datasetId,
-                                Json::Value* rows,
+    // Typed columns with an int64 "timestamp_ms". Asks for an Arrow IPC
+    // stream and decodes JSON rows without a DOM when the server has none.
+    // limit/offset select one page of rows in timestamp order.
+    bool FetchDatasetOhlcvTable(const std::string& datasetId,
+                                std::shared_ptr<arrow::Table>* table,
                                 std::string* error,
-                                int limit = 0);
+                                int limit = 0,
+                                int64_t offset = 0);
+
+    bool FetchDatasetIndicatorTable(const std::string& datasetId,
+                                    std::shared_ptr<arrow::Table>* table,
+                                    std::string* error,
+                                    int limit = 0,
+                                    int64_t offset = 0);
 
     bool SubmitQuestDbImport(const std::string& measurement,
                              const std::string& csvData,
@@ -169,6 +181,16 @@ public:
                            AppendTarget target,
                            std::string* error);
 
+    // Posts an already serialized {"rows": [...]} body. A non-empty
+    // idempotencyKey goes out as Idempotency-Key, so a batch retried after
+    // a lost response is applied once. httpStatus is 0 on transport errors.
+    bool AppendDatasetRowBatch(const std::string& datasetId,
+                               const std::string& body,
+                               AppendTarget target,
+                               const std::string& idempotencyKey,
+                               long* httpStatus,
+                               std::string* error);
+
     bool CreateOrUpdateDataset(const std::string& datasetId,
                                const std::string& datasetSlug,
                                const std::string& granularity,
@@ -191,6 +213,14 @@ public:
     bool GetHealth(std::string* payload,
                    std::string* error);
 
+    // Timing of the calling thread's most recent request. Set
+    // STAGE1_HTTP_TIMING=1 to log every request's timing as well.
+    static HttpTiming LastRequestTiming();
+    HttpTransportStats GetTransportStats() const;
+
+    // Pooled keep-alive transport, for batches run with PerformAll()
+    HttpTransport& Transport() { return *m_transport; }
+
 private:
     RestClient();
     bool Execute(const std::string& method,
@@ -201,6 +231,21 @@ private:
                  std::string* responseBody,
                  std::string* error);
 
+    bool Send(const std::string& method,
+              const std::string& path,
+              const std::string& body,
+              const std::vector<std::string>& extraHeaders,
+              HttpResponse* response,
+              std::string* error);
+
+    bool FetchDatasetTable(const std::string& datasetId,
+                           const char* part,
+                           const char* label,
+                           int limit,
+                           int64_t offset,
+                           std::shared_ptr<arrow::Table>* table,
+                           std::string* error);
+
     bool ParseDatasets(const std::string& json,
                        std::vector<DatasetSummary>* datasets,
                        std::string* error);
@@ -216,6 +261,8 @@ private:
 
     std::string m_baseUrl;
     std::string m_apiToken;
+    bool m_logTiming = false;
+    std::unique_ptr<HttpTransport> m_transport;
 };
 
 } // namespace stage1
@@ -0,0 +1,242 @@
+#include "Stage1RowUploader.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace stage1 {
+
+namespace {
+
+constexpr const char* kBatchPrefix = "{\"rows\":[";
+constexpr const char* kBatchSuffix = "]}";
+
+// Same body, same key: a resent batch is recognisable however often it is
+// retried, and so is the same batch from a re-run export
+std::string MakeIdempotencyKey(const std::string& datasetId,
+                               RestClient::AppendTarget target,
+                               const std::string& body) {
+    uint64_t hash = 1469598103934665603ull;
+    for (unsigned char ch : body) {
+        hash ^= ch;
+        hash *= 1099511628211ull;
+    }
+    std::ostringstream key;
+    key << datasetId << '-' << (target == RestClient::AppendTarget::Ohlcv ? "ohlcv" : "indicators")
+        << '-' << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+// Nothing shows the append endpoint honours Idempotency-Key, so only
+// failures that prove the rows were not stored are retried: a transport
+// error before any of the body went out, or an explicit 429/503. A timeout
+// or a 500 after the body was sent may have landed and is not resent.
+bool IsRetryable(long status, int64_t bytesSent) {
+    if (status == 0) {
+        return bytesSent == 0;
+    }
+    return status == 429 || status == 503;
+}
+
+} // namespace
+
+RowUploader::RowUploader(RestClient::AppendTarget target, RowUploadOptions options)
+    : m_target(target),
+      m_options(options) {
+    m_options.batch_rows = std::max<int64_t>(m_options.batch_rows, 1);
+    m_options.max_in_flight = std::max(m_options.max_in_flight, 1);
+    m_options.max_attempts = std::max(m_options.max_attempts, 1);
+}
+
+RowUploadProgress RowUploader::Progress() const {
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    RowUploadProgress progress = m_progress;
+    if (progress.active) {
+        progress.elapsed_seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - m_started).count();
+    }
+    return progress;
+}
+
+bool RowUploader::PostBatch(const std::string& datasetId, const std::string& body, std::string* error) {
+    const std::string key = MakeIdempotencyKey(datasetId, m_target, body);
+    int backoffMs = m_options.retry_backoff_ms;
+    for (int attempt = 1; ; ++attempt) {
+        long status = 0;
+        std::string attemptError;
+        if (RestClient::Instance().AppendDatasetRowBatch(datasetId, body, m_target, key, &status, &attemptError)) {
+            return true;
+        }
+        if (!IsRetryable(status, RestClient::LastRequestTiming().bytes_sent) || attempt >= m_options.max_attempts) {
+            if (error) {
+                *error = attemptError;
+                if (attempt > 1) {
+                    *error += " (after " + std::to_string(attempt) + " attempts)";
+                }
+            }
+            return false;
+        }
+        std::cerr << "[Stage1RowUploader] Batch failed (" << attemptError << "), retry "
+                  << attempt << " of " << (m_options.max_attempts - 1) << " in " << backoffMs << " ms"
+                  << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            ++m_progress.retries;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoffMs));
+        backoffMs *= 2;
+    }
+}
+
+bool RowUploader::Upload(const std::string& datasetId,
+                         int64_t sourceRows,
+                         const RowBatchSerializer& serialize,
+                         int64_t* rowsSent,
+                         std::string* error) {
+    if (rowsSent) *rowsSent = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_progress = RowUploadProgress();
+        m_progress.active = true;
+        m_progress.rows_total = sourceRows;
+        m_started = std::chrono::steady_clock::now();
+    }
+
+    struct Batch {
+        std::string body;
+        int64_t rows = 0;
+    };
+
+    // One buffer more than there are posters, so the next batch is being
+    // serialized while every poster is busy
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::string> freeBuffers(static_cast<size_t>(m_options.max_in_flight) + 1);
+    std::deque<Batch> ready;
+    bool producerDone = false;
+    bool failed = false;
+    std::string firstError;
+
+    auto fail = [&](std::string message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!failed) {
+            failed = true;
+            firstError = std::move(message);
+        }
+        changed.notify_all();
+    };
+
+    auto poster = [&]() {
+        while (true) {
+            Batch batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return failed || !ready.empty() || producerDone; });
+                if (failed || ready.empty()) {
+                    return;
+                }
+                batch = std::move(ready.front());
+                ready.pop_front();
+            }
+
+            std::string postError;
+            if (!PostBatch(datasetId, batch.body, &postError)) {
+                fail(std::move(postError));
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_progressMutex);
+                m_progress.rows_sent += batch.rows;
+                m_progress.bytes_sent += static_cast<int64_t>(batch.body.size());
+                ++m_progress.batches_sent;
+            }
+
+            batch.body.clear();     // Keeps its capacity for the next batch
+            std::lock_guard<std::mutex> lock(mutex);
+            freeBuffers.push_back(std::move(batch.body));
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> posters;
+    posters.reserve(static_cast<size_t>(m_options.max_in_flight));
+    for (int i = 0; i < m_options.max_in_flight; ++i) {
+        posters.emplace_back(poster);
+    }
+
+    for (int64_t begin = 0; begin < sourceRows; begin += m_options.batch_rows) {
+        std::string buffer;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return failed || !freeBuffers.empty(); });
+            if (failed) {
+                break;
+            }
+            buffer = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+
+        const int64_t end = std::min(sourceRows, begin + m_options.batch_rows);
+        std::string serializeError;
+        buffer.append(kBatchPrefix);
+        const int64_t written = serialize(begin, end, &buffer, &serializeError);
+        buffer.append(kBatchSuffix);
+        if (written < 0) {
+            fail(serializeError.empty() ? std::string("Failed to serialize rows.") : serializeError);
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_progressMutex);
+            m_progress.rows_serialized += end - begin;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (written == 0) {
+            buffer.clear();
+            freeBuffers.push_back(std::move(buffer));
+            continue;
+        }
+        ready.push_back(Batch{ std::move(buffer), written });
+        changed.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        producerDone = true;
+        changed.notify_all();
+    }
+    for (auto& thread : posters) {
+        thread.join();
+    }
+
+    const auto progress = Progress();
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_progress.active = false;
+        m_progress.elapsed_seconds = progress.elapsed_seconds;
+    }
+    if (rowsSent) *rowsSent = progress.rows_sent;
+
+    if (failed) {
+        if (error) *error = firstError;
+        return false;
+    }
+    const double seconds = std::max(progress.elapsed_seconds, 1e-6);
+    std::cout << "[Stage1RowUploader] " << progress.rows_sent << " rows in " << progress.batches_sent
+              << " batches, " << std::fixed << std::setprecision(1)
+              << (static_cast<double>(progress.bytes_sent) / (1024.0 * 1024.0)) / seconds << " MB/s, "
+              << std::setprecision(0) << static_cast<double>(progress.rows_sent) / seconds << " rows/s"
+              << std::defaultfloat;
+    if (progress.retries > 0) {
+        std::cout << ", " << progress.retries << " retries";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+} // namespace stage1
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Stage1RestClient.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace stage1 {
+
+// Appends the JSON objects of source rows [begin, end) to out, comma
+// separated, and returns how many it wrote. Rows may be skipped. A negative
+// return aborts the upload with *error set.
+using RowBatchSerializer = std::function<int64_t(int64_t begin, int64_t end, std::string* out, std::string* error)>;
+
+struct RowUploadOptions {
+    int64_t batch_rows = 10000;
+    int max_in_flight = 1;              // Batches being posted at once; above 1 they may land out of order
+    int max_attempts = 4;               // Per batch, including the first
+    int retry_backoff_ms = 250;         // Doubled after every failed attempt
+};
+
+struct RowUploadProgress {
+    bool active = false;
+    int64_t rows_total = 0;             // Source rows, before any are skipped
+    int64_t rows_serialized = 0;
+    int64_t rows_sent = 0;
+    int64_t batches_sent = 0;
+    int64_t retries = 0;
+    int64_t bytes_sent = 0;
+    double elapsed_seconds = 0.0;
+};
+
+// Streams rows to /api/datasets/<id>/<part>/append in fixed-size batches.
+//
+// The calling thread serializes one batch after another into a small pool of
+// reused buffers while max_in_flight threads post the finished ones, so the
+// network never waits for the whole dataset to be encoded and memory stays
+// at a few batches. With the default single poster, batches are appended in
+// source (time) order and a failed batch stops the ones after it. More
+// posters are only for targets that accept rows out of time order.
+//
+// Each batch carries an Idempotency-Key derived from its body. A post is
+// retried with backoff only when the rows provably were not stored: a
+// transport error before any body bytes were sent, or HTTP 429/503.
+class RowUploader {
+public:
+    explicit RowUploader(RestClient::AppendTarget target,
+                         RowUploadOptions options = RowUploadOptions());
+
+    // rowsSent (optional) is the number of rows the server accepted
+    bool Upload(const std::string& datasetId,
+                int64_t sourceRows,
+                const RowBatchSerializer& serialize,
+                int64_t* rowsSent,
+                std::string* error);
+
+    RowUploadProgress Progress() const;
+
+private:
+    bool PostBatch(const std::string& datasetId, const std::string& body, std::string* error);
+
+    RestClient::AppendTarget m_target;
+    RowUploadOptions m_options;
+
+    mutable std::mutex m_progressMutex;
+    RowUploadProgress m_progress;
+    std::chrono::steady_clock::time_point m_started;
+};
+
+} // namespace stage1
@@ -0,0 +1,274 @@
+#include "TableCellCache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+#include <arrow/api.h>
+
+namespace {
+
+constexpr std::string_view kNullText = "N/A";
+constexpr std::string_view kMissingText = "[Missing]";
+
+template <typename T>
+void AppendNumber(T value, std::string* out) {
+    char buffer[64];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    if (result.ec == std::errc()) {
+        out->append(buffer, result.ptr);
+    }
+}
+
+template <typename T>
+T LoadValue(const uint8_t* values, int64_t index) {
+    T value;
+    std::memcpy(&value, values + index * static_cast<int64_t>(sizeof(T)), sizeof(T));
+    return value;
+}
+
+void AppendDigits(int64_t value, int width, std::string* out) {
+    char buffer[24];
+    int length = 0;
+    do {
+        buffer[length++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (int i = length; i < width; ++i) {
+        out->push_back('0');
+    }
+    while (length > 0) {
+        out->push_back(buffer[--length]);
+    }
+}
+
+// "YYYY-MM-DD HH:MM:SS[.fff...]" in UTC, civil date from days since epoch
+void AppendTimestamp(int64_t ticks, int64_t ticksPerSecond, std::string* out) {
+    int64_t seconds = ticks / ticksPerSecond;
+    int64_t fraction = ticks % ticksPerSecond;
+    if (fraction < 0) {
+        fraction += ticksPerSecond;
+        --seconds;
+    }
+    int64_t days = seconds / 86400;
+    int64_t secondOfDay = seconds % 86400;
+    if (secondOfDay < 0) {
+        secondOfDay += 86400;
+        --days;
+    }
+
+    const int64_t z = days + 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const int64_t dayOfEra = z - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t mp = (5 * dayOfYear + 2) / 153;
+    const int64_t day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    const int64_t year = yearOfEra + era * 400 + (month <= 2 ? 1 : 0);
+
+    if (year < 0) {
+        out->push_back('-');
+    }
+    AppendDigits(year < 0 ? -year : year, 4, out);
+    out->push_back('-');
+    AppendDigits(month, 2, out);
+    out->push_back('-');
+    AppendDigits(day, 2, out);
+    out->push_back(' ');
+    AppendDigits(secondOfDay / 3600, 2, out);
+    out->push_back(':');
+    AppendDigits((secondOfDay / 60) % 60, 2, out);
+    out->push_back(':');
+    AppendDigits(secondOfDay % 60, 2, out);
+    if (ticksPerSecond > 1) {
+        int width = 0;
+        for (int64_t scale = ticksPerSecond; scale > 1; scale /= 10) {
+            ++width;
+        }
+        out->push_back('.');
+        AppendDigits(fraction, width, out);
+    }
+}
+
+int64_t TicksPerSecond(arrow::TimeUnit::type unit) {
+    switch (unit) {
+        case arrow::TimeUnit::SECOND: return 1;
+        case arrow::TimeUnit::MILLI: return 1000;
+        case arrow::TimeUnit::MICRO: return 1000000;
+        case arrow::TimeUnit::NANO: return 1000000000;
+    }
+    return 1;
+}
+
+} // namespace
+
+void TableCellCache::SetTable(std::shared_ptr<arrow::Table> table) {
+    Clear();
+    if (!table) {
+        return;
+    }
+    m_table = std::move(table);
+    m_numRows = m_table->num_rows();
+    m_blocks.reserve(kMaxBlocks);
+    m_columns.resize(static_cast<size_t>(m_table->num_columns()));
+
+    for (int col = 0; col < m_table->num_columns(); ++col) {
+        const auto column = m_table->column(col);
+        if (!column) {
+            continue;
+        }
+        Column& target = m_columns[static_cast<size_t>(col)];
+        int64_t firstRow = 0;
+        for (const auto& array : column->chunks()) {
+            if (!array || array->length() == 0) {
+                continue;
+            }
+            Chunk chunk;
+            chunk.array = array;
+            chunk.first_row = firstRow;
+            chunk.type = static_cast<int>(array->type_id());
+            const auto& data = *array->data();
+            if (arrow::is_fixed_width(array->type_id()) && array->type_id() != arrow::Type::BOOL &&
+                data.buffers.size() > 1 && data.buffers[1]) {
+                const auto& fixed = static_cast<const arrow::FixedWidthType&>(*array->type());
+                chunk.values = data.buffers[1]->data() + data.offset * (fixed.bit_width() / 8);
+            }
+            if (array->type_id() == arrow::Type::TIMESTAMP) {
+                const auto& type = static_cast<const arrow::TimestampType&>(*array->type());
+                chunk.scale = TicksPerSecond(type.unit());
+            }
+            target.chunks.push_back(std::move(chunk));
+            firstRow += array->length();
+        }
+    }
+}
+
+void TableCellCache::Clear() {
+    m_table.reset();
+    m_columns.clear();
+    m_numRows = 0;
+    m_blocks.clear();
+    m_lastBlock = 0;
+    m_clock = 0;
+}
+
+std::string_view TableCellCache::Cell(int64_t row, int col) {
+    if (row < 0 || row >= m_numRows || col < 0 || col >= NumColumns()) {
+        return kMissingText;
+    }
+    const Block& block = BlockFor(row);
+    const size_t cell = static_cast<size_t>(row - block.first_row) * m_columns.size() + static_cast<size_t>(col);
+    const uint32_t begin = block.offsets[cell];
+    const uint32_t end = block.offsets[cell + 1];
+    return std::string_view(block.arena.data() + begin, end - begin);
+}
+
+TableCellCache::Block& TableCellCache::BlockFor(int64_t row) {
+    ++m_clock;
+    if (m_lastBlock < m_blocks.size()) {
+        Block& last = m_blocks[m_lastBlock];
+        if (row >= last.first_row && row < last.first_row + last.rows) {
+            last.last_used = m_clock;
+            return last;
+        }
+    }
+
+    const int64_t firstRow = (row / kBlockRows) * kBlockRows;
+    size_t victim = m_blocks.size();
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        if (m_blocks[i].first_row == firstRow) {
+            m_lastBlock = i;
+            m_blocks[i].last_used = m_clock;
+            return m_blocks[i];
+        }
+        if (victim == m_blocks.size() || m_blocks[i].last_used < m_blocks[victim].last_used) {
+            victim = i;
+        }
+    }
+    if (m_blocks.size() < kMaxBlocks) {
+        victim = m_blocks.size();
+        m_blocks.emplace_back();
+    }
+
+    Block& block = m_blocks[victim];
+    FormatBlock(&block, firstRow);
+    block.last_used = m_clock;
+    m_lastBlock = victim;
+    return block;
+}
+
+// The evicted block's arena and offsets keep their capacity for the next rows
+void TableCellCache::FormatBlock(Block* block, int64_t firstRow) {
+    block->first_row = firstRow;
+    block->rows = std::min(kBlockRows, m_numRows - firstRow);
+    block->arena.clear();
+    block->offsets.clear();
+    block->offsets.reserve(static_cast<size_t>(block->rows) * m_columns.size() + 1);
+    block->offsets.push_back(0);
+    for (int64_t row = firstRow; row < firstRow + block->rows; ++row) {
+        for (const Column& column : m_columns) {
+            AppendCell(column, row, &block->arena);
+            block->offsets.push_back(static_cast<uint32_t>(block->arena.size()));
+        }
+    }
+}
+
+void TableCellCache::AppendCell(const Column& column, int64_t row, std::string* out) const {
+    auto it = std::upper_bound(column.chunks.begin(), column.chunks.end(), row,
+                               [](int64_t value, const Chunk& chunk) { return value < chunk.first_row; });
+    if (it == column.chunks.begin()) {
+        out->append(kMissingText);
+        return;
+    }
+    const Chunk& chunk = *(it - 1);
+    const int64_t index = row - chunk.first_row;
+    if (index >= chunk.array->length()) {
+        out->append(kMissingText);
+        return;
+    }
+    if (chunk.array->IsNull(index)) {
+        out->append(kNullText);
+        return;
+    }
+
+    if (chunk.values) {
+        switch (chunk.type) {
+            case arrow::Type::DOUBLE: AppendNumber(LoadValue<double>(chunk.values, index), out); return;
+            case arrow::Type::FLOAT: AppendNumber(LoadValue<float>(chunk.values, index), out); return;
+            case arrow::Type::INT8: AppendNumber(LoadValue<int8_t>(chunk.values, index), out); return;
+            case arrow::Type::INT16: AppendNumber(LoadValue<int16_t>(chunk.values, index), out); return;
+            case arrow::Type::INT32: AppendNumber(LoadValue<int32_t>(chunk.values, index), out); return;
+            case arrow::Type::INT64: AppendNumber(LoadValue<int64_t>(chunk.values, index), out); return;
+            case arrow::Type::UINT8: AppendNumber(LoadValue<uint8_t>(chunk.values, index), out); return;
+            case arrow::Type::UINT16: AppendNumber(LoadValue<uint16_t>(chunk.values, index), out); return;
+            case arrow::Type::UINT32: AppendNumber(LoadValue<uint32_t>(chunk.values, index), out); return;
+            case arrow::Type::UINT64: AppendNumber(LoadValue<uint64_t>(chunk.values, index), out); return;
+            case arrow::Type::TIMESTAMP:
+                AppendTimestamp(LoadValue<int64_t>(chunk.values, index), chunk.scale, out);
+                return;
+            default:
+                break;
+        }
+    }
+    switch (chunk.type) {
+        case arrow::Type::BOOL:
+            out->append(static_cast<const arrow::BooleanArray&>(*chunk.array).Value(index) ? "true" : "false");
+            return;
+        case arrow::Type::STRING: {
+            const auto view = static_cast<const arrow::StringArray&>(*chunk.array).GetView(index);
+            out->append(view.data(), view.size());
+            return;
+        }
+        case arrow::Type::LARGE_STRING: {
+            const auto view = static_cast<const arrow::LargeStringArray&>(*chunk.array).GetView(index);
+            out->append(view.data(), view.size());
+            return;
+        }
+        default: {
+            auto scalar = chunk.array->GetScalar(index);
+            out->append(scalar.ok() ? scalar.ValueOrDie()->ToString() : std::string(kNullText));
+            return;
+        }
+    }
+}
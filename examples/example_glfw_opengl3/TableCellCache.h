@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace arrow {
+class Array;
+class Table;
+}
+
+// Formats table cells on demand for a clipped ImGui table.
+//
+// Rows are formatted a block at a time, straight from the typed column
+// buffers, into one character arena per block; ImGui draws the cells as
+// slices of that arena. Only the most recently used blocks are kept, so
+// memory follows the number of rows on screen rather than the size of the
+// table. Numbers use std::to_chars, timestamps are printed as UTC
+// date-times and nulls as "N/A". Types without a fast path fall back to
+// Arrow's own formatting.
+class TableCellCache {
+public:
+    static constexpr int64_t kBlockRows = 64;
+    static constexpr size_t kMaxBlocks = 16;
+
+    void SetTable(std::shared_ptr<arrow::Table> table);
+    void Clear();
+
+    int64_t NumRows() const { return m_numRows; }
+    int NumColumns() const { return static_cast<int>(m_columns.size()); }
+
+    // Valid until the next call to Cell() or SetTable()
+    std::string_view Cell(int64_t row, int col);
+
+private:
+    struct Chunk {
+        std::shared_ptr<arrow::Array> array;
+        int64_t first_row = 0;
+        int type = 0;                       // arrow::Type::type
+        const uint8_t* values = nullptr;    // Fixed-width values, array offset applied
+        int64_t scale = 0;                  // Timestamp ticks per second
+    };
+
+    struct Column {
+        std::vector<Chunk> chunks;
+    };
+
+    struct Block {
+        int64_t first_row = -1;
+        int64_t rows = 0;
+        uint64_t last_used = 0;
+        std::string arena;
+        std::vector<uint32_t> offsets;      // rows * columns + 1 cell bounds into arena
+    };
+
+    Block& BlockFor(int64_t row);
+    void FormatBlock(Block* block, int64_t firstRow);
+    void AppendCell(const Column& column, int64_t row, std::string* out) const;
+
+    std::shared_ptr<arrow::Table> m_table;
+    std::vector<Column> m_columns;
+    int64_t m_numRows = 0;
+    std::vector<Block> m_blocks;
+    size_t m_lastBlock = 0;
+    uint64_t m_clock = 0;
+};
@@ -8,6 +8,8 @@
 #include "StationarityWindow.h"
 #include "FSCAWindow.h"
 #include "stage1_metadata_writer.h"
+#include "modern_discretizer.h"
+#include "implot_internal.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -67,7 +69,6 @@
 
 #include "QuestDbDataFrameGateway.h"
 #include "Stage1RestClient.h"
-#include <json/json.h>
 
 namespace {
 std::string SanitizeSlug(const std::string& value) {
@@ -210,26 +211,6 @@ std::optional<int64_t> ParseIsoToMillis(const std::string& text) {
     return static_cast<int64_t>(seconds) * 1000LL + fractionMillis;
 }
 
-std::string ChunkedValueToString(const std::shared_ptr<arrow::ChunkedArray>& column, int64_t row) {
-    if (!column) {
-        return "[Missing]";
-    }
-    int64_t offset = row;
-    for (const auto& chunk : column->chunks()) {
-        if (!chunk) {
-            continue;
-        }
-        if (offset < chunk->length()) {
-            if (!chunk->IsValid(offset)) {
-                return "N/A";
-            }
-            return chunk->FormatValue(offset);
-        }
-        offset -= chunk->length();
-    }
-    return "N/A";
-}
-
 arrow::Result<chronosflow::AnalyticsDataFrame> EnsureTimestampUnixColumn(chronosflow::AnalyticsDataFrame&& frame) {
     auto table = frame.get_cpu_table();
     if (!table) {
@@ -557,6 +538,20 @@ void TimeSeriesWindow::SetActiveDatasetMetadata(const DatasetMetadata& metadata)
     m_activeDataset = metadata;
 }
 
+bool TimeSeriesWindow::GetStage1DownloadProgress(stage1::DatasetDownloadProgress* progress) const {
+    if (!m_stage1Download) {
+        return false;
+    }
+    auto current = m_stage1Download->Progress();
+    if (!current.active) {
+        return false;
+    }
+    if (progress) {
+        *progress = current;
+    }
+    return true;
+}
+
 std::pair<std::optional<int64_t>, std::optional<int64_t>> TimeSeriesWindow::GetTimestampBounds() const {
     if (!m_dataFrame) {
         return {};
@@ -578,6 +573,7 @@ void TimeSeriesWindow::Draw() {
         auto finishLoading = [&]() {
             m_isLoading = false;
             m_isQuestDBFetching = false;
+            m_stage1Download.reset();
         };
 
         if (result.ok()) {
@@ -649,6 +645,7 @@ void TimeSeriesWindow::Draw() {
             }
 
             m_dataFrame = std::move(df);
+            DiscretizationCache::instance().clear();  // Sorted columns of the previous frame
             m_columnHeaders = m_dataFrame->column_names();
 
             UpdateDisplayCache();
@@ -921,9 +918,10 @@ void TimeSeriesWindow::DrawQuestDBImportControls() {
 }
 
 void TimeSeriesWindow::DrawDataTable() {
-    if (m_columnHeaders.empty() || m_displayCache.empty()) return;
+    if (m_columnHeaders.empty() || m_cellCache.NumRows() == 0) return;
 
-    const size_t numRows = m_displayCache.size();
+    // Every row is listed; the clipper only asks for the visible ones
+    const int numRows = static_cast<int>(std::min<int64_t>(m_cellCache.NumRows(), std::numeric_limits<int>::max()));
     const int numColumns = static_cast<int>(m_columnHeaders.size());
 
     if (ImGui::BeginTable("TimeSeriesTable", numColumns, m_tableFlags)) {
@@ -958,8 +956,8 @@ void TimeSeriesWindow::DrawDataTable() {
                 ImGui::TableNextRow();
                 for (int col = 0; col < numColumns; ++col) {
                     ImGui::TableSetColumnIndex(col);
-                    // --- PERFORMANCE FIX: Read from cache ---
-                    ImGui::TextUnformatted(m_displayCache[row][col].c_str());
+                    const std::string_view text = m_cellCache.Cell(row, col);
+                    ImGui::TextUnformatted(text.data(), text.data() + text.size());
 
                     if (col == m_selectedColumnIndex) {
                         ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, ImGui::GetColorU32(ImGuiCol_HeaderHovered));
@@ -968,13 +966,6 @@ void TimeSeriesWindow::DrawDataTable() {
             }
         }
         
-        // Show pagination info if data is truncated
-        if (m_dataFrame && m_dataFrame->num_rows() > MAX_DISPLAY_ROWS) {
-            ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0);
-            ImGui::Text("... (%lld more rows)", m_dataFrame->num_rows() - MAX_DISPLAY_ROWS);
-        }
-        
         ImGui::EndTable();
     }
 }
@@ -1011,28 +1002,58 @@ void TimeSeriesWindow::DrawPlotArea() {
         ImPlot::SetupAxisFormat(ImAxis_X1, "%Y-%m-%d");
         ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Time);
         
-        if (m_autoFitPlot && !m_cachedPlotValues.empty()) {
-            // Calculate actual data range for Y-axis
-            auto minmax = std::minmax_element(m_cachedPlotValues.begin(), m_cachedPlotValues.end());
-            double minVal = *minmax.first;
-            double maxVal = *minmax.second;
-            
-            // Add some padding (5% on each side) for better visualization
-            double range = maxVal - minVal;
-            double padding = range * 0.05;
-            if (range == 0.0) {
-                // Handle case where all values are the same
-                padding = std::abs(minVal) * 0.1;
-                if (padding == 0.0) padding = 1.0; // Fallback for zero values
+        if (m_autoFitPlot && !m_plotLod.Empty()) {
+            // Calculate actual data range for Y-axis from the pyramid's top buckets
+            double minVal = 0.0;
+            double maxVal = 0.0;
+            if (m_plotLod.RangeMinMax(0, m_plotLod.Count(), &minVal, &maxVal)) {
+                // Add some padding (5% on each side) for better visualization
+                double range = maxVal - minVal;
+                double padding = range * 0.05;
+                if (range == 0.0) {
+                    // Handle case where all values are the same
+                    padding = std::abs(minVal) * 0.1;
+                    if (padding == 0.0) padding = 1.0; // Fallback for zero values
+                }
+                
+                ImPlot::SetupAxisLimits(ImAxis_Y1, minVal - padding, maxVal + padding, ImGuiCond_Always);
             }
-            
-            ImPlot::SetupAxisLimits(ImAxis_Y1, minVal - padding, maxVal + padding, ImGuiCond_Always);
         }
         
         if (!m_cachedPlotTimes.empty()) {
-            ImPlot::PlotLine(m_selectedIndicator.c_str(),
-                           m_cachedPlotTimes.data(), m_cachedPlotValues.data(),
-                           static_cast<int>(m_cachedPlotTimes.size()));
+            // Only the visible range is drawn, except on frames where ImPlot
+            // fits the axes to the data
+            const ImPlotRect limits = ImPlot::GetPlotLimits();
+            size_t begin = 0;
+            size_t end = m_cachedPlotTimes.size();
+            if (!ImPlot::FitThisFrame() && m_cachedPlotTimesSorted) {
+                const double* times = m_cachedPlotTimes.data();
+                size_t first = static_cast<size_t>(std::lower_bound(times, times + end, limits.X.Min) - times);
+                size_t last = static_cast<size_t>(std::upper_bound(times, times + end, limits.X.Max) - times);
+                // One point past each edge so the line reaches the plot border
+                first = first > 0 ? first - 1 : 0;
+                last = std::min(last + 1, end);
+                if (first < last) {
+                    begin = first;
+                    end = last;
+                }
+            }
+            
+            const double pixels = std::max(1.0f, ImPlot::GetPlotSize().x);
+            const int level = plot_lod::PickLevel(begin, end, pixels / 2.0, m_plotLod.LevelCount());
+            if (level == 0) {
+                ImPlot::PlotLine(m_selectedIndicator.c_str(),
+                               m_cachedPlotTimes.data() + begin, m_cachedPlotValues.data() + begin,
+                               static_cast<int>(end - begin));
+            } else {
+                m_lodPlotTimes.clear();
+                m_lodPlotValues.clear();
+                plot_lod::DecimateLine(m_plotLod, m_cachedPlotTimes.data(), m_cachedPlotValues.data(),
+                                       begin, end, level, &m_lodPlotTimes, &m_lodPlotValues);
+                ImPlot::PlotLine(m_selectedIndicator.c_str(),
+                               m_lodPlotTimes.data(), m_lodPlotValues.data(),
+                               static_cast<int>(m_lodPlotTimes.size()));
+            }
         } else {
             ImPlot::PlotText("No valid data points to plot", 0.5, 0.5);
         }
@@ -1075,7 +1096,8 @@ void TimeSeriesWindow::LoadCSVFile(const std::string& filepath) {
         options.has_header = true; 
         
         // Let the generic loader run. We will find the date/time columns later.
-        return chronosflow::DataFrameIO::read_tssb(filepath, options);
+        // Repeat loads of an unchanged file memory-map the IPC cache instead.
+        return chronosflow::DataFrameIO::read_tssb_cached(filepath, options);
     });
 }
 
@@ -1162,137 +1184,53 @@ void TimeSeriesWindow::LoadFromStage1(const std::string& datasetId) {
     m_lastQuestDBFetchSuccess = false;
     m_loadedFilePath = "Stage1:" + datasetId;
 
-    m_loadingFuture = std::async(std::launch::async, [datasetId]() -> arrow::Result<chronosflow::AnalyticsDataFrame> {
-        // Fetch data from Stage1 API
-        Json::Value rows;
+    auto download = std::make_shared<stage1::DatasetDownloader>(datasetId, stage1::DatasetPart::Indicators);
+    m_stage1Download = download;
+    m_loadingFuture = std::async(std::launch::async, [download]() -> arrow::Result<chronosflow::AnalyticsDataFrame> {
+        std::shared_ptr<arrow::Table> rows;
         std::string error;
-        if (!stage1::RestClient::Instance().FetchDatasetIndicators(datasetId, &rows, &error)) {
+        if (!download->Run(&rows, &error)) {
             return arrow::Status::IOError("Failed to fetch indicators: " + error);
         }
-
-        if (!rows.isArray() || rows.empty()) {
+        if (!rows || rows->num_rows() == 0) {
             return arrow::Status::IOError("No indicator data returned from Stage1.");
         }
 
-        // Build Arrow table directly from JSON
-        std::vector<std::string> columnNames;
-        std::map<std::string, std::vector<double>> doubleColumns;
-        std::vector<int64_t> timestamps;
-
-        // Extract column names from first row (skip timestamp and string columns)
-        if (rows[0].isObject()) {
-            for (auto it = rows[0].begin(); it != rows[0].end(); ++it) {
-                std::string colName = it.name();
-                // Skip timestamp columns and string columns (Date, Time, etc.)
-                if (colName == "timestamp_ms" || colName == "timestamp" ||
-                    colName == "Date" || colName == "Time" ||
-                    !it->isNumeric()) {
-                    continue;
-                }
-                columnNames.push_back(colName);
-                doubleColumns[colName].reserve(rows.size());
-            }
-        }
-
-        timestamps.reserve(rows.size());
-
-        // Helper to parse ISO8601 timestamp to milliseconds
-        auto parseTimestampMs = [](const Json::Value& val) -> int64_t {
-            if (val.isInt64()) {
-                return val.asInt64();
-            } else if (val.isString()) {
-                std::string str = val.asString();
-                // Parse ISO8601: "2024-11-28T22:00:00.000000Z"
-                if (str.size() >= 19) {
-                    std::tm tm = {};
-                    int year, month, day, hour, minute, second;
-                    if (sscanf(str.c_str(), "%d-%d-%dT%d:%d:%d", &year, &month, &day, &hour, &minute, &second) == 6) {
-                        tm.tm_year = year - 1900;
-                        tm.tm_mon = month - 1;
-                        tm.tm_mday = day;
-                        tm.tm_hour = hour;
-                        tm.tm_min = minute;
-                        tm.tm_sec = second;
-                        #ifdef _WIN32
-                        time_t t = _mkgmtime(&tm);
-                        #else
-                        time_t t = timegm(&tm);
-                        #endif
-                        int64_t millis = static_cast<int64_t>(t) * 1000LL;
-                        auto dot = str.find('.');
-                        if (dot != std::string::npos) {
-                            std::string frac = str.substr(dot + 1);
-                            while (!frac.empty() && !std::isdigit(static_cast<unsigned char>(frac.back()))) {
-                                frac.pop_back();
-                            }
-                            if (!frac.empty()) {
-                                while (frac.size() < 3) frac.push_back('0');
-                                if (frac.size() > 3) frac.resize(3);
-                                try {
-                                    millis += std::stoll(frac);
-                                } catch (...) {
-                                }
-                            }
-                        }
-                        return millis;
-                    }
-                }
-            }
-            return 0;
-        };
-
-        // Extract data
-        for (const auto& row : rows) {
-            if (!row.isObject()) continue;
-
-            // Extract timestamp (milliseconds)
-            int64_t ts_millis = 0;
-            if (row.isMember("timestamp_ms")) {
-                ts_millis = parseTimestampMs(row["timestamp_ms"]);
-            } else if (row.isMember("timestamp")) {
-                ts_millis = parseTimestampMs(row["timestamp"]);
-            }
-            timestamps.push_back(ts_millis);
-
-            // Extract indicator values
-            for (const auto& colName : columnNames) {
-                double value = 0.0;
-                if (row.isMember(colName)) {
-                    const auto& val = row[colName];
-                    if (val.isDouble()) {
-                        value = val.asDouble();
-                    } else if (val.isInt()) {
-                        value = static_cast<double>(val.asInt64());
-                    }
-                }
-                doubleColumns[colName].push_back(value);
-            }
-        }
-
-        // Build Arrow schema and arrays
+        // timestamp_unix (ms) followed by every numeric indicator as
+        // float64, with missing values as 0 like the QuestDB export
         std::vector<std::shared_ptr<arrow::Field>> fields;
-        std::vector<std::shared_ptr<arrow::Array>> arrays;
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
 
-        // Add timestamp column (seconds, same as QuestDB export)
         fields.push_back(arrow::field("timestamp_unix", arrow::int64()));
-        arrow::Int64Builder tsBuilder;
-        ARROW_RETURN_NOT_OK(tsBuilder.AppendValues(timestamps));
-        std::shared_ptr<arrow::Array> tsArray;
-        ARROW_RETURN_NOT_OK(tsBuilder.Finish(&tsArray));
-        arrays.push_back(tsArray);
-
-        // Add indicator columns
-        for (const auto& colName : columnNames) {
-            fields.push_back(arrow::field(colName, arrow::float64()));
-            arrow::DoubleBuilder builder;
-            ARROW_RETURN_NOT_OK(builder.AppendValues(doubleColumns[colName]));
+        if (auto timestamps = rows->GetColumnByName("timestamp_ms")) {
+            ARROW_ASSIGN_OR_RAISE(auto filled, arrow::compute::CallFunction(
+                "coalesce", { timestamps, arrow::MakeScalar(int64_t{0}) }));
+            columns.push_back(filled.chunked_array());
+        } else {
+            arrow::Int64Builder zeros;
+            ARROW_RETURN_NOT_OK(zeros.AppendEmptyValues(rows->num_rows()));
             std::shared_ptr<arrow::Array> array;
-            ARROW_RETURN_NOT_OK(builder.Finish(&array));
-            arrays.push_back(array);
+            ARROW_RETURN_NOT_OK(zeros.Finish(&array));
+            columns.push_back(std::make_shared<arrow::ChunkedArray>(array));
+        }
+
+        for (int i = 0; i < rows->num_columns(); ++i) {
+            const auto& field = rows->schema()->field(i);
+            const std::string& colName = field->name();
+            // Skip timestamp columns and string columns (Date, Time, etc.)
+            if (colName == "timestamp_ms" || colName == "timestamp" ||
+                colName == "Date" || colName == "Time" ||
+                !(arrow::is_integer(field->type()->id()) || arrow::is_floating(field->type()->id()))) {
+                continue;
+            }
+            ARROW_ASSIGN_OR_RAISE(auto asDouble, arrow::compute::Cast(rows->column(i), arrow::float64()));
+            ARROW_ASSIGN_OR_RAISE(auto filled, arrow::compute::CallFunction(
+                "coalesce", { asDouble, arrow::MakeScalar(0.0) }));
+            fields.push_back(arrow::field(colName, arrow::float64()));
+            columns.push_back(filled.chunked_array());
         }
 
-        auto schema = arrow::schema(fields);
-        auto table = arrow::Table::Make(schema, arrays);
+        auto table = arrow::Table::Make(arrow::schema(fields), columns, rows->num_rows());
         return chronosflow::AnalyticsDataFrame(table);
     });
 }
@@ -1324,7 +1262,12 @@ bool TimeSeriesWindow::ExportToQuestDB(const std::string& tableName, std::string
 
     m_lastQuestDbMeasurement = tableName;
 
-    statusMessage = "Exported " + std::to_string(exportResult.rows_serialized) + " rows to QuestDB table '" + tableName + "'.";
+    std::ostringstream message;
+    message << "Exported " << exportResult.rows_serialized << " rows to QuestDB table '" << tableName << "' ("
+            << std::fixed << std::setprecision(0) << exportResult.rows_per_second << " rows/s, "
+            << std::setprecision(1) << exportResult.megabytes_per_second << " MB/s over "
+            << exportResult.connections << " connection" << (exportResult.connections == 1 ? "" : "s") << ").";
+    statusMessage = message.str();
     return true;
 }
 
@@ -1385,8 +1328,9 @@ std::pair<std::optional<int64_t>, std::optional<int64_t>> TimeSeriesWindow::Extr
 
 void TimeSeriesWindow::ClearData() {
     m_dataFrame.reset();
+    DiscretizationCache::instance().clear();
     m_activeDataset.reset();
-    m_displayCache.clear(); // <<<--- ADD THIS CALL HERE
+    m_cellCache.Clear();
     m_loadedFilePath.clear();
     m_columnHeaders.clear(); // Clear the headers.
     m_isExporting = false;
@@ -1413,6 +1357,7 @@ void TimeSeriesWindow::ResetUIState() {
     m_tableHeight = DEFAULT_TABLE_HEIGHT;
     m_plotHeight = DEFAULT_PLOT_HEIGHT;
     m_plotDataDirty = true;
+    m_plotLod.Clear();
     m_cachedPlotTimes.clear();
     m_cachedPlotValues.clear();
     m_cachedIndicatorName.clear();
@@ -1425,6 +1370,7 @@ void TimeSeriesWindow::ResetUIState() {
 }
 
 void TimeSeriesWindow::UpdatePlotData() {
+    m_plotLod.Clear();
     m_cachedPlotTimes.clear();
     m_cachedPlotValues.clear();
 
@@ -1470,30 +1416,17 @@ void TimeSeriesWindow::UpdatePlotData() {
         m_cachedPlotTimes.push_back(timestamp_seconds);
     }
 
+    m_cachedPlotTimesSorted = std::is_sorted(m_cachedPlotTimes.begin(), m_cachedPlotTimes.end());
+    m_plotLod.Build(m_cachedPlotValues.data(), m_cachedPlotValues.data(), m_cachedPlotValues.size());
+
     m_cachedIndicatorName = m_selectedIndicator;
     m_plotDataDirty = false;
 }
 
 
-// Add the implementation for UpdateDisplayCache
 void TimeSeriesWindow::UpdateDisplayCache() {
-    m_displayCache.clear();
-    if (!m_dataFrame) return;
-
-    auto table = m_dataFrame->get_cpu_table();
-    if (!table) return;
-
-    const size_t numRows = std::min(static_cast<size_t>(MAX_DISPLAY_ROWS), static_cast<size_t>(table->num_rows()));
-    const int numColumns = table->num_columns();
-    
-    m_displayCache.resize(numRows);
-    for (size_t row = 0; row < numRows; ++row) {
-        m_displayCache[row].resize(numColumns);
-        for (int col = 0; col < numColumns; ++col) {
-            auto column_data = table->column(col);
-            m_displayCache[row][col] = ChunkedValueToString(column_data, static_cast<int64_t>(row));
-        }
-    }
+    // Cells are formatted when the table first draws them
+    m_cellCache.SetTable(m_dataFrame ? m_dataFrame->get_cpu_table() : nullptr);
 }
 
 void TimeSeriesWindow::NotifyColumnSelection(const std::string& indicatorName, size_t columnIndex) {
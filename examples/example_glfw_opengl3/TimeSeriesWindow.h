@@ -5,6 +5,9 @@
 #include "analytics_dataframe.h"
 #include "dataframe_io.h"
 #include "TimeSeries.h"
+#include "Stage1DatasetDownloader.h"
+#include "PlotLodPyramid.h"
+#include "TableCellCache.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -76,6 +79,8 @@ public:
                        bool recordMetadata = true);
     void SetActiveDatasetMetadata(const DatasetMetadata& metadata);
     std::pair<std::optional<int64_t>, std::optional<int64_t>> GetTimestampBounds() const;
+    // Paged indicator download started by LoadFromStage1; false when none is running
+    bool GetStage1DownloadProgress(stage1::DatasetDownloadProgress* progress) const;
     
     // Histogram window integration
     void SetHistogramWindow(HistogramWindow* histogramWindow) { m_histogramWindow = histogramWindow; }
@@ -122,7 +127,7 @@ private:
     // UI state management
     void ResetUIState();
     void UpdatePlotData();
-    void UpdateDisplayCache(); // Add this helper function
+    void UpdateDisplayCache(); // Points the table's cell cache at the loaded data
     
     // Helper methods
     std::string GetFileDialogPath();
@@ -166,16 +171,22 @@ private:
     std::vector<double> m_cachedPlotValues;
     std::string m_cachedIndicatorName;
     bool m_plotDataDirty;
+    bool m_cachedPlotTimesSorted = true;
     
-    // High-performance display cache for the table
-    std::vector<std::vector<std::string>> m_displayCache;
+    // Min/max pyramid over m_cachedPlotValues; each frame draws the visible
+    // range at about two points per pixel from the decimated buffers
+    plot_lod::MinMaxPyramid m_plotLod;
+    std::vector<double> m_lodPlotTimes;
+    std::vector<double> m_lodPlotValues;
+    
+    // Formats only the table rows the clipper shows, a block of rows at a time
+    TableCellCache m_cellCache;
     
     // UI layout constants
     static constexpr float FILE_CONTROLS_HEIGHT = 80.0f;
     static constexpr float STATUS_BAR_HEIGHT = 25.0f;
     static constexpr float DEFAULT_TABLE_HEIGHT = 200.0f;
     static constexpr float DEFAULT_PLOT_HEIGHT = 300.0f;
-    static constexpr int MAX_DISPLAY_ROWS = 250;  // Reduced from 1000 for better performance
     
     
     // Histogram window integration
@@ -196,6 +207,7 @@ private:
     
     // Asynchronous loading support
     std::future<arrow::Result<chronosflow::AnalyticsDataFrame>> m_loadingFuture;
+    std::shared_ptr<stage1::DatasetDownloader> m_stage1Download;
     
     // Detected time format for timestamp conversion
     chronosflow::TimeFormat m_detectedTimeFormat;
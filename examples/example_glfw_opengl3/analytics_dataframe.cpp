@@ -22,6 +22,10 @@
 
 namespace chronosflow {
 
+    namespace {
+        const char* const kUnixTimestampColumn = "timestamp_unix";
+    }
+
     AnalyticsDataFrame::AnalyticsDataFrame() = default;
 
     AnalyticsDataFrame::AnalyticsDataFrame(std::shared_ptr<arrow::Table> cpu_table)
@@ -68,6 +72,8 @@ namespace chronosflow {
             result.schema_ = schema_;
             result.tssb_date_column_ = tssb_date_column_;
             result.tssb_time_column_ = tssb_time_column_;
+            result.timestamp_index_cache_ = timestamp_index_cache_;
+            result.combined_column_cache_ = combined_column_cache_;
             return result;
         }
 
@@ -206,6 +212,18 @@ namespace chronosflow {
             return arrow::Status::Invalid("TSSB date/time columns not found");
         }
 
+        const int64_t start_key = static_cast<int64_t>(start.date()) * 1000000LL + start.time();
+        const int64_t end_key = static_cast<int64_t>(end.date()) * 1000000LL + end.time();
+
+        // Sorted keys: two binary searches and a zero-copy slice
+        ARROW_ASSIGN_OR_RAISE(auto index, timestamp_index());
+        if (index->is_sorted()) {
+            auto [first, last] = index->row_range(start_key, end_key);
+            return create_from_cpu_table(cpu_table_->Slice(first, last - first));
+        }
+
+        // Unsorted keys: evaluate the range filter over every row
+
         arrow::Datum date_datum(date_column);
         arrow::Datum time_datum(time_column);
 
@@ -218,8 +236,8 @@ namespace chronosflow {
         ARROW_ASSIGN_OR_RAISE(auto date_multiplied_res, arrow::compute::Multiply(date_int64_res, multiplier));
         ARROW_ASSIGN_OR_RAISE(auto combined_ts_res, arrow::compute::Add(date_multiplied_res, time_int64_res));
 
-        auto start_combined = arrow::MakeScalar(static_cast<int64_t>(start.date()) * 1000000LL + start.time());
-        auto end_combined = arrow::MakeScalar(static_cast<int64_t>(end.date()) * 1000000LL + end.time());
+        auto start_combined = arrow::MakeScalar(start_key);
+        auto end_combined = arrow::MakeScalar(end_key);
 
         ARROW_ASSIGN_OR_RAISE(auto ge_start_res, arrow::compute::CallFunction("greater_equal", { combined_ts_res, start_combined }));
         ARROW_ASSIGN_OR_RAISE(auto le_end_res, arrow::compute::CallFunction("less_equal", { combined_ts_res, end_combined }));
@@ -230,6 +248,153 @@ namespace chronosflow {
         return create_from_cpu_table(filtered_table);
     }
 
+    arrow::Result<AnalyticsDataFrame> AnalyticsDataFrame::select_rows_by_unix_range(
+        int64_t start, int64_t end) const {
+
+        if (!cpu_table_) {
+            return arrow::Status::Invalid("No data available");
+        }
+
+        // The cached index is keyed on TSSB date/time when metadata is set
+        std::shared_ptr<const TimestampIndex> index;
+        if (has_tssb_metadata()) {
+            ARROW_ASSIGN_OR_RAISE(index, TimestampIndex::from_column(cpu_table_, kUnixTimestampColumn));
+        } else {
+            ARROW_ASSIGN_OR_RAISE(index, timestamp_index());
+        }
+
+        if (index->is_sorted()) {
+            auto [first, last] = index->row_range(start, end);
+            return create_from_cpu_table(cpu_table_->Slice(first, last - first));
+        }
+
+        auto column = cpu_table_->GetColumnByName(kUnixTimestampColumn);
+        arrow::compute::CastOptions cast_opts;
+        cast_opts.to_type = arrow::int64();
+        ARROW_ASSIGN_OR_RAISE(auto ts_res, arrow::compute::Cast(arrow::Datum(column), cast_opts));
+        ARROW_ASSIGN_OR_RAISE(auto ge_start_res, arrow::compute::CallFunction("greater_equal", { ts_res, arrow::MakeScalar(start) }));
+        ARROW_ASSIGN_OR_RAISE(auto le_end_res, arrow::compute::CallFunction("less_equal", { ts_res, arrow::MakeScalar(end) }));
+        ARROW_ASSIGN_OR_RAISE(auto final_filter_res, arrow::compute::CallFunction("and", { ge_start_res, le_end_res }));
+        ARROW_ASSIGN_OR_RAISE(auto filtered_result, arrow::compute::Filter(cpu_table_, final_filter_res));
+
+        return create_from_cpu_table(filtered_result.table());
+    }
+
+    arrow::Result<std::shared_ptr<const TimestampIndex>> AnalyticsDataFrame::timestamp_index() const {
+        if (!cpu_table_ || !timestamp_index_cache_) {
+            return arrow::Status::Invalid("No data available");
+        }
+
+        std::lock_guard<std::mutex> lock(timestamp_index_cache_->mutex);
+        if (!timestamp_index_cache_->index) {
+            if (has_tssb_metadata()) {
+                ARROW_ASSIGN_OR_RAISE(timestamp_index_cache_->index,
+                    TimestampIndex::from_tssb_columns(cpu_table_, *tssb_date_column_, *tssb_time_column_));
+            } else {
+                ARROW_ASSIGN_OR_RAISE(timestamp_index_cache_->index,
+                    TimestampIndex::from_column(cpu_table_, kUnixTimestampColumn));
+            }
+        }
+        return timestamp_index_cache_->index;
+    }
+
+    arrow::Result<std::shared_ptr<arrow::Array>> AnalyticsDataFrame::contiguous_column(
+        const std::string& column_name) const {
+
+        if (!cpu_table_ || !combined_column_cache_) {
+            return arrow::Status::Invalid("No data available");
+        }
+
+        auto column = cpu_table_->GetColumnByName(column_name);
+        if (!column) {
+            return arrow::Status::Invalid("Column not found: ", column_name);
+        }
+        if (column->num_chunks() == 1) {
+            return column->chunk(0);
+        }
+        if (column->num_chunks() == 0) {
+            return arrow::MakeEmptyArray(column->type());
+        }
+
+        std::lock_guard<std::mutex> lock(combined_column_cache_->mutex);
+        auto& cached = combined_column_cache_->arrays[column_name];
+        if (!cached) {
+            ARROW_ASSIGN_OR_RAISE(cached, arrow::Concatenate(column->chunks()));
+        }
+        return cached;
+    }
+
+    std::vector<std::string> AnalyticsDataFrame::timestamp_key_columns() const {
+        if (has_tssb_metadata()) {
+            return { *tssb_date_column_, *tssb_time_column_ };
+        }
+        return { kUnixTimestampColumn };
+    }
+
+    arrow::Result<AnalyticsDataFrame> AnalyticsDataFrame::asof_join(
+        const AnalyticsDataFrame& right, const std::string& right_suffix) const {
+
+        if (!cpu_table_ || !right.cpu_table_) {
+            return arrow::Status::Invalid("No data available");
+        }
+        if (has_tssb_metadata() != right.has_tssb_metadata()) {
+            return arrow::Status::Invalid("As-of join needs both frames keyed the same way");
+        }
+
+        ARROW_ASSIGN_OR_RAISE(auto left_index, timestamp_index());
+        ARROW_ASSIGN_OR_RAISE(auto right_index, right.timestamp_index());
+        if (!right_index->is_sorted()) {
+            return arrow::Status::Invalid("As-of join requires sorted right-hand timestamps");
+        }
+
+        // Row of the right frame for every left row. With sorted left keys
+        // the match only moves forward, so one merge pass suffices.
+        const auto& left_keys = left_index->keys();
+        const auto& right_keys = right_index->keys();
+        arrow::Int64Builder take_builder;
+        ARROW_RETURN_NOT_OK(take_builder.Reserve(left_index->size()));
+        int64_t match = -1;
+        for (int64_t i = 0; i < left_index->size(); ++i) {
+            if (left_index->is_sorted()) {
+                while (match + 1 < right_index->size() && right_keys[match + 1] <= left_keys[i]) {
+                    ++match;
+                }
+            } else {
+                match = right_index->asof_row(left_keys[i]);
+            }
+            if (match < 0) {
+                take_builder.UnsafeAppendNull();
+            } else {
+                take_builder.UnsafeAppend(match);
+            }
+        }
+        std::shared_ptr<arrow::Array> take_indices;
+        ARROW_RETURN_NOT_OK(take_builder.Finish(&take_indices));
+
+        std::vector<std::shared_ptr<arrow::ChunkedArray>> columns = cpu_table_->columns();
+        std::vector<std::shared_ptr<arrow::Field>> fields = cpu_table_->schema()->fields();
+        const auto right_keys_columns = right.timestamp_key_columns();
+        const auto right_schema = right.cpu_table_->schema();
+
+        for (int i = 0; i < right_schema->num_fields(); ++i) {
+            const auto& field = right_schema->field(i);
+            if (std::find(right_keys_columns.begin(), right_keys_columns.end(), field->name()) != right_keys_columns.end()) {
+                continue;
+            }
+            ARROW_ASSIGN_OR_RAISE(auto taken, arrow::compute::Take(
+                arrow::Datum(right.cpu_table_->column(i)), arrow::Datum(take_indices)));
+            std::string name = field->name();
+            if (cpu_table_->schema()->GetFieldIndex(name) != -1) {
+                name += right_suffix;
+            }
+            columns.push_back(taken.chunked_array());
+            fields.push_back(arrow::field(name, field->type()));
+        }
+
+        auto joined = arrow::Table::Make(arrow::schema(fields), columns, cpu_table_->num_rows());
+        return create_from_cpu_table(joined);
+    }
+
     arrow::Result<AnalyticsDataFrame> AnalyticsDataFrame::select_columns(
         const std::vector<std::string>& column_names) const {
 
@@ -452,11 +617,12 @@ namespace chronosflow {
             return arrow::Status::Invalid("Window size and step size must be positive");
         }
 
+        RollingWindowRange range(cpu_table_->num_rows(), window_size, step_size);
         std::vector<AnalyticsDataFrame> windows;
-        int64_t num_rows = cpu_table_->num_rows();
+        windows.reserve(static_cast<size_t>(range.size()));
 
-        for (int64_t start = 0; start + window_size <= num_rows; start += step_size) {
-            auto window_result = slice_by_row_index(start, start + window_size);
+        for (const RowWindow& window : range) {
+            auto window_result = window_frame(window);
             if (!window_result.ok()) {
                 return window_result.status();
             }
@@ -466,10 +632,29 @@ namespace chronosflow {
         return windows;
     }
 
+    arrow::Result<RollingWindowRange> AnalyticsDataFrame::rolling_windows(
+        int64_t window_size, int64_t step_size) const {
+
+        if (!cpu_table_) {
+            return arrow::Status::Invalid("No data available");
+        }
+
+        if (window_size <= 0 || step_size <= 0) {
+            return arrow::Status::Invalid("Window size and step size must be positive");
+        }
+
+        return RollingWindowRange(cpu_table_->num_rows(), window_size, step_size);
+    }
+
+    arrow::Result<AnalyticsDataFrame> AnalyticsDataFrame::window_frame(const RowWindow& window) const {
+        return slice_by_row_index(window.offset, window.offset + window.length);
+    }
+
     void AnalyticsDataFrame::set_tssb_metadata(
         const std::string& date_column, const std::string& time_column) {
         tssb_date_column_ = date_column;
         tssb_time_column_ = time_column;
+        timestamp_index_cache_ = std::make_shared<TimestampIndexCache>();
     }
 
     int64_t AnalyticsDataFrame::num_rows() const {
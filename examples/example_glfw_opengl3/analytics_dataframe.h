@@ -2,12 +2,16 @@
 
 #include "tssb_timestamp.h"
 #include "column_view.h"
+#include "rolling_window_range.h"
+#include "timestamp_index.h"
 #include <arrow/table.h>
 #include <arrow/result.h>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <optional>
+#include <unordered_map>
 
 #ifdef WITH_CUDA
 #include <cudf/table/table.hpp>
@@ -47,6 +51,22 @@ public:
     arrow::Result<AnalyticsDataFrame> select_rows_by_timestamp(
         const TSSBTimestamp& start, const TSSBTimestamp& end) const;
 
+    // Rows with start <= timestamp_unix <= end
+    arrow::Result<AnalyticsDataFrame> select_rows_by_unix_range(
+        int64_t start, int64_t end) const;
+
+    // Row keys: TSSB date/time when metadata is set, otherwise the
+    // timestamp_unix column. Built on first use and cached with the table.
+    arrow::Result<std::shared_ptr<const TimestampIndex>> timestamp_index() const;
+
+    // Attaches to each row the right frame's columns taken from its last row
+    // whose key is <= this row's key (nulls when there is none). Both frames
+    // must be keyed the same way and right must be sorted. Right key columns
+    // are dropped; other clashing names get right_suffix.
+    arrow::Result<AnalyticsDataFrame> asof_join(
+        const AnalyticsDataFrame& right,
+        const std::string& right_suffix = "_right") const;
+
     arrow::Result<AnalyticsDataFrame> select_columns(
         const std::vector<std::string>& column_names) const;
 
@@ -61,9 +81,23 @@ public:
     arrow::Result<std::vector<AnalyticsDataFrame>> create_rolling_windows(
         int64_t window_size, int64_t step_size = 1) const;
 
+    // Lazy counterpart of create_rolling_windows: windows are (offset, length)
+    // pairs generated on demand, read through ColumnView<T> via RowWindow::slice
+    arrow::Result<RollingWindowRange> rolling_windows(
+        int64_t window_size, int64_t step_size = 1) const;
+
+    // One window as a dataframe, for code that needs a full frame
+    arrow::Result<AnalyticsDataFrame> window_frame(const RowWindow& window) const;
+
+    // Contiguous view. Multi-chunk columns are concatenated once per table and
+    // the combined array is reused by later calls.
     template<typename T>
     arrow::Result<ColumnView<T>> get_column_view(const std::string& column_name) const;
 
+    // Per-chunk view of a CPU column; never copies
+    template<typename T>
+    arrow::Result<ChunkedColumnView<T>> get_chunked_column_view(const std::string& column_name) const;
+
     void set_tssb_metadata(const std::string& date_column, const std::string& time_column);
 
     int64_t num_rows() const;
@@ -89,6 +123,24 @@ private:
     DataLocation location_ = DataLocation::CPU;
     std::optional<std::string> tssb_date_column_;
     std::optional<std::string> tssb_time_column_;
+
+    // Shared by frames that wrap the same table with the same metadata
+    struct TimestampIndexCache {
+        std::mutex mutex;
+        std::shared_ptr<const TimestampIndex> index;
+    };
+    std::shared_ptr<TimestampIndexCache> timestamp_index_cache_ = std::make_shared<TimestampIndexCache>();
+
+    // Concatenated copies of multi-chunk columns, shared like the index cache
+    struct CombinedColumnCache {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<arrow::Array>> arrays;
+    };
+    std::shared_ptr<CombinedColumnCache> combined_column_cache_ = std::make_shared<CombinedColumnCache>();
+
+    arrow::Result<std::shared_ptr<arrow::Array>> contiguous_column(const std::string& column_name) const;
+
+    std::vector<std::string> timestamp_key_columns() const;
     
     // Allow FeatureUtils to access private members for GPU operations
     friend class FeatureUtils;
@@ -123,10 +175,21 @@ arrow::Result<ColumnView<T>> AnalyticsDataFrame::get_column_view(
 #endif
     
     if (cpu_table_) {
-        return ColumnView<T>::from_arrow_column(cpu_table_, column_name);
+        ARROW_ASSIGN_OR_RAISE(auto array, contiguous_column(column_name));
+        return ColumnView<T>::from_arrow_array(std::move(array), column_name);
     }
     
     return arrow::Status::Invalid("No data available");
 }
 
+template<typename T>
+arrow::Result<ChunkedColumnView<T>> AnalyticsDataFrame::get_chunked_column_view(
+    const std::string& column_name) const {
+
+    if (!cpu_table_) {
+        return arrow::Status::Invalid("No data available");
+    }
+    return ChunkedColumnView<T>::from_arrow_column(cpu_table_, column_name);
+}
+
 } // namespace chronosflow
\ No newline at end of file
@@ -23,88 +23,126 @@
 #include <mutex>
 #include <future>
 #include <execution>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include "bivariate_analysis_exact.h"
 #include "aligned_allocator.h"
 #include "modern_discretizer.h"
 #include "modern_algorithms.h"
 #include "simple_logger.h"
 
-// High-performance pre-converted data class - eliminates massive memory waste
-class PreconvertedData {
+// Screening engine for bivariate MCPT.
+//
+// Bins are packed one byte per case. For a predictor pair only the target moves
+// between replications, so the pair's joint bin (p1 * nbins_pred + p2), already
+// scaled to its row offset in the contingency table, is built once per task and
+// reused for every permuted target in that task. Each table is then a single
+// histogram over joint_row + target.
+namespace {
+
+constexpr int MAX_PACKED_BINS = 256;        // Bins must fit in uint8
+constexpr int MAX_TABLE_SIZE = 65536;       // Joint row offsets must fit in uint16
+constexpr int REPS_PER_BLOCK = 64;          // Permuted targets materialized at once
+constexpr int REPS_PER_TASK = 16;           // Replications sharing one joint-bin pass
+constexpr int HISTOGRAM_LANES = 4;          // Interleaved count tables
+
+class PackedBinColumns {
 private:
-    std::vector<AlignedVector<int>> predictor_data_int;  // [npred][n_cases]
-    AlignedVector<int> target_data_int;                  // [n_cases]
-    std::vector<const int*> predictor_ptrs;             // Zero-copy pointers
+    std::vector<AlignedVector<uint8_t>> predictors_;   // [npred][n_cases]
+    AlignedVector<uint8_t> target_;                    // [n_cases]
     int n_cases_;
-    int n_predictors_;
-    
-public:
-    PreconvertedData(const std::vector<const short int*>& pred_short_ptrs,
-                     const short int* target_short, int n_cases, int n_predictors) 
-        : n_cases_(n_cases), n_predictors_(n_predictors) {
-        
-        // Pre-convert all predictors ONCE (eliminates 99% of memory traffic)
-        predictor_data_int.resize(n_predictors);
-        predictor_ptrs.resize(n_predictors);
-        
-        for (int p = 0; p < n_predictors; p++) {
-            predictor_data_int[p].resize(n_cases);
-            
-            // Optimized conversion - compiler can vectorize this
-            const short int* src = pred_short_ptrs[p];
-            int* dst = predictor_data_int[p].data();
-            
-            for (int i = 0; i < n_cases; i++) {
-                dst[i] = static_cast<int>(src[i]);
-            }
-            
-            predictor_ptrs[p] = dst;  // Store pointer for zero-copy access
-        }
-        
-        // Pre-convert target ONCE  
-        target_data_int.resize(n_cases);
+
+    static void pack(const short int* src, uint8_t* dst, int n_cases) {
         for (int i = 0; i < n_cases; i++) {
-            target_data_int[i] = static_cast<int>(target_short[i]);
+            dst[i] = static_cast<uint8_t>(src[i]);
         }
     }
-    
-    const int* get_predictor(int index) const { 
-        return predictor_ptrs[index]; 
-    }
-    
-    int* get_target_data() { 
-        return target_data_int.data(); 
+
+public:
+    PackedBinColumns(const std::vector<const short int*>& pred_short_ptrs,
+                     const short int* target_short, int n_cases)
+        : predictors_(pred_short_ptrs.size()), target_(n_cases), n_cases_(n_cases) {
+        for (size_t p = 0; p < pred_short_ptrs.size(); p++) {
+            predictors_[p].resize(n_cases);
+            pack(pred_short_ptrs[p], predictors_[p].data(), n_cases);
+        }
+        pack(target_short, target_.data(), n_cases);
     }
-    
+
+    const uint8_t* predictor(int index) const { return predictors_[index].data(); }
+    const uint8_t* target() const { return target_.data(); }
     int num_cases() const { return n_cases_; }
-    int num_predictors() const { return n_predictors_; }
 };
 
-// Optimized integer shuffle for target data
-void fast_shuffle_int(int* data, int n_cases, std::mt19937& gen) {
-    // Fisher-Yates shuffle optimized for integers
-    for (int i = n_cases - 1; i > 0; i--) {
-        std::uniform_int_distribution<int> dist(0, i);
-        int j = dist(gen);
-        if (i != j) {
-            std::swap(data[i], data[j]);
+// SplitMix64: one multiply-xorshift chain per draw, cheap enough to seed per replication
+struct SplitMix64 {
+    uint64_t state;
+
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, range) by multiply-shift (no division, no rejection loop)
+    uint32_t below(uint32_t range) {
+        return static_cast<uint32_t>(((next() >> 32) * static_cast<uint64_t>(range)) >> 32);
+    }
+};
+
+// Fills dst with the target for one replication. Each replication has its own
+// seed, so replications can be generated in any order on any thread.
+void permute_target(const uint8_t* src, uint8_t* dst, int n_cases, int mcpt_type, uint64_t seed) {
+    SplitMix64 rng(seed);
+    if (mcpt_type == 2 && n_cases > 1) {  // Cyclic shuffle: rotate left by a random offset
+        int offset = 1 + static_cast<int>(rng.below(static_cast<uint32_t>(n_cases - 1)));
+        std::memcpy(dst, src + offset, n_cases - offset);
+        std::memcpy(dst + n_cases - offset, src, offset);
+        return;
+    }
+
+    std::memcpy(dst, src, n_cases);
+    if (mcpt_type == 1) {  // Complete shuffle (Fisher-Yates)
+        for (int i = n_cases - 1; i > 0; i--) {
+            int j = static_cast<int>(rng.below(static_cast<uint32_t>(i + 1)));
+            std::swap(dst[i], dst[j]);
         }
     }
 }
 
-// Optimized cyclic shuffle for integers
-void fast_cyclic_shuffle_int(int* data, int n_cases, std::mt19937& gen) {
-    // Random cyclic rotation by random offset
-    std::uniform_int_distribution<int> dist(1, n_cases - 1);
-    int offset = dist(gen);
-    
-    // Use a more efficient rotation algorithm
-    std::vector<int> temp(data, data + offset);
-    std::move(data + offset, data + n_cases, data);
-    std::move(temp.begin(), temp.end(), data + n_cases - offset);
+// Contingency table of (joint predictor bin, target bin). Consecutive cases go
+// to different count tables so repeated hits on the same cell do not serialize
+// on store-to-load forwarding; the tables are summed at the end.
+void histogram_joint_target(const uint16_t* joint, const uint8_t* target, int n_cases,
+                            int table_size, int* lanes, int* bin_counts) {
+    std::memset(lanes, 0, sizeof(int) * HISTOGRAM_LANES * table_size);
+    int* c0 = lanes;
+    int* c1 = lanes + table_size;
+    int* c2 = lanes + 2 * table_size;
+    int* c3 = lanes + 3 * table_size;
+
+    int i = 0;
+    for (; i + HISTOGRAM_LANES <= n_cases; i += HISTOGRAM_LANES) {
+        ++c0[joint[i] + target[i]];
+        ++c1[joint[i + 1] + target[i + 1]];
+        ++c2[joint[i + 2] + target[i + 2]];
+        ++c3[joint[i + 3] + target[i + 3]];
+    }
+    for (; i < n_cases; i++) {
+        ++c0[joint[i] + target[i]];
+    }
+
+    for (int k = 0; k < table_size; k++) {
+        bin_counts[k] = c0[k] + c1[k] + c2[k] + c3[k];
+    }
 }
 
-// OPTIMIZED: Zero-copy implementation - eliminates 99% of memory traffic
+} // namespace
+
 std::vector<BivariateResult> run_analysis_on_binned_data(
     int n_cases,
     const std::vector<std::string>& predictor_names,
@@ -116,9 +154,12 @@ std::vector<BivariateResult> run_analysis_on_binned_data(
     int mcpt_type,
     int n_permutations
 ) {
-    // PRE-CONVERT ALL DATA ONCE - massive performance boost!
-    PreconvertedData converted_data(predictor_bins_ptrs, target_bin, n_cases, 
-                                   static_cast<int>(predictor_names.size()));
+    if (nbins_pred > MAX_PACKED_BINS || nbins_target > MAX_PACKED_BINS ||
+        nbins_pred * nbins_pred * nbins_target > MAX_TABLE_SIZE) {
+        throw std::runtime_error("Too many bins for bivariate screening (pred^2 * target must not exceed 65536)");
+    }
+
+    PackedBinColumns packed(predictor_bins_ptrs, target_bin, n_cases);
     
     // Calculate target marginal once
     AlignedVector<double> target_marginal(nbins_target, 0.0);
@@ -143,104 +184,112 @@ std::vector<BivariateResult> run_analysis_on_binned_data(
     int n_combo = static_cast<int>(predictor_pairs.size());
     std::vector<BivariateResult> results(n_combo);
     std::vector<double> original_crits(n_combo);
-    std::vector<int> mcpt_solo(n_combo, 0);
-    std::vector<int> mcpt_bestof(n_combo, 0);
-    
-    // Pre-allocate working memory parameters
-    int work_size = nbins_pred * nbins_pred * nbins_target;
-    int rmarg_size = nbins_pred * nbins_pred;
+    std::vector<int> mcpt_solo(n_combo, 1);
+    std::vector<int> mcpt_bestof(n_combo, 1);
     
-    // Initialize random number generator for MCPT
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    const int nbins_pred_squared = nbins_pred * nbins_pred;
+    const int table_size = nbins_pred_squared * nbins_target;
     
-    // Main MCPT replication loop (matching legacy exactly)
+    // Replication 0 is the original target; the rest are permutations
     int mcpt_reps = (n_permutations < 1) ? 1 : n_permutations;
+    std::random_device rd;
+    const uint64_t base_seed = (static_cast<uint64_t>(rd()) << 32) | rd();
     
-    // Working copy of target data for shuffling
-    AlignedVector<int> target_work_copy(n_cases);
-    const int* original_target = converted_data.get_target_data();
+    const int block_capacity = std::min(REPS_PER_BLOCK, mcpt_reps);
+    AlignedVector<uint8_t> block_targets(static_cast<size_t>(block_capacity) * n_cases);
+    std::vector<double> block_crits(static_cast<size_t>(block_capacity) * n_combo);
+    std::vector<double> block_best(block_capacity);
     
-    for (int irep = 0; irep < mcpt_reps; irep++) {
-        // Copy original target data for this replication
-        std::copy(original_target, original_target + n_cases, target_work_copy.begin());
+    for (int block_start = 0; block_start < mcpt_reps; block_start += REPS_PER_BLOCK) {
+        const int block_reps = std::min(REPS_PER_BLOCK, mcpt_reps - block_start);
         
-        // Shuffle target if in permutation run (irep > 0) 
-        if (irep > 0) {
-            if (mcpt_type == 1) {  // Complete shuffle - optimized for integers
-                fast_shuffle_int(target_work_copy.data(), n_cases, gen);
-            } else if (mcpt_type == 2) {  // Cyclic shuffle - optimized for integers
-                fast_cyclic_shuffle_int(target_work_copy.data(), n_cases, gen);
+        // Materialize this block's targets, one replication per task
+        std::vector<int> rep_indices(block_reps);
+        std::iota(rep_indices.begin(), rep_indices.end(), 0);
+        std::for_each(std::execution::par, rep_indices.begin(), rep_indices.end(),
+            [&](int r) {
+                const int irep = block_start + r;
+                uint8_t* dst = block_targets.data() + static_cast<size_t>(r) * n_cases;
+                if (irep == 0) {
+                    std::memcpy(dst, packed.target(), n_cases);
+                } else {
+                    permute_target(packed.target(), dst, n_cases, mcpt_type,
+                                   base_seed + 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(irep));
+                }
             }
-        }
-        // Note: For irep == 0, target_work_copy contains original data (unshuffled)
-        
-        // Calculate criteria for all combinations in this replication
-        std::vector<double> crit(n_combo);
-        double best_crit = -DBL_MAX;
+        );
         
-        // Parallel execution using std::execution::par (restored for performance)
-        std::vector<size_t> indices(n_combo);
-        std::iota(indices.begin(), indices.end(), 0);
+        // Tasks are (pair, run of replications); the joint bins of the pair are
+        // computed once per task and shared by all its replications
+        const int chunks_per_pair = (block_reps + REPS_PER_TASK - 1) / REPS_PER_TASK;
+        std::vector<size_t> tasks(static_cast<size_t>(n_combo) * chunks_per_pair);
+        std::iota(tasks.begin(), tasks.end(), 0);
         
-        std::for_each(std::execution::par, indices.begin(), indices.end(),
-            [&](size_t i) {
+        std::for_each(std::execution::par, tasks.begin(), tasks.end(),
+            [&](size_t task) {
+                const int i = static_cast<int>(task / chunks_per_pair);
+                const int r_begin = static_cast<int>(task % chunks_per_pair) * REPS_PER_TASK;
+                const int r_end = std::min(r_begin + REPS_PER_TASK, block_reps);
                 const auto& pair = predictor_pairs[i];
                 
-                // Pre-allocate thread-local working memory with alignment
-                // These are allocated once per thread and reused
-                thread_local AlignedVector<int> local_bin_counts_storage;
-                thread_local AlignedVector<int> local_rmarg_storage;
-                
-                // Ensure correct size (only resizes if needed)
-                local_bin_counts_storage.resize(work_size);
-                local_rmarg_storage.resize(rmarg_size);
-                
-                // ZERO COPY: Direct pointer access to pre-converted data
-                const int* pred1_ptr = converted_data.get_predictor(pair.i);
-                const int* pred2_ptr = converted_data.get_predictor(pair.j);
-                const int* target_ptr = target_work_copy.data();
+                // Per-thread buffers, allocated once and reused across tasks
+                thread_local AlignedVector<uint16_t> local_joint;
+                thread_local AlignedVector<int> local_lanes;
+                thread_local AlignedVector<int> local_bin_counts;
+                thread_local AlignedVector<int> local_rmarg;
+                local_joint.resize(n_cases);
+                local_lanes.resize(static_cast<size_t>(HISTOGRAM_LANES) * table_size);
+                local_bin_counts.resize(table_size);
+                local_rmarg.resize(nbins_pred_squared);
                 
-                std::fill(local_bin_counts_storage.begin(), local_bin_counts_storage.end(), 0);
+                const uint8_t* pred1 = packed.predictor(pair.i);
+                const uint8_t* pred2 = packed.predictor(pair.j);
+                uint16_t* joint = local_joint.data();
+                for (int c = 0; c < n_cases; c++) {
+                    joint[c] = static_cast<uint16_t>((pred1[c] * nbins_pred + pred2[c]) * nbins_target);
+                }
                 
-                if (criterion_type == 1) {
-                    crit[i] = ModernAlgorithms::compute_mi(
-                        n_cases, nbins_pred, pred1_ptr, pred2_ptr,
-                        nbins_target, target_ptr, target_marginal.data(), local_bin_counts_storage.data()
-                    );
-                } else {
-                    double row_dep, col_dep, sym;
-                    ModernAlgorithms::uncert_reduc(
-                        n_cases, nbins_pred, pred1_ptr, pred2_ptr,
-                        nbins_target, target_ptr, target_marginal.data(),
-                        &row_dep, &col_dep, &sym, local_rmarg_storage.data(), local_bin_counts_storage.data()
-                    );
-                    crit[i] = sym;
+                for (int r = r_begin; r < r_end; r++) {
+                    const uint8_t* target = block_targets.data() + static_cast<size_t>(r) * n_cases;
+                    histogram_joint_target(joint, target, n_cases, table_size,
+                                           local_lanes.data(), local_bin_counts.data());
+                    
+                    double crit;
+                    if (criterion_type == 1) {
+                        crit = ModernAlgorithms::mi_from_counts(
+                            n_cases, nbins_pred_squared, nbins_target,
+                            target_marginal.data(), local_bin_counts.data());
+                    } else {
+                        double row_dep, col_dep, sym;
+                        ModernAlgorithms::uncert_reduc_from_counts(
+                            nbins_pred_squared, nbins_target, target_marginal.data(),
+                            local_bin_counts.data(), &row_dep, &col_dep, &sym, local_rmarg.data());
+                        crit = sym;
+                    }
+                    block_crits[static_cast<size_t>(r) * n_combo + i] = crit;
                 }
             }
         );
         
-        // Find best criterion in this replication
-        for (int i = 0; i < n_combo; i++) {
-            if (i == 0 || crit[i] > best_crit) {
-                best_crit = crit[i];
-            }
+        // Best criterion of each replication across all pairs
+        for (int r = 0; r < block_reps; r++) {
+            const double* crit = block_crits.data() + static_cast<size_t>(r) * n_combo;
+            block_best[r] = n_combo > 0 ? *std::max_element(crit, crit + n_combo) : -DBL_MAX;
         }
         
         // Update MCPT counters (matching legacy logic exactly)
-        for (int i = 0; i < n_combo; i++) {
+        for (int r = 0; r < block_reps; r++) {
+            const int irep = block_start + r;
+            const double* crit = block_crits.data() + static_cast<size_t>(r) * n_combo;
             if (irep == 0) {  // Original, unpermuted data
-                original_crits[i] = crit[i];
-                mcpt_solo[i] = mcpt_bestof[i] = 1;
-            } else if (crit[i] >= original_crits[i]) {
-                mcpt_solo[i]++;
+                std::copy(crit, crit + n_combo, original_crits.begin());
+                continue;
             }
-        }
-        
-        // Update bestof counters (only for non-original replications)
-        if (irep > 0) {
             for (int i = 0; i < n_combo; i++) {
-                if (best_crit >= original_crits[i]) {
+                if (crit[i] >= original_crits[i]) {
+                    mcpt_solo[i]++;
+                }
+                if (block_best[r] >= original_crits[i]) {
                     mcpt_bestof[i]++;
                 }
             }
@@ -283,29 +332,26 @@ std::vector<BivariateResult> screen_bivariate(
     int mcpt_type,
     int n_permutations
 ) {
+    // Sorted columns are cached across calls, so only the O(n) binning pass
+    // runs again when the bin counts change
+    DiscretizationCache& cache = DiscretizationCache::instance();
+    std::vector<std::string> columns = predictor_names;
+    columns.push_back(target_name);
+    cache.prepare(df, columns);
+    
     // Create map to store binned data and bounds
     std::map<std::string, AlignedVector<short int>> binned_data;
     std::map<std::string, std::vector<double>> bounds_data;
     
     // Discretize all predictor columns using modern partition algorithm
     for (const auto& pred_name : predictor_names) {
-        // Use correct API and handle the Result object
-        auto view_res = df.get_column_view<double>(pred_name);
-        if (!view_res.ok()) throw std::runtime_error("Failed to get view for predictor: " + pred_name);
-        auto column_view = std::move(view_res).ValueOrDie();
-        
-        // Get both bins and bounds for debugging
         std::vector<double> bounds;
-        binned_data[pred_name] = discretize_with_bounds(column_view, nbins_pred, bounds);
+        binned_data[pred_name] = cache.discretize(df, pred_name, nbins_pred, &bounds);
         bounds_data[pred_name] = bounds;
     }
     
-    auto target_view_res = df.get_column_view<double>(target_name);
-    if (!target_view_res.ok()) throw std::runtime_error("Failed to get view for target: " + target_name);
-    auto target_column_view = std::move(target_view_res).ValueOrDie();
-    
     std::vector<double> target_bounds;
-    AlignedVector<short int> target_binned = discretize_with_bounds(target_column_view, nbins_target, target_bounds);
+    AlignedVector<short int> target_binned = cache.discretize(df, target_name, nbins_target, &target_bounds);
     
     // Create vector of pointers to binned predictor data (zero-copy)
     std::vector<const short int*> predictor_bins_ptrs;
@@ -5,6 +5,7 @@
 #include <map>       // For std::map
 #include "imgui.h"
 #include "implot.h"
+#include "implot_internal.h" // For the plot frame width before setup is locked
 #include <algorithm> // For std::min, std::max
 #include <cmath>     // For fabs, round
 #include <cfloat>    // For DBL_MAX
@@ -18,8 +19,7 @@
 #include "QuestDbDataFrameGateway.h"
 #include "analytics_dataframe.h"
 #include "dataframe_io.h"
-#include "Stage1RestClient.h"
-#include <json/json.h>
+#include "Stage1DatasetDownloader.h"
 
 namespace {
 
@@ -350,99 +350,78 @@ bool CandlestickChart::LoadFromStage1(const std::string& datasetId, std::string*
         return false;
     }
 
-    Json::Value rows;
+    std::shared_ptr<arrow::Table> rows;
     std::string error;
-    if (!stage1::RestClient::Instance().FetchDatasetOhlcv(datasetId, &rows, &error)) {
+    stage1::DatasetDownloader download(datasetId, stage1::DatasetPart::Ohlcv);
+    if (!download.Run(&rows, &error)) {
         if (statusMessage) {
             *statusMessage = "Failed to fetch OHLCV: " + error;
         }
         return false;
     }
 
-    if (!rows.isArray() || rows.empty()) {
+    if (!rows || rows->num_rows() == 0) {
         if (statusMessage) {
             *statusMessage = "No OHLCV data returned from Stage1.";
         }
         return false;
     }
 
-    // Helper to parse ISO8601 timestamp to milliseconds
-    auto parseTimestamp = [](const Json::Value& val) -> int64_t {
-        if (val.isInt64()) {
-            return val.asInt64();
-        } else if (val.isDouble()) {
-            return static_cast<int64_t>(val.asDouble());
-        } else if (val.isString()) {
-            std::string str = val.asString();
-            // Try parsing as ISO8601: "2024-11-28T22:00:00.000000Z"
-            if (str.size() >= 19 && str.find('T') != std::string::npos) {
-                std::tm tm = {};
-                int year, month, day, hour, minute, second;
-                if (sscanf(str.c_str(), "%d-%d-%dT%d:%d:%d", &year, &month, &day, &hour, &minute, &second) == 6) {
-                    tm.tm_year = year - 1900;
-                    tm.tm_mon = month - 1;
-                    tm.tm_mday = day;
-                    tm.tm_hour = hour;
-                    tm.tm_min = minute;
-                    tm.tm_sec = second;
-                    #ifdef _WIN32
-                    time_t t = _mkgmtime(&tm);
-                    #else
-                    time_t t = timegm(&tm);
-                    #endif
-                    return static_cast<int64_t>(t) * 1000; // Convert to milliseconds
-                }
-            }
-            // Try parsing as numeric string
-            try {
-                return std::stoll(str);
-            } catch (...) {
-                return 0;
-            }
+    auto timestamps = rows->GetColumnByName("timestamp_ms");
+    if (!timestamps) {
+        if (statusMessage) {
+            *statusMessage = "No valid candles found in response.";
         }
-        return 0;
-    };
-
-    // Convert JSON rows to OHLCV format
-    std::vector<OHLCVData> candles;
-    candles.reserve(rows.size());
+        return false;
+    }
 
-    size_t skipped = 0;
-    for (const auto& row : rows) {
-        if (!row.isObject()) {
-            skipped++;
-            continue;
+    // Prices may arrive as numbers or numeric strings; both cast to double
+    auto doubleColumn = [&](const char* name) -> std::shared_ptr<arrow::ChunkedArray> {
+        auto column = rows->GetColumnByName(name);
+        if (!column) {
+            return nullptr;
+        }
+        auto cast = arrow::compute::Cast(column, arrow::float64());
+        return cast.ok() ? cast.ValueOrDie().chunked_array() : nullptr;
+    };
+    auto flatten = [&](const std::shared_ptr<arrow::ChunkedArray>& column) -> std::shared_ptr<arrow::Array> {
+        if (!column) {
+            return nullptr;
         }
+        auto combined = arrow::Concatenate(column->chunks());
+        return combined.ok() ? combined.ValueOrDie() : nullptr;
+    };
 
-        OHLCVData candle;
-        int64_t timestamp_ms = 0;
-        if (row.isMember("timestamp_ms")) {
-            timestamp_ms = parseTimestamp(row["timestamp_ms"]);
-        } else if (row.isMember("timestamp")) {
-            timestamp_ms = parseTimestamp(row["timestamp"]);
+    auto times = std::static_pointer_cast<arrow::Int64Array>(flatten(timestamps));
+    std::shared_ptr<arrow::Array> prices[5] = {
+        flatten(doubleColumn("open")), flatten(doubleColumn("high")), flatten(doubleColumn("low")),
+        flatten(doubleColumn("close")), flatten(doubleColumn("volume"))
+    };
+    auto priceAt = [&](int field, int64_t row) -> double {
+        const auto& array = prices[field];
+        if (!array || array->IsNull(row)) {
+            return 0.0;
         }
+        return std::static_pointer_cast<arrow::DoubleArray>(array)->Value(row);
+    };
+
+    // Convert rows to OHLCV format
+    std::vector<OHLCVData> candles;
+    candles.reserve(static_cast<size_t>(rows->num_rows()));
 
+    for (int64_t row = 0; times && row < times->length(); ++row) {
+        const int64_t timestamp_ms = times->IsValid(row) ? times->Value(row) : 0;
         if (timestamp_ms == 0) {
-            skipped++;
             continue;
         }
 
+        OHLCVData candle;
         candle.time = static_cast<time_t>(timestamp_ms / 1000); // Convert milliseconds to seconds
-
-        // Parse OHLCV values - they might be strings or numbers
-        auto getDoubleValue = [](const Json::Value& val) -> double {
-            if (val.isDouble()) return val.asDouble();
-            if (val.isInt()) return static_cast<double>(val.asInt64());
-            if (val.isString()) return std::stod(val.asString());
-            return 0.0;
-        };
-
-        candle.open = getDoubleValue(row.get("open", 0.0));
-        candle.high = getDoubleValue(row.get("high", 0.0));
-        candle.low = getDoubleValue(row.get("low", 0.0));
-        candle.close = getDoubleValue(row.get("close", 0.0));
-        candle.volume = getDoubleValue(row.get("volume", 0.0));
-
+        candle.open = priceAt(0, row);
+        candle.high = priceAt(1, row);
+        candle.low = priceAt(2, row);
+        candle.close = priceAt(3, row);
+        candle.volume = priceAt(4, row);
         candles.push_back(candle);
     }
 
@@ -722,9 +701,36 @@ int CandlestickChart::FindHoveredBarIndex(double mouse_x_plot, const double* x_v
     return potential_idx;
 }
 
+void CandlestickChart::EnsurePlotLod() {
+    if (lod_revision_ == ohlcv_data_.getRevision()) {
+        return;
+    }
+    const auto& lows = ohlcv_data_.getLows();
+    const auto& highs = ohlcv_data_.getHighs();
+    const auto& volumes = ohlcv_data_.getVolumes();
+    price_lod_.Build(lows.data(), highs.data(), ohlcv_data_.getProcessedDataCount());
+    volume_prefix_.assign(volumes.size() + 1, 0.0);
+    for (size_t i = 0; i < volumes.size(); ++i) {
+        volume_prefix_[i + 1] = volume_prefix_[i] + volumes[i];
+    }
+    lod_candles_.Clear();
+    lod_volumes_.Clear();
+    lod_revision_ = ohlcv_data_.getRevision();
+}
+
+// Frame width rather than GetPlotSize(), which would lock setup before the Y
+// limits are set. Both panes are as wide as the window, so they pick the same level.
+static int PickPlotLodLevel(const plot_lod::MinMaxPyramid& pyramid, int start_idx, int end_idx) {
+    if (end_idx < start_idx) {
+        return 0;
+    }
+    const double pixels = std::max(1.0f, ImPlot::GetCurrentPlot()->FrameRect.GetWidth());
+    return plot_lod::PickLevel(static_cast<size_t>(start_idx), static_cast<size_t>(end_idx) + 1, pixels, pyramid.LevelCount());
+}
 
 void CandlestickChart::RenderCandlestickPlotPane() {
     if (ohlcv_data_.getProcessedDataCount() == 0) return;
+    EnsurePlotLod();
 
     const auto& times = ohlcv_data_.getTimes();
     const auto& opens = ohlcv_data_.getOpens();
@@ -802,9 +808,9 @@ void CandlestickChart::RenderCandlestickPlotPane() {
         }
 
 
-        for (int i = start_idx; i <= end_idx && i < static_cast<int>(ohlcv_data_.getProcessedDataCount()); ++i) {
-            min_price = std::min(min_price, lows[i]);
-            max_price = std::max(max_price, highs[i]);
+        if (end_idx >= start_idx) {
+            // Leaves DBL_MAX / -DBL_MAX in place when the range holds no prices
+            price_lod_.RangeMinMax(static_cast<size_t>(start_idx), static_cast<size_t>(end_idx) + 1, &min_price, &max_price);
         }
 
         if (min_price != DBL_MAX && max_price != -DBL_MAX) {
@@ -838,17 +844,36 @@ void CandlestickChart::RenderCandlestickPlotPane() {
             int plot_start_idx = start_idx;
             int plot_end_idx = std::min(end_idx, static_cast<int>(ohlcv_data_.getProcessedDataCount()) - 1);
             int plot_count = (plot_end_idx >= plot_start_idx) ? (plot_end_idx - plot_start_idx + 1) : 0;
-            MyImPlot::PlotCandlestick(symbol_.c_str(),
-                                      times.data() + plot_start_idx,
-                                      opens.data() + plot_start_idx,
-                                      closes.data() + plot_start_idx,
-                                      lows.data() + plot_start_idx,
-                                      highs.data() + plot_start_idx,
-                                      plot_count,
-                                      candle_width_percent,
-                                      bullCol,
-                                      bearCol,
-                                      candle_width_plot_units);
+            const int lod_level = PickPlotLodLevel(price_lod_, plot_start_idx, plot_end_idx);
+            if (lod_level == 0) {
+                MyImPlot::PlotCandlestick(symbol_.c_str(),
+                                          times.data() + plot_start_idx,
+                                          opens.data() + plot_start_idx,
+                                          closes.data() + plot_start_idx,
+                                          lows.data() + plot_start_idx,
+                                          highs.data() + plot_start_idx,
+                                          plot_count,
+                                          candle_width_percent,
+                                          bullCol,
+                                          bearCol,
+                                          candle_width_plot_units);
+            } else {
+                // More candles than pixels: draw 2^level candles as one
+                plot_lod::AggregateOhlc(price_lod_, times.data(), opens.data(), closes.data(), nullptr,
+                                        static_cast<size_t>(plot_start_idx), static_cast<size_t>(plot_end_idx) + 1,
+                                        lod_level, &lod_candles_);
+                MyImPlot::PlotCandlestick(symbol_.c_str(),
+                                          lod_candles_.x.data(),
+                                          lod_candles_.open.data(),
+                                          lod_candles_.close.data(),
+                                          lod_candles_.low.data(),
+                                          lod_candles_.high.data(),
+                                          static_cast<int>(lod_candles_.Size()),
+                                          candle_width_percent,
+                                          bullCol,
+                                          bearCol,
+                                          candle_width_plot_units * static_cast<double>(1ull << lod_level));
+            }
         }
 
         // Draw news event markers above candles
@@ -1043,6 +1068,7 @@ void CandlestickChart::RenderCandlestickPlotPane() {
 
 void CandlestickChart::RenderVolumePlotPane() {
     if (ohlcv_data_.getProcessedDataCount() == 0) return;
+    EnsurePlotLod();
 
     const auto& times = ohlcv_data_.getTimes();
     const auto& volumes = ohlcv_data_.getVolumes();
@@ -1093,8 +1119,19 @@ void CandlestickChart::RenderVolumePlotPane() {
         }
         double max_volume = 0;
 
-        for (int i = start_idx; i <= end_idx && i < static_cast<int>(ohlcv_data_.getProcessedDataCount()); ++i) {
-            max_volume = std::max(max_volume, volumes[i]);
+        // Same level as the candles; merged bars carry the summed volume
+        const int lod_level = PickPlotLodLevel(price_lod_, start_idx, end_idx);
+        if (lod_level == 0) {
+            for (int i = start_idx; i <= end_idx && i < static_cast<int>(ohlcv_data_.getProcessedDataCount()); ++i) {
+                max_volume = std::max(max_volume, volumes[i]);
+            }
+        } else {
+            plot_lod::AggregateOhlc(price_lod_, times.data(), ohlcv_data_.getOpens().data(), ohlcv_data_.getCloses().data(),
+                                    volume_prefix_.data(), static_cast<size_t>(start_idx), static_cast<size_t>(end_idx) + 1,
+                                    lod_level, &lod_volumes_);
+            for (double volume : lod_volumes_.volume) {
+                max_volume = std::max(max_volume, volume);
+            }
         }
 
         if (max_volume > 0) {
@@ -1112,13 +1149,19 @@ void CandlestickChart::RenderVolumePlotPane() {
         } else {
             bar_width_plot_units = (ohlcv_data_.getProcessedDataCount() > 1 && (times[1] - times[0] > 0)) ? (times[1] - times[0]) * 0.8 : (86400.0 * 0.8 / 24) ; // 80% of time interval, default 1hr
         }
-        {
+        if (lod_level == 0) {
             int plot_count = (end_idx >= start_idx) ? (end_idx - start_idx + 1) : 0;
             ImPlot::PlotBars("Volume",
                              times.data() + start_idx,
                              volumes.data() + start_idx,
                              plot_count,
                              bar_width_plot_units);
+        } else {
+            ImPlot::PlotBars("Volume",
+                             lod_volumes_.x.data(),
+                             lod_volumes_.volume.data(),
+                             static_cast<int>(lod_volumes_.Size()),
+                             bar_width_plot_units * static_cast<double>(1ull << lod_level));
         }
 
         if (show_tooltip_ && ImPlot::IsPlotHovered()) {
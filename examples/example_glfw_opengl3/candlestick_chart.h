@@ -14,6 +14,7 @@
 #include "ohlcv_data.h" // For OhlcvData class
 #include "implot_custom_plotters.h" // For MyImPlot::PlotCandlestick
 #include "TickerSelector.h" // Added for ticker selection UI
+#include "PlotLodPyramid.h" // Min/max pyramid for decimated drawing
 
 namespace chronosflow {
 class AnalyticsDataFrame;
@@ -86,6 +87,14 @@ private:
     int    visible_start_idx_; // Index of first visible data point
     int    visible_end_idx_;   // Index of last visible data point
 
+    // Level-of-detail state: candles and volume bars are drawn at most about
+    // one per pixel by merging 2^k neighbours into one OHLC bucket
+    plot_lod::MinMaxPyramid price_lod_;      // Over processed lows/highs
+    std::vector<double> volume_prefix_;      // Running volume sums, count + 1 entries
+    unsigned long long lod_revision_ = ~0ull; // OhlcvData revision the LOD state was built from
+    plot_lod::OhlcBuckets lod_candles_;
+    plot_lod::OhlcBuckets lod_volumes_;
+
     // Helper Methods
     void RequestLoadData();
     void CheckAndProcessLoadedData();
@@ -96,6 +105,7 @@ private:
     void RenderUnifiedTooltip();
     void DrawFileLoadControls();
     bool LoadOhlcvFromFile(const std::string& filepath);
+    void EnsurePlotLod();
     int FindHoveredBarIndex(double mouse_x_plot, const double* x_values, int num_values, double item_full_width_plot_units, bool is_time_scale);
 
     // User data struct for VolumeTimeAxisFormatter
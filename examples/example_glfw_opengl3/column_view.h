@@ -2,7 +2,12 @@
 
 #include <memory>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
 #include <typeinfo>
+#include <vector>
+#include <algorithm>
 #include <arrow/table.h>
 #include <arrow/array.h>
 #include <arrow/array/array_primitive.h>
@@ -59,6 +64,11 @@ public:
         std::shared_ptr<arrow::Table> table, 
         const std::string& column_name);
 
+    // View of one contiguous array; the view keeps the array alive
+    static arrow::Result<ColumnView<T>> from_arrow_array(
+        std::shared_ptr<arrow::Array> array,
+        const std::string& column_name);
+
 #ifdef WITH_CUDA
     static arrow::Result<ColumnView<T>> from_cudf_column(
         std::shared_ptr<cudf::table> table,
@@ -130,6 +140,176 @@ arrow::Result<ColumnView<T>> ColumnView<T>::from_arrow_column(
     return ColumnView<T>(data_ptr, size, DeviceType::CPU, lifetime_sentinel);
 }
 
+template<typename T>
+arrow::Result<ColumnView<T>> ColumnView<T>::from_arrow_array(
+    std::shared_ptr<arrow::Array> array,
+    const std::string& column_name) {
+
+    using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+
+    auto typed_array = std::dynamic_pointer_cast<ArrayType>(array);
+    if (!typed_array) {
+        return arrow::Status::Invalid("Type mismatch: Cannot cast column '", column_name,
+                                      "' to the requested type '", typeid(T).name(), "'.");
+    }
+
+    return ColumnView<T>(typed_array->raw_values(), typed_array->length(), DeviceType::CPU, array);
+}
+
+// Read-only view of a column as it is stored: one span per Arrow chunk, no
+// concatenation. Use it when an algorithm can work chunk by chunk; use
+// ColumnView<T> (via AnalyticsDataFrame::get_column_view, which combines
+// chunks at most once per column) when it needs one contiguous buffer.
+template<typename T>
+class ChunkedColumnView {
+public:
+    // Walks the elements of all chunks in order
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator(const ChunkedColumnView* view, std::size_t chunk, std::size_t pos)
+            : view_(view), chunk_(chunk), pos_(pos) { skip_empty(); }
+
+        reference operator*() const { return view_->chunks_[chunk_][pos_]; }
+        pointer operator->() const { return &view_->chunks_[chunk_][pos_]; }
+
+        const_iterator& operator++() {
+            if (++pos_ == view_->chunks_[chunk_].size()) {
+                ++chunk_;
+                pos_ = 0;
+                skip_empty();
+            }
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++(*this); return tmp; }
+
+        bool operator==(const const_iterator& other) const { return chunk_ == other.chunk_ && pos_ == other.pos_; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+    private:
+        void skip_empty() {
+            while (view_ && chunk_ < view_->chunks_.size() && view_->chunks_[chunk_].empty()) {
+                ++chunk_;
+            }
+        }
+
+        const ChunkedColumnView* view_ = nullptr;
+        std::size_t chunk_ = 0;
+        std::size_t pos_ = 0;
+    };
+
+    ChunkedColumnView() = default;
+
+    static arrow::Result<ChunkedColumnView<T>> from_arrow_column(
+        std::shared_ptr<arrow::Table> table,
+        const std::string& column_name);
+
+    std::size_t size() const { return size_; }
+    std::size_t num_chunks() const { return chunks_.size(); }
+    std::span<const T> chunk(std::size_t index) const { return chunks_[index]; }
+    const std::vector<std::span<const T>>& chunks() const { return chunks_; }
+
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return const_iterator(this, chunks_.size(), 0); }
+
+    // Element by global row; locates the chunk by binary search
+    const T& operator[](std::size_t row) const {
+        std::size_t c = chunk_index(row);
+        return chunks_[c][row - offsets_[c]];
+    }
+
+    // fn(std::span<const T> chunk, std::size_t first_row) for each chunk
+    template<typename Fn>
+    void for_each_chunk(Fn&& fn) const {
+        for (std::size_t c = 0; c < chunks_.size(); ++c) {
+            fn(chunks_[c], offsets_[c]);
+        }
+    }
+
+    template<typename Acc, typename Op>
+    Acc reduce(Acc init, Op&& op) const {
+        for (const auto& span : chunks_) {
+            for (const T& value : span) {
+                init = op(init, value);
+            }
+        }
+        return init;
+    }
+
+    // out[i] = column[rows[i]]
+    template<typename Index>
+    void gather(const Index* rows, std::size_t count, T* out) const {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = (*this)[static_cast<std::size_t>(rows[i])];
+        }
+    }
+
+    void copy_to(T* out) const {
+        for (const auto& span : chunks_) {
+            std::copy(span.begin(), span.end(), out);
+            out += span.size();
+        }
+    }
+
+    std::vector<T> to_vector() const {
+        std::vector<T> result(size_);
+        copy_to(result.data());
+        return result;
+    }
+
+private:
+    std::size_t chunk_index(std::size_t row) const {
+        auto it = std::upper_bound(offsets_.begin(), offsets_.end(), row);
+        return static_cast<std::size_t>(it - offsets_.begin()) - 1;
+    }
+
+    std::vector<std::span<const T>> chunks_;
+    std::vector<std::size_t> offsets_;     // First global row of each chunk
+    std::size_t size_ = 0;
+    std::shared_ptr<void> lifetime_sentinel_;
+};
+
+template<typename T>
+arrow::Result<ChunkedColumnView<T>> ChunkedColumnView<T>::from_arrow_column(
+    std::shared_ptr<arrow::Table> table,
+    const std::string& column_name) {
+
+    if (!table) {
+        return arrow::Status::Invalid("Input table is null");
+    }
+
+    auto column = table->GetColumnByName(column_name);
+    if (!column) {
+        return arrow::Status::Invalid("Column not found: ", column_name);
+    }
+
+    using ArrowType = typename arrow::CTypeTraits<T>::ArrowType;
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+
+    ChunkedColumnView<T> view;
+    view.chunks_.reserve(column->num_chunks());
+    view.offsets_.reserve(column->num_chunks());
+    for (const auto& chunk : column->chunks()) {
+        auto typed_chunk = std::dynamic_pointer_cast<ArrayType>(chunk);
+        if (!typed_chunk) {
+            return arrow::Status::Invalid("Type mismatch: Cannot cast column '", column_name,
+                                          "' to the requested type '", typeid(T).name(), "'.");
+        }
+        view.offsets_.push_back(view.size_);
+        view.chunks_.emplace_back(typed_chunk->raw_values(), static_cast<std::size_t>(typed_chunk->length()));
+        view.size_ += static_cast<std::size_t>(typed_chunk->length());
+    }
+    view.lifetime_sentinel_ = column;
+    return view;
+}
+
 #ifdef WITH_CUDA
 template<typename T>
 arrow::Result<ColumnView<T>> ColumnView<T>::from_cudf_column(
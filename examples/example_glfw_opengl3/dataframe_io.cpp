@@ -1,4 +1,5 @@
 #include "dataframe_io.h"
+#include "tssb_text_parser.h"
 #include <arrow/io/file.h>
 #include <arrow/io/memory.h>
 #include <arrow/buffer.h>
@@ -9,10 +10,17 @@
 #include <parquet/arrow/writer.h>
 #include <parquet/properties.h>
 #include <arrow/scalar.h>
+#include <arrow/compute/api.h>
+#include <arrow/ipc/api.h>
+#include <arrow/util/key_value_metadata.h>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <random>
+#include <unordered_map>
 
 namespace chronosflow {
 
@@ -89,41 +97,42 @@ arrow::Result<AnalyticsDataFrame> DataFrameIO::read_tssb(
     const std::string& file_path,
     const TSSBReadOptions& options) {
     
-    ARROW_ASSIGN_OR_RAISE(auto input_file, arrow::io::ReadableFile::Open(file_path));
-    
-    std::shared_ptr<arrow::io::InputStream> input = input_file;
+    ARROW_ASSIGN_OR_RAISE(auto mapped_file,
+                          arrow::io::MemoryMappedFile::Open(file_path, arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto file_size, mapped_file->GetSize());
+    ARROW_ASSIGN_OR_RAISE(auto contents, mapped_file->ReadAt(0, file_size));
     
     char delimiter = options.delimiter;
     
     if (options.auto_detect_delimiter) {
-        // Read first few lines for detection
-        auto buffer_result = input->Read(1024);
-        if (!buffer_result.ok()) {
-            return buffer_result.status();
-        }
-        
-        auto buffer = buffer_result.ValueOrDie();
-        std::string sample(reinterpret_cast<const char*>(buffer->data()), buffer->size());
+        // Detect from the first line of a short sample
+        const auto sample_size = std::min<int64_t>(contents->size(), 1024);
+        std::string sample(reinterpret_cast<const char*>(contents->data()), sample_size);
         
         std::istringstream stream(sample);
         std::string first_line;
         std::getline(stream, first_line);
         
         delimiter = detect_delimiter(first_line);
-        
-        // Reset file position after reading sample
-        ARROW_RETURN_NOT_OK(input_file->Seek(0));
     }
     
-    // If space delimiter is detected, wrap the input stream with our normalizer
-    if (delimiter == ' ') {
-        input = std::make_shared<WhitespaceNormalizingInputStream>(input);
-        delimiter = '\t'; // The normalizer outputs tabs, so we tell the CSV parser to expect tabs
+    std::shared_ptr<arrow::Table> table;
+    if (contents->size() > 0 && TssbTextParser::supports(*contents)) {
+        // Parallel parse straight from the mapped bytes into typed columns
+        ARROW_ASSIGN_OR_RAISE(table, TssbTextParser::parse(contents, delimiter, options.has_header));
+    } else {
+        // Quoted fields: hand the bytes to Arrow's CSV reader instead
+        std::shared_ptr<arrow::io::InputStream> input = std::make_shared<arrow::io::BufferReader>(contents);
+        
+        // If space delimiter is detected, wrap the input stream with our normalizer
+        if (delimiter == ' ') {
+            input = std::make_shared<WhitespaceNormalizingInputStream>(input);
+            delimiter = '\t'; // The normalizer outputs tabs, so we tell the CSV parser to expect tabs
+        }
+        
+        ARROW_ASSIGN_OR_RAISE(table, parse_tssb_stream(input, delimiter, options.has_header));
     }
     
-    // The rest of the function proceeds as before, but with the correct stream
-    ARROW_ASSIGN_OR_RAISE(auto table, parse_tssb_stream(input, delimiter, options.has_header));
-    
     AnalyticsDataFrame df(std::move(table));
     
     // IMPORTANT: Set metadata ONLY if explicitly provided in options.
@@ -201,11 +210,30 @@ arrow::Result<AnalyticsDataFrame> DataFrameIO::read_parquet(
     return AnalyticsDataFrame(std::move(table));
 }
 
+arrow::Result<AnalyticsDataFrame> DataFrameIO::read_parquet(
+    const std::string& file_path,
+    const ParquetScanOptions& options) {
+    
+    ARROW_ASSIGN_OR_RAISE(auto stream, ParquetBatchStream::open(file_path, options));
+    ARROW_ASSIGN_OR_RAISE(auto table, stream->read_all());
+    return AnalyticsDataFrame(std::move(table));
+}
+
 arrow::Status DataFrameIO::write_parquet(
     const AnalyticsDataFrame& df,
     const std::string& file_path,
     bool use_compression) {
     
+    ParquetWriteOptions options;
+    options.use_compression = use_compression;
+    return write_parquet(df, file_path, options);
+}
+
+arrow::Status DataFrameIO::write_parquet(
+    const AnalyticsDataFrame& df,
+    const std::string& file_path,
+    const ParquetWriteOptions& options) {
+    
     auto cpu_df_result = df.to_cpu();
     if (!cpu_df_result.ok()) {
         return cpu_df_result.status();
@@ -218,31 +246,46 @@ arrow::Status DataFrameIO::write_parquet(
         return arrow::Status::Invalid("DataFrame is empty");
     }
     
+    auto table = cpu_df.get_cpu_table();
+    if (!table) {
+        return arrow::Status::Invalid("No table data available");
+    }
+    
+    if (!options.sort_by_column.empty()) {
+        if (table->schema()->GetFieldIndex(options.sort_by_column) < 0) {
+            return arrow::Status::KeyError("Sort column not found: ", options.sort_by_column);
+        }
+        arrow::compute::SortOptions sort_options({arrow::compute::SortKey(options.sort_by_column)});
+        ARROW_ASSIGN_OR_RAISE(auto indices, arrow::compute::SortIndices(arrow::Datum(table), sort_options));
+        ARROW_ASSIGN_OR_RAISE(auto sorted, arrow::compute::Take(arrow::Datum(table), arrow::Datum(indices)));
+        table = sorted.table();
+    }
+    
     auto output_file = arrow::io::FileOutputStream::Open(file_path);
     if (!output_file.ok()) {
         return output_file.status();
     }
     
+    const int64_t row_group_size = std::max<int64_t>(1, options.row_group_size);
+    
     parquet::WriterProperties::Builder props_builder;
-    if (use_compression) {
+    if (options.use_compression) {
         props_builder.compression(parquet::Compression::SNAPPY);
     } else {
         props_builder.compression(parquet::Compression::UNCOMPRESSED);
     }
+    // Min/max statistics per row group are what ParquetBatchStream prunes on
+    props_builder.enable_statistics();
+    props_builder.max_row_group_length(row_group_size);
     
     auto writer_properties = props_builder.build();
     auto arrow_writer_properties = parquet::ArrowWriterProperties::Builder().build();
     
-    auto table = cpu_df.get_cpu_table();
-    if (!table) {
-        return arrow::Status::Invalid("No table data available");
-    }
-    
     auto status = parquet::arrow::WriteTable(
         *table, 
         arrow::default_memory_pool(),
         output_file.ValueOrDie(),
-        table->num_rows(),
+        row_group_size,
         writer_properties,
         arrow_writer_properties);
     
@@ -321,4 +364,210 @@ arrow::Result<std::shared_ptr<arrow::Table>> DataFrameIO::parse_tssb_stream(
 }
 
 
+// --- Arrow IPC dataset cache ---
+
+namespace {
+
+constexpr const char* kCacheExtension = ".arrowcache";
+constexpr const char* kCacheFormatVersion = "2";
+
+// Identity of the source file as it is now; empty if it cannot be stat'ed
+std::unordered_map<std::string, std::string> source_key(const std::string& file_path,
+                                                        const std::string& options_key) {
+    std::error_code ec;
+    const auto absolute = std::filesystem::absolute(file_path, ec);
+    if (ec) return {};
+    const auto size = std::filesystem::file_size(absolute, ec);
+    if (ec) return {};
+    const auto mtime = std::filesystem::last_write_time(absolute, ec);
+    if (ec) return {};
+
+    return {
+        {"chronosflow.cache_version", kCacheFormatVersion},
+        {"chronosflow.source_path", absolute.generic_string()},
+        {"chronosflow.source_size", std::to_string(size)},
+        {"chronosflow.source_mtime", std::to_string(mtime.time_since_epoch().count())},
+        {"chronosflow.read_options", options_key},
+    };
+}
+
+// Every read option; column names are length-prefixed so none can run
+// into the next field
+std::string tssb_options_key(const TSSBReadOptions& options) {
+    std::ostringstream key;
+    key << "tssb;auto=" << options.auto_detect_delimiter
+        << ";delim=" << static_cast<int>(options.delimiter)
+        << ";header=" << options.has_header
+        << ";date=" << options.date_column.size() << ':' << options.date_column
+        << ";time=" << options.time_column.size() << ':' << options.time_column;
+    return key.str();
+}
+
+// Temp file beside the cache, distinct per process and per write, so two
+// readers warming the same source never write into one file
+std::string unique_temp_path(const std::string& cache_path) {
+    static const uint64_t process_tag =
+        (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    static std::atomic<uint64_t> counter{0};
+    std::ostringstream path;
+    path << cache_path << ".tmp." << std::hex << process_tag << '.' << counter.fetch_add(1);
+    return path.str();
+}
+
+} // namespace
+
+std::string DataFrameIO::cache_path_for(
+    const std::string& file_path,
+    const DatasetCacheOptions& cache) {
+
+    std::filesystem::path source(file_path);
+    if (cache.cache_directory.empty()) {
+        return source.string() + kCacheExtension;
+    }
+    return (std::filesystem::path(cache.cache_directory) / source.filename()).string() + kCacheExtension;
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> DataFrameIO::load_cached_table(
+    const std::string& file_path,
+    const std::string& options_key,
+    const DatasetCacheOptions& cache) {
+
+    const std::string cache_path = cache_path_for(file_path, cache);
+    std::error_code ec;
+    if (!std::filesystem::exists(cache_path, ec)) {
+        return std::shared_ptr<arrow::Table>();
+    }
+
+    const auto expected = source_key(file_path, options_key);
+    if (expected.empty()) {
+        return std::shared_ptr<arrow::Table>();
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto mapped, arrow::io::MemoryMappedFile::Open(cache_path, arrow::io::FileMode::READ));
+    ARROW_ASSIGN_OR_RAISE(auto reader, arrow::ipc::RecordBatchFileReader::Open(mapped));
+
+    auto metadata = reader->schema()->metadata();
+    if (!metadata) {
+        return std::shared_ptr<arrow::Table>();
+    }
+    for (const auto& [key, value] : expected) {
+        auto stored = metadata->Get(key);
+        if (!stored.ok() || stored.ValueOrDie() != value) {
+            return std::shared_ptr<arrow::Table>();
+        }
+    }
+
+    // Uncompressed batches reference the mapped pages directly
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    batches.reserve(reader->num_record_batches());
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, reader->ReadRecordBatch(i));
+        batches.push_back(std::move(batch));
+    }
+    return arrow::Table::FromRecordBatches(reader->schema()->RemoveMetadata(), batches);
+}
+
+arrow::Status DataFrameIO::store_cached_table(
+    const std::string& file_path,
+    const std::string& options_key,
+    const std::shared_ptr<arrow::Table>& table,
+    const DatasetCacheOptions& cache) {
+
+    const auto key = source_key(file_path, options_key);
+    if (key.empty()) {
+        return arrow::Status::IOError("Cannot stat source file: ", file_path);
+    }
+
+    const std::string cache_path = cache_path_for(file_path, cache);
+    const std::string temp_path = unique_temp_path(cache_path);
+    if (!cache.cache_directory.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(cache.cache_directory, ec);
+    }
+
+    auto schema = table->schema()->WithMetadata(
+        std::make_shared<arrow::KeyValueMetadata>(key));
+
+    auto write = [&]() -> arrow::Status {
+        ARROW_ASSIGN_OR_RAISE(auto output, arrow::io::FileOutputStream::Open(temp_path));
+        ARROW_ASSIGN_OR_RAISE(auto writer, arrow::ipc::MakeFileWriter(
+            output, schema, arrow::ipc::IpcWriteOptions::Defaults()));
+        arrow::TableBatchReader batches(*table);
+        std::shared_ptr<arrow::RecordBatch> batch;
+        while (true) {
+            ARROW_RETURN_NOT_OK(batches.ReadNext(&batch));
+            if (!batch) break;
+            ARROW_ASSIGN_OR_RAISE(auto tagged, batch->ReplaceSchema(schema));
+            ARROW_RETURN_NOT_OK(writer->WriteRecordBatch(*tagged));
+        }
+        ARROW_RETURN_NOT_OK(writer->Close());
+        return output->Close();
+    };
+    std::error_code ec;
+    const arrow::Status written = write();
+    if (!written.ok()) {
+        std::filesystem::remove(temp_path, ec);
+        return written;
+    }
+
+    // Readers never see a half-written cache
+    std::filesystem::rename(temp_path, cache_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return arrow::Status::IOError("Failed to move cache into place: ", cache_path);
+    }
+    return arrow::Status::OK();
+}
+
+arrow::Result<AnalyticsDataFrame> DataFrameIO::read_tssb_cached(
+    const std::string& file_path,
+    const TSSBReadOptions& options,
+    const DatasetCacheOptions& cache) {
+
+    if (!cache.enabled) {
+        return read_tssb(file_path, options);
+    }
+
+    const std::string options_key = tssb_options_key(options);
+    auto cached = load_cached_table(file_path, options_key, cache);
+    if (cached.ok() && cached.ValueOrDie()) {
+        AnalyticsDataFrame df(std::move(cached).ValueOrDie());
+        if (!options.date_column.empty()) {
+            df.set_tssb_metadata(options.date_column, options.time_column);
+        }
+        return df;
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto df, read_tssb(file_path, options));
+    (void)store_cached_table(file_path, options_key, df.get_cpu_table(), cache);
+    return df;
+}
+
+arrow::Status DataFrameIO::warm_tssb_cache(
+    const std::string& file_path,
+    const TSSBReadOptions& options,
+    const DatasetCacheOptions& cache) {
+
+    const std::string options_key = tssb_options_key(options);
+    auto cached = load_cached_table(file_path, options_key, cache);
+    if (cached.ok() && cached.ValueOrDie()) {
+        return arrow::Status::OK();
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto df, read_tssb(file_path, options));
+    return store_cached_table(file_path, options_key, df.get_cpu_table(), cache);
+}
+
+arrow::Status DataFrameIO::invalidate_cache(
+    const std::string& file_path,
+    const DatasetCacheOptions& cache) {
+
+    std::error_code ec;
+    std::filesystem::remove(cache_path_for(file_path, cache), ec);
+    if (ec) {
+        return arrow::Status::IOError("Failed to remove cache for ", file_path, ": ", ec.message());
+    }
+    return arrow::Status::OK();
+}
+
 } // namespace chronosflow
\ No newline at end of file
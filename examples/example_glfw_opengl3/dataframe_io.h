@@ -1,6 +1,7 @@
 #pragma once
 
 #include "analytics_dataframe.h"
+#include "parquet_batch_stream.h"
 #include <arrow/io/interfaces.h> // Required for InputStream
 #include <arrow/result.h>
 #include <arrow/status.h>  // DIAGNOSTIC: Added missing Status header
@@ -55,6 +56,35 @@ struct TSSBWriteOptions {
     }
 };
 
+struct ParquetWriteOptions {
+    bool use_compression = true;
+
+    // Rows per row group. Smaller groups give finer statistics for pruning
+    // in ParquetBatchStream at the cost of a larger footer.
+    int64_t row_group_size = 128 * 1024;
+
+    // When set, rows are sorted ascending by this column before writing so
+    // each row group covers a narrow, non-overlapping key range.
+    std::string sort_by_column;
+
+    static ParquetWriteOptions Defaults() {
+        return ParquetWriteOptions{};
+    }
+};
+
+// On-disk Arrow IPC copy of a parsed source file. The cache is uncompressed so
+// it can be memory-mapped and read without copying column buffers. It is
+// keyed by the source's absolute path, size, modification time and the read
+// options, all stored in the IPC schema metadata.
+struct DatasetCacheOptions {
+    bool enabled = true;
+    std::string cache_directory;   // Empty: next to the source file
+
+    static DatasetCacheOptions Defaults() {
+        return DatasetCacheOptions{};
+    }
+};
+
 class DataFrameIO {
 public:
     static arrow::Result<AnalyticsDataFrame> read_tssb(
@@ -74,9 +104,54 @@ public:
         const std::string& file_path,
         bool use_compression = true);
 
+    // Projected and range-filtered read through ParquetBatchStream
+    static arrow::Result<AnalyticsDataFrame> read_parquet(
+        const std::string& file_path,
+        const ParquetScanOptions& options);
+
+    static arrow::Status write_parquet(
+        const AnalyticsDataFrame& df,
+        const std::string& file_path,
+        const ParquetWriteOptions& options);
+
+    // read_tssb through the IPC cache: a matching cache file is memory-mapped,
+    // otherwise the source is parsed and the cache rewritten. Failure to
+    // write the cache is not an error.
+    static arrow::Result<AnalyticsDataFrame> read_tssb_cached(
+        const std::string& file_path,
+        const TSSBReadOptions& options = TSSBReadOptions::Defaults(),
+        const DatasetCacheOptions& cache = DatasetCacheOptions::Defaults());
+
+    // Parses the source and writes its cache if it is missing or stale
+    static arrow::Status warm_tssb_cache(
+        const std::string& file_path,
+        const TSSBReadOptions& options = TSSBReadOptions::Defaults(),
+        const DatasetCacheOptions& cache = DatasetCacheOptions::Defaults());
+
+    // Deletes the cache file of file_path, if any
+    static arrow::Status invalidate_cache(
+        const std::string& file_path,
+        const DatasetCacheOptions& cache = DatasetCacheOptions::Defaults());
+
+    static std::string cache_path_for(
+        const std::string& file_path,
+        const DatasetCacheOptions& cache = DatasetCacheOptions::Defaults());
+
 private:
     static char detect_delimiter(const std::string& sample_line);
 
+    // nullptr when there is no cache file or its key does not match
+    static arrow::Result<std::shared_ptr<arrow::Table>> load_cached_table(
+        const std::string& file_path,
+        const std::string& options_key,
+        const DatasetCacheOptions& cache);
+
+    static arrow::Status store_cached_table(
+        const std::string& file_path,
+        const std::string& options_key,
+        const std::shared_ptr<arrow::Table>& table,
+        const DatasetCacheOptions& cache);
+
     static arrow::Result<std::shared_ptr<arrow::Table>> parse_tssb_stream(
         std::shared_ptr<arrow::io::InputStream> input,
         char delimiter,
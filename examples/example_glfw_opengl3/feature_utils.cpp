@@ -87,6 +87,17 @@ arrow::Result<AnalyticsDataFrame> FeatureUtils::create_rolling_features(
     const std::vector<int>& window_sizes,
     bool use_gpu) {
     
+    RollingFeatureSpec spec;
+    spec.window_sizes = window_sizes;
+    spec.statistics = {RollingStatistic::Mean, RollingStatistic::StdDev};
+    return create_rolling_features(df, feature_columns, spec);
+}
+
+arrow::Result<AnalyticsDataFrame> FeatureUtils::create_rolling_features(
+    const AnalyticsDataFrame& df,
+    const std::vector<std::string>& feature_columns,
+    const RollingFeatureSpec& spec) {
+    
     auto cpu_df_result = df.to_cpu();
     if (!cpu_df_result.ok()) {
         return cpu_df_result.status();
@@ -107,51 +118,20 @@ arrow::Result<AnalyticsDataFrame> FeatureUtils::create_rolling_features(
         new_fields.push_back(schema->field(i));
     }
     
-    // Use Arrow's native rolling window functions
+    // Columns that are not in the table are skipped
+    std::vector<std::string> present_columns;
     for (const auto& column_name : feature_columns) {
-        auto column_result = table->GetColumnByName(column_name);
-        if (!column_result) {
-            continue;
-        }
-        
-        auto column = column_result->chunk(0);
-        
-        for (int window_size : window_sizes) {
-            // PERFORMANCE WARNING: The following is a manual, unoptimized implementation
-            // of a rolling window due to limitations in Arrow 21.0.0. It has O(N*W)
-            // complexity and is extremely slow on large datasets. For production use,
-            // upgrade Arrow or implement an optimized sliding-window algorithm.
-            {
-                arrow::DoubleBuilder mean_builder;
-                
-                for (int64_t i = 0; i < column->length(); ++i) {
-                    if (i < window_size - 1) {
-                        ARROW_RETURN_NOT_OK(mean_builder.AppendNull());
-                    } else {
-                        auto window_slice = column->Slice(i - window_size + 1, window_size);
-                        auto mean_result = arrow::compute::CallFunction("mean", std::vector<arrow::Datum>{window_slice});
-                        
-                        if (mean_result.ok() && mean_result.ValueOrDie().scalar()->is_valid) {
-                            auto scalar_val = std::static_pointer_cast<arrow::DoubleScalar>(mean_result.ValueOrDie().scalar());
-                            ARROW_RETURN_NOT_OK(mean_builder.Append(scalar_val->value));
-                        } else {
-                            ARROW_RETURN_NOT_OK(mean_builder.AppendNull());
-                        }
-                    }
-                }
-                
-                std::shared_ptr<arrow::Array> mean_array;
-                ARROW_RETURN_NOT_OK(mean_builder.Finish(&mean_array));
-                
-                std::string mean_name = column_name + "_rolling_mean_" + std::to_string(window_size);
-                new_columns.push_back(std::make_shared<arrow::ChunkedArray>(mean_array));
-                new_fields.push_back(arrow::field(mean_name, arrow::float64()));
-            }
-            
-            // DIAGNOSTIC: Skip rolling stddev since rolling functions don't exist in Arrow 21.0.0
+        if (table->GetColumnByName(column_name)) {
+            present_columns.push_back(column_name);
         }
     }
     
+    ARROW_ASSIGN_OR_RAISE(auto rolling, RollingWindowKernels::compute_columns(table, present_columns, spec));
+    for (auto& column : rolling) {
+        new_columns.push_back(std::make_shared<arrow::ChunkedArray>(column.values));
+        new_fields.push_back(arrow::field(column.name, arrow::float64()));
+    }
+    
     auto new_schema = arrow::schema(new_fields);
     auto new_table = arrow::Table::Make(new_schema, new_columns);
     
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "analytics_dataframe.h"
+#include "rolling_window_kernels.h"
 #include <arrow/result.h>
 #include <vector>
 #include <string>
@@ -26,6 +27,12 @@ public:
         const std::vector<int>& window_sizes = {5, 10, 20},
         bool use_gpu = false);
 
+    // Any mix of rolling statistics; see RollingWindowKernels
+    static arrow::Result<AnalyticsDataFrame> create_rolling_features(
+        const AnalyticsDataFrame& df,
+        const std::vector<std::string>& feature_columns,
+        const RollingFeatureSpec& spec);
+
     static arrow::Result<std::vector<std::string>> select_top_features(
         const AnalyticsDataFrame& df,
         const std::string& target_column,
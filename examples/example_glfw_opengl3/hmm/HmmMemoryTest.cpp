@@ -1,14 +1,15 @@
 #include "HmmMemoryTest.h"
 
 #include <algorithm>
-#include <atomic>
 #include <cmath>
-#include <future>
+#include <mutex>
 #include <numeric>
+#include <stdexcept>
 #include <thread>
 #include <functional>
 
 #include "HmmGpu.h"
+#include "HmmWorkPool.h"
 
 namespace hmm {
 
@@ -27,7 +28,8 @@ HmmMemoryAnalyzer::HmmMemoryAnalyzer(HmmMemoryConfig config)
 
 HmmMemoryResult HmmMemoryAnalyzer::analyze(const Eigen::MatrixXd& observations,
                                            std::mt19937_64& rng,
-                                           std::function<void(double)> progressCallback) {
+                                           std::function<void(double)> progressCallback,
+                                           HmmMemoryPartialCallback partialCallback) {
     if (observations.rows() < 3) {
         throw std::invalid_argument("HMM memory analysis requires at least 3 observations");
     }
@@ -92,133 +94,141 @@ HmmMemoryResult HmmMemoryAnalyzer::analyze(const Eigen::MatrixXd& observations,
     }
 
     const int permutations = totalRuns - 1;
-    result.permutationLogLikelihoods.resize(permutations);
+    result.permutationLogLikelihoods.assign(permutations, 0.0);
 
     std::vector<uint64_t> seeds(permutations);
     for (int i = 0; i < permutations; ++i) {
         seeds[i] = rng();
     }
 
-    std::vector<int> baseIndex(data.rows());
-    std::iota(baseIndex.begin(), baseIndex.end(), 0);
+    // Partial events carry only the newest permutation; the running statistics are
+    // updated in O(1) per completion (Welford) rather than recomputed over all of them.
+    HmmMemoryPartialResult partial;
+    if (partialCallback) {
+        HmmFitResult publishedFit;
+        publishedFit.parameters = originalFit.parameters;
+        publishedFit.logLikelihood = originalFit.logLikelihood;
+        publishedFit.iterations = originalFit.iterations;
+        publishedFit.converged = originalFit.converged;
+        partial.originalFit = &publishedFit;
+        partialCallback(partial);
+        partial.originalFit = nullptr;
+    }
+    int partialGreaterOrEqual = 1; // original run
+    double partialM2 = 0.0;
+
+    HmmWorkPool pool(m_config.maxThreads);
+
+    // Each worker permutes an index vector and gathers rows into a buffer that is
+    // allocated once, instead of building a fresh matrix for every permutation.
+    struct PermutationScratch {
+        std::vector<int> index;
+        Eigen::MatrixXd permuted;
+    };
+    std::vector<PermutationScratch> scratch(pool.workerCount());
+
+    auto buildPermutation = [&data](PermutationScratch& local, std::mt19937_64& localRng) -> const Eigen::MatrixXd& {
+        if (local.index.size() != static_cast<std::size_t>(data.rows())) {
+            local.index.resize(data.rows());
+            local.permuted.resize(data.rows(), data.cols());
+        }
+        std::iota(local.index.begin(), local.index.end(), 0);
+        std::shuffle(local.index.begin(), local.index.end(), localRng);
+        local.permuted = data(local.index, Eigen::all);
+        return local.permuted;
+    };
+
+    std::mutex completionMutex;
+    int completed = 0;
+    auto recordCompletion = [&](int idx, double logLikelihood) {
+        result.permutationLogLikelihoods[idx] = logLikelihood;
 
-    const int concurrency = std::max(1, std::min(m_config.maxThreads, permutations));
-    std::atomic<int> completed{0};
-    auto updateProgress = [&](int localCompleted) {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ++completed;
         if (progressCallback) {
-            double fraction = static_cast<double>(localCompleted) / static_cast<double>(permutations);
+            double fraction = static_cast<double>(completed) / static_cast<double>(permutations);
             progressCallback(std::min(1.0, fraction));
         }
+        if (partialCallback) {
+            if (logLikelihood >= result.originalLogLikelihood) {
+                ++partialGreaterOrEqual;
+            }
+            const double delta = logLikelihood - partial.meanPermutationLogLikelihood;
+            partial.meanPermutationLogLikelihood += delta / static_cast<double>(completed);
+            partialM2 += delta * (logLikelihood - partial.meanPermutationLogLikelihood);
+
+            partial.permutationsCompleted = completed;
+            partial.permutationLogLikelihood = logLikelihood;
+            partial.pValue = static_cast<double>(partialGreaterOrEqual) / static_cast<double>(completed + 1);
+            partial.stdPermutationLogLikelihood = std::sqrt(partialM2 / std::max(1, completed - 1));
+            partialCallback(partial);
+        }
     };
 
+    int firstCpuPermutation = 0;
     if (canUseGpu) {
-        bool gpuHealthy = true;
-        int idx = 0;
-        for (; idx < permutations; ++idx) {
-            std::mt19937_64 localRng(seeds[idx]);
-            std::vector<int> permutedIndex = baseIndex;
-            std::shuffle(permutedIndex.begin(), permutedIndex.end(), localRng);
-
-            Eigen::MatrixXd permuted(data.rows(), data.cols());
-            for (int row = 0; row < permuted.rows(); ++row) {
-                permuted.row(row) = data.row(permutedIndex[row]);
-            }
+        for (; firstCpuPermutation < permutations; ++firstCpuPermutation) {
+            std::mt19937_64 localRng(seeds[firstCpuPermutation]);
+            const Eigen::MatrixXd& permuted = buildPermutation(scratch[0], localRng);
 
+            HmmFitResult fit;
             try {
-                HmmFitResult fit = FitHmmGpu(permuted, modelConfig, localRng, std::function<void(int, double)>());
-                result.permutationLogLikelihoods[idx] = fit.logLikelihood;
+                fit = FitHmmGpu(permuted, modelConfig, localRng, std::function<void(int, double)>());
             } catch (const std::exception&) {
-                gpuHealthy = false;
+                // fall through to CPU path for remaining permutations
                 break;
             }
-
-            completed.fetch_add(1);
-            updateProgress(completed.load());
-        }
-
-        if (!gpuHealthy) {
-            canUseGpu = false;
-            // fall through to CPU path for remaining permutations
-            for (int cpuIdx = idx; cpuIdx < permutations; ++cpuIdx) {
-                std::mt19937_64 localRng(seeds[cpuIdx]);
-                std::vector<int> permutedIndex = baseIndex;
-                std::shuffle(permutedIndex.begin(), permutedIndex.end(), localRng);
-
-                Eigen::MatrixXd permuted(data.rows(), data.cols());
-                for (int row = 0; row < permuted.rows(); ++row) {
-                    permuted.row(row) = data.row(permutedIndex[row]);
-                }
-
-                HmmModel localModel(modelConfig);
-                HmmFitResult fit = localModel.fit(permuted, localRng);
-                result.permutationLogLikelihoods[cpuIdx] = fit.logLikelihood;
-                completed.fetch_add(1);
-                updateProgress(completed.load());
-            }
+            recordCompletion(firstCpuPermutation, fit.logLikelihood);
         }
     }
 
-    if (completed.load() < permutations) {
-        std::vector<std::future<std::pair<int, double>>> tasks;
-        tasks.reserve(permutations);
-
-        for (int idx = 0; idx < permutations; ++idx) {
-            if (static_cast<int>(tasks.size()) >= concurrency) {
-                auto finished = tasks.front().get();
-                result.permutationLogLikelihoods[finished.first] = finished.second;
-                tasks.erase(tasks.begin());
-                completed.fetch_add(1);
-                updateProgress(completed.load());
-            }
+    pool.parallelFor(permutations - firstCpuPermutation, [&](int task, int worker) {
+        const int idx = firstCpuPermutation + task;
+        std::mt19937_64 localRng(seeds[idx]);
+        const Eigen::MatrixXd& permuted = buildPermutation(scratch[worker], localRng);
 
-            tasks.emplace_back(std::async(std::launch::async, [&, idx]() -> std::pair<int, double> {
-                std::mt19937_64 localRng(seeds[idx]);
-                std::vector<int> permutedIndex = baseIndex;
-                std::shuffle(permutedIndex.begin(), permutedIndex.end(), localRng);
+        HmmModel localModel(modelConfig);
+        HmmFitResult fit = localModel.fit(permuted, localRng);
+        recordCompletion(idx, fit.logLikelihood);
+    });
 
-                Eigen::MatrixXd permuted(data.rows(), data.cols());
-                for (int row = 0; row < permuted.rows(); ++row) {
-                    permuted.row(row) = data.row(permutedIndex[row]);
-                }
+    result.permutationsCompleted = permutations;
+    computePermutationStatistics(result, totalRuns);
 
-                HmmModel localModel(modelConfig);
-                HmmFitResult fit = localModel.fit(permuted, localRng);
-                return std::make_pair(idx, fit.logLikelihood);
-            }));
-        }
+    if (progressCallback) {
+        progressCallback(1.0);
+    }
 
-        for (auto& task : tasks) {
-            auto finished = task.get();
-            result.permutationLogLikelihoods[finished.first] = finished.second;
-            completed.fetch_add(1);
-            updateProgress(completed.load());
-        }
+    return result;
+}
+
+void HmmMemoryAnalyzer::computePermutationStatistics(HmmMemoryResult& result, int totalRuns) {
+    const auto& permuted = result.permutationLogLikelihoods;
+    const int permutations = static_cast<int>(permuted.size());
+    if (permutations == 0) {
+        result.pValue = 1.0;
+        result.meanPermutationLogLikelihood = 0.0;
+        result.stdPermutationLogLikelihood = 0.0;
+        return;
     }
 
     int greaterOrEqual = 1; // original run
-    for (double loglike : result.permutationLogLikelihoods) {
+    for (double loglike : permuted) {
         if (loglike >= result.originalLogLikelihood) {
             ++greaterOrEqual;
         }
     }
     result.pValue = static_cast<double>(greaterOrEqual) / static_cast<double>(totalRuns);
 
-    double sum = std::accumulate(result.permutationLogLikelihoods.begin(),
-                                 result.permutationLogLikelihoods.end(), 0.0);
+    double sum = std::accumulate(permuted.begin(), permuted.end(), 0.0);
     result.meanPermutationLogLikelihood = sum / static_cast<double>(permutations);
 
     double sqSum = 0.0;
-    for (double loglike : result.permutationLogLikelihoods) {
+    for (double loglike : permuted) {
         double diff = loglike - result.meanPermutationLogLikelihood;
         sqSum += diff * diff;
     }
     result.stdPermutationLogLikelihood = std::sqrt(sqSum / std::max(1, permutations - 1));
-
-    if (progressCallback) {
-        progressCallback(1.0);
-    }
-
-    return result;
 }
 
 } // namespace hmm
@@ -27,19 +27,37 @@ struct HmmMemoryResult {
     double pValue = 1.0;
     double meanPermutationLogLikelihood = 0.0;
     double stdPermutationLogLikelihood = 0.0;
+    int permutationsCompleted = 0;                   // Equals mcptReplications - 1 once finished
     HmmFitResult originalFit;
 };
 
+// Published once after the original fit (originalFit set, permutationsCompleted == 0)
+// and then once per finished permutation, carrying only that permutation's
+// log-likelihood. Statistics cover the permutations completed so far.
+struct HmmMemoryPartialResult {
+    const HmmFitResult* originalFit = nullptr;       // Without the state posterior; first event only
+    int permutationsCompleted = 0;
+    double permutationLogLikelihood = 0.0;           // The permutation that just finished
+    double pValue = 1.0;
+    double meanPermutationLogLikelihood = 0.0;
+    double stdPermutationLogLikelihood = 0.0;
+};
+
+using HmmMemoryPartialCallback = std::function<void(const HmmMemoryPartialResult&)>;
+
 class HmmMemoryAnalyzer {
 public:
     explicit HmmMemoryAnalyzer(HmmMemoryConfig config);
 
     HmmMemoryResult analyze(const Eigen::MatrixXd& observations,
                             std::mt19937_64& rng,
-                            std::function<void(double)> progressCallback = {});
+                            std::function<void(double)> progressCallback = {},
+                            HmmMemoryPartialCallback partialCallback = {});
 
 private:
     HmmMemoryConfig m_config;
+
+    static void computePermutationStatistics(HmmMemoryResult& result, int totalRuns);
 };
 
 } // namespace hmm
@@ -1,8 +1,6 @@
 #include "HmmTargetCorrelation.h"
 
 #include <algorithm>
-#include <atomic>
-#include <future>
 #include <functional>
 #include <mutex>
 #include <numeric>
@@ -13,6 +11,7 @@
 #include <Eigen/QR>
 
 #include "HmmGpu.h"
+#include "HmmWorkPool.h"
 
 namespace hmm {
 
@@ -33,7 +32,8 @@ TargetCorrelationResult TargetCorrelationAnalyzer::analyze(const Eigen::MatrixXd
                                                            const std::vector<std::string>& featureNames,
                                                            const Eigen::VectorXd& target,
                                                            std::mt19937_64& rng,
-                                                           std::function<void(double)> progressCallback) {
+                                                           std::function<void(double)> progressCallback,
+                                                           TargetCorrelationPartialCallback partialCallback) {
     if (candidateFeatures.rows() != target.size()) {
         throw std::invalid_argument("Feature matrix row count must match target length");
     }
@@ -63,58 +63,48 @@ TargetCorrelationResult TargetCorrelationAnalyzer::analyze(const Eigen::MatrixXd
     }
 
     TargetCorrelationResult result;
-    result.combinations.reserve(combinations.size());
-
     const int totalCombos = static_cast<int>(combinations.size());
-    const int concurrency = std::max(1, std::min(m_config.maxThreads, totalCombos));
-    std::mutex resultMutex;
-    std::atomic<int> completed{0};
+    result.combinations.resize(totalCombos);
 
     std::vector<uint64_t> seeds(totalCombos);
     for (int i = 0; i < totalCombos; ++i) {
         seeds[i] = rng();
     }
 
-    auto updateProgress = [&](int localCompleted) {
+    const int mcptReps = std::max(0, m_config.mcptReplications);
+    const int totalUnits = totalCombos + mcptReps;
+    std::mutex progressMutex;
+    int completed = 0;
+    auto updateProgress = [&](int units) {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        completed += units;
         if (progressCallback) {
-            double fraction = static_cast<double>(localCompleted) / static_cast<double>(totalCombos);
-            progressCallback(fraction);
+            double fraction = static_cast<double>(completed) / static_cast<double>(totalUnits);
+            progressCallback(std::min(1.0, fraction));
         }
     };
 
-    std::vector<std::future<void>> tasks;
-    tasks.reserve(totalCombos);
-
-    for (int idx = 0; idx < totalCombos; ++idx) {
-        const auto& combo = combinations[idx];
-        if (static_cast<int>(tasks.size()) >= concurrency) {
-            tasks.front().wait();
-            tasks.erase(tasks.begin());
-        }
+    HmmWorkPool pool(m_config.maxThreads);
 
-        tasks.emplace_back(std::async(std::launch::async, [&, idx, combo]() {
-            std::mt19937_64 localRng(seeds[idx]);
+    // Per-worker gather buffer: every combination has the same shape, so each worker
+    // pulls its column subset through an indexed view into storage sized once.
+    std::vector<Eigen::MatrixXd> subsetScratch(pool.workerCount());
 
-            Eigen::MatrixXd subset(processed.rows(), combo.size());
-            for (std::size_t c = 0; c < combo.size(); ++c) {
-                subset.col(static_cast<int>(c)) = processed.col(combo[c]);
-            }
+    pool.parallelFor(totalCombos, [&](int idx, int worker) {
+        const auto& combo = combinations[idx];
+        std::mt19937_64 localRng(seeds[idx]);
 
-            TargetCorrelationComboResult comboResult =
-                evaluateCombination(subset, combo, featureNames, target, localRng);
+        Eigen::MatrixXd& subset = subsetScratch[worker];
+        subset = processed(Eigen::all, combo);
 
-            {
-                std::lock_guard<std::mutex> lock(resultMutex);
-                result.combinations.push_back(std::move(comboResult));
-                completed.fetch_add(1);
-                updateProgress(completed.load());
-            }
-        }));
-    }
+        result.combinations[idx] = evaluateCombination(subset, combo, featureNames, target, localRng);
 
-    for (auto& task : tasks) {
-        task.wait();
-    }
+        if (partialCallback) {
+            std::lock_guard<std::mutex> lock(progressMutex);
+            partialCallback(result.combinations[idx]);
+        }
+        updateProgress(1);
+    });
 
     std::sort(result.combinations.begin(), result.combinations.end(),
               [](const TargetCorrelationComboResult& lhs, const TargetCorrelationComboResult& rhs) {
@@ -123,44 +113,73 @@ TargetCorrelationResult TargetCorrelationAnalyzer::analyze(const Eigen::MatrixXd
 
     result.mcptReplicationsEvaluated = 1;
 
-    if (m_config.mcptReplications > 0) {
-        Eigen::VectorXd permuted = target;
-        std::vector<int> indices(target.size());
-        std::iota(indices.begin(), indices.end(), 0);
+    if (mcptReps > 0) {
+        std::vector<uint64_t> repSeeds(mcptReps);
+        for (int rep = 0; rep < mcptReps; ++rep) {
+            repSeeds[rep] = rng();
+        }
 
-        for (int rep = 0; rep < m_config.mcptReplications; ++rep) {
-            std::shuffle(indices.begin(), indices.end(), rng);
-            for (int i = 0; i < target.size(); ++i) {
-                permuted[i] = target[indices[i]];
+        struct McptScratch {
+            std::vector<int> index;
+            Eigen::VectorXd permuted;
+            std::vector<int> soloCounts;
+            std::vector<int> bestOfCounts;
+        };
+        std::vector<McptScratch> mcptScratch(pool.workerCount());
+
+        pool.parallelFor(mcptReps, [&](int rep, int worker) {
+            McptScratch& local = mcptScratch[worker];
+            if (local.index.empty()) {
+                local.index.resize(target.size());
+                local.permuted.resize(target.size());
+                local.soloCounts.assign(totalCombos, 0);
+                local.bestOfCounts.assign(totalCombos, 0);
             }
 
+            std::mt19937_64 localRng(repSeeds[rep]);
+            std::iota(local.index.begin(), local.index.end(), 0);
+            std::shuffle(local.index.begin(), local.index.end(), localRng);
+            local.permuted = target(local.index);
+
             double bestCritThisRep = 0.0;
-            for (auto& comboResult : result.combinations) {
+            for (int c = 0; c < totalCombos; ++c) {
+                const auto& comboResult = result.combinations[c];
                 double r2 = computeRSquared(comboResult.designMatrix,
                                             comboResult.designMatrixTranspose,
                                             comboResult.xtxInverse,
-                                            permuted);
+                                            local.permuted);
                 if (r2 >= comboResult.rSquared - 1e-12) {
-                    comboResult.mcptSoloCount += 1;
+                    local.soloCounts[c] += 1;
                 }
                 if (r2 > bestCritThisRep) {
                     bestCritThisRep = r2;
                 }
             }
 
-            for (auto& comboResult : result.combinations) {
-                if (bestCritThisRep >= comboResult.rSquared - 1e-12) {
-                    comboResult.mcptBestOfCount += 1;
+            for (int c = 0; c < totalCombos; ++c) {
+                if (bestCritThisRep >= result.combinations[c].rSquared - 1e-12) {
+                    local.bestOfCounts[c] += 1;
                 }
             }
+            updateProgress(1);
+        });
+
+        for (const auto& local : mcptScratch) {
+            if (local.soloCounts.empty()) {
+                continue;
+            }
+            for (int c = 0; c < totalCombos; ++c) {
+                result.combinations[c].mcptSoloCount += local.soloCounts[c];
+                result.combinations[c].mcptBestOfCount += local.bestOfCounts[c];
+            }
         }
 
-        const double denom = static_cast<double>(m_config.mcptReplications + 1);
+        const double denom = static_cast<double>(mcptReps + 1);
         for (auto& comboResult : result.combinations) {
             comboResult.mcptSoloPValue = static_cast<double>(comboResult.mcptSoloCount) / denom;
             comboResult.mcptBestOfPValue = static_cast<double>(comboResult.mcptBestOfCount) / denom;
         }
-        result.mcptReplicationsEvaluated = m_config.mcptReplications + 1;
+        result.mcptReplicationsEvaluated = mcptReps + 1;
     } else {
         for (auto& comboResult : result.combinations) {
             comboResult.mcptSoloPValue = 1.0;
@@ -43,6 +43,9 @@ struct TargetCorrelationResult {
     int mcptReplicationsEvaluated = 1;
 };
 
+// Invoked once per fitted combination, in completion order, before MCPT p-values exist.
+using TargetCorrelationPartialCallback = std::function<void(const TargetCorrelationComboResult&)>;
+
 class TargetCorrelationAnalyzer {
 public:
     explicit TargetCorrelationAnalyzer(TargetCorrelationConfig config);
@@ -51,7 +54,8 @@ public:
                                     const std::vector<std::string>& featureNames,
                                     const Eigen::VectorXd& target,
                                     std::mt19937_64& rng,
-                                    std::function<void(double)> progressCallback = {});
+                                    std::function<void(double)> progressCallback = {},
+                                    TargetCorrelationPartialCallback partialCallback = {});
 
 private:
     TargetCorrelationConfig m_config;
@@ -0,0 +1,146 @@
+#include "HmmWorkPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hmm {
+
+namespace {
+
+struct alignas(64) WorkRange {
+    std::atomic<int> next{0};
+    int end = 0;
+};
+
+// Helper threads shared by every pool in the process; the calling thread of
+// parallelFor() always works and is not counted
+class ThreadBudget {
+public:
+    ThreadBudget()
+        : m_available(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1) {
+    }
+
+    int acquire(int wanted) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const int granted = std::max(0, std::min(wanted, m_available));
+        m_available -= granted;
+        return granted;
+    }
+
+    void release(int count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_available += count;
+    }
+
+private:
+    std::mutex m_mutex;
+    int m_available;
+};
+
+ThreadBudget& sharedBudget() {
+    static ThreadBudget budget;
+    return budget;
+}
+
+struct BudgetLease {
+    explicit BudgetLease(int wanted) : count(sharedBudget().acquire(wanted)) {}
+    ~BudgetLease() { sharedBudget().release(count); }
+    BudgetLease(const BudgetLease&) = delete;
+    BudgetLease& operator=(const BudgetLease&) = delete;
+
+    const int count;
+};
+
+} // namespace
+
+HmmWorkPool::HmmWorkPool(int maxThreads)
+    : m_workerCount(maxThreads),
+      m_explicitLimit(maxThreads > 0) {
+    if (m_workerCount <= 0) {
+        m_workerCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+}
+
+void HmmWorkPool::parallelFor(int taskCount, const Task& task) const {
+    if (taskCount <= 0) {
+        return;
+    }
+
+    const int wanted = std::max(1, std::min(m_workerCount, taskCount));
+    const BudgetLease helpers(wanted - 1);
+    const int workers = helpers.count + 1;
+    if (m_explicitLimit && workers < wanted) {
+        std::cerr << "HmmWorkPool: running " << workers << " of " << wanted
+                  << " requested workers; the shared helper-thread budget is in use or smaller than maxThreads\n";
+    }
+    if (workers == 1) {
+        for (int idx = 0; idx < taskCount; ++idx) {
+            task(idx, 0);
+        }
+        return;
+    }
+
+    std::unique_ptr<WorkRange[]> ranges(new WorkRange[workers]);
+    const int baseChunk = taskCount / workers;
+    const int remainder = taskCount % workers;
+    int begin = 0;
+    for (int w = 0; w < workers; ++w) {
+        const int length = baseChunk + (w < remainder ? 1 : 0);
+        ranges[w].next.store(begin, std::memory_order_relaxed);
+        ranges[w].end = begin + length;
+        begin += length;
+    }
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto claim = [&](int owner) -> int {
+        WorkRange& range = ranges[owner];
+        if (range.next.load(std::memory_order_relaxed) >= range.end) {
+            return -1;
+        }
+        int idx = range.next.fetch_add(1, std::memory_order_relaxed);
+        return idx < range.end ? idx : -1;
+    };
+
+    auto workerLoop = [&](int workerIndex) {
+        for (int offset = 0; offset < workers && !failed.load(std::memory_order_relaxed); ++offset) {
+            const int victim = (workerIndex + offset) % workers;
+            int idx;
+            while (!failed.load(std::memory_order_relaxed) && (idx = claim(victim)) >= 0) {
+                try {
+                    task(idx, workerIndex);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!firstError) {
+                        firstError = std::current_exception();
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (int w = 1; w < workers; ++w) {
+        threads.emplace_back(workerLoop, w);
+    }
+    workerLoop(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+} // namespace hmm
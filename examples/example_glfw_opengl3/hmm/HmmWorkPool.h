@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+
+namespace hmm {
+
+// Bounded work-stealing executor shared by the HMM analyzers.
+//
+// Tasks [0, taskCount) are split into one contiguous range per worker. A worker
+// drains its own range first and then steals single tasks from the other ranges,
+// so at most `maxThreads` threads run per call regardless of how many
+// permutations or combinations are queued. The worker index passed to the task
+// body is stable for the lifetime of the call, which lets callers keep
+// per-worker scratch buffers.
+//
+// Helper threads are drawn from one process-wide budget of
+// hardware_concurrency() - 1, so analyzers running at the same time share the
+// machine instead of each starting maxThreads threads. A call that finds the
+// budget taken runs with fewer helpers, down to the calling thread alone. When
+// that cuts below an explicit maxThreads, the clamp is reported on stderr.
+class HmmWorkPool {
+public:
+    using Task = std::function<void(int taskIndex, int workerIndex)>;
+
+    explicit HmmWorkPool(int maxThreads);
+
+    int workerCount() const { return m_workerCount; }
+
+    // Blocks until every task has run. The first exception thrown by a task is
+    // rethrown on the calling thread after all workers have stopped.
+    void parallelFor(int taskCount, const Task& task) const;
+
+private:
+    int m_workerCount;
+    bool m_explicitLimit;
+};
+
+} // namespace hmm
@@ -27,6 +27,7 @@
 #include "Stage1ServerWindow.h"
 #include "Stage1DatasetManager.h"
 #include "IndicatorBuilderWindow.h"
+#include "stage1_metadata_writer.h"
 #include <stdio.h>
 #include "utils.h"
 #include <string>
@@ -712,6 +713,7 @@ int main(int, char**)
 #endif
 
     // Cleanup
+    Stage1MetadataWriter::Instance().Shutdown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -195,6 +195,17 @@ double compute_mi(
         ++bin_counts[k * nbins_target + target_bin[i]];
     }
     
+    return mi_from_counts(ncases, nbins_pred_squared, nbins_target, target_marginal, bin_counts);
+}
+
+// Mutual information of an already-filled contingency table
+double mi_from_counts(
+    int ncases,
+    int nbins_pred_squared,
+    int nbins_target,
+    const double* target_marginal,
+    const int* bin_counts
+) {
     // Compute mutual information
     double MI = 0.0;
     for (int i = 0; i < nbins_pred_squared; i++) {
@@ -247,6 +258,21 @@ void uncert_reduc(
         ++bin_counts[k * nbins_target + target_bin[i]];
     }
     
+    uncert_reduc_from_counts(nbins_pred_squared, nbins_target, target_marginal,
+                             bin_counts, row_dep, col_dep, sym, rmarg);
+}
+
+// Uncertainty reduction of an already-filled contingency table
+void uncert_reduc_from_counts(
+    int nbins_pred_squared,
+    int nbins_target,
+    const double* target_marginal,
+    const int* bin_counts,
+    double* row_dep,
+    double* col_dep,
+    double* sym,
+    int* rmarg
+) {
     int total = 0;
     for (int irow = 0; irow < nbins_pred_squared; irow++) {
         rmarg[irow] = 0;
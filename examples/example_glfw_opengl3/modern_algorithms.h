@@ -53,4 +53,26 @@ void uncert_reduc(
     int* bin_counts
 );
 
+// Criterion evaluation on a contingency table that is already filled.
+// bin_counts is laid out [joint predictor bin][target bin] exactly as
+// compute_mi / uncert_reduc build it, so results are bit-identical.
+double mi_from_counts(
+    int ncases,
+    int nbins_pred_squared,
+    int nbins_target,
+    const double* target_marginal,
+    const int* bin_counts
+);
+
+void uncert_reduc_from_counts(
+    int nbins_pred_squared,
+    int nbins_target,
+    const double* target_marginal,
+    const int* bin_counts,
+    double* row_dep,
+    double* col_dep,
+    double* sym,
+    int* rmarg
+);
+
 } // namespace ModernAlgorithms
\ No newline at end of file
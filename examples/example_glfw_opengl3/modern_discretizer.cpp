@@ -1,5 +1,11 @@
 #include "modern_discretizer.h"
 #include "modern_algorithms.h"
+#include "analytics_dataframe.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <stdexcept>
+#include <utility>
 
 template<typename T>
 AlignedVector<short int> discretize_exact(
@@ -53,6 +59,280 @@ AlignedVector<short int> discretize_with_bounds(
     return bins;
 }
 
+SortedColumn build_sorted_column(const double* data, int n_cases) {
+    SortedColumn column;
+    if (n_cases <= 0) return column;
+    
+    // Sort (value, row) pairs together for locality; NaN sorts last
+    std::vector<std::pair<double, int>> keyed(n_cases);
+    for (int i = 0; i < n_cases; ++i) {
+        keyed[i] = { data[i], i };
+    }
+    std::sort(keyed.begin(), keyed.end(),
+        [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+            if (std::isnan(b.first)) return !std::isnan(a.first);
+            return a.first < b.first;
+        });
+    
+    column.sorted.resize(n_cases);
+    column.order.resize(n_cases);
+    column.run_id.resize(n_cases);
+    for (int i = 0; i < n_cases; ++i) {
+        column.sorted[i] = keyed[i].first;
+        column.order[i] = keyed[i].second;
+    }
+    
+    // Tie runs, using the same relative tolerance as the partition algorithm
+    const std::vector<double>& x = column.sorted;
+    int k = 0;
+    column.run_id[0] = 0;
+    for (int i = 1; i < n_cases; ++i) {
+        if (x[i] - x[i-1] >= 1.e-12 * (1.0 + std::fabs(x[i]) + std::fabs(x[i-1]))) {
+            column.run_end.push_back(i - 1);
+            ++k;
+        }
+        column.run_id[i] = k;
+    }
+    column.run_end.push_back(n_cases - 1);
+    
+    return column;
+}
+
+// Mirrors ModernAlgorithms::partition step for step. The only difference is
+// that the split search visits run ends instead of every sorted position,
+// which skips exactly the positions the original loop rejects as ties.
+void partition_sorted(
+    const SortedColumn& column,
+    int& npart,
+    std::vector<double>* bounds,
+    AlignedVector<short int>& bins
+) {
+    const int n = static_cast<int>(column.sorted.size());
+    if (npart > n)  // Defend against invalid input
+        npart = n;
+    if (n == 0) {
+        bins.clear();
+        if (bounds != nullptr) bounds->clear();
+        return;
+    }
+    
+    int np = npart;
+    const std::vector<int>& ix = column.run_id;
+    const std::vector<int>& run_end = column.run_end;
+    std::vector<int> bin_end(np + 1);
+    
+    // Initial bounds based on equal number of cases per bin
+    int k = 0;
+    for (int i = 0; i < np; i++) {
+        int j = (n - k) / (np - i);
+        k += j;
+        bin_end[i] = k - 1;
+    }
+    
+    // Iterate until no partition boundary splits a tie
+    bool tie_found;
+    do {
+        tie_found = false;
+        
+        for (int ibound = 0; ibound < np - 1; ibound++) {
+            if (ix[bin_end[ibound]] == ix[bin_end[ibound] + 1]) {  // Splits a tie?
+                for (int i = ibound + 1; i < np; i++)
+                    bin_end[i - 1] = bin_end[i];
+                --np;
+                tie_found = true;
+                break;
+            }
+        }
+        
+        if (!tie_found)
+            break;
+        
+        // Try splitting each remaining bin at a run end
+        int istart = 0;
+        int nbest = -1;
+        int ibound_best = -1;
+        int isplit_best = -1;
+        
+        for (int ibound = 0; ibound < np; ibound++) {
+            int istop = bin_end[ibound];
+            auto it = std::lower_bound(run_end.begin(), run_end.end(), istart);
+            for (; it != run_end.end() && *it < istop; ++it) {
+                int i = *it;
+                int nleft = i - istart + 1;
+                int nright = istop - i;
+                int nsmall = (nleft < nright) ? nleft : nright;
+                if (nsmall > nbest) {
+                    nbest = nsmall;
+                    ibound_best = ibound;
+                    isplit_best = i;
+                }
+            }
+            istart = istop + 1;
+        }
+        
+        if (nbest > 0) {
+            for (int ibound = np - 1; ibound >= ibound_best; ibound--)
+                bin_end[ibound + 1] = bin_end[ibound];
+            bin_end[ibound_best] = isplit_best;
+            ++np;
+        }
+        
+    } while (tie_found);
+    
+    npart = np;
+    
+    if (bounds != nullptr) {
+        bounds->resize(np);
+        for (int i = 0; i < np; i++) {
+            (*bounds)[i] = column.sorted[bin_end[i]];
+        }
+    }
+    
+    bins.resize(n);
+    int istart = 0;
+    for (int ibound = 0; ibound < np; ibound++) {
+        int istop = bin_end[ibound];
+        for (int i = istart; i <= istop; i++)
+            bins[column.order[i]] = static_cast<short int>(ibound);
+        istart = istop + 1;
+    }
+}
+
+namespace {
+
+std::shared_ptr<const SortedColumn> sort_dataframe_column(
+    const chronosflow::AnalyticsDataFrame& df,
+    const std::string& column_name
+) {
+    auto view_res = df.get_column_view<double>(column_name);
+    if (!view_res.ok()) throw std::runtime_error("Failed to get view for column: " + column_name);
+    auto view = std::move(view_res).ValueOrDie();
+    return std::make_shared<const SortedColumn>(
+        build_sorted_column(view.data(), static_cast<int>(view.size())));
+}
+
+size_t sorted_column_bytes(const SortedColumn& column) {
+    return column.sorted.capacity() * sizeof(double) +
+           (column.order.capacity() + column.run_id.capacity() + column.run_end.capacity()) * sizeof(int);
+}
+
+} // namespace
+
+DiscretizationCache& DiscretizationCache::instance() {
+    static DiscretizationCache cache;
+    return cache;
+}
+
+bool DiscretizationCache::sync_table_locked(const chronosflow::AnalyticsDataFrame& df) {
+    std::shared_ptr<arrow::Table> table = df.get_cpu_table();
+    std::shared_ptr<arrow::Table> cached = table_.lock();
+    if (!cached || cached != table) {
+        columns_.clear();
+        bytes_ = 0;
+        table_ = table;
+    }
+    return table != nullptr;
+}
+
+void DiscretizationCache::insert_locked(const std::string& name, std::shared_ptr<const SortedColumn> column) {
+    Entry& entry = columns_[name];
+    bytes_ -= entry.bytes;
+    entry.bytes = sorted_column_bytes(*column);
+    entry.column = std::move(column);
+    entry.last_used = ++clock_;
+    bytes_ += entry.bytes;
+}
+
+// Columns already handed out stay alive through their shared_ptr
+void DiscretizationCache::evict_locked() {
+    while (bytes_ > kMaxCachedBytes && columns_.size() > 1) {
+        auto victim = columns_.begin();
+        for (auto it = columns_.begin(); it != columns_.end(); ++it) {
+            if (it->second.last_used < victim->second.last_used) {
+                victim = it;
+            }
+        }
+        bytes_ -= victim->second.bytes;
+        columns_.erase(victim);
+    }
+}
+
+void DiscretizationCache::prepare(
+    const chronosflow::AnalyticsDataFrame& df,
+    const std::vector<std::string>& column_names
+) {
+    std::vector<std::string> missing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!sync_table_locked(df)) return;  // Nothing stable to key the cache on
+        for (const auto& name : column_names) {
+            if (columns_.find(name) == columns_.end() &&
+                std::find(missing.begin(), missing.end(), name) == missing.end()) {
+                missing.push_back(name);
+            }
+        }
+    }
+    
+    // One sort per column, columns in parallel, without blocking discretize()
+    std::vector<std::shared_ptr<const SortedColumn>> sorted(missing.size());
+    std::vector<size_t> indices(missing.size());
+    for (size_t i = 0; i < indices.size(); ++i) indices[i] = i;
+    std::for_each(std::execution::par, indices.begin(), indices.end(),
+        [&](size_t i) {
+            sorted[i] = sort_dataframe_column(df, missing[i]);
+        });
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!sync_table_locked(df)) return;
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (columns_.find(missing[i]) == columns_.end()) {
+            insert_locked(missing[i], std::move(sorted[i]));
+        }
+    }
+    evict_locked();
+}
+
+AlignedVector<short int> DiscretizationCache::discretize(
+    const chronosflow::AnalyticsDataFrame& df,
+    const std::string& column_name,
+    int num_bins,
+    std::vector<double>* bounds
+) {
+    std::shared_ptr<const SortedColumn> column;
+    bool keyed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        keyed = sync_table_locked(df);
+        auto it = keyed ? columns_.find(column_name) : columns_.end();
+        if (it != columns_.end()) {
+            it->second.last_used = ++clock_;
+            column = it->second.column;
+        }
+    }
+    if (!column) {
+        column = sort_dataframe_column(df, column_name);
+        if (keyed) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sync_table_locked(df) && columns_.find(column_name) == columns_.end()) {
+                insert_locked(column_name, column);
+                evict_locked();
+            }
+        }
+    }
+    
+    AlignedVector<short int> bins;
+    int npart = num_bins;
+    partition_sorted(*column, npart, bounds, bins);
+    return bins;
+}
+
+void DiscretizationCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    columns_.clear();
+    bytes_ = 0;
+    table_.reset();
+}
+
 // Explicit template instantiations
 template AlignedVector<short int> discretize_exact<double>(
     const chronosflow::ColumnView<double>&, int);
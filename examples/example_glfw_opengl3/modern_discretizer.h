@@ -1,7 +1,16 @@
 #pragma once
 #include "column_view.h"
 #include "aligned_allocator.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace arrow { class Table; }
+namespace chronosflow { class AnalyticsDataFrame; }
 
 // Modern C++ discretizer using the exact partition algorithm
 template<typename T>
@@ -16,4 +25,73 @@ AlignedVector<short int> discretize_with_bounds(
     const chronosflow::ColumnView<T>& column,
     int num_bins,
     std::vector<double>& bounds
-);
\ No newline at end of file
+);
+
+// Sorted order and tie structure of one column. Everything the partition
+// algorithm needs that does not depend on the bin count.
+struct SortedColumn {
+    std::vector<double> sorted;   // Values in ascending order
+    std::vector<int> order;       // Original row of each sorted value
+    std::vector<int> run_id;      // Tie-run index of each sorted position (legacy ix)
+    std::vector<int> run_end;     // Last sorted position of each tie run
+};
+
+// Sorts once and records tie runs with the same tolerance as the partition algorithm
+SortedColumn build_sorted_column(const double* data, int n_cases);
+
+// Same result as ModernAlgorithms::partition, but in O(n) from a sorted column
+void partition_sorted(
+    const SortedColumn& column,
+    int& npart,                              // In/Out: number of partitions
+    std::vector<double>* bounds,            // Output: upper bounds (can be nullptr)
+    AlignedVector<short int>& bins          // Output: bin assignments
+);
+
+// Process-wide cache of sorted columns for the current dataframe.
+//
+// Columns are sorted on first use (in parallel across columns, outside the
+// lock) so changing the bin count only costs one O(n) pass per column.
+// Entries are dropped as soon as the cached table has expired or a different
+// one is seen, and the least recently used columns are evicted once the cache
+// holds more than kMaxCachedBytes (a sorted column takes about 20 bytes per row).
+class DiscretizationCache {
+public:
+    static constexpr size_t kMaxCachedBytes = size_t(1) << 30;
+
+    static DiscretizationCache& instance();
+
+    // Sorts every listed column that is not cached yet
+    void prepare(const chronosflow::AnalyticsDataFrame& df,
+                 const std::vector<std::string>& column_names);
+
+    // Throws std::runtime_error if the column cannot be read as double
+    AlignedVector<short int> discretize(const chronosflow::AnalyticsDataFrame& df,
+                                        const std::string& column_name,
+                                        int num_bins,
+                                        std::vector<double>* bounds = nullptr);
+
+    void clear();
+
+private:
+    struct Entry {
+        std::shared_ptr<const SortedColumn> column;
+        size_t bytes = 0;
+        uint64_t last_used = 0;
+    };
+
+    DiscretizationCache() = default;
+
+    // Drops all entries if the cached table expired or df refers to another
+    // one. Returns false when df has no table to key on. Caller holds mutex_.
+    bool sync_table_locked(const chronosflow::AnalyticsDataFrame& df);
+
+    // Caller holds mutex_
+    void insert_locked(const std::string& name, std::shared_ptr<const SortedColumn> column);
+    void evict_locked();
+
+    std::mutex mutex_;
+    std::weak_ptr<arrow::Table> table_;
+    std::unordered_map<std::string, Entry> columns_;
+    size_t bytes_ = 0;
+    uint64_t clock_ = 0;
+};
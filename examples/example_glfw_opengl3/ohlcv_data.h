@@ -102,10 +102,13 @@ public:
     }
 
     bool isDataProcessed() const { return data_is_processed_; }
+    // Changes whenever the processed vectors are rebuilt, so derived caches know to follow
+    unsigned long long getRevision() const { return revision_; }
     bool isRawDataEmpty() const { return raw_ohlcv_data_.empty(); }
 
 private:
     void clearProcessedDataVectors() {
+        ++revision_;
         times_vec_.clear();
         opens_vec_.clear();
         highs_vec_.clear();
@@ -128,4 +131,5 @@ private:
 
     bool data_is_processed_;
     bool last_processed_hide_empty_candles_state_; // Stores the 'hide_empty_candles' state used for the last processing
+    unsigned long long revision_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "parquet_batch_stream.h"
+
+#include <arrow/compute/api.h>
+#include <arrow/io/file.h>
+#include <arrow/scalar.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace chronosflow {
+
+namespace {
+
+// [min, max] of a column chunk as int64, when its statistics record them
+std::optional<std::pair<int64_t, int64_t>> chunk_range(const parquet::ColumnChunkMetaData& chunk) {
+    auto stats = chunk.statistics();
+    if (!stats || !stats->HasMinMax()) {
+        return std::nullopt;
+    }
+    switch (stats->physical_type()) {
+        case parquet::Type::INT32: {
+            auto typed = std::static_pointer_cast<parquet::Int32Statistics>(stats);
+            return std::make_pair(static_cast<int64_t>(typed->min()), static_cast<int64_t>(typed->max()));
+        }
+        case parquet::Type::INT64: {
+            auto typed = std::static_pointer_cast<parquet::Int64Statistics>(stats);
+            return std::make_pair(typed->min(), typed->max());
+        }
+        case parquet::Type::DOUBLE: {
+            auto typed = std::static_pointer_cast<parquet::DoubleStatistics>(stats);
+            if (std::isnan(typed->min()) || std::isnan(typed->max())) {
+                return std::nullopt;
+            }
+            return std::make_pair(static_cast<int64_t>(std::floor(typed->min())),
+                                  static_cast<int64_t>(std::ceil(typed->max())));
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+} // namespace
+
+arrow::Result<std::unique_ptr<ParquetBatchStream>> ParquetBatchStream::open(
+    const std::string& file_path,
+    const ParquetScanOptions& options) {
+
+    std::unique_ptr<ParquetBatchStream> stream(new ParquetBatchStream());
+    stream->options_ = options;
+
+    ARROW_ASSIGN_OR_RAISE(auto input_file, arrow::io::ReadableFile::Open(file_path));
+    ARROW_ASSIGN_OR_RAISE(stream->reader_, parquet::arrow::OpenFile(input_file, arrow::default_memory_pool()));
+    stream->reader_->set_batch_size(options.batch_size);
+    stream->reader_->set_use_threads(options.use_threads);
+
+    std::shared_ptr<arrow::Schema> file_schema;
+    ARROW_RETURN_NOT_OK(stream->reader_->GetSchema(&file_schema));
+
+    // Projection (file order when no columns are named)
+    std::vector<std::string> output_columns = options.columns;
+    if (output_columns.empty()) {
+        for (const auto& field : file_schema->fields()) {
+            output_columns.push_back(field->name());
+        }
+    }
+    std::vector<std::string> read_columns = output_columns;
+    const bool has_range = !options.timestamp_column.empty() &&
+                           (options.timestamp_start.has_value() || options.timestamp_end.has_value());
+    if (has_range &&
+        std::find(read_columns.begin(), read_columns.end(), options.timestamp_column) == read_columns.end()) {
+        read_columns.push_back(options.timestamp_column);
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> output_fields;
+    for (const auto& name : read_columns) {
+        const int index = file_schema->GetFieldIndex(name);
+        if (index < 0) {
+            return arrow::Status::KeyError("Column not found in Parquet file: ", name);
+        }
+        stream->column_indices_.push_back(index);
+        if (output_fields.size() < output_columns.size()) {
+            output_fields.push_back(file_schema->field(index));
+        }
+    }
+    stream->schema_ = arrow::schema(std::move(output_fields));
+
+    // Row-group pruning from column statistics
+    const auto metadata = stream->reader_->parquet_reader()->metadata();
+    stream->total_row_groups_ = metadata->num_row_groups();
+    const int64_t lower = options.timestamp_start.value_or(std::numeric_limits<int64_t>::min());
+    const int64_t upper = options.timestamp_end.value_or(std::numeric_limits<int64_t>::max());
+    const int leaf = has_range ? metadata->schema()->ColumnIndex(options.timestamp_column) : -1;
+
+    for (int rg = 0; rg < stream->total_row_groups_; ++rg) {
+        bool inside = !has_range;
+        if (has_range && leaf >= 0) {
+            const auto range = chunk_range(*metadata->RowGroup(rg)->ColumnChunk(leaf));
+            if (range) {
+                if (range->second < lower || range->first > upper) {
+                    continue;
+                }
+                inside = range->first >= lower && range->second <= upper;
+            }
+        }
+        stream->row_groups_.push_back(rg);
+        stream->row_group_inside_.push_back(inside);
+    }
+
+    ParquetBatchStream* self = stream.get();
+    stream->producer_ = std::thread([self]() {
+        arrow::Status status = self->produce();
+        {
+            std::lock_guard<std::mutex> lock(self->mutex_);
+            self->error_ = std::move(status);
+            self->finished_ = true;
+        }
+        self->not_empty_.notify_all();
+    });
+    return stream;
+}
+
+ParquetBatchStream::~ParquetBatchStream() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    not_full_.notify_all();
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+}
+
+arrow::Status ParquetBatchStream::produce() {
+    for (std::size_t i = 0; i < row_groups_.size(); ++i) {
+        ARROW_ASSIGN_OR_RAISE(auto batches, reader_->GetRecordBatchReader({row_groups_[i]}, column_indices_));
+        while (true) {
+            std::shared_ptr<arrow::RecordBatch> batch;
+            ARROW_RETURN_NOT_OK(batches->ReadNext(&batch));
+            if (!batch) {
+                break;
+            }
+            if (!row_group_inside_[i]) {
+                ARROW_ASSIGN_OR_RAISE(batch, filter_rows(batch));
+            }
+            if (batch->num_rows() == 0) {
+                continue;
+            }
+            ARROW_ASSIGN_OR_RAISE(batch, project(batch));
+            if (!push(std::move(batch))) {
+                return arrow::Status::OK();   // Consumer went away
+            }
+        }
+    }
+    return arrow::Status::OK();
+}
+
+bool ParquetBatchStream::push(std::shared_ptr<arrow::RecordBatch> batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this]() {
+        return cancelled_ || queue_.size() < std::max<std::size_t>(1, options_.max_queued_batches);
+    });
+    if (cancelled_) {
+        return false;
+    }
+    queue_.push_back(std::move(batch));
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+}
+
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> ParquetBatchStream::next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this]() { return !queue_.empty() || finished_; });
+    if (queue_.empty()) {
+        ARROW_RETURN_NOT_OK(error_);
+        return std::shared_ptr<arrow::RecordBatch>();
+    }
+    auto batch = std::move(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return batch;
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> ParquetBatchStream::read_all() {
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    while (true) {
+        ARROW_ASSIGN_OR_RAISE(auto batch, next());
+        if (!batch) {
+            break;
+        }
+        batches.push_back(std::move(batch));
+    }
+    return arrow::Table::FromRecordBatches(schema_, batches);
+}
+
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> ParquetBatchStream::filter_rows(
+    const std::shared_ptr<arrow::RecordBatch>& batch) const {
+
+    auto column = batch->GetColumnByName(options_.timestamp_column);
+    if (!column) {
+        return arrow::Status::KeyError("Column not found in batch: ", options_.timestamp_column);
+    }
+
+    ARROW_ASSIGN_OR_RAISE(auto keys, arrow::compute::Cast(arrow::Datum(column),
+                                                          arrow::compute::CastOptions::Unsafe(arrow::int64())));
+    arrow::Datum mask;
+    if (options_.timestamp_start) {
+        ARROW_ASSIGN_OR_RAISE(mask, arrow::compute::CallFunction("greater_equal",
+            { keys, arrow::MakeScalar(*options_.timestamp_start) }));
+    }
+    if (options_.timestamp_end) {
+        ARROW_ASSIGN_OR_RAISE(auto le_end, arrow::compute::CallFunction("less_equal",
+            { keys, arrow::MakeScalar(*options_.timestamp_end) }));
+        if (mask.kind() == arrow::Datum::NONE) {
+            mask = std::move(le_end);
+        } else {
+            ARROW_ASSIGN_OR_RAISE(mask, arrow::compute::CallFunction("and", { mask, le_end }));
+        }
+    }
+    ARROW_ASSIGN_OR_RAISE(auto filtered, arrow::compute::Filter(arrow::Datum(batch), mask));
+    return filtered.record_batch();
+}
+
+arrow::Result<std::shared_ptr<arrow::RecordBatch>> ParquetBatchStream::project(
+    const std::shared_ptr<arrow::RecordBatch>& batch) const {
+
+    std::vector<std::shared_ptr<arrow::Array>> columns;
+    columns.reserve(schema_->num_fields());
+    for (const auto& field : schema_->fields()) {
+        auto column = batch->GetColumnByName(field->name());
+        if (!column) {
+            return arrow::Status::KeyError("Column not found in batch: ", field->name());
+        }
+        columns.push_back(std::move(column));
+    }
+    return arrow::RecordBatch::Make(schema_, batch->num_rows(), std::move(columns));
+}
+
+} // namespace chronosflow
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <arrow/record_batch.h>
+#include <arrow/result.h>
+#include <arrow/status.h>
+#include <arrow/table.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace parquet::arrow {
+class FileReader;
+}
+
+namespace chronosflow {
+
+struct ParquetScanOptions {
+    std::vector<std::string> columns;          // Projection; empty reads every column
+
+    // Optional inclusive range on an integer or timestamp column, in the
+    // column's stored units (e.g. unix ms, or YYYYMMDD for a TSSB date).
+    // Row groups whose statistics lie outside the range are never read.
+    std::string timestamp_column;
+    std::optional<int64_t> timestamp_start;
+    std::optional<int64_t> timestamp_end;
+
+    int64_t batch_size = 64 * 1024;            // Rows per record batch
+    std::size_t max_queued_batches = 4;        // Read-ahead bound
+    bool use_threads = true;                   // Decode columns in parallel
+
+    static ParquetScanOptions Defaults() {
+        return ParquetScanOptions{};
+    }
+};
+
+// Record batches of a Parquet file, read on a background thread.
+//
+// Row groups are pruned with their column statistics before any data is read;
+// rows of partially matching groups are then filtered exactly. Decoded
+// batches wait in a queue of at most max_queued_batches, so the reader stays
+// that far ahead of the consumer and memory use does not grow with file size.
+class ParquetBatchStream {
+public:
+    static arrow::Result<std::unique_ptr<ParquetBatchStream>> open(
+        const std::string& file_path,
+        const ParquetScanOptions& options = ParquetScanOptions::Defaults());
+
+    ~ParquetBatchStream();
+    ParquetBatchStream(const ParquetBatchStream&) = delete;
+    ParquetBatchStream& operator=(const ParquetBatchStream&) = delete;
+
+    // Next batch in file order; nullptr once the scan is complete
+    arrow::Result<std::shared_ptr<arrow::RecordBatch>> next();
+
+    // Remaining batches as one table
+    arrow::Result<std::shared_ptr<arrow::Table>> read_all();
+
+    // Projected schema of every batch
+    const std::shared_ptr<arrow::Schema>& schema() const { return schema_; }
+
+    int total_row_groups() const { return total_row_groups_; }
+    int selected_row_groups() const { return static_cast<int>(row_groups_.size()); }
+
+private:
+    ParquetBatchStream() = default;
+
+    arrow::Status produce();
+    bool push(std::shared_ptr<arrow::RecordBatch> batch);
+    arrow::Result<std::shared_ptr<arrow::RecordBatch>> filter_rows(
+        const std::shared_ptr<arrow::RecordBatch>& batch) const;
+    arrow::Result<std::shared_ptr<arrow::RecordBatch>> project(
+        const std::shared_ptr<arrow::RecordBatch>& batch) const;
+
+    ParquetScanOptions options_;
+    std::unique_ptr<parquet::arrow::FileReader> reader_;
+    std::shared_ptr<arrow::Schema> schema_;
+    std::vector<int> column_indices_;          // Columns read from the file
+    std::vector<int> row_groups_;              // Row groups that may match
+    std::vector<bool> row_group_inside_;       // Entirely within the range
+    int total_row_groups_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<std::shared_ptr<arrow::RecordBatch>> queue_;
+    arrow::Status error_;
+    bool finished_ = false;
+    bool cancelled_ = false;
+    std::thread producer_;
+};
+
+} // namespace chronosflow
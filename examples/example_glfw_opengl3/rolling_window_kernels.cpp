@@ -0,0 +1,452 @@
+#include "rolling_window_kernels.h"
+#include <arrow/builder.h>
+#include <arrow/compute/api.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <execution>
+#include <numeric>
+#include <utility>
+
+namespace chronosflow {
+
+namespace {
+
+// Column values as one contiguous buffer; NaN and nulls are both invalid
+struct DenseColumn {
+    std::vector<double> values;
+    std::vector<uint8_t> valid;
+};
+
+arrow::Result<DenseColumn> to_dense(const std::shared_ptr<arrow::ChunkedArray>& column) {
+    DenseColumn dense;
+    dense.values.resize(column->length());
+    dense.valid.resize(column->length());
+
+    int64_t offset = 0;
+    for (const auto& raw_chunk : column->chunks()) {
+        std::shared_ptr<arrow::Array> chunk = raw_chunk;
+        if (chunk->type_id() != arrow::Type::DOUBLE) {
+            ARROW_ASSIGN_OR_RAISE(auto cast, arrow::compute::Cast(arrow::Datum(chunk), arrow::float64()));
+            chunk = cast.make_array();
+        }
+        auto doubles = std::static_pointer_cast<arrow::DoubleArray>(chunk);
+        const double* src = doubles->raw_values();
+        const int64_t length = doubles->length();
+        const bool has_nulls = doubles->null_count() > 0;
+
+        for (int64_t i = 0; i < length; ++i) {
+            const double v = src[i];
+            dense.values[offset + i] = v;
+            dense.valid[offset + i] = (!has_nulls || doubles->IsValid(i)) && !std::isnan(v);
+        }
+        offset += length;
+    }
+    return dense;
+}
+
+// Count, mean and central sums M2, M3 of a set of values
+struct Moments {
+    double n = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double m3 = 0.0;
+};
+
+// One row, offset by shift
+Moments single(const DenseColumn& col, int64_t i, double shift) {
+    Moments m;
+    if (col.valid[i]) {
+        m.n = 1.0;
+        m.mean = col.values[i] - shift;
+    }
+    return m;
+}
+
+// Moments of the union of two disjoint sets (Chan et al.). Nothing is ever
+// subtracted back out, so a window does not inherit rounding from values
+// that have left it.
+Moments merge(const Moments& a, const Moments& b) {
+    if (a.n == 0.0) return b;
+    if (b.n == 0.0) return a;
+    Moments m;
+    m.n = a.n + b.n;
+    const double delta = b.mean - a.mean;
+    const double ab = a.n * b.n / m.n;
+    m.mean = a.mean + delta * b.n / m.n;
+    m.m2 = a.m2 + b.m2 + delta * delta * ab;
+    m.m3 = a.m3 + b.m3 + delta * delta * delta * ab * (a.n - b.n) / m.n +
+           3.0 * delta * (a.n * b.m2 - b.n * a.m2) / m.n;
+    return m;
+}
+
+// Output buffer for one derived column
+struct RollingOutput {
+    std::vector<double> values;
+    std::vector<uint8_t> valid;
+
+    explicit RollingOutput(size_t n) : values(n, 0.0), valid(n, 0) {}
+
+    void set(size_t i, double v) { values[i] = v; valid[i] = 1; }
+};
+
+arrow::Result<std::shared_ptr<arrow::Array>> finish(const RollingOutput& out) {
+    arrow::DoubleBuilder builder;
+    ARROW_RETURN_NOT_OK(builder.AppendValues(out.values.data(),
+                                             static_cast<int64_t>(out.values.size()),
+                                             out.valid.data()));
+    std::shared_ptr<arrow::Array> array;
+    ARROW_RETURN_NOT_OK(builder.Finish(&array));
+    return array;
+}
+
+// Window moments from two pieces: the rows are cut into blocks of `window`,
+// so a window is a suffix of one block plus a prefix of the next. Suffixes
+// of the previous block are kept, the current block's prefix is running,
+// and each row costs three merges whatever the window size. Values are
+// offset by the column mean first, so a series far from zero keeps the
+// digits of its variation in the running means.
+void rolling_moments(const DenseColumn& col, int window, int min_periods,
+                     const std::vector<std::pair<RollingStatistic, RollingOutput*>>& stats) {
+    const int64_t n = static_cast<int64_t>(col.values.size());
+    double total = 0.0;
+    int64_t valid = 0;
+    for (int64_t i = 0; i < n; ++i) {
+        if (col.valid[i]) { total += col.values[i]; ++valid; }
+    }
+    const double shift = valid > 0 ? total / static_cast<double>(valid) : 0.0;
+    std::vector<Moments> suffix(window);
+
+    for (int64_t start = 0; start < n; start += window) {
+        const int64_t stop = std::min<int64_t>(n, start + window);
+        Moments prefix;
+        for (int64_t i = start; i < stop; ++i) {
+            prefix = merge(prefix, single(col, i, shift));
+            const int64_t lo = i + 1 - window;
+            if (lo < 0) continue;
+            const Moments m = lo == start ? prefix : merge(suffix[lo - (start - window)], prefix);
+
+            for (const auto& [statistic, out] : stats) {
+                int64_t needed = min_periods;
+                if (statistic == RollingStatistic::StdDev || statistic == RollingStatistic::Variance ||
+                    statistic == RollingStatistic::ZScore) {
+                    needed = std::max<int64_t>(needed, 2);
+                } else if (statistic == RollingStatistic::Skew) {
+                    needed = std::max<int64_t>(needed, 3);
+                }
+                if (m.n < static_cast<double>(needed)) continue;
+
+                const double var = m.m2 / (m.n - 1.0);
+                switch (statistic) {
+                case RollingStatistic::Mean:
+                    out->set(i, shift + m.mean);
+                    break;
+                case RollingStatistic::Variance:
+                    out->set(i, var);
+                    break;
+                case RollingStatistic::StdDev:
+                    out->set(i, std::sqrt(var));
+                    break;
+                case RollingStatistic::ZScore: {
+                    const double sd = std::sqrt(var);
+                    if (col.valid[i] && sd > 0.0) {
+                        out->set(i, (col.values[i] - shift - m.mean) / sd);
+                    }
+                    break;
+                }
+                case RollingStatistic::Skew: {
+                    if (m.m2 <= 0.0) break;
+                    const double g1 = (m.m3 / m.n) / std::pow(m.m2 / m.n, 1.5);
+                    out->set(i, g1 * std::sqrt(m.n * (m.n - 1.0)) / (m.n - 2.0));
+                    break;
+                }
+                default:
+                    break;
+                }
+            }
+        }
+
+        // Suffixes of this block serve the windows ending in the next one
+        Moments tail;
+        for (int64_t i = stop - 1; i >= start; --i) {
+            tail = merge(single(col, i, shift), tail);
+            suffix[i - start] = tail;
+        }
+    }
+}
+
+// Monotonic deque of valid indices; the front is the window extreme
+void rolling_extreme(const DenseColumn& col, int window, int min_periods, bool is_max,
+                     RollingOutput& out) {
+    const int64_t n = static_cast<int64_t>(col.values.size());
+    std::deque<int64_t> candidates;
+    int64_t valid_in_window = 0;
+
+    for (int64_t i = 0; i < n; ++i) {
+        if (col.valid[i]) {
+            const double v = col.values[i];
+            while (!candidates.empty() &&
+                   (is_max ? col.values[candidates.back()] <= v : col.values[candidates.back()] >= v)) {
+                candidates.pop_back();
+            }
+            candidates.push_back(i);
+            ++valid_in_window;
+        }
+        const int64_t lo = i + 1 - window;
+        if (lo > 0 && col.valid[lo - 1]) --valid_in_window;
+        while (!candidates.empty() && candidates.front() < lo) candidates.pop_front();
+
+        if (lo >= 0 && valid_in_window >= std::max(min_periods, 1) && !candidates.empty()) {
+            out.set(i, col.values[candidates.front()]);
+        }
+    }
+}
+
+// The k-th and (k+1)-th smallest values of a sliding window: the lowest
+// k + 1 in a max-heap, the rest in a min-heap. Entries carry their row, so
+// one that has left the window is recognised by it and dropped once it
+// reaches a top; heaps holding more dead than live entries are compacted.
+class WindowOrderStatistic {
+public:
+    void insert(double value, int64_t row) {
+        const Entry entry{value, row};
+        prune();
+        if (lower_live_ > 0 && Less{}(entry, lower_.front())) {
+            push(lower_, entry, Less{});
+            ++lower_live_;
+        } else {
+            push(upper_, entry, Greater{});
+            ++upper_live_;
+        }
+    }
+
+    // Rows leave in order, so everything before this one is already gone
+    void erase(double value, int64_t row) {
+        prune();
+        if (lower_live_ > 0 && !Less{}(lower_.front(), Entry{value, row})) {
+            --lower_live_;
+        } else {
+            --upper_live_;
+        }
+        first_row_ = row + 1;
+        compact(lower_, lower_live_, Less{});
+        compact(upper_, upper_live_, Greater{});
+    }
+
+    int64_t size() const { return lower_live_ + upper_live_; }
+
+    // Moves entries until the max-heap holds the k + 1 smallest
+    void select(int64_t k) {
+        while (lower_live_ > k + 1) {
+            prune();
+            push(upper_, pop(lower_, Less{}), Greater{});
+            --lower_live_;
+            ++upper_live_;
+        }
+        while (lower_live_ < k + 1 && upper_live_ > 0) {
+            prune();
+            push(lower_, pop(upper_, Greater{}), Less{});
+            ++lower_live_;
+            --upper_live_;
+        }
+        prune();
+    }
+
+    double kth() const { return lower_.front().value; }
+    double next() const { return upper_.front().value; }
+
+private:
+    struct Entry {
+        double value;
+        int64_t row;
+    };
+    struct Less {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return a.value < b.value || (a.value == b.value && a.row < b.row);
+        }
+    };
+    struct Greater {
+        bool operator()(const Entry& a, const Entry& b) const { return Less{}(b, a); }
+    };
+
+    template <typename Compare>
+    static void push(std::vector<Entry>& heap, const Entry& entry, Compare compare) {
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), compare);
+    }
+
+    template <typename Compare>
+    static Entry pop(std::vector<Entry>& heap, Compare compare) {
+        std::pop_heap(heap.begin(), heap.end(), compare);
+        const Entry top = heap.back();
+        heap.pop_back();
+        return top;
+    }
+
+    void prune() {
+        while (!lower_.empty() && lower_.front().row < first_row_) pop(lower_, Less{});
+        while (!upper_.empty() && upper_.front().row < first_row_) pop(upper_, Greater{});
+    }
+
+    template <typename Compare>
+    void compact(std::vector<Entry>& heap, int64_t live, Compare compare) {
+        if (static_cast<int64_t>(heap.size()) <= 2 * live + 16) return;
+        heap.erase(std::remove_if(heap.begin(), heap.end(),
+                                  [this](const Entry& e) { return e.row < first_row_; }),
+                   heap.end());
+        std::make_heap(heap.begin(), heap.end(), compare);
+    }
+
+    std::vector<Entry> lower_;      // Max-heap
+    std::vector<Entry> upper_;      // Min-heap
+    int64_t lower_live_ = 0;
+    int64_t upper_live_ = 0;
+    int64_t first_row_ = 0;
+};
+
+// Linear interpolation between the order statistics around q * (count - 1);
+// each row costs O(log W) per quantile
+void rolling_quantiles(const DenseColumn& col, int window, int min_periods,
+                       const std::vector<double>& quantiles, std::vector<RollingOutput>& outs) {
+    const int64_t n = static_cast<int64_t>(col.values.size());
+    std::vector<WindowOrderStatistic> heaps(quantiles.size());
+
+    for (int64_t i = 0; i < n; ++i) {
+        const int64_t lo = i + 1 - window;
+        for (auto& heap : heaps) {
+            if (col.valid[i]) heap.insert(col.values[i], i);
+            if (lo > 0 && col.valid[lo - 1]) heap.erase(col.values[lo - 1], lo - 1);
+        }
+        const int64_t count = heaps.empty() ? 0 : heaps.front().size();
+        if (lo < 0 || count == 0 || count < min_periods) continue;
+
+        const double last = static_cast<double>(count - 1);
+        for (size_t q = 0; q < quantiles.size(); ++q) {
+            const double pos = std::clamp(quantiles[q], 0.0, 1.0) * last;
+            const int64_t below = std::min(static_cast<int64_t>(pos), count - 1);
+            const double frac = pos - static_cast<double>(below);
+            heaps[q].select(below);
+            const double low = heaps[q].kth();
+            const double high = frac > 0.0 ? heaps[q].next() : low;
+            outs[q].set(i, low + frac * (high - low));
+        }
+    }
+}
+
+} // namespace
+
+std::string RollingWindowKernels::statistic_suffix(RollingStatistic statistic, double quantile) {
+    switch (statistic) {
+    case RollingStatistic::Mean: return "mean";
+    case RollingStatistic::StdDev: return "std";
+    case RollingStatistic::Variance: return "var";
+    case RollingStatistic::Min: return "min";
+    case RollingStatistic::Max: return "max";
+    case RollingStatistic::ZScore: return "zscore";
+    case RollingStatistic::Skew: return "skew";
+    case RollingStatistic::Quantile:
+        return "q" + std::to_string(static_cast<int>(std::lround(quantile * 100.0)));
+    }
+    return "unknown";
+}
+
+arrow::Result<std::vector<RollingColumn>> RollingWindowKernels::compute(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    const std::string& column_name,
+    const RollingFeatureSpec& spec) {
+
+    if (!column) {
+        return arrow::Status::Invalid("Null column: ", column_name);
+    }
+    for (int window : spec.window_sizes) {
+        if (window < 1) {
+            return arrow::Status::Invalid("Rolling window size must be positive, got ", window);
+        }
+    }
+
+    ARROW_ASSIGN_OR_RAISE(DenseColumn dense, to_dense(column));
+    const size_t n = dense.values.size();
+
+    std::vector<RollingColumn> result;
+    for (int window : spec.window_sizes) {
+        const std::string window_tag = "_" + std::to_string(window);
+
+        // Every moment statistic of this window comes from one pass
+        std::vector<RollingOutput> moment_outs;
+        moment_outs.reserve(spec.statistics.size());
+        std::vector<std::pair<RollingStatistic, RollingOutput*>> moment_stats;
+        for (RollingStatistic stat : spec.statistics) {
+            if (stat == RollingStatistic::Mean || stat == RollingStatistic::StdDev ||
+                stat == RollingStatistic::Variance || stat == RollingStatistic::ZScore ||
+                stat == RollingStatistic::Skew) {
+                moment_outs.emplace_back(n);
+                moment_stats.emplace_back(stat, &moment_outs.back());
+            }
+        }
+        if (!moment_stats.empty()) {
+            rolling_moments(dense, window, spec.min_periods, moment_stats);
+        }
+
+        size_t next_moment = 0;
+        for (RollingStatistic stat : spec.statistics) {
+            if (stat == RollingStatistic::Quantile) {
+                std::vector<RollingOutput> outs(spec.quantiles.size(), RollingOutput(n));
+                rolling_quantiles(dense, window, spec.min_periods, spec.quantiles, outs);
+                for (size_t q = 0; q < outs.size(); ++q) {
+                    ARROW_ASSIGN_OR_RAISE(auto array, finish(outs[q]));
+                    result.push_back({column_name + "_rolling_" + statistic_suffix(stat, spec.quantiles[q]) + window_tag,
+                                      array});
+                }
+                continue;
+            }
+
+            std::shared_ptr<arrow::Array> array;
+            if (stat == RollingStatistic::Min || stat == RollingStatistic::Max) {
+                RollingOutput out(n);
+                rolling_extreme(dense, window, spec.min_periods, stat == RollingStatistic::Max, out);
+                ARROW_ASSIGN_OR_RAISE(array, finish(out));
+            } else {
+                ARROW_ASSIGN_OR_RAISE(array, finish(moment_outs[next_moment++]));
+            }
+            result.push_back({column_name + "_rolling_" + statistic_suffix(stat) + window_tag, array});
+        }
+    }
+    return result;
+}
+
+arrow::Result<std::vector<RollingColumn>> RollingWindowKernels::compute_columns(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<std::string>& column_names,
+    const RollingFeatureSpec& spec) {
+
+    if (!table) {
+        return arrow::Status::Invalid("No table data available");
+    }
+
+    std::vector<arrow::Result<std::vector<RollingColumn>>> per_column(
+        column_names.size(), arrow::Status::UnknownError("not computed"));
+    std::vector<size_t> indices(column_names.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::for_each(std::execution::par, indices.begin(), indices.end(),
+        [&](size_t i) {
+            auto column = table->GetColumnByName(column_names[i]);
+            if (!column) {
+                per_column[i] = arrow::Status::Invalid("Column not found: ", column_names[i]);
+                return;
+            }
+            per_column[i] = compute(column, column_names[i], spec);
+        });
+
+    std::vector<RollingColumn> result;
+    for (auto& columns : per_column) {
+        ARROW_ASSIGN_OR_RAISE(auto derived, std::move(columns));
+        for (auto& c : derived) {
+            result.push_back(std::move(c));
+        }
+    }
+    return result;
+}
+
+} // namespace chronosflow
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <arrow/array.h>
+#include <arrow/chunked_array.h>
+#include <arrow/result.h>
+#include <arrow/table.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace chronosflow {
+
+enum class RollingStatistic {
+    Mean,
+    StdDev,     // Sample standard deviation (ddof = 1)
+    Variance,   // Sample variance (ddof = 1)
+    Min,
+    Max,
+    ZScore,     // (x - window mean) / window std, window includes x
+    Skew,       // Bias-corrected sample skewness
+    Quantile    // One output per entry of RollingFeatureSpec::quantiles
+};
+
+struct RollingFeatureSpec {
+    std::vector<int> window_sizes = {5, 10, 20};
+    std::vector<RollingStatistic> statistics = {RollingStatistic::Mean, RollingStatistic::StdDev};
+    std::vector<double> quantiles = {0.5};
+
+    // Minimum number of valid values a window needs to produce a result.
+    // Nulls and NaNs are skipped; the first window_size - 1 rows are always null.
+    int min_periods = 1;
+};
+
+struct RollingColumn {
+    std::string name;                        // <column>_rolling_<stat>_<window>
+    std::shared_ptr<arrow::Array> values;    // float64, null where undefined
+};
+
+// Sliding-window aggregations on raw column buffers.
+//
+// Each column is copied out of its Arrow chunks once. Mean, variance, z-score
+// and skew merge per-row moments pairwise (Chan et al.) from a block suffix
+// and a running prefix, so each window costs O(N) and nothing is subtracted
+// back out. Min and max use a monotonic deque (O(N)); each quantile keeps
+// the window split around its order statistic in two heaps (O(N log W)).
+class RollingWindowKernels {
+public:
+    static arrow::Result<std::vector<RollingColumn>> compute(
+        const std::shared_ptr<arrow::ChunkedArray>& column,
+        const std::string& column_name,
+        const RollingFeatureSpec& spec);
+
+    // Columns are processed in parallel. Output is grouped by column in the
+    // order given, then by window size, then by statistic.
+    static arrow::Result<std::vector<RollingColumn>> compute_columns(
+        const std::shared_ptr<arrow::Table>& table,
+        const std::vector<std::string>& column_names,
+        const RollingFeatureSpec& spec);
+
+    // "mean", "std", "var", "min", "max", "zscore", "skew", "q25", ...
+    static std::string statistic_suffix(RollingStatistic statistic, double quantile = 0.5);
+};
+
+} // namespace chronosflow
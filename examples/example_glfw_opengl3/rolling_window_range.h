@@ -0,0 +1,122 @@
+#pragma once
+
+#include "column_view.h"
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace chronosflow {
+
+// One window of a rolling range: rows [offset, offset + length)
+struct RowWindow {
+    int64_t index = 0;
+    int64_t offset = 0;
+    int64_t length = 0;
+
+    template<typename T>
+    std::span<const T> slice(const ColumnView<T>& column) const {
+        return std::span<const T>(column.data() + offset, static_cast<std::size_t>(length));
+    }
+};
+
+// Lazy range of fixed-size windows over num_rows rows.
+//
+// Windows are computed from their index on demand, so the range itself is
+// three integers regardless of how many windows it covers. Pair it with
+// ColumnView<T> (RowWindow::slice) to read window data straight from the
+// column buffers without slicing tables.
+class RollingWindowRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = RowWindow;
+        using difference_type = int64_t;
+        using pointer = void;
+        using reference = RowWindow;
+
+        iterator() = default;
+        iterator(const RollingWindowRange* range, int64_t index) : range_(range), index_(index) {}
+
+        RowWindow operator*() const { return (*range_)[index_]; }
+        RowWindow operator[](difference_type n) const { return (*range_)[index_ + n]; }
+
+        iterator& operator++() { ++index_; return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++index_; return tmp; }
+        iterator& operator--() { --index_; return *this; }
+        iterator operator--(int) { iterator tmp = *this; --index_; return tmp; }
+        iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+        iterator operator+(difference_type n) const { return iterator(range_, index_ + n); }
+        iterator operator-(difference_type n) const { return iterator(range_, index_ - n); }
+        friend iterator operator+(difference_type n, const iterator& it) { return it + n; }
+        difference_type operator-(const iterator& other) const { return index_ - other.index_; }
+
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+        bool operator<(const iterator& other) const { return index_ < other.index_; }
+        bool operator>(const iterator& other) const { return index_ > other.index_; }
+        bool operator<=(const iterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const iterator& other) const { return index_ >= other.index_; }
+
+    private:
+        const RollingWindowRange* range_ = nullptr;
+        int64_t index_ = 0;
+    };
+
+    RollingWindowRange() = default;
+    RollingWindowRange(int64_t num_rows, int64_t window_size, int64_t step_size)
+        : num_rows_(num_rows), window_size_(window_size), step_size_(step_size) {}
+
+    // Same windows as the eager create_rolling_windows
+    int64_t size() const {
+        if (window_size_ <= 0 || step_size_ <= 0 || num_rows_ < window_size_) return 0;
+        return (num_rows_ - window_size_) / step_size_ + 1;
+    }
+    bool empty() const { return size() == 0; }
+
+    int64_t window_size() const { return window_size_; }
+    int64_t step_size() const { return step_size_; }
+
+    RowWindow operator[](int64_t index) const {
+        return RowWindow{index, index * step_size_, window_size_};
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+
+    // Calls fn(const RowWindow&) for every window in parallel. Windows are
+    // handed out in contiguous blocks, one task per block, so scheduling state
+    // is proportional to the thread count rather than the window count.
+    template<typename Fn>
+    void parallel_for_each(Fn&& fn) const {
+        const int64_t total = size();
+        if (total == 0) return;
+
+        const int64_t threads = std::max<int64_t>(1, std::thread::hardware_concurrency());
+        const int64_t blocks = std::min<int64_t>(total, threads * 4);
+        std::vector<int64_t> block_ids(static_cast<std::size_t>(blocks));
+        std::iota(block_ids.begin(), block_ids.end(), 0);
+
+        std::for_each(std::execution::par, block_ids.begin(), block_ids.end(),
+            [&](int64_t block) {
+                const int64_t first = total * block / blocks;
+                const int64_t last = total * (block + 1) / blocks;
+                for (int64_t i = first; i < last; ++i) {
+                    fn((*this)[i]);
+                }
+            });
+    }
+
+private:
+    int64_t num_rows_ = 0;
+    int64_t window_size_ = 0;
+    int64_t step_size_ = 1;
+};
+
+} // namespace chronosflow
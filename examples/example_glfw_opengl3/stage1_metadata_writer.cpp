@@ -1,9 +1,9 @@
 #include "stage1_metadata_writer.h"
 #include "Stage1DatasetManifest.h"
+#include "Stage1MetadataSpool.h"
 #include "Stage1RestClient.h"
 #include "TradeSimulator.h"
 #include <filesystem>
-#include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
@@ -24,7 +24,6 @@
 #include <libpq-fe.h>
 
 namespace {
-std::mutex g_writerMutex;
 const char* kSpoolPath = "docs/fixtures/stage1_3/pending_postgres_inserts.sql";
 
 double SafeDouble(double value) {
@@ -612,13 +611,16 @@ Stage1MetadataWriter& Stage1MetadataWriter::Instance() {
 
 Stage1MetadataWriter::Stage1MetadataWriter()
     : m_spoolPath(kSpoolPath) {
-    std::lock_guard<std::mutex> lock(g_writerMutex);
-    std::filesystem::create_directories(std::filesystem::path(m_spoolPath).parent_path());
-    if (!std::filesystem::exists(m_spoolPath)) {
-        std::ofstream out(m_spoolPath, std::ios::app);
-        out << "-- Auto-generated Stage 1 metadata inserts. Apply with psql once\n"
-            << "-- connectivity to 45.85.147.236 is available.\n\n";
-    }
+    stage1::MetadataSpoolOptions options;
+    options.header = "-- Auto-generated Stage 1 metadata inserts. Apply with psql once\n"
+                     "-- connectivity to 45.85.147.236 is available.\n\n";
+    m_spool = std::make_unique<stage1::MetadataSpool>(m_spoolPath, options);
+}
+
+Stage1MetadataWriter::~Stage1MetadataWriter() = default;
+
+void Stage1MetadataWriter::Shutdown() {
+    m_spool->Shutdown();
 }
 
 bool Stage1MetadataWriter::NetworkExportsEnabled() {
@@ -855,6 +857,21 @@ bool Stage1MetadataWriter::RecordWalkforwardRun(const WalkforwardRecord& record,
         }
     }
 
+    stage1::SpoolRows foldRows;
+    foldRows.insert_prefix = "INSERT INTO walkforward_folds "
+                             "(run_id, fold_number, train_start_idx, train_end_idx, test_start_idx, "
+                             "test_end_idx, train_start_ts_ms, train_end_ts_ms, test_start_ts_ms, test_end_ts_ms, "
+                             "samples_train, samples_test, metrics, thresholds)\nVALUES\n";
+    foldRows.conflict_clause = "ON CONFLICT (run_id, fold_number) DO UPDATE SET\n"
+                               "  train_start_idx = EXCLUDED.train_start_idx,\n"
+                               "  train_end_idx = EXCLUDED.train_end_idx,\n"
+                               "  test_start_idx = EXCLUDED.test_start_idx,\n"
+                               "  test_end_idx = EXCLUDED.test_end_idx,\n"
+                               "  samples_train = EXCLUDED.samples_train,\n"
+                               "  samples_test = EXCLUDED.samples_test,\n"
+                               "  metrics = EXCLUDED.metrics,\n"
+                               "  thresholds = EXCLUDED.thresholds;\n\n";
+    foldRows.rows.reserve(record.folds.size());
     for (const auto& fold : record.folds) {
         std::ostringstream foldSql;
         std::ostringstream thresholds;
@@ -901,11 +918,7 @@ bool Stage1MetadataWriter::RecordWalkforwardRun(const WalkforwardRecord& record,
                 << "\"used_cached_model\":" << (fold.used_cached_model ? "true" : "false")
                 << "}";
 
-        foldSql << "INSERT INTO walkforward_folds "
-                   "(run_id, fold_number, train_start_idx, train_end_idx, test_start_idx, "
-                   "test_end_idx, train_start_ts_ms, train_end_ts_ms, test_start_ts_ms, test_end_ts_ms, "
-                   "samples_train, samples_test, metrics, thresholds)\n"
-                << "VALUES ("
+        foldSql << "("
                 << Quote(record.run_id) << ", "
                 << fold.fold_number << ", "
                 << fold.train_start << ", "
@@ -916,18 +929,10 @@ bool Stage1MetadataWriter::RecordWalkforwardRun(const WalkforwardRecord& record,
                 << fold.samples_train << ", "
                 << fold.samples_test << ", "
                 << Quote(metrics.str()) << "::jsonb, "
-                << Quote(thresholds.str()) << "::jsonb)\n"
-                << "ON CONFLICT (run_id, fold_number) DO UPDATE SET\n"
-                << "  train_start_idx = EXCLUDED.train_start_idx,\n"
-                << "  train_end_idx = EXCLUDED.train_end_idx,\n"
-                << "  test_start_idx = EXCLUDED.test_start_idx,\n"
-                << "  test_end_idx = EXCLUDED.test_end_idx,\n"
-                << "  samples_train = EXCLUDED.samples_train,\n"
-                << "  samples_test = EXCLUDED.samples_test,\n"
-                << "  metrics = EXCLUDED.metrics,\n"
-                << "  thresholds = EXCLUDED.thresholds;\n\n";
-        AppendSql(foldSql.str(), mode);
+                << Quote(thresholds.str()) << "::jsonb)";
+        foldRows.rows.emplace_back(record.run_id + ":" + std::to_string(fold.fold_number), foldSql.str());
     }
+    AppendRows(std::move(foldRows), mode);
 
     return true;
 }
@@ -965,16 +970,28 @@ void Stage1MetadataWriter::RecordSimulationRun(
         << "  completed_at = EXCLUDED.completed_at,\n"
         << "  summary_metrics = EXCLUDED.summary_metrics;\n\n";
     if (allowNetwork) {
-        PostStage1Json("simulation run", "/api/simulations", simulationJson);
+        // Nothing reports the outcome, so the caller need not wait for it
+        m_spool->Post([simulationJson]() {
+            PostStage1Json("simulation run", "/api/simulations", simulationJson);
+        });
     }
     AppendSql(sql.str(), allowNetwork ? mode : PersistMode::FileOnly);
 
+    stage1::SpoolRows bucketRows;
+    bucketRows.insert_prefix = "INSERT INTO simulation_trade_buckets "
+                               "(simulation_id, side, trade_count, win_count, profit_factor, "
+                               "avg_return_pct, max_drawdown_pct, notes)\nVALUES\n";
+    bucketRows.conflict_clause = "ON CONFLICT (simulation_id, side) DO UPDATE SET\n"
+                                 "  trade_count = EXCLUDED.trade_count,\n"
+                                 "  win_count = EXCLUDED.win_count,\n"
+                                 "  profit_factor = EXCLUDED.profit_factor,\n"
+                                 "  avg_return_pct = EXCLUDED.avg_return_pct,\n"
+                                 "  max_drawdown_pct = EXCLUDED.max_drawdown_pct,\n"
+                                 "  notes = EXCLUDED.notes;\n\n";
+    bucketRows.rows.reserve(record.buckets.size());
     for (const auto& bucket : record.buckets) {
         std::ostringstream bucketSql;
-        bucketSql << "INSERT INTO simulation_trade_buckets "
-                     "(simulation_id, side, trade_count, win_count, profit_factor, "
-                     "avg_return_pct, max_drawdown_pct, notes)\n"
-                  << "VALUES ("
+        bucketSql << "("
                   << Quote(record.simulation_id) << ", "
                   << Quote(bucket.side) << ", "
                   << bucket.trade_count << ", "
@@ -982,25 +999,30 @@ void Stage1MetadataWriter::RecordSimulationRun(
                   << FormatDouble(bucket.profit_factor) << ", "
                   << FormatDouble(bucket.avg_return_pct) << ", "
                   << FormatDouble(bucket.max_drawdown_pct) << ", "
-                  << Quote(bucket.notes) << ")\n"
-                  << "ON CONFLICT (simulation_id, side) DO UPDATE SET\n"
-                  << "  trade_count = EXCLUDED.trade_count,\n"
-                  << "  win_count = EXCLUDED.win_count,\n"
-                  << "  profit_factor = EXCLUDED.profit_factor,\n"
-                  << "  avg_return_pct = EXCLUDED.avg_return_pct,\n"
-                  << "  max_drawdown_pct = EXCLUDED.max_drawdown_pct,\n"
-                  << "  notes = EXCLUDED.notes;\n\n";
-        AppendSql(bucketSql.str(), mode);
+                  << Quote(bucket.notes) << ")";
+        bucketRows.rows.emplace_back(record.simulation_id + ":" + bucket.side, bucketSql.str());
     }
-
+    AppendRows(std::move(bucketRows), mode);
+
+    stage1::SpoolRows tradeRows;
+    tradeRows.insert_prefix = "INSERT INTO simulation_trades "
+                              "(trade_id, simulation_id, bar_timestamp, side, size, "
+                              "entry_price, exit_price, pnl, return_pct, metadata)\nVALUES\n";
+    tradeRows.conflict_clause = "ON CONFLICT (trade_id) DO UPDATE SET\n"
+                                "  bar_timestamp = EXCLUDED.bar_timestamp,\n"
+                                "  side = EXCLUDED.side,\n"
+                                "  size = EXCLUDED.size,\n"
+                                "  entry_price = EXCLUDED.entry_price,\n"
+                                "  exit_price = EXCLUDED.exit_price,\n"
+                                "  pnl = EXCLUDED.pnl,\n"
+                                "  return_pct = EXCLUDED.return_pct,\n"
+                                "  metadata = EXCLUDED.metadata;\n\n";
+    tradeRows.rows.reserve(trades.size());
     for (std::size_t i = 0; i < trades.size(); ++i) {
         const auto& trade = trades[i];
         std::ostringstream tradeSql;
         std::string trade_id = MakeUuidFromSeed(record.simulation_id + ":trade:" + std::to_string(i + 1));
-        tradeSql << "INSERT INTO simulation_trades "
-                    "(trade_id, simulation_id, bar_timestamp, side, size, "
-                    "entry_price, exit_price, pnl, return_pct, metadata)\n"
-                 << "VALUES ("
+        tradeSql << "("
                  << Quote(trade_id) << ", "
                  << Quote(record.simulation_id) << ", "
                  << ToTimestampLiteral(static_cast<std::int64_t>(trade.entry_timestamp / 1000.0)) << ", "
@@ -1012,30 +1034,24 @@ void Stage1MetadataWriter::RecordSimulationRun(
                  << FormatDouble(trade.return_pct) << ", "
                  << Quote("{\"fold\":" + std::to_string(trade.fold_index) +
                           ",\"entry_signal\":" + FormatDouble(trade.entry_signal) +
-                          ",\"exit_signal\":" + FormatDouble(trade.exit_signal) + "}") << ")\n"
-                 << "ON CONFLICT (trade_id) DO UPDATE SET\n"
-                 << "  bar_timestamp = EXCLUDED.bar_timestamp,\n"
-                 << "  side = EXCLUDED.side,\n"
-                 << "  size = EXCLUDED.size,\n"
-                 << "  entry_price = EXCLUDED.entry_price,\n"
-                 << "  exit_price = EXCLUDED.exit_price,\n"
-                 << "  pnl = EXCLUDED.pnl,\n"
-                 << "  return_pct = EXCLUDED.return_pct,\n"
-                 << "  metadata = EXCLUDED.metadata;\n\n";
-        AppendSql(tradeSql.str(), mode);
+                          ",\"exit_signal\":" + FormatDouble(trade.exit_signal) + "}") << ")";
+        tradeRows.rows.emplace_back(std::move(trade_id), tradeSql.str());
     }
+    AppendRows(std::move(tradeRows), mode);
 }
 
 void Stage1MetadataWriter::AppendSql(const std::string& sql, PersistMode mode) {
     if (mode == PersistMode::DatabaseOnly) {
         return;
     }
-    std::lock_guard<std::mutex> lock(g_writerMutex);
-    std::ofstream out(m_spoolPath, std::ios::app);
-    if (!out) {
+    m_spool->AppendStatement(sql);
+}
+
+void Stage1MetadataWriter::AppendRows(stage1::SpoolRows rows, PersistMode mode) {
+    if (mode == PersistMode::DatabaseOnly) {
         return;
     }
-    out << sql;
+    m_spool->AppendRows(std::move(rows));
 }
 
 std::string Stage1MetadataWriter::MakeDeterministicUuid(const std::string& seed) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <optional>
@@ -10,11 +11,17 @@ namespace simulation {
 struct SimulationRun;
 struct FoldResult;
 } // namespace simulation
+namespace stage1 {
+class MetadataSpool;
+struct SpoolRows;
+} // namespace stage1
 
 // Lightweight helper that records Stage 1 metadata inserts so the frontend
 // Postgres instance can be hydrated once connectivity is available.
 // The implementation appends idempotent INSERT ... ON CONFLICT statements to
-// docs/fixtures/stage1_3/pending_postgres_inserts.sql.
+// docs/fixtures/stage1_3/pending_postgres_inserts.sql through a write-behind
+// spool, so recording never waits on the file; fold, bucket and trade rows
+// are written as multi-row INSERTs.
 class Stage1MetadataWriter {
 public:
     enum class PersistMode {
@@ -131,6 +138,10 @@ public:
     };
 
     static Stage1MetadataWriter& Instance();
+    ~Stage1MetadataWriter();
+
+    // Writes out everything still queued for the spool file
+    void Shutdown();
 
     static std::string MakeDeterministicUuid(const std::string& seed);
 
@@ -150,6 +161,7 @@ public:
 private:
     Stage1MetadataWriter();
     void AppendSql(const std::string& sql, PersistMode mode);
+    void AppendRows(stage1::SpoolRows rows, PersistMode mode);
     static std::string EscapeSql(const std::string& value);
     static std::string Quote(const std::string& value);
     static std::string ToTimestampLiteral(std::int64_t unix_seconds);
@@ -159,4 +171,5 @@ private:
     static std::string CurrentUsername();
 
     std::string m_spoolPath;
+    std::unique_ptr<stage1::MetadataSpool> m_spool;
 };
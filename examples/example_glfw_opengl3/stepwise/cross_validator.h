@@ -10,12 +10,12 @@ class CrossValidator {
 private:
     int n_folds_;
     
-    // Generate fold boundaries for cross-validation
-    void create_folds(int n_cases, std::vector<std::pair<int, int>>& folds) const;
-    
 public:
     explicit CrossValidator(int n_folds = 4) : n_folds_(n_folds) {}
     
+    // Generate fold boundaries [test_start, test_stop) for cross-validation
+    void create_folds(int n_cases, std::vector<std::pair<int, int>>& folds) const;
+    
     // Compute cross-validation criterion (R-square) for a feature set
     // Returns R-square value (1.0 - normalized_error)
     // The model is passed in as a dependency
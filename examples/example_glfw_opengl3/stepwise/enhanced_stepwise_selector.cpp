@@ -5,8 +5,11 @@
 #include <iomanip>
 #include <random>
 #include <chrono>
+#include <limits>
+#include <memory>
 #include <omp.h>
 #include "memory_pool.h"
+#include "monte_carlo_permutation_test.h"
 
 bool EnhancedStepwiseSelector::FeatureCombination::operator<(const FeatureCombination& other) const {
     return features < other.features;
@@ -146,8 +149,47 @@ EnhancedStepwiseSelector::SelectionResults EnhancedStepwiseSelector::select_feat
             }
         }
         
+        // --- Batched MCPT: all permuted targets in a block share each candidate's fold factorizations ---
+        if (config_.mcpt_replications > 1 && config_.incremental_evaluation) {
+            #ifdef _OPENMP
+            std::ostringstream parallel_msg;
+            parallel_msg << "Running " << (config_.mcpt_replications - 1) << " permutation replications as batched solves using "
+                         << omp_get_max_threads() << " threads";
+            SimpleLogger::Log(parallel_msg.str());
+            #endif
+            
+            const auto perm_type = (config_.mcpt_type == SelectionConfig::COMPLETE)
+                ? MonteCarloPermutationTest::COMPLETE : MonteCarloPermutationTest::CYCLIC;
+            const double normalized_prior = (prior_step_performance < 0.0) ? 0.0 : prior_step_performance;
+            
+            // One block at a time; its candidates are spread over the threads
+            const int block_size = MonteCarloPermutationTest::block_replications(ncases);
+            for (int first_rep = 1; first_rep < config_.mcpt_replications; first_rep += block_size) {
+                if (config_.cancel_callback && config_.cancel_callback()) {
+                    break;
+                }
+                
+                const int n_reps = std::min(block_size, config_.mcpt_replications - first_rep);
+                Eigen::MatrixXd permuted_targets =
+                    MonteCarloPermutationTest::build_permuted_targets(y, first_rep, n_reps, perm_type);
+                Eigen::VectorXd best = best_permuted_criteria(X, permuted_targets, current_best_sets, ncand);
+                
+                for (int c = 0; c < n_reps; ++c) {
+                    if (best(c) < 0.0) {
+                        continue;  // No candidate survived, same as an empty next_best_sets
+                    }
+                    double new_crit = best(c);
+                    if (new_crit >= original_crit) {
+                        mcpt_mod_count++;
+                    }
+                    if (new_crit - normalized_prior >= original_change) {
+                        mcpt_change_count++;
+                    }
+                }
+            }
+        }
         // --- Parallel MCPT Loop for permuted replications (irep = 1 to config_.mcpt_replications-1) ---
-        if (config_.mcpt_replications > 1) {
+        else if (config_.mcpt_replications > 1) {
             #ifdef _OPENMP
             int num_threads = omp_get_max_threads();
             std::ostringstream parallel_msg;
@@ -332,6 +374,12 @@ std::vector<FeatureSet> EnhancedStepwiseSelector::find_first_variable(
     }
 
     // STEP 2: Execute the tasks in parallel.
+    // The base set is empty, so one engine (intercept only) serves every candidate.
+    std::unique_ptr<IncrementalCvEngine> engine;
+    if (config_.incremental_evaluation) {
+        engine = std::make_unique<IncrementalCvEngine>(cv_, X, y, std::vector<int>{});
+    }
+
     std::vector<FeatureSet> candidate_sets;
     candidate_sets.reserve(tasks.size());
     omp_lock_t writelock;
@@ -341,9 +389,8 @@ std::vector<FeatureSet> EnhancedStepwiseSelector::find_first_variable(
     #pragma omp parallel for if(!omp_in_parallel())
     for (int i = 0; i < num_tasks; ++i) {
         const auto& feature_set_indices = tasks[i];
-        LinearQuadraticModel thread_local_model;
 
-        double performance = cv_.compute_criterion(thread_local_model, X, y, feature_set_indices);
+        double performance = evaluate_candidate(engine.get(), X, y, feature_set_indices, feature_set_indices[0]);
 
         if (performance >= 0) {
             FeatureSet fs;
@@ -385,9 +432,12 @@ std::vector<FeatureSet> EnhancedStepwiseSelector::add_next_variable(
 
     // STEP 1: Generate the list of unique tasks to be done. (This is fast)
     std::vector<std::vector<int>> tasks;
+    std::vector<int> task_base;       // Index into current_best that generated each task
+    std::vector<int> task_candidate;  // Variable added to that base set
     std::set<FeatureCombination> new_combos_this_step; // Use a local set to find unique new tasks
 
-    for (const auto& base_set : current_best) {
+    for (size_t base_idx = 0; base_idx < current_best.size(); ++base_idx) {
+        const auto& base_set = current_best[base_idx];
         for (int var_idx = 0; var_idx < n_candidates; ++var_idx) {
             if (std::find(base_set.get_features().begin(), base_set.get_features().end(), var_idx) != base_set.get_features().end()) {
                 continue;
@@ -405,12 +455,23 @@ std::vector<FeatureSet> EnhancedStepwiseSelector::add_next_variable(
                 new_combos_this_step.find(combo) == new_combos_this_step.end()) {
                 
                 tasks.push_back(new_features);
+                task_base.push_back(static_cast<int>(base_idx));
+                task_candidate.push_back(var_idx);
                 new_combos_this_step.insert(combo);
             }
         }
     }
 
     // STEP 2: Execute the tasks in parallel.
+    // Factor each base set's per-fold Gram matrices once; candidates are bordered updates.
+    std::vector<std::unique_ptr<IncrementalCvEngine>> engines(current_best.size());
+    if (config_.incremental_evaluation) {
+        for (size_t base_idx = 0; base_idx < current_best.size(); ++base_idx) {
+            engines[base_idx] = std::make_unique<IncrementalCvEngine>(
+                cv_, X, y, current_best[base_idx].get_features());
+        }
+    }
+
     std::vector<FeatureSet> new_candidate_sets;
     new_candidate_sets.reserve(tasks.size());
     omp_lock_t writelock;
@@ -420,9 +481,9 @@ std::vector<FeatureSet> EnhancedStepwiseSelector::add_next_variable(
     #pragma omp parallel for if(!omp_in_parallel())
     for (int i = 0; i < num_tasks; ++i) {
         const auto& feature_set_indices = tasks[i];
-        LinearQuadraticModel thread_local_model;
 
-        double performance = cv_.compute_criterion(thread_local_model, X, y, feature_set_indices);
+        double performance = evaluate_candidate(engines[task_base[i]].get(), X, y,
+                                                feature_set_indices, task_candidate[i]);
         
         if (performance >= 0) {
             FeatureSet fs;
@@ -449,6 +510,102 @@ std::vector<FeatureSet> EnhancedStepwiseSelector::add_next_variable(
 }
 
 
+Eigen::VectorXd EnhancedStepwiseSelector::best_permuted_criteria(
+    const DataMatrix& X,
+    const Eigen::MatrixXd& permuted_targets,
+    const std::vector<FeatureSet>& current_best,
+    int n_candidates) const {
+    
+    const int n_targets = static_cast<int>(permuted_targets.cols());
+    Eigen::VectorXd best = Eigen::VectorXd::Constant(n_targets, -std::numeric_limits<double>::infinity());
+    
+    // Same task list as find_first_variable / add_next_variable on a fresh tested set
+    std::vector<std::vector<int>> bases;
+    if (current_best.empty()) {
+        bases.emplace_back();
+    } else {
+        for (const auto& base_set : current_best) {
+            bases.push_back(base_set.get_features());
+        }
+    }
+    
+    std::vector<std::vector<int>> tasks;
+    std::vector<int> task_base;
+    std::vector<int> task_candidate;
+    std::set<FeatureCombination> unique_combos;
+    for (size_t base_idx = 0; base_idx < bases.size(); ++base_idx) {
+        for (int var_idx = 0; var_idx < n_candidates; ++var_idx) {
+            if (std::find(bases[base_idx].begin(), bases[base_idx].end(), var_idx) != bases[base_idx].end()) {
+                continue;
+            }
+            FeatureCombination combo;
+            combo.features = bases[base_idx];
+            combo.features.push_back(var_idx);
+            std::sort(combo.features.begin(), combo.features.end());
+            if (unique_combos.insert(combo).second) {
+                tasks.push_back(combo.features);
+                task_base.push_back(static_cast<int>(base_idx));
+                task_candidate.push_back(var_idx);
+            }
+        }
+    }
+    
+    // One factorization per base and fold covers every permuted target column
+    std::vector<std::unique_ptr<IncrementalCvEngine>> engines(bases.size());
+    for (size_t base_idx = 0; base_idx < bases.size(); ++base_idx) {
+        engines[base_idx] = std::make_unique<IncrementalCvEngine>(cv_, X, permuted_targets, bases[base_idx]);
+    }
+    
+    int num_tasks = static_cast<int>(tasks.size());
+    #pragma omp parallel
+    {
+        Eigen::VectorXd local_best = Eigen::VectorXd::Constant(n_targets, -std::numeric_limits<double>::infinity());
+        Eigen::VectorXd criteria;
+        std::vector<double> column(permuted_targets.rows());
+        
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < num_tasks; ++i) {
+            if (!engines[task_base[i]]->evaluate_candidate(task_candidate[i], criteria)) {
+                // Singular update: refit each target column through the QR/SVD path
+                criteria.resize(n_targets);
+                for (int c = 0; c < n_targets; ++c) {
+                    Eigen::VectorXd::Map(column.data(), permuted_targets.rows()) = permuted_targets.col(c);
+                    LinearQuadraticModel thread_local_model;
+                    criteria(c) = cv_.compute_criterion(thread_local_model, X, column, tasks[i]);
+                }
+            }
+            for (int c = 0; c < n_targets; ++c) {
+                // Candidates below zero are discarded, as in find_first_variable / add_next_variable
+                if (criteria(c) >= 0.0 && criteria(c) > local_best(c)) {
+                    local_best(c) = criteria(c);
+                }
+            }
+        }
+        
+        #pragma omp critical
+        best = best.cwiseMax(local_best);
+    }
+    
+    return best;
+}
+
+double EnhancedStepwiseSelector::evaluate_candidate(
+    const IncrementalCvEngine* engine,
+    const DataMatrix& X,
+    const std::vector<double>& y,
+    const std::vector<int>& feature_set_indices,
+    int candidate) const {
+    
+    double performance = 0.0;
+    if (engine && engine->evaluate_candidate(candidate, performance)) {
+        return performance;
+    }
+    
+    // Singular or ill-conditioned update: full refit handles it through QR/SVD
+    LinearQuadraticModel thread_local_model;
+    return cv_.compute_criterion(thread_local_model, X, y, feature_set_indices);
+}
+
 void EnhancedStepwiseSelector::log_step_results(
     int step_number,
     const SelectionStep& step) const {
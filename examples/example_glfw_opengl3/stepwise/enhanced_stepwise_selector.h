@@ -7,6 +7,7 @@
 #include "data_matrix.h"
 #include "cross_validator.h"
 #include "linear_quadratic_model.h"
+#include "incremental_cv_engine.h"
 #include "../simple_logger.h"
 
 // Enhanced stepwise feature selection algorithm
@@ -21,6 +22,7 @@ public:
         enum PermutationType { COMPLETE = 1, CYCLIC = 2 };
         PermutationType mcpt_type = COMPLETE;  // Permutation type
         bool early_termination = true;     // Stop if performance degrades
+        bool incremental_evaluation = true; // Score candidates by bordered Cholesky updates of per-fold Gram matrices
         std::function<bool()> cancel_callback; // Optional cancellation callback
     };
     
@@ -46,6 +48,24 @@ private:
     SelectionConfig config_;
     CrossValidator cv_;
     
+    // Cross-validated criterion for base + {candidate}; uses the incremental engine when possible
+    double evaluate_candidate(
+        const IncrementalCvEngine* engine,
+        const DataMatrix& X,
+        const std::vector<double>& y,
+        const std::vector<int>& feature_set_indices,
+        int candidate
+    ) const;
+    
+    // Best next-step criterion over all candidates, for each permuted target column.
+    // Entries stay at -infinity when no candidate reached a non-negative criterion.
+    Eigen::VectorXd best_permuted_criteria(
+        const DataMatrix& X,
+        const Eigen::MatrixXd& permuted_targets,
+        const std::vector<FeatureSet>& current_best,
+        int n_candidates
+    ) const;
+    
     // Feature combination structure (now used locally)
     struct FeatureCombination {
         std::vector<int> features;
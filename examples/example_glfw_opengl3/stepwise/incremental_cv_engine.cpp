@@ -0,0 +1,211 @@
+#include "incremental_cv_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <Eigen/Cholesky>
+#include "linear_quadratic_model.h"
+
+namespace {
+
+// Relative pivot floor below which a bordered factor is treated as singular
+constexpr double kPivotTolerance = 1e-10;
+
+bool factor_is_usable(const Eigen::LLT<Eigen::MatrixXd>& llt, const Eigen::MatrixXd& gram) {
+    if (llt.info() != Eigen::Success) {
+        return false;
+    }
+    const double scale = gram.diagonal().cwiseAbs().maxCoeff();
+    const Eigen::MatrixXd& L = llt.matrixLLT();
+    for (int i = 0; i < L.rows(); ++i) {
+        const double pivot = L(i, i);
+        if (!(pivot * pivot > kPivotTolerance * scale)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Per-thread buffers for evaluate_candidate. Shapes only change with the
+// base set or the target block, so after a thread's first candidate the
+// products and solves below write into existing storage.
+struct CandidateWorkspace {
+    Eigen::MatrixXd B;             // Candidate columns, n_cases x k
+    Eigen::MatrixXd full_cross;    // A'B
+    Eigen::MatrixXd full_bgram;    // B'B
+    Eigen::MatrixXd full_bty;      // B'Y
+    Eigen::MatrixXd cross;
+    Eigen::MatrixXd bgram;
+    Eigen::MatrixXd L12;
+    Eigen::MatrixXd schur;
+    Eigen::MatrixXd beta1;
+    Eigen::MatrixXd beta2;
+    Eigen::MatrixXd residual;      // Largest fold's n_test x n_targets
+    Eigen::LLT<Eigen::MatrixXd> llt;
+};
+
+} // namespace
+
+IncrementalCvEngine::IncrementalCvEngine(
+    const CrossValidator& cv,
+    const DataMatrix& X,
+    const std::vector<double>& y,
+    const std::vector<int>& base_features)
+    : X_(&X),
+      base_features_(base_features),
+      targets_(Eigen::Map<const Eigen::MatrixXd>(y.data(), static_cast<Eigen::Index>(y.size()), 1)),
+      n_cases_(static_cast<int>(y.size())),
+      ready_(false) {
+    initialize(cv);
+}
+
+IncrementalCvEngine::IncrementalCvEngine(
+    const CrossValidator& cv,
+    const DataMatrix& X,
+    const Eigen::Ref<const Eigen::MatrixXd>& Y,
+    const std::vector<int>& base_features)
+    : X_(&X),
+      base_features_(base_features),
+      targets_(Y),
+      n_cases_(static_cast<int>(targets_.rows())),
+      ready_(false) {
+    initialize(cv);
+}
+
+void IncrementalCvEngine::initialize(const CrossValidator& cv) {
+    if (n_cases_ <= cv.get_n_folds() || targets_.cols() == 0) {
+        return;
+    }
+
+    // Same term order as LinearQuadraticModel: linear, square, interaction, intercept
+    const int npred = static_cast<int>(base_features_.size());
+    const int n_terms = LinearQuadraticModel::get_n_terms(npred);
+    base_design_.resize(n_cases_, n_terms);
+    int col = 0;
+    for (int p = 0; p < npred; ++p) {
+        base_design_.col(col++) = Eigen::Map<const Eigen::VectorXd>(X_->get_column(base_features_[p]), n_cases_);
+    }
+    for (int p = 0; p < npred; ++p) {
+        base_design_.col(col++) = base_design_.col(p).array().square();
+    }
+    for (int p1 = 0; p1 < npred; ++p1) {
+        for (int p2 = p1 + 1; p2 < npred; ++p2) {
+            base_design_.col(col++) = base_design_.col(p1).array() * base_design_.col(p2).array();
+        }
+    }
+    base_design_.col(col).setOnes();
+
+    const Eigen::MatrixXd full_gram = base_design_.transpose() * base_design_;
+    const Eigen::MatrixXd full_aty = base_design_.transpose() * targets_;
+
+    std::vector<std::pair<int, int>> fold_bounds;
+    cv.create_folds(n_cases_, fold_bounds);
+    folds_.resize(fold_bounds.size());
+
+    for (size_t f = 0; f < fold_bounds.size(); ++f) {
+        FoldState& fold = folds_[f];
+        fold.test_start = fold_bounds[f].first;
+        fold.test_stop = fold_bounds[f].second;
+        const int n_test = fold.test_stop - fold.test_start;
+
+        auto test_rows = base_design_.middleRows(fold.test_start, n_test);
+        const Eigen::MatrixXd train_gram = full_gram - test_rows.transpose() * test_rows;
+        Eigen::LLT<Eigen::MatrixXd> llt(train_gram);
+        if (!factor_is_usable(llt, train_gram)) {
+            folds_.clear();
+            return;
+        }
+        fold.chol = llt.matrixL();
+        fold.z = fold.chol.triangularView<Eigen::Lower>().solve(
+            full_aty - test_rows.transpose() * targets_.middleRows(fold.test_start, n_test));
+    }
+
+    ready_ = true;
+}
+
+void IncrementalCvEngine::build_candidate_columns(Eigen::Ref<Eigen::MatrixXd> B, int candidate) const {
+    const Eigen::Map<const Eigen::VectorXd> x(X_->get_column(candidate), n_cases_);
+    B.col(0) = x;
+    B.col(1) = x.array().square();
+    for (size_t p = 0; p < base_features_.size(); ++p) {
+        B.col(2 + static_cast<int>(p)) = x.array() * base_design_.col(static_cast<int>(p)).array();
+    }
+}
+
+bool IncrementalCvEngine::evaluate_candidate(int candidate, double& criterion) const {
+    Eigen::VectorXd criteria;
+    if (!evaluate_candidate(candidate, criteria)) {
+        return false;
+    }
+    criterion = criteria(0);
+    return true;
+}
+
+bool IncrementalCvEngine::evaluate_candidate(int candidate, Eigen::VectorXd& criteria) const {
+    if (!ready_) {
+        return false;
+    }
+
+    const int k = 2 + static_cast<int>(base_features_.size());
+    const Eigen::Index n_targets = targets_.cols();
+
+    static thread_local CandidateWorkspace ws;
+    ws.B.resize(n_cases_, k);
+    build_candidate_columns(ws.B, candidate);
+    const Eigen::MatrixXd& B = ws.B;
+
+    ws.full_cross.noalias() = base_design_.transpose() * B;
+    ws.full_bgram.noalias() = B.transpose() * B;
+    ws.full_bty.noalias() = B.transpose() * targets_;
+
+    int max_test = 0;
+    for (const FoldState& fold : folds_) {
+        max_test = std::max(max_test, fold.test_stop - fold.test_start);
+    }
+    ws.residual.resize(max_test, n_targets);
+
+    Eigen::VectorXd total_error = Eigen::VectorXd::Zero(n_targets);
+    for (const FoldState& fold : folds_) {
+        const int n_test = fold.test_stop - fold.test_start;
+        auto A_test = base_design_.middleRows(fold.test_start, n_test);
+        auto B_test = B.middleRows(fold.test_start, n_test);
+        auto Y_test = targets_.middleRows(fold.test_start, n_test);
+
+        // Training cross products = full minus test block
+        ws.cross = ws.full_cross;
+        ws.cross.noalias() -= A_test.transpose() * B_test;
+        ws.bgram = ws.full_bgram;
+        ws.bgram.noalias() -= B_test.transpose() * B_test;
+        ws.beta2 = ws.full_bty;
+        ws.beta2.noalias() -= B_test.transpose() * Y_test;
+
+        // Bordered Cholesky: [L 0; L12' L22] factors [A'A A'B; B'A B'B]
+        ws.L12 = ws.cross;
+        fold.chol.triangularView<Eigen::Lower>().solveInPlace(ws.L12);
+        ws.schur = ws.bgram;
+        ws.schur.noalias() -= ws.L12.transpose() * ws.L12;
+        ws.llt.compute(ws.schur);
+        if (!factor_is_usable(ws.llt, ws.bgram)) {
+            return false;
+        }
+
+        ws.beta2.noalias() -= ws.L12.transpose() * fold.z;
+        ws.llt.matrixL().solveInPlace(ws.beta2);
+        ws.llt.matrixU().solveInPlace(ws.beta2);
+        ws.beta1 = fold.z;
+        ws.beta1.noalias() -= ws.L12 * ws.beta2;
+        fold.chol.transpose().triangularView<Eigen::Upper>().solveInPlace(ws.beta1);
+
+        auto residual = ws.residual.topRows(n_test);
+        residual = Y_test;
+        residual.noalias() -= A_test * ws.beta1;
+        residual.noalias() -= B_test * ws.beta2;
+        total_error += residual.colwise().squaredNorm().transpose();
+    }
+
+    if (!total_error.allFinite()) {
+        return false;
+    }
+
+    // Same criterion as CrossValidator::compute_criterion
+    criteria = Eigen::VectorXd::Ones(n_targets) - total_error / static_cast<double>(n_cases_);
+    return true;
+}
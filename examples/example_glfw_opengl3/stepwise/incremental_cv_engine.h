@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <Eigen/Dense>
+#include "data_matrix.h"
+#include "cross_validator.h"
+
+// Candidate-evaluation engine for stepwise selection.
+//
+// Holds, for one base feature set, the linear-quadratic design matrix and the
+// per-fold training Gram matrices (A'A, A'Y) with their Cholesky factors.
+// Adding a candidate variable appends its linear, square and interaction
+// columns; the cross-validated criterion is then obtained with a bordered
+// Cholesky update of each fold's factor instead of refitting from scratch.
+//
+// Y may hold several target columns (e.g. permuted replications for MCPT);
+// every column shares the same factorization and is solved as one
+// multiple-right-hand-side system. Like X, the targets are referenced, not
+// copied, so several engines can share one n x R block; they must outlive
+// the engine.
+//
+// The result matches CrossValidator::compute_criterion up to rounding. When a
+// bordered factor is not positive definite, evaluate_candidate() returns false
+// and the caller should fall back to the full refit, which handles rank
+// deficiency through QR/SVD.
+class IncrementalCvEngine {
+private:
+    struct FoldState {
+        int test_start = 0;
+        int test_stop = 0;
+        Eigen::MatrixXd chol;      // Lower Cholesky factor of training A'A
+        Eigen::MatrixXd z;         // chol^-1 * (training A'Y)
+    };
+
+    const DataMatrix* X_;
+    std::vector<int> base_features_;
+    Eigen::MatrixXd base_design_;  // n_cases x n_terms(base), intercept included
+    Eigen::Ref<const Eigen::MatrixXd> targets_;  // n_cases x n_targets, not owned
+    std::vector<FoldState> folds_;
+    int n_cases_;
+    bool ready_;
+
+    void initialize(const CrossValidator& cv);
+
+    // Linear, square and base-interaction columns contributed by one candidate
+    void build_candidate_columns(Eigen::Ref<Eigen::MatrixXd> B, int candidate) const;
+
+public:
+    IncrementalCvEngine(
+        const CrossValidator& cv,
+        const DataMatrix& X,
+        const std::vector<double>& y,
+        const std::vector<int>& base_features
+    );
+
+    // One target per column of Y
+    IncrementalCvEngine(
+        const CrossValidator& cv,
+        const DataMatrix& X,
+        const Eigen::Ref<const Eigen::MatrixXd>& Y,
+        const std::vector<int>& base_features
+    );
+
+    // False when the base set itself could not be factorized (use full refit)
+    bool ready() const { return ready_; }
+
+    const std::vector<int>& get_base_features() const { return base_features_; }
+    int get_n_targets() const { return static_cast<int>(targets_.cols()); }
+
+    // Cross-validated R-square of base_features + {candidate} for the first target.
+    // Thread-safe; candidate columns and fold solves use a per-thread workspace
+    // that is reused from one candidate to the next.
+    // Returns false if the incremental update is numerically unusable.
+    bool evaluate_candidate(int candidate, double& criterion) const;
+
+    // Same, for every target column at once (criteria is resized to n_targets)
+    bool evaluate_candidate(int candidate, Eigen::VectorXd& criteria) const;
+};
@@ -1,7 +1,11 @@
 #include "monte_carlo_permutation_test.h"
 #include "linear_quadratic_model.h"
+#include "incremental_cv_engine.h"
 #include <algorithm>
 #include <stdexcept>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // Legacy random number generator implementation (same as RAND32.CPP)
 double MonteCarloPermutationTest::fast_unif(int* iparam) {
@@ -41,39 +45,73 @@ MonteCarloPermutationTest::MCPTResults MonteCarloPermutationTest::compute_signif
     double clamped_prior = (prior_performance < 0.0) ? 0.0 : prior_performance;
     double observed_change = clamped_observed - clamped_prior;
     
-    // Perform permutation replications
-    for (int irep = 1; irep < n_replications_; ++irep) {  // Start from 1 (skip unpermuted)
-        // Create copy of targets for permutation
-        std::vector<double> permuted_targets = y;
-        
-        // Permute targets using deterministic seed based on replication number
-        if (permutation_type_ == COMPLETE) {
-            permute_targets_complete(permuted_targets, irep);
-        } else {
-            permute_targets_cyclic(permuted_targets, irep);
-        }
+    const int n_permuted = n_replications_ - 1;
+    
+    int n_threads = 1;
+    #ifdef _OPENMP
+    n_threads = omp_get_max_threads();
+    #endif
+    const int block_size = std::max(1, std::min(block_replications(static_cast<int>(y.size()), n_threads),
+                                                (n_permuted + n_threads - 1) / std::max(1, n_threads)));
+    const int n_blocks = n_permuted > 0 ? (n_permuted + block_size - 1) / block_size : 0;
+    
+    // The full feature set is split as base + last feature so the incremental engine
+    // can factor the base once and border it with the remaining columns.
+    std::vector<int> base_features;
+    int last_feature = -1;
+    if (!current_features.empty()) {
+        base_features.assign(current_features.begin(), current_features.end() - 1);
+        last_feature = current_features.back();
+    }
+    
+    int model_count = 0;
+    int change_count = 0;
+    
+    #pragma omp parallel for schedule(dynamic) reduction(+:model_count, change_count)
+    for (int block = 0; block < n_blocks; ++block) {
+        const int first_rep = 1 + block * block_size;  // Start from 1 (skip unpermuted)
+        const int n_reps = std::min(block_size, n_replications_ - first_rep);
         
-        // Compute performance on permuted data
-        LinearQuadraticModel model;  // Create model instance for this iteration
-        double permuted_performance = cv_.compute_criterion(model, X, permuted_targets, current_features);
+        Eigen::MatrixXd permuted = build_permuted_targets(y, first_rep, n_reps, permutation_type_);
         
-        // Clamp negative performance for conservative test
-        if (permuted_performance < 0.0) {
-            permuted_performance = 0.0;
+        Eigen::VectorXd criteria;
+        bool solved = false;
+        if (last_feature >= 0) {
+            IncrementalCvEngine engine(cv_, X, permuted, base_features);
+            solved = engine.evaluate_candidate(last_feature, criteria);
         }
         
-        // Update model p-value counter
-        if (permuted_performance >= clamped_observed) {
-            results.model_count++;
+        if (!solved) {
+            // Rank-deficient design: refit each replication through the QR/SVD path
+            criteria.resize(n_reps);
+            std::vector<double> permuted_targets(y.size());
+            for (int c = 0; c < n_reps; ++c) {
+                Eigen::VectorXd::Map(permuted_targets.data(), permuted.rows()) = permuted.col(c);
+                LinearQuadraticModel model;
+                criteria(c) = cv_.compute_criterion(model, X, permuted_targets, current_features);
+            }
         }
         
-        // Update change p-value counter
-        double permuted_change = permuted_performance - clamped_prior;
-        if (permuted_change >= observed_change) {
-            results.change_count++;
+        for (int c = 0; c < n_reps; ++c) {
+            // Clamp negative performance for conservative test
+            double permuted_performance = std::max(0.0, criteria(c));
+            
+            // Update model p-value counter
+            if (permuted_performance >= clamped_observed) {
+                model_count++;
+            }
+            
+            // Update change p-value counter
+            double permuted_change = permuted_performance - clamped_prior;
+            if (permuted_change >= observed_change) {
+                change_count++;
+            }
         }
     }
     
+    results.model_count += model_count;
+    results.change_count += change_count;
+    
     // Compute p-values
     results.model_p_value = static_cast<double>(results.model_count) / n_replications_;
     results.change_p_value = static_cast<double>(results.change_count) / n_replications_;
@@ -81,6 +119,50 @@ MonteCarloPermutationTest::MCPTResults MonteCarloPermutationTest::compute_signif
     return results;
 }
 
+int MonteCarloPermutationTest::block_replications(int n_cases, int concurrent_blocks) {
+    const size_t per_block = MAX_BLOCK_DOUBLES / static_cast<size_t>(std::max(1, concurrent_blocks));
+    const size_t columns = per_block / static_cast<size_t>(std::max(1, n_cases));
+    return static_cast<int>(std::clamp<size_t>(columns, 1, MAX_BLOCK_REPLICATIONS));
+}
+
+Eigen::MatrixXd MonteCarloPermutationTest::build_permuted_targets(
+    const std::vector<double>& y,
+    int first_rep,
+    int n_reps,
+    PermutationType perm_type) {
+    
+    const int n = static_cast<int>(y.size());
+    Eigen::MatrixXd permuted(n, std::max(0, n_reps));
+    const Eigen::Map<const Eigen::VectorXd> original(y.data(), n);
+    
+    for (int c = 0; c < n_reps; ++c) {
+        int irand = 17 * (first_rep + c) + 11;
+        fast_unif(&irand);  // Warm up generator
+        fast_unif(&irand);  // Warm up generator again
+        
+        auto column = permuted.col(c);
+        if (perm_type == COMPLETE) {
+            // Fisher-Yates shuffle, identical to permute_targets_complete
+            column = original;
+            for (int i = n - 1; i > 0; --i) {
+                int j = static_cast<int>(fast_unif(&irand) * (i + 1));
+                if (j > i) j = i;
+                if (i != j) {
+                    std::swap(column(i), column(j));
+                }
+            }
+        } else {
+            // Cyclic rotation, identical to permute_targets_cyclic
+            int offset = (n > 1) ? static_cast<int>(fast_unif(&irand) * n) : 0;
+            if (offset >= n) offset = n - 1;
+            column.head(n - offset) = original.tail(n - offset);
+            column.tail(offset) = original.head(offset);
+        }
+    }
+    
+    return permuted;
+}
+
 void MonteCarloPermutationTest::permute_targets_complete(
     std::vector<double>& targets, int seed) const {
     
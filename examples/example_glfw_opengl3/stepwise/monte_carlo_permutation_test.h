@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
+#include <Eigen/Dense>
 #include "data_matrix.h"
 #include "cross_validator.h"
 
@@ -12,6 +14,18 @@ public:
         CYCLIC = 2     // Cyclic permutation (for serial correlation)
     };
     
+    // Upper bound on permuted target columns solved together
+    static constexpr int MAX_BLOCK_REPLICATIONS = 256;
+    
+    // Memory budget for the blocks in flight at once, in doubles (64 MB). A block
+    // holds n_cases x columns permuted targets, and each solving thread keeps a
+    // residual workspace of at most the same size.
+    static constexpr size_t MAX_BLOCK_DOUBLES = size_t(8) << 20;
+    
+    // Replications per block for n_cases rows when concurrent_blocks blocks are
+    // held at once: MAX_BLOCK_DOUBLES split between them, 1 to MAX_BLOCK_REPLICATIONS
+    static int block_replications(int n_cases, int concurrent_blocks = 1);
+    
     struct MCPTResults {
         double model_p_value;     // P-value for overall model performance
         double change_p_value;    // P-value for performance improvement
@@ -39,7 +53,19 @@ public:
         int n_folds = 4
     ) : n_replications_(n_replications), permutation_type_(perm_type), cv_(n_folds) {}
     
-    // Compute statistical significance of feature set performance
+    // Permuted copies of y for replications [first_rep, first_rep + n_reps), one per column.
+    // Replication irep uses the same fast_unif stream (seed 17 * irep + 11) as the serial path,
+    // so any split of replications across threads reproduces identical permutations.
+    static Eigen::MatrixXd build_permuted_targets(
+        const std::vector<double>& y,
+        int first_rep,
+        int n_reps,
+        PermutationType perm_type
+    );
+    
+    // Compute statistical significance of feature set performance.
+    // Each fold's design matrix is factorized once per block of replications and all
+    // permuted targets in the block are solved together; blocks run in parallel.
     MCPTResults compute_significance(
         const DataMatrix& X,
         const std::vector<double>& y,
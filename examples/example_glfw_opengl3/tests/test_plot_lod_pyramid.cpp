@@ -0,0 +1,178 @@
+// Checks MinMaxPyramid, DecimateLine and AggregateOhlc against brute force
+// over random series with NaN gaps. Exits non-zero on any mismatch.
+#include "PlotLodPyramid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace plot_lod;
+
+namespace {
+
+int g_failures = 0;
+
+void Fail(const char* what, size_t n, size_t begin, size_t end) {
+    if (g_failures++ < 20) {
+        std::cerr << "FAIL " << what << " (n=" << n << ", range " << begin << ".." << end << ")\n";
+    }
+}
+
+struct Series {
+    std::vector<double> x, y, open, high, low, close, volume, volumePrefix;
+};
+
+Series MakeSeries(std::mt19937_64& rng, size_t n) {
+    Series s;
+    s.x.resize(n);
+    s.y.resize(n);
+    s.open.resize(n);
+    s.high.resize(n);
+    s.low.resize(n);
+    s.close.resize(n);
+    s.volume.resize(n);
+    s.volumePrefix.assign(n + 1, 0.0);
+    std::normal_distribution<double> step(0.0, 1.0);
+    double value = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        value += step(rng);
+        s.x[i] = 1e9 + 60.0 * static_cast<double>(i);
+        s.y[i] = rng() % 50 == 0 ? std::numeric_limits<double>::quiet_NaN() : value;
+        s.open[i] = value;
+        s.close[i] = value + 0.3;
+        s.low[i] = value - 1.0 - static_cast<double>(rng() % 10) * 0.1;
+        s.high[i] = value + 1.0 + static_cast<double>(rng() % 10) * 0.1;
+        s.volume[i] = static_cast<double>(rng() % 100);
+        s.volumePrefix[i + 1] = s.volumePrefix[i] + s.volume[i];
+    }
+    return s;
+}
+
+bool BruteMinMax(const std::vector<double>& y, size_t begin, size_t end, double* lo, double* hi) {
+    *lo = std::numeric_limits<double>::infinity();
+    *hi = -std::numeric_limits<double>::infinity();
+    for (size_t i = begin; i < end; ++i) {
+        if (!std::isnan(y[i])) {
+            *lo = std::min(*lo, y[i]);
+            *hi = std::max(*hi, y[i]);
+        }
+    }
+    return *lo <= *hi;
+}
+
+void CheckLine(const Series& s, const MinMaxPyramid& pyramid, size_t begin, size_t end) {
+    const size_t n = s.y.size();
+    double lo = 0.0, hi = 0.0, bruteLo = 0.0, bruteHi = 0.0;
+    const bool found = pyramid.RangeMinMax(begin, end, &lo, &hi);
+    const bool bruteFound = BruteMinMax(s.y, begin, end, &bruteLo, &bruteHi);
+    if (found != bruteFound || (found && (lo != bruteLo || hi != bruteHi))) {
+        Fail("RangeMinMax", n, begin, end);
+    }
+    if (end <= begin) {
+        return;
+    }
+
+    for (double width : { 50.0, 400.0, 1900.0 }) {
+        const int level = PickLevel(begin, end, width / 2.0, pyramid.LevelCount());
+        std::vector<double> outX, outY;
+        DecimateLine(pyramid, s.x.data(), s.y.data(), begin, end, level, &outX, &outY);
+        if (outX.size() != outY.size() || outX.empty()) {
+            Fail("DecimateLine size", n, begin, end);
+            continue;
+        }
+        if (static_cast<double>(outX.size()) > std::max(static_cast<double>(end - begin), 2.0 * width)) {
+            Fail("DecimateLine point budget", n, begin, end);
+        }
+        if (!std::is_sorted(outX.begin(), outX.end()) ||
+            std::adjacent_find(outX.begin(), outX.end()) != outX.end()) {
+            Fail("DecimateLine x order", n, begin, end);
+        }
+        // Edge buckets may reach past the range, so only containment holds
+        double decLo = std::numeric_limits<double>::infinity();
+        double decHi = -std::numeric_limits<double>::infinity();
+        for (double v : outY) {
+            if (!std::isnan(v)) {
+                decLo = std::min(decLo, v);
+                decHi = std::max(decHi, v);
+            }
+        }
+        if (bruteFound && (decLo > bruteLo || decHi < bruteHi)) {
+            Fail("DecimateLine lost extrema", n, begin, end);
+        }
+        if (outX.front() > s.x[begin] || outX.back() < s.x[end - 1]) {
+            Fail("DecimateLine lost end points", n, begin, end);
+        }
+    }
+}
+
+void CheckOhlc(const Series& s, const MinMaxPyramid& candles, size_t begin, size_t end) {
+    const size_t n = s.x.size();
+    const int level = PickLevel(begin, end, 800.0, candles.LevelCount());
+    OhlcBuckets buckets;
+    AggregateOhlc(candles, s.x.data(), s.open.data(), s.close.data(), s.volumePrefix.data(),
+                  begin, end, level, &buckets);
+    if (buckets.Size() == 0 || (level > 0 && buckets.Size() > 800)) {
+        Fail("AggregateOhlc bucket count", n, begin, end);
+        return;
+    }
+
+    // The buckets cover whole level-aligned spans around [begin, end)
+    const size_t span = size_t(1) << level;
+    const size_t first = (begin >> level) * span;
+    const size_t last = std::min(((end - 1) >> level) * span + span, n);
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    double volume = 0.0;
+    for (size_t i = first; i < last; ++i) {
+        lo = std::min(lo, s.low[i]);
+        hi = std::max(hi, s.high[i]);
+        volume += s.volume[i];
+    }
+    double bucketVolume = 0.0;
+    for (double v : buckets.volume) {
+        bucketVolume += v;
+    }
+    if (*std::min_element(buckets.low.begin(), buckets.low.end()) != lo ||
+        *std::max_element(buckets.high.begin(), buckets.high.end()) != hi ||
+        bucketVolume != volume ||
+        buckets.open.front() != s.open[first] ||
+        buckets.close.back() != s.close[last - 1]) {
+        Fail("AggregateOhlc", n, begin, end);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng(7);
+    for (int trial = 0; trial < 300; ++trial) {
+        const size_t n = 1 + rng() % (trial < 200 ? 3000 : 200000);
+        const Series s = MakeSeries(rng, n);
+
+        MinMaxPyramid line;
+        line.Build(s.y.data(), s.y.data(), n);
+        for (int query = 0; query < 50; ++query) {
+            const size_t begin = rng() % n;
+            const size_t end = begin + rng() % (n - begin + 1);
+            CheckLine(s, line, begin, end);
+        }
+
+        MinMaxPyramid candles;
+        candles.Build(s.low.data(), s.high.data(), n);
+        for (int query = 0; query < 20; ++query) {
+            const size_t begin = rng() % n;
+            const size_t end = begin + 1 + rng() % (n - begin);
+            CheckOhlc(s, candles, begin, end);
+        }
+    }
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " PlotLodPyramid checks failed\n";
+        return 1;
+    }
+    std::cout << "PlotLodPyramid: all checks passed\n";
+    return 0;
+}
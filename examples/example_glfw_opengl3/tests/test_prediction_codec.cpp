@@ -0,0 +1,213 @@
+// Round-trips walk-forward runs through EncodeWalkforwardPredictions and
+// DecodeWalkforwardPredictions and compares every row with the rows the
+// export rules predict. Also decodes chunked tables and the column aliases
+// of older exports. Exits non-zero on any mismatch.
+#include "QuestDbPredictionCodec.h"
+
+#include <arrow/api.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using questdb::WalkforwardPredictionSeries;
+using Entry = WalkforwardPredictionSeries::Entry;
+
+namespace {
+
+constexpr float kNaNf = std::numeric_limits<float>::quiet_NaN();
+constexpr float kInff = std::numeric_limits<float>::infinity();
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+int g_failures = 0;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+bool Same(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+bool SameEntry(const Entry& a, const Entry& b) {
+    return a.timestamp_ms == b.timestamp_ms && a.bar_index == b.bar_index && a.fold_number == b.fold_number &&
+           Same(a.prediction, b.prediction) && Same(a.target, b.target) &&
+           Same(a.long_threshold, b.long_threshold) && Same(a.short_threshold, b.short_threshold) &&
+           Same(a.roc_threshold, b.roc_threshold) && Same(a.short_entry_threshold, b.short_entry_threshold) &&
+           Same(a.fold_score, b.fold_score) && Same(a.fold_profit_factor, b.fold_profit_factor);
+}
+
+double Finite(float value) {
+    return std::isfinite(value) ? static_cast<double>(value) : kNaN;
+}
+
+// Folds with NaN and infinite fold values, rows without a timestamp or with
+// a non-finite prediction or target, an empty fold and short actuals
+simulation::SimulationRun MakeRun(std::mt19937& rng, int folds, int perFold) {
+    simulation::SimulationRun run;
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    int64_t timestamp = 1700000000000;
+    for (int f = 0; f < folds; ++f) {
+        simulation::FoldResult fold{};
+        fold.fold_number = f + 1;
+        fold.test_start = 1000 + f * perFold;
+        fold.long_threshold_optimal = dist(rng);
+        fold.short_threshold_optimal = dist(rng);
+        fold.prediction_threshold_original = dist(rng);
+        fold.short_threshold_original = dist(rng);
+        fold.best_score = (f % 17 == 0) ? kNaNf : dist(rng);
+        fold.profit_factor_test = (f % 29 == 0) ? kInff : dist(rng);
+        run.fold_prediction_offsets.push_back(static_cast<int>(run.all_test_predictions.size()));
+        const int count = (f == 3) ? 0 : perFold;
+        for (int i = 0; i < count; ++i) {
+            const int idx = static_cast<int>(run.all_test_predictions.size());
+            run.all_test_predictions.push_back(idx % 97 == 5 ? kNaNf : dist(rng));
+            run.all_test_actuals.push_back(idx % 113 == 7 ? kInff : dist(rng));
+            run.all_test_timestamps.push_back(idx % 131 == 9 ? 0 : (timestamp += 60000));
+        }
+        run.foldResults.push_back(std::move(fold));
+    }
+    run.all_test_actuals.resize(run.all_test_actuals.size() - 3);
+    return run;
+}
+
+std::vector<Entry> ExpectedRows(const simulation::SimulationRun& run) {
+    std::vector<Entry> rows;
+    const size_t total = run.all_test_predictions.size();
+    for (size_t f = 0; f < run.foldResults.size(); ++f) {
+        const auto& fold = run.foldResults[f];
+        const size_t start = static_cast<size_t>(run.fold_prediction_offsets[f]);
+        const size_t end = f + 1 < run.fold_prediction_offsets.size()
+            ? static_cast<size_t>(run.fold_prediction_offsets[f + 1]) : total;
+        for (size_t idx = start; idx < end; ++idx) {
+            if (run.all_test_timestamps[idx] <= 0 || idx >= run.all_test_actuals.size() ||
+                !std::isfinite(run.all_test_predictions[idx]) || !std::isfinite(run.all_test_actuals[idx])) {
+                continue;
+            }
+            Entry entry;
+            entry.timestamp_ms = run.all_test_timestamps[idx];
+            entry.bar_index = fold.test_start + static_cast<int64_t>(idx - start);
+            entry.fold_number = fold.fold_number;
+            entry.prediction = run.all_test_predictions[idx];
+            entry.target = run.all_test_actuals[idx];
+            entry.long_threshold = Finite(fold.long_threshold_optimal);
+            entry.short_threshold = Finite(fold.short_threshold_optimal);
+            entry.roc_threshold = Finite(fold.prediction_threshold_original);
+            entry.short_entry_threshold = Finite(fold.short_threshold_original);
+            entry.fold_score = Finite(fold.best_score);
+            entry.fold_profit_factor = Finite(fold.profit_factor_test);
+            rows.push_back(entry);
+        }
+    }
+    return rows;
+}
+
+size_t Mismatches(const std::vector<Entry>& expected, const WalkforwardPredictionSeries& series) {
+    if (expected.size() != series.rows.size()) {
+        return std::max(expected.size(), series.rows.size());
+    }
+    size_t mismatches = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        mismatches += SameEntry(expected[i], series.rows[i]) ? 0 : 1;
+    }
+    return mismatches;
+}
+
+// The same columns split into chunks of at most chunkRows
+std::shared_ptr<arrow::Table> Rechunk(const std::shared_ptr<arrow::Table>& table, int64_t chunkRows) {
+    std::vector<std::shared_ptr<arrow::Table>> slices;
+    for (int64_t offset = 0; offset < table->num_rows(); offset += chunkRows) {
+        slices.push_back(table->Slice(offset, chunkRows));
+    }
+    return arrow::ConcatenateTables(slices).ValueOrDie();
+}
+
+std::shared_ptr<arrow::Table> Rename(const std::shared_ptr<arrow::Table>& table,
+                                     const std::vector<std::pair<std::string, std::string>>& renames) {
+    std::vector<std::string> names = table->ColumnNames();
+    for (auto& name : names) {
+        for (const auto& [from, to] : renames) {
+            if (name == from) name = to;
+        }
+    }
+    return table->RenameColumns(names).ValueOrDie();
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    for (int trial = 0; trial < 20; ++trial) {
+        const auto run = MakeRun(rng, 1 + trial * 15, 50 + trial * 20);
+        const auto expected = ExpectedRows(run);
+        const std::string label = "trial " + std::to_string(trial);
+
+        auto encoded = questdb::EncodeWalkforwardPredictions(run);
+        if (!encoded.ok()) {
+            Expect(false, label + " encode: " + encoded.status().ToString());
+            continue;
+        }
+        const auto table = *encoded;
+        Expect(table->ValidateFull().ok(), label + " encoded table is valid");
+        Expect(table->num_rows() == static_cast<int64_t>(expected.size()), label + " encoded row count");
+
+        WalkforwardPredictionSeries decoded;
+        Expect(questdb::DecodeWalkforwardPredictions(table, &decoded).ok(), label + " decode");
+        Expect(Mismatches(expected, decoded) == 0, label + " round trip matches the export rules");
+
+        WalkforwardPredictionSeries chunked;
+        Expect(questdb::DecodeWalkforwardPredictions(Rechunk(table, 37), &chunked).ok(), label + " chunked decode");
+        Expect(Mismatches(expected, chunked) == 0, label + " chunked round trip");
+
+        // Older exports named the columns differently
+        WalkforwardPredictionSeries aliased;
+        const auto renamed = Rename(table, { { "timestamp_unix", "timestamp" }, { "fold_number", "fold" },
+                                             { "target_value", "target" }, { "roc_threshold", "prediction_threshold" },
+                                             { "fold_score", "best_score" } });
+        Expect(questdb::DecodeWalkforwardPredictions(renamed, &aliased).ok(), label + " aliased decode");
+        Expect(Mismatches(expected, aliased) == 0, label + " aliased round trip");
+    }
+
+    // Missing optional columns decode as NaN, bar_index as the row number
+    {
+        const auto run = MakeRun(rng, 5, 40);
+        auto table = *questdb::EncodeWalkforwardPredictions(run);
+        for (const char* name : { "bar_index", "fold_number", "long_threshold", "fold_profit_factor" }) {
+            table = *table->RemoveColumn(table->schema()->GetFieldIndex(name));
+        }
+        auto expected = ExpectedRows(run);
+        for (size_t row = 0; row < expected.size(); ++row) {
+            expected[row].bar_index = static_cast<int64_t>(row);
+            expected[row].fold_number = 0;
+            expected[row].long_threshold = kNaN;
+            expected[row].fold_profit_factor = kNaN;
+        }
+        WalkforwardPredictionSeries decoded;
+        Expect(questdb::DecodeWalkforwardPredictions(table, &decoded).ok(), "decode without optional columns");
+        Expect(Mismatches(expected, decoded) == 0, "optional columns default");
+    }
+
+    // Tables without timestamps or predictions are rejected
+    {
+        const auto run = MakeRun(rng, 2, 10);
+        const auto table = *questdb::EncodeWalkforwardPredictions(run);
+        WalkforwardPredictionSeries decoded;
+        const auto noPrediction = *table->RemoveColumn(table->schema()->GetFieldIndex("prediction"));
+        Expect(!questdb::DecodeWalkforwardPredictions(noPrediction, &decoded).ok(), "missing prediction is rejected");
+        Expect(!questdb::DecodeWalkforwardPredictions(nullptr, &decoded).ok(), "null table is rejected");
+        Expect(!questdb::EncodeWalkforwardPredictions(simulation::SimulationRun()).ok(), "empty run is rejected");
+    }
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " prediction codec checks failed\n";
+        return 1;
+    }
+    std::cout << "Prediction codec: all checks passed\n";
+    return 0;
+}
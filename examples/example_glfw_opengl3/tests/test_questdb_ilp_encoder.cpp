@@ -0,0 +1,533 @@
+// Exports tables through DataFrameGateway::Export into a local TCP sink and
+// compares the bytes with what the previous per-cell scalar encoder (kept
+// below as the reference) writes over one socket. Covers every column kind,
+// nulls, non-finite values, escaping, tags, chunked columns and each
+// timestamp representation, over one and several ILP connections. Exits
+// non-zero on any mismatch.
+#include "QuestDbDataFrameGateway.h"
+#include "chronosflow.h"
+#include "tests/test_support.h"
+
+#include <arrow/api.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace test_support;
+
+namespace {
+
+int g_failures = 0;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Reference: the scalar encoder Export used before IlpEncoder
+// ---------------------------------------------------------------------------
+
+std::string EscapeIdentifier(const std::string& value) {
+    std::string escaped;
+    for (char ch : value) {
+        if (ch == ' ' || ch == ',' || ch == '=') escaped.push_back('\\');
+        escaped.push_back(ch);
+    }
+    return escaped;
+}
+
+std::string EscapeStringValue(const std::string& value) {
+    std::string escaped = "\"";
+    for (char ch : value) {
+        if (ch == '"' || ch == '\\') escaped.push_back('\\');
+        escaped.push_back(ch);
+    }
+    return escaped + '"';
+}
+
+std::string EscapeTagValue(const std::string& value) {
+    std::string escaped;
+    for (char ch : value) {
+        if (ch == ' ' || ch == ',' || ch == '=' || ch == '\t') escaped.push_back('\\');
+        escaped.push_back(ch);
+    }
+    return escaped.empty() ? "none" : escaped;
+}
+
+std::optional<int64_t> ParseIsoToMillis(const std::string& text) {
+    if (text.size() < 19) return std::nullopt;
+    auto parseInt = [&](size_t pos, size_t len) -> std::optional<int> {
+        int value = 0;
+        for (size_t i = 0; i < len; ++i) {
+            const char ch = text[pos + i];
+            if (ch < '0' || ch > '9') return std::nullopt;
+            value = value * 10 + (ch - '0');
+        }
+        return value;
+    };
+    auto year = parseInt(0, 4), month = parseInt(5, 2), day = parseInt(8, 2);
+    auto hour = parseInt(11, 2), minute = parseInt(14, 2), second = parseInt(17, 2);
+    if (!year || !month || !day || !hour || !minute || !second) return std::nullopt;
+    int64_t fractionMillis = 0;
+    const auto dot = text.find('.', 19);
+    if (dot != std::string::npos) {
+        size_t end = dot + 1;
+        while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) ++end;
+        std::string fraction = text.substr(dot + 1, end - dot - 1);
+        while (fraction.size() < 3) fraction.push_back('0');
+        fraction.resize(3);
+        fractionMillis = std::stoi(fraction);
+    }
+    std::tm tm = {};
+    tm.tm_year = *year - 1900;
+    tm.tm_mon = *month - 1;
+    tm.tm_mday = *day;
+    tm.tm_hour = *hour;
+    tm.tm_min = *minute;
+    tm.tm_sec = *second;
+    const time_t seconds = timegm(&tm);
+    if (seconds == static_cast<time_t>(-1)) return std::nullopt;
+    return static_cast<int64_t>(seconds) * 1000LL + fractionMillis;
+}
+
+std::optional<int64_t> ScalarToMillis(const std::shared_ptr<arrow::Scalar>& scalar, bool coerce) {
+    if (!scalar || !scalar->is_valid) return std::nullopt;
+    auto coerced = [coerce](int64_t value) {
+        return (coerce && std::llabs(value) < 4'000'000'000LL) ? value * 1000 : value;
+    };
+    switch (scalar->type->id()) {
+        case arrow::Type::INT64:
+            return coerced(std::static_pointer_cast<arrow::Int64Scalar>(scalar)->value);
+        case arrow::Type::INT32:
+            return coerced(std::static_pointer_cast<arrow::Int32Scalar>(scalar)->value);
+        case arrow::Type::DOUBLE:
+        case arrow::Type::FLOAT: {
+            const double numeric = scalar->type->id() == arrow::Type::DOUBLE
+                ? std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value
+                : static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value);
+            return coerced(static_cast<int64_t>(std::llround(numeric)));
+        }
+        case arrow::Type::STRING:
+        case arrow::Type::LARGE_STRING: {
+            const auto text = scalar->ToString();
+            if (text.empty()) return std::nullopt;
+            const bool numeric = std::all_of(text.begin(), text.end(), [](unsigned char ch) {
+                return std::isdigit(ch) || ch == '-' || ch == '+';
+            });
+            if (numeric) {
+                try {
+                    return coerced(std::stoll(text));
+                } catch (...) {
+                }
+            }
+            return ParseIsoToMillis(text);
+        }
+        case arrow::Type::TIMESTAMP: {
+            auto ts = std::static_pointer_cast<arrow::TimestampScalar>(scalar);
+            switch (std::static_pointer_cast<arrow::TimestampType>(ts->type)->unit()) {
+                case arrow::TimeUnit::SECOND: return ts->value * 1000;
+                case arrow::TimeUnit::MILLI: return ts->value;
+                case arrow::TimeUnit::MICRO: return ts->value / 1000;
+                case arrow::TimeUnit::NANO: return ts->value / 1000000;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return std::nullopt;
+}
+
+bool ReferenceEncode(const std::shared_ptr<arrow::Table>& table, const questdb::ExportSpec& spec,
+                     std::string* payload, int64_t* rows) {
+    const auto schema = table->schema();
+    const int numColumns = schema->num_fields();
+    const int timestampIndex = schema->GetFieldIndex(spec.timestamp_column);
+    const auto timestampColumn = table->column(timestampIndex);
+    std::string prefix = EscapeIdentifier(spec.measurement.empty() ? "measurement" : spec.measurement);
+    for (const auto& [key, value] : spec.static_tags) {
+        if (!key.empty()) prefix += ',' + EscapeIdentifier(key) + '=' + EscapeTagValue(value);
+    }
+    std::vector<bool> skip(numColumns, false);
+    skip[timestampIndex] = true;
+    if (spec.emit_timestamp_field && !spec.timestamp_field_name.empty()) {
+        const int index = schema->GetFieldIndex(spec.timestamp_field_name);
+        if (index >= 0) skip[index] = true;
+    }
+    std::vector<int> tags;
+    for (const auto& name : spec.tag_columns) {
+        const int index = schema->GetFieldIndex(name);
+        if (index >= 0) {
+            tags.push_back(index);
+            skip[index] = true;
+        }
+    }
+
+    std::ostringstream lines;
+    *rows = 0;
+    for (int64_t row = 0; row < table->num_rows(); ++row) {
+        std::ostringstream fields;
+        int fieldCount = 0;
+        for (int col = 0; col < numColumns; ++col) {
+            if (skip[col]) continue;
+            auto scalar = table->column(col)->GetScalar(row).ValueOrDie();
+            if (!scalar->is_valid) continue;
+            const auto& field = schema->field(col);
+            std::string value;
+            switch (field->type()->id()) {
+                case arrow::Type::BOOL:
+                    value = std::static_pointer_cast<arrow::BooleanScalar>(scalar)->value ? "true" : "false";
+                    break;
+                case arrow::Type::FLOAT:
+                case arrow::Type::DOUBLE: {
+                    const double numeric = field->type()->id() == arrow::Type::FLOAT
+                        ? static_cast<double>(std::static_pointer_cast<arrow::FloatScalar>(scalar)->value)
+                        : std::static_pointer_cast<arrow::DoubleScalar>(scalar)->value;
+                    if (!std::isfinite(numeric)) continue;
+                    std::ostringstream stream;
+                    stream << std::setprecision(std::numeric_limits<double>::digits10 + 1) << numeric;
+                    value = stream.str();
+                    break;
+                }
+                case arrow::Type::INT8:
+                case arrow::Type::INT16:
+                case arrow::Type::INT32:
+                case arrow::Type::INT64:
+                case arrow::Type::UINT8:
+                case arrow::Type::UINT16:
+                case arrow::Type::UINT32:
+                case arrow::Type::UINT64:
+                    value = scalar->ToString() + 'i';
+                    break;
+                default:
+                    value = EscapeStringValue(scalar->ToString());
+                    break;
+            }
+            if (fieldCount++ > 0) fields << ',';
+            fields << EscapeIdentifier(field->name()) << '=' << value;
+        }
+        std::string measurement = prefix;
+        for (int index : tags) {
+            auto scalar = table->column(index)->GetScalar(row).ValueOrDie();
+            if (scalar->is_valid) {
+                measurement += ',' + EscapeIdentifier(schema->field(index)->name()) + '=' +
+                               EscapeTagValue(scalar->ToString());
+            }
+        }
+        const auto timestamp = ScalarToMillis(timestampColumn->GetScalar(row).ValueOrDie(),
+                                              spec.coerce_seconds_to_millis);
+        if (!timestamp || *timestamp == 0) return false;
+        if (spec.emit_timestamp_field && !spec.timestamp_field_name.empty()) {
+            if (fieldCount++ > 0) fields << ',';
+            fields << EscapeIdentifier(spec.timestamp_field_name) << '=' << *timestamp << 'i';
+        }
+        if (fieldCount == 0) continue;
+        lines << measurement << ' ' << fields.str() << ' ' << *timestamp * 1000000LL << '\n';
+        ++*rows;
+    }
+    *payload = lines.str();
+    return true;
+}
+
+// Writes payload over one plain socket, as the old Export did
+void SendOverSocket(int port, const std::string& payload) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+        size_t sent = 0;
+        while (sent < payload.size()) {
+            const ssize_t wrote = send(fd, payload.data() + sent, payload.size() - sent, MSG_NOSIGNAL);
+            if (wrote <= 0) break;
+            sent += static_cast<size_t>(wrote);
+        }
+    }
+    close(fd);
+}
+
+// ---------------------------------------------------------------------------
+// Test tables
+// ---------------------------------------------------------------------------
+
+enum class TimestampKind { Seconds, Millis, ArrowMillis, Iso, Double };
+
+std::shared_ptr<arrow::Array> Finish(arrow::ArrayBuilder& builder) {
+    return builder.Finish().ValueOrDie();
+}
+
+// Rows span several UTC days; cells cycle through nulls, non-finite values,
+// extreme magnitudes and characters that need escaping
+std::shared_ptr<arrow::Table> MakeTable(std::mt19937_64& rng, int64_t rows, TimestampKind kind, int64_t chunkRows) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const double specials[] = { nan, inf, -inf, 0.0, -0.0, 1e-300, 4.9e-324, 1.7976931348623157e308,
+                                0.1, 1.0 / 3.0, 123456789.123456789, -2.5e-7, 1e16, 9007199254740993.0 };
+    const char* strings[] = { "plain", "", "with space", "comma,here", "quote\"inside", "back\\slash",
+                              "eq=sign", "tab\tchar", "unicode \xc3\xa9" };
+
+    arrow::Int64Builder seconds;
+    arrow::Int64Builder millis;
+    arrow::TimestampBuilder arrowMillis(arrow::timestamp(arrow::TimeUnit::MILLI), arrow::default_memory_pool());
+    arrow::StringBuilder iso;
+    arrow::DoubleBuilder doubleTs;
+    arrow::DoubleBuilder price;
+    arrow::FloatBuilder ratio;
+    arrow::Int8Builder tiny;
+    arrow::Int32Builder count;
+    arrow::Int64Builder big;
+    arrow::UInt64Builder unsignedBig;
+    arrow::BooleanBuilder flag;
+    arrow::StringBuilder note;
+    arrow::StringBuilder venue;
+    arrow::Date32Builder session;
+    std::uniform_real_distribution<double> uniform(-1e6, 1e6);
+
+    const int64_t start = 1700000000;  // 2023-11-14 22:13:20 UTC
+    for (int64_t i = 0; i < rows; ++i) {
+        const int64_t ts = start + i * 3607;
+        seconds.Append(ts).ok();
+        millis.Append(ts * 1000 + i % 1000).ok();
+        arrowMillis.Append(ts * 1000 + i % 1000).ok();
+        char text[40];
+        std::time_t t = static_cast<std::time_t>(ts);
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &tm);
+        iso.Append(std::string(text) + (i % 2 ? ".25Z" : "Z")).ok();
+        doubleTs.Append(static_cast<double>(ts) + 0.4).ok();
+
+        if (i % 11 == 3) price.AppendNull().ok();
+        else price.Append(i % 5 == 0 ? specials[(i / 5) % std::size(specials)] : uniform(rng)).ok();
+        if (i % 13 == 6) ratio.AppendNull().ok();
+        else ratio.Append(i % 7 == 0 ? static_cast<float>(specials[(i / 7) % std::size(specials)])
+                                     : static_cast<float>(uniform(rng) / 1e3)).ok();
+        tiny.Append(static_cast<int8_t>(static_cast<int>(i % 256) - 128)).ok();
+        if (i % 9 == 4) count.AppendNull().ok();
+        else count.Append(static_cast<int32_t>(rng())).ok();
+        big.Append(i % 17 == 0 ? std::numeric_limits<int64_t>::min() : static_cast<int64_t>(rng())).ok();
+        unsignedBig.Append(i % 19 == 0 ? std::numeric_limits<uint64_t>::max() : rng()).ok();
+        if (i % 8 == 7) flag.AppendNull().ok();
+        else flag.Append(i % 3 == 0).ok();
+        if (i % 10 == 2) note.AppendNull().ok();
+        else note.Append(strings[i % std::size(strings)]).ok();
+        if (i % 23 == 1) venue.AppendNull().ok();
+        else venue.Append(strings[(i / 3) % std::size(strings)]).ok();
+        session.Append(static_cast<int32_t>(ts / 86400)).ok();
+    }
+
+    std::shared_ptr<arrow::Array> timestamp;
+    std::shared_ptr<arrow::DataType> timestampType;
+    switch (kind) {
+        case TimestampKind::Seconds: timestamp = Finish(seconds); break;
+        case TimestampKind::Millis: timestamp = Finish(millis); break;
+        case TimestampKind::ArrowMillis: timestamp = Finish(arrowMillis); break;
+        case TimestampKind::Iso: timestamp = Finish(iso); break;
+        case TimestampKind::Double: timestamp = Finish(doubleTs); break;
+    }
+    auto table = arrow::Table::Make(
+        arrow::schema({ arrow::field("price", arrow::float64()), arrow::field("timestamp_unix", timestamp->type()),
+                        arrow::field("ratio f", arrow::float32()), arrow::field("tiny", arrow::int8()),
+                        arrow::field("count,n", arrow::int32()), arrow::field("big", arrow::int64()),
+                        arrow::field("ubig", arrow::uint64()), arrow::field("flag", arrow::boolean()),
+                        arrow::field("note", arrow::utf8()), arrow::field("venue", arrow::utf8()),
+                        arrow::field("session", arrow::date32()) }),
+        { Finish(price), timestamp, Finish(ratio), Finish(tiny), Finish(count), Finish(big), Finish(unsignedBig),
+          Finish(flag), Finish(note), Finish(venue), Finish(session) });
+
+    std::vector<std::shared_ptr<arrow::Table>> slices;
+    for (int64_t offset = 0; offset < rows; offset += chunkRows) {
+        slices.push_back(table->Slice(offset, chunkRows));
+    }
+    return arrow::ConcatenateTables(slices).ValueOrDie();
+}
+
+// Only the timestamp and one all-null column for the first half of the rows
+std::shared_ptr<arrow::Table> MakeSparseTable(int64_t rows) {
+    arrow::Int64Builder ts;
+    arrow::DoubleBuilder value;
+    for (int64_t i = 0; i < rows; ++i) {
+        ts.Append(1700000000000 + i * 60000).ok();
+        if (i < rows / 2) value.AppendNull().ok();
+        else value.Append(static_cast<double>(i) / 7.0).ok();
+    }
+    return arrow::Table::Make(
+        arrow::schema({ arrow::field("timestamp_unix", arrow::int64()), arrow::field("value", arrow::float64()) }),
+        { Finish(ts), Finish(value) });
+}
+
+std::vector<std::string> SortedLines(const std::string& payload) {
+    std::vector<std::string> lines;
+    std::istringstream stream(payload);
+    for (std::string line; std::getline(stream, line);) lines.push_back(line);
+    std::sort(lines.begin(), lines.end());
+    return lines;
+}
+
+// Timestamps of the lines in payload, in order
+std::vector<int64_t> LineTimestamps(const std::string& payload) {
+    std::vector<int64_t> timestamps;
+    std::istringstream stream(payload);
+    for (std::string line; std::getline(stream, line);) {
+        timestamps.push_back(std::stoll(line.substr(line.rfind(' ') + 1)));
+    }
+    return timestamps;
+}
+
+struct Case {
+    std::string label;
+    std::shared_ptr<arrow::Table> table;
+    questdb::ExportSpec spec;
+};
+
+void RunCase(const Case& c) {
+    std::string reference;
+    int64_t referenceRows = 0;
+    if (!ReferenceEncode(c.table, c.spec, &reference, &referenceRows)) {
+        Expect(false, c.label + ": reference encoder rejected the table");
+        return;
+    }
+    std::string oldBytes;
+    {
+        TcpSink sink;
+        SendOverSocket(sink.Port(), reference);
+        WaitUntil([&]() { return sink.Connections() == 1; }, 5000);
+        sink.WaitFinished(5000);
+        oldBytes = sink.ReceivedAll();
+    }
+    Expect(oldBytes == reference, c.label + ": reference payload arrives intact");
+
+    for (int connections : { 1, 3 }) {
+        const std::string label = c.label + " (" + std::to_string(connections) + " connections)";
+        TcpSink sink;
+        questdb::ConnectionOptions options;
+        options.ilp_host = "127.0.0.1";
+        options.ilp_port = sink.Port();
+        options.ilp_connections = connections;
+        options.ilp_buffer_bytes = 64 * 1024;
+        questdb::DataFrameGateway gateway(options);
+        chronosflow::AnalyticsDataFrame frame(c.table);
+        questdb::ExportResult result;
+        std::string error;
+        const bool ok = gateway.Export(frame, c.spec, &result, &error);
+        Expect(ok, label + ": export succeeds: " + error);
+        Expect(sink.WaitFinished(5000), label + ": sender closes its connections");
+        Expect(result.rows_serialized == referenceRows, label + ": row count matches the reference");
+        Expect(result.bytes_sent == static_cast<int64_t>(oldBytes.size()), label + ": byte count matches the reference");
+
+        if (connections == 1) {
+            Expect(sink.ReceivedAll() == oldBytes, label + ": bytes match the reference");
+            continue;
+        }
+        // Buffers are spread over the sockets; every line still arrives
+        // once, and within a connection each day's lines stay in order
+        Expect(SortedLines(sink.ReceivedAll()) == SortedLines(oldBytes), label + ": lines match the reference");
+        for (const auto& received : sink.Received()) {
+            std::map<int64_t, int64_t> lastPerDay;
+            bool ordered = true;
+            for (int64_t ts : LineTimestamps(received)) {
+                int64_t& last = lastPerDay[ts / 86'400'000'000'000LL];
+                ordered = ordered && ts >= last;
+                last = ts;
+            }
+            Expect(ordered, label + ": per-day order within a connection");
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::mt19937_64 rng(11);
+
+    std::vector<Case> cases;
+    const std::pair<TimestampKind, const char*> kinds[] = {
+        { TimestampKind::Seconds, "int64 seconds" }, { TimestampKind::Millis, "int64 millis" },
+        { TimestampKind::ArrowMillis, "timestamp[ms]" }, { TimestampKind::Iso, "ISO strings" },
+        { TimestampKind::Double, "double seconds" } };
+    for (const auto& [kind, name] : kinds) {
+        Case c;
+        c.label = name;
+        c.table = MakeTable(rng, 3000, kind, 701);
+        c.spec.measurement = "bars";
+        cases.push_back(c);
+    }
+    {
+        Case c;
+        c.label = "tags and timestamp field";
+        c.table = MakeTable(rng, 5000, TimestampKind::Seconds, 997);
+        c.spec.measurement = "bars m,1";
+        c.spec.static_tags = { { "source", "unit test" }, { "empty", "" }, { "", "skipped" } };
+        c.spec.tag_columns = { "venue", "missing" };
+        c.spec.emit_timestamp_field = true;
+        cases.push_back(c);
+    }
+    {
+        Case c;
+        c.label = "uncoerced millis";
+        c.table = MakeTable(rng, 2000, TimestampKind::Millis, 2000);
+        c.spec.coerce_seconds_to_millis = false;
+        cases.push_back(c);
+    }
+    {
+        Case c;
+        c.label = "rows without fields";
+        c.table = MakeSparseTable(4000);
+        c.spec.measurement = "sparse";
+        cases.push_back(c);
+    }
+    for (const auto& c : cases) {
+        RunCase(c);
+    }
+
+    // A bad timestamp fails the export before anything is sent
+    {
+        arrow::Int64Builder ts;
+        arrow::DoubleBuilder value;
+        for (int64_t i = 0; i < 100; ++i) {
+            if (i == 60) ts.AppendNull().ok();
+            else ts.Append(1700000000 + i).ok();
+            value.Append(static_cast<double>(i)).ok();
+        }
+        auto table = arrow::Table::Make(
+            arrow::schema({ arrow::field("timestamp_unix", arrow::int64()), arrow::field("value", arrow::float64()) }),
+            { Finish(ts), Finish(value) });
+        questdb::ExportSpec spec;
+        std::string reference;
+        int64_t rows = 0;
+        Expect(!ReferenceEncode(table, spec, &reference, &rows), "reference rejects a null timestamp");
+
+        TcpSink sink;
+        questdb::ConnectionOptions options;
+        options.ilp_host = "127.0.0.1";
+        options.ilp_port = sink.Port();
+        questdb::DataFrameGateway gateway(options);
+        chronosflow::AnalyticsDataFrame frame(table);
+        std::string error;
+        Expect(!gateway.Export(frame, spec, nullptr, &error), "export rejects a null timestamp");
+        Expect(error.find("Row 60") != std::string::npos, "error names the bad row: " + error);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        Expect(sink.Connections() == 0, "nothing is sent for a table with a bad timestamp");
+    }
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " ILP encoder checks failed\n";
+        return 1;
+    }
+    std::cout << "ILP encoder: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,232 @@
+// Sends ILP buffers through IlpSender to a local TCP sink over several
+// connections. Checks shard placement and order, that Submit blocks while
+// the sink stops reading, and that a failed connection is reopened and the
+// buffer resent only when none of it had been accepted. Exits non-zero on
+// any mismatch.
+#include "QuestDbIlpSender.h"
+#include "tests/test_support.h"
+
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace questdb;
+using namespace test_support;
+
+namespace {
+
+int g_failures = 0;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+IlpSenderOptions Options(const TcpSink& sink, int connections, size_t queueDepth) {
+    IlpSenderOptions options;
+    options.host = "127.0.0.1";
+    options.port = sink.Port();
+    options.connections = connections;
+    options.queue_depth = queueDepth;
+    options.connect_timeout_ms = 2000;
+    options.send_retry_window_ms = 5000;
+    return options;
+}
+
+// rows lines of "shard=<key> seq=<n>"
+IlpBuffer MakeBuffer(const std::string& shard, int64_t firstSeq, int64_t rows) {
+    IlpBuffer buffer;
+    buffer.shard_key = shard;
+    buffer.rows = rows;
+    for (int64_t i = 0; i < rows; ++i) {
+        buffer.data += "m,shard=" + shard + " seq=" + std::to_string(firstSeq + i) + "i\n";
+    }
+    return buffer;
+}
+
+// Buffer of roughly bytes, one line per 100 bytes
+IlpBuffer MakeLargeBuffer(size_t bytes) {
+    IlpBuffer buffer;
+    const std::string line = "m value=" + std::string(89, '7') + "i 1\n";
+    buffer.data.reserve(bytes + line.size());
+    while (buffer.data.size() < bytes) {
+        buffer.data += line;
+        ++buffer.rows;
+    }
+    return buffer;
+}
+
+void CheckShards() {
+    TcpSink sink;
+    IlpSender sender(Options(sink, 3, 2));
+    std::string error;
+    const bool opened = sender.Open(&error);
+    Expect(opened, "open three connections: " + error);
+    Expect(WaitUntil([&]() { return sink.Connections() == 3; }, 2000), "three connections are accepted");
+
+    const int shards = 7;
+    const int64_t rowsPerBuffer = 50;
+    std::map<std::string, int64_t> next;
+    int64_t rows = 0;
+    for (int b = 0; b < 140; ++b) {
+        const std::string shard = "s" + std::to_string((b * 5) % shards);
+        Expect(sender.Submit(MakeBuffer(shard, next[shard], rowsPerBuffer)), "submit buffer " + std::to_string(b));
+        next[shard] += rowsPerBuffer;
+        rows += rowsPerBuffer;
+    }
+    IlpSendStats stats;
+    const bool closed = sender.Close(&stats, &error);
+    Expect(closed, "close after sharded sends: " + error);
+    Expect(sink.WaitFinished(2000), "sharded connections are closed");
+    Expect(stats.rows == rows && stats.connections == 3, "stats count every row and connection");
+    Expect(stats.bytes == sink.BytesReceived(), "stats count every byte the sink received");
+
+    // Every line once; a shard lives on one connection, in submission order
+    std::map<std::string, int> shardConnection;
+    std::map<std::string, int64_t> seen;
+    const auto received = sink.Received();
+    for (size_t c = 0; c < received.size(); ++c) {
+        std::istringstream lines(received[c]);
+        for (std::string line; std::getline(lines, line);) {
+            const std::string shard = line.substr(8, line.find(' ') - 8);
+            const int64_t seq = std::stoll(line.substr(line.find("seq=") + 4));
+            auto [placed, inserted] = shardConnection.emplace(shard, static_cast<int>(c));
+            Expect(placed->second == static_cast<int>(c), "shard " + shard + " stays on one connection");
+            Expect(seq == seen[shard], "shard " + shard + " arrives in order without gaps");
+            seen[shard] = seq + 1;
+        }
+    }
+    Expect(seen == next, "every submitted line arrives exactly once");
+    std::set<int> used;
+    for (const auto& [shard, connection] : shardConnection) used.insert(connection);
+    Expect(used.size() > 1, "shards are spread over the connections");
+}
+
+void CheckBackPressure() {
+    TcpSink sink;
+    sink.SetPaused(true);
+    IlpSender sender(Options(sink, 2, 2));
+    std::string error;
+    const bool opened = sender.Open(&error);
+    Expect(opened, "open for back-pressure: " + error);
+
+    const int buffers = 48;
+    const size_t bufferBytes = 2 << 20;
+    std::atomic<int> submitted{ 0 };
+    std::thread producer([&]() {
+        for (int b = 0; b < buffers; ++b) {
+            IlpBuffer buffer = MakeLargeBuffer(bufferBytes);
+            buffer.shard_key = std::to_string(b);
+            if (!sender.Submit(std::move(buffer))) return;
+            ++submitted;
+        }
+    });
+
+    // Queues and socket buffers fill, then Submit blocks
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    const int stalled = submitted.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    Expect(submitted.load() == stalled, "Submit blocks while the sink does not read");
+    Expect(stalled < buffers / 2, "the producer is held to the queues and socket buffers (" +
+                                      std::to_string(stalled) + " of " + std::to_string(buffers) + " submitted)");
+
+    sink.SetPaused(false);
+    producer.join();
+    IlpSendStats stats;
+    Expect(submitted.load() == buffers, "every buffer is submitted once the sink reads again");
+    const bool closed = sender.Close(&stats, &error);
+    Expect(closed, "close after back-pressure: " + error);
+    Expect(sink.WaitFinished(5000), "back-pressure connections are closed");
+    Expect(stats.bytes == sink.BytesReceived() && sink.Connections() == 2,
+           "everything arrives without reconnects");
+}
+
+// The sink resets the first connection once it is open; the buffer fails
+// before any byte is accepted, so it is sent on a new one
+void CheckResendBeforeFirstByte() {
+    std::atomic<bool> open{ false };
+    TcpSink sink([&open](int connection) -> int64_t {
+        if (connection > 0) return -1;
+        WaitUntil([&]() { return open.load(); }, 2000);
+        return 0;
+    });
+    IlpSender sender(Options(sink, 1, 2));
+    std::string error;
+    const bool opened = sender.Open(&error);
+    Expect(opened, "open for resend: " + error);
+    open = true;
+    Expect(WaitUntil([&]() { return sink.Finished() == 1; }, 2000), "the sink resets the first connection");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const IlpBuffer buffer = MakeBuffer("r", 0, 1000);
+    Expect(sender.Submit(buffer), "submit after the reset");
+    IlpSendStats stats;
+    const bool closed = sender.Close(&stats, &error);
+    Expect(closed, "a reset before the first byte is recovered: " + error);
+    Expect(sink.WaitFinished(2000), "resend connection is closed");
+    const auto received = sink.Received();
+    Expect(sink.Connections() == 2, "one reconnect");
+    Expect(received.size() == 2 && received[0].empty() && received[1] == buffer.data,
+           "the buffer arrives once, on the new connection");
+}
+
+// The sink resets the connection after 1 MB of a 32 MB buffer; the leading
+// lines may be committed, so nothing is resent and the sender fails
+void CheckNoResendAfterPartialSend() {
+    TcpSink sink([](int) -> int64_t { return 1 << 20; });
+    IlpSender sender(Options(sink, 1, 2));
+    std::string error;
+    const bool opened = sender.Open(&error);
+    Expect(opened, "open for partial send: " + error);
+
+    Expect(sender.Submit(MakeLargeBuffer(32 << 20)), "submit the large buffer");
+    Expect(WaitUntil([&]() { return sink.Finished() == 1; }, 5000), "the sink resets mid-buffer");
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    Expect(!sender.Submit(MakeBuffer("late", 0, 10)), "Submit fails once a connection has failed");
+
+    IlpSendStats stats;
+    Expect(!sender.Close(&stats, &error), "a partial send fails the export");
+    Expect(error.find("send failed") != std::string::npos, "error reports the failed send: " + error);
+    Expect(sink.Connections() == 1, "no reconnect after a partial send");
+    Expect(sink.BytesReceived() == (1 << 20), "nothing past the reset is delivered");
+    Expect(stats.rows == 0, "the failed buffer is not counted as sent");
+}
+
+void CheckRefusedConnection() {
+    int port = 0;
+    {
+        TcpSink sink;
+        port = sink.Port();
+    }
+    IlpSenderOptions options;
+    options.host = "127.0.0.1";
+    options.port = port;
+    IlpSender sender(options);
+    std::string error;
+    Expect(!sender.Open(&error), "open fails without a listener");
+    Expect(error.find("connection failed") != std::string::npos, "error reports the refused connection: " + error);
+}
+
+} // namespace
+
+int main() {
+    CheckShards();
+    CheckBackPressure();
+    CheckResendBeforeFirstByte();
+    CheckNoResendAfterPartialSend();
+    CheckRefusedConnection();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " ILP sender checks failed\n";
+        return 1;
+    }
+    std::cout << "ILP sender: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,298 @@
+// Serves canned /exp CSV responses from a local HTTP stub and reads them
+// through HttpResponseStream and DataFrameGateway::Import. Chunk boundaries
+// fall inside quoted fields and the read-ahead ring wraps many times. Also
+// checks that a reader that stops reading holds the server back, that
+// Close() interrupts a stalled transfer, and that the timeout only fires
+// after a gap in the data. Exits non-zero on any mismatch.
+#include "QuestDbDataFrameGateway.h"
+#include "QuestDbResponseStream.h"
+#include "chronosflow.h"
+#include "tests/test_support.h"
+
+#include <arrow/api.h>
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace questdb;
+using namespace test_support;
+
+namespace {
+
+int g_failures = 0;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+struct Row {
+    int64_t ts;
+    std::string name;
+    double price;
+    std::string symbol;
+};
+
+std::vector<Row> MakeRows(int64_t count) {
+    std::vector<Row> rows;
+    const char* names[] = { "plain", "with, comma", "say \"hi\"", "", "a,\"b\",c", "trailing space " };
+    for (int64_t i = 0; i < count; ++i) {
+        rows.push_back({ 1700000000000000 + i * 1000, std::string(names[i % 6]) + " #" + std::to_string(i),
+                         static_cast<double>(i) / 8.0 - 1000.0, i % 3 == 0 ? "BTC" : "ETH" });
+    }
+    return rows;
+}
+
+// Every name quoted, embedded quotes doubled, as QuestDB writes them
+std::string ToCsv(const std::vector<Row>& rows) {
+    std::string csv = "\"ts\",\"name\",\"price\",\"symbol\"\r\n";
+    for (const auto& row : rows) {
+        csv += std::to_string(row.ts) + ",\"";
+        for (char ch : row.name) {
+            if (ch == '"') csv += '"';
+            csv += ch;
+        }
+        char price[32];
+        std::snprintf(price, sizeof(price), "%.17g", row.price);
+        csv += "\"," + std::string(price) + "," + row.symbol + "\r\n";
+    }
+    return csv;
+}
+
+// Random splits, plus one split right after every opening quote of the
+// first rows so some chunks end inside a quoted field
+std::vector<std::string> Split(const std::string& body, std::mt19937& rng, size_t maxChunk) {
+    std::vector<std::string> chunks;
+    std::uniform_int_distribution<size_t> size(1, maxChunk);
+    size_t pos = 0;
+    for (int quotes = 0; quotes < 200 && pos < body.size();) {
+        const size_t quote = body.find(",\"", pos);
+        if (quote == std::string::npos) break;
+        chunks.push_back(body.substr(pos, quote + 3 - pos));
+        pos = quote + 3;
+        ++quotes;
+    }
+    while (pos < body.size()) {
+        const size_t take = std::min(size(rng), body.size() - pos);
+        chunks.push_back(body.substr(pos, take));
+        pos += take;
+    }
+    return chunks;
+}
+
+std::string Query(const std::string& target) {
+    const size_t start = target.find("query=");
+    std::string query;
+    for (size_t i = start + 6; i < target.size() && target[i] != '&'; ++i) {
+        if (target[i] == '%' && i + 2 < target.size()) {
+            query.push_back(static_cast<char>(std::stoi(target.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            query.push_back(target[i]);
+        }
+    }
+    return query;
+}
+
+arrow::Result<std::string> ReadAll(HttpResponseStream& stream, int64_t readSize) {
+    std::string body;
+    std::vector<char> buffer(static_cast<size_t>(readSize));
+    while (true) {
+        ARROW_ASSIGN_OR_RAISE(int64_t got, stream.Read(readSize, buffer.data()));
+        body.append(buffer.data(), static_cast<size_t>(got));
+        if (got < readSize) return body;
+    }
+}
+
+HttpResponseStream::Options StreamOptions(size_t bufferBytes, long idleTimeoutMs) {
+    HttpResponseStream::Options options;
+    options.buffer_bytes = bufferBytes;
+    options.idle_timeout_ms = idleTimeoutMs;
+    return options;
+}
+
+void CheckImport() {
+    std::mt19937 rng(3);
+    const auto rows = MakeRows(120000);
+    const std::string csv = ToCsv(rows);
+    const auto chunks = Split(csv, rng, 40000);
+    HttpStub stub([&](const StubRequest& request) {
+        StubResponse response;
+        response.headers.push_back("Content-Type: text/csv");
+        if (Query(request.target).find("table_columns") != std::string::npos) {
+            response.chunks = { "\"column\",\"type\"\r\n\"ts\",\"LONG\"\r\n\"na", "me\",\"STRING\"\r\n",
+                                "\"price\",\"DOUBLE\"\r\n\"symbol\",\"SYM", "BOL\"\r\n" };
+        } else {
+            response.chunks = chunks;
+        }
+        return response;
+    });
+
+    ConnectionOptions options;
+    options.rest_url = stub.Url();
+    options.import_buffer_bytes = 64 * 1024;
+    DataFrameGateway gateway(options);
+    auto imported = gateway.Import("bars");
+    Expect(imported.ok(), "import from the stub: " + imported.status().ToString());
+    if (!imported.ok()) return;
+    auto table = imported->get_cpu_table()->CombineChunks().ValueOrDie();
+    Expect(stub.Requests() == 2, "schema lookup and export are both requested");
+    Expect(table->num_rows() == static_cast<int64_t>(rows.size()), "every row is imported");
+    Expect(table->schema()->Equals(*arrow::schema({ arrow::field("ts", arrow::int64()),
+                                                    arrow::field("name", arrow::utf8()),
+                                                    arrow::field("price", arrow::float64()),
+                                                    arrow::field("symbol", arrow::utf8()) })),
+           "column types come from table_columns: " + table->schema()->ToString());
+    if (table->num_rows() != static_cast<int64_t>(rows.size()) || table->num_columns() != 4) return;
+
+    auto ts = std::static_pointer_cast<arrow::Int64Array>(table->column(0)->chunk(0));
+    auto name = std::static_pointer_cast<arrow::StringArray>(table->column(1)->chunk(0));
+    auto price = std::static_pointer_cast<arrow::DoubleArray>(table->column(2)->chunk(0));
+    auto symbol = std::static_pointer_cast<arrow::StringArray>(table->column(3)->chunk(0));
+    int64_t mismatches = 0;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const auto& row = rows[i];
+        mismatches += (ts->Value(i) != row.ts || name->GetString(i) != row.name ||
+                       price->Value(i) != row.price || symbol->GetString(i) != row.symbol) ? 1 : 0;
+    }
+    Expect(mismatches == 0, std::to_string(mismatches) + " imported rows differ from the CSV");
+}
+
+void CheckImportError() {
+    HttpStub stub([](const StubRequest&) {
+        StubResponse response;
+        response.status = 400;
+        response.headers.push_back("Content-Type: application/json");
+        response.body = "{\"query\":\"SELECT\",\"error\":\"table does not exist [table=nope]\",\"position\":14}";
+        return response;
+    });
+    ConnectionOptions options;
+    options.rest_url = stub.Url();
+    DataFrameGateway gateway(options);
+    auto imported = gateway.Import("nope");
+    Expect(!imported.ok() && imported.status().IsIOError(), "a JSON error response fails the import");
+    Expect(imported.status().message().find("table does not exist") != std::string::npos,
+           "the QuestDB error message is reported: " + imported.status().ToString());
+}
+
+// Bytes come out as the stub sent them whatever the chunking and read size
+void CheckStreamBytes() {
+    std::mt19937 rng(5);
+    std::string body(3 << 20, '\0');
+    for (auto& ch : body) ch = static_cast<char>(rng());
+    for (const size_t maxChunk : { size_t(7), size_t(5000), size_t(300000) }) {
+        const auto chunks = Split(body, rng, maxChunk);
+        HttpStub stub([&](const StubRequest&) {
+            StubResponse response;
+            response.chunks = chunks;
+            return response;
+        });
+        for (const int64_t readSize : { int64_t(1) << 10, int64_t(100000), int64_t(8) << 20 }) {
+            auto stream = HttpResponseStream::Open(stub.Url() + "/exp", StreamOptions(64 * 1024, 5000)).ValueOrDie();
+            auto read = ReadAll(*stream, readSize);
+            Expect(read.ok() && *read == body, "body arrives intact (chunks up to " + std::to_string(maxChunk) +
+                                                   ", reads of " + std::to_string(readSize) + ")");
+            Expect(stream->ResponseCode() == 200, "response code is known");
+            Expect(stream->TransferStatus().ok(), "transfer finishes cleanly");
+        }
+    }
+}
+
+// The reader pauses: the server gets at most the ring plus socket buffers
+// ahead, then the whole body still arrives
+void CheckBackPressure() {
+    const std::string body(64 << 20, 'x');
+    HttpStub stub([&](const StubRequest&) {
+        StubResponse response;
+        response.body = body;
+        return response;
+    }, 64 * 1024);
+    auto stream = HttpResponseStream::Open(stub.Url() + "/exp", StreamOptions(1 << 20, 5000)).ValueOrDie();
+    Expect(stream->Peek(16) == "xxxxxxxxxxxxxxxx", "first bytes can be peeked");
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    const int64_t ahead = stub.BodyBytesSent();
+    Expect(ahead < (24 << 20), "a paused reader holds the server back (" + std::to_string(ahead >> 20) + " MB sent)");
+
+    auto read = ReadAll(*stream, 1 << 20);
+    Expect(read.ok() && read->size() == body.size(), "the whole body arrives after the pause");
+
+    // Time the download spends blocked on the reader is not idle time
+    auto slow = HttpResponseStream::Open(stub.Url() + "/exp", StreamOptions(1 << 20, 500)).ValueOrDie();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+    auto slowRead = ReadAll(*slow, 1 << 20);
+    Expect(slowRead.ok() && slowRead->size() == body.size(),
+           "a reader slower than the idle timeout does not time out: " +
+               (slowRead.ok() ? std::string() : slowRead.status().ToString()));
+}
+
+// A server that stops sending mid-body
+StubResponse Stalling(const StubRequest&) {
+    StubResponse response;
+    response.chunks = { std::string(1000, 'a'), std::string(1000, 'b') };
+    response.chunk_delay_ms = 60000;
+    return response;
+}
+
+void CheckCloseInterruptsStall() {
+    HttpStub stub(Stalling);
+    auto stream = HttpResponseStream::Open(stub.Url() + "/exp", StreamOptions(64 * 1024, 60000)).ValueOrDie();
+    Expect(stream->Peek(1000) == std::string(1000, 'a'), "bytes before the stall arrive");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const auto start = std::chrono::steady_clock::now();
+    Expect(stream->Close().ok(), "close a stalled stream");
+    const double ms = MillisSince(start);
+    Expect(ms < 2500, "Close() interrupts the stalled transfer (" + std::to_string(ms) + " ms)");
+    Expect(stream->closed(), "stream reports closed");
+}
+
+void CheckIdleTimeout() {
+    // A stall longer than the idle timeout fails the read
+    {
+        HttpStub stub(Stalling);
+        auto stream = HttpResponseStream::Open(stub.Url() + "/exp", StreamOptions(64 * 1024, 700)).ValueOrDie();
+        const auto start = std::chrono::steady_clock::now();
+        auto read = ReadAll(*stream, 4096);
+        const double ms = MillisSince(start);
+        Expect(!read.ok() && read.status().IsIOError(), "a stall past the idle timeout fails the read");
+        Expect(read.status().message().find("no data received") != std::string::npos,
+               "the error names the idle timeout: " + read.status().ToString());
+        Expect(ms >= 600 && ms < 3000, "the idle timeout fires after the gap (" + std::to_string(ms) + " ms)");
+    }
+    // A transfer that keeps trickling may take longer than the timeout
+    {
+        HttpStub stub([](const StubRequest&) {
+            StubResponse response;
+            response.chunks.assign(12, std::string(100, 'z'));
+            response.chunk_delay_ms = 150;
+            return response;
+        });
+        auto stream = HttpResponseStream::Open(stub.Url() + "/exp", StreamOptions(64 * 1024, 700)).ValueOrDie();
+        const auto start = std::chrono::steady_clock::now();
+        auto read = ReadAll(*stream, 4096);
+        Expect(read.ok() && read->size() == 1200, "a slow steady transfer completes: " +
+                                                      (read.ok() ? std::string() : read.status().ToString()));
+        Expect(MillisSince(start) > 1400, "the transfer outlasts the idle timeout");
+    }
+}
+
+} // namespace
+
+int main() {
+    CheckImport();
+    CheckImportError();
+    CheckStreamBytes();
+    CheckBackPressure();
+    CheckCloseInterruptsStall();
+    CheckIdleTimeout();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " response stream checks failed\n";
+        return 1;
+    }
+    std::cout << "Response stream: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,210 @@
+// Fetches dataset tables through RestClient from a local HTTP stub that
+// answers with an Arrow IPC stream or with JSON rows. Checks that both
+// formats decode to the same typed columns with an int64 timestamp_ms, that
+// limit/offset and the Accept header are sent, and that bad bodies, out of
+// range timestamps and HTTP errors are reported. Exits non-zero on any
+// mismatch.
+#include "Stage1DatasetTable.h"
+#include "Stage1RestClient.h"
+#include "tests/test_support.h"
+
+#include <arrow/api.h>
+#include <arrow/io/memory.h>
+#include <arrow/ipc/writer.h>
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace stage1;
+using namespace test_support;
+
+namespace {
+
+int g_failures = 0;
+std::mutex g_mutex;
+std::vector<StubRequest> g_requests;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+constexpr int64_t kFirstMillis = 1732831200000;   // 2024-11-28T22:00:00Z
+constexpr int kRows = 6;
+
+double CloseAt(int row) { return 100.0 + row * 0.25; }
+
+// Six hourly bars in two record batches: timestamp[ms], close, symbol
+std::string ArrowStreamBody() {
+    auto schema = arrow::schema({ arrow::field("timestamp", arrow::timestamp(arrow::TimeUnit::MILLI)),
+                                  arrow::field("close", arrow::float64()),
+                                  arrow::field("symbol", arrow::utf8()) });
+    auto sink = arrow::io::BufferOutputStream::Create().ValueOrDie();
+    auto writer = arrow::ipc::MakeStreamWriter(sink, schema).ValueOrDie();
+    for (int batch = 0; batch < 2; ++batch) {
+        arrow::TimestampBuilder times(arrow::timestamp(arrow::TimeUnit::MILLI), arrow::default_memory_pool());
+        arrow::DoubleBuilder closes;
+        arrow::StringBuilder symbols;
+        for (int row = batch * 3; row < batch * 3 + 3; ++row) {
+            (void)times.Append(kFirstMillis + row * 3600000LL);
+            (void)closes.Append(CloseAt(row));
+            (void)symbols.Append("NQ");
+        }
+        std::shared_ptr<arrow::Array> t, c, s;
+        (void)times.Finish(&t);
+        (void)closes.Finish(&c);
+        (void)symbols.Finish(&s);
+        (void)writer->WriteRecordBatch(*arrow::RecordBatch::Make(schema, 3, { t, c, s }));
+    }
+    (void)writer->Close();
+    return sink->Finish().ValueOrDie()->ToString();
+}
+
+// The same bars as JSON rows: ISO timestamps, a quoted number, a missing
+// key, an explicit null and a key order change
+std::string JsonRowsBody() {
+    return R"({"count": 6, "rows": [
+        {"timestamp": "2024-11-28T22:00:00.000000Z", "close": 100.0, "symbol": "NQ", "volume": null},
+        {"timestamp": "2024-11-28T23:00:00.000000Z", "close": 100.25, "symbol": "NQ"},
+        {"close": "100.5", "timestamp": "2024-11-29 00:00:00", "symbol": "NQ", "volume": 12},
+        {"timestamp": "2024-11-29T01:00:00Z", "close": 100.75, "symbol": "NQ", "volume": 18446744073709551615},
+        {"symbol": "NQ", "timestamp": "2024-11-29T02:00:00.000Z", "close": 101},
+        {"timestamp": "2024-11-29T03:00:00.000000Z", "close": 101.25, "symbol": "NQ", "volume": 3.5}
+    ]})";
+}
+
+// /api/datasets/<id>/ohlcv per dataset id: arrow, json, garbled, bigtime;
+// anything else is a 404
+StubResponse Datasets(const StubRequest& request) {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_requests.push_back(request);
+    }
+    StubResponse response;
+    const std::string prefix = "/api/datasets/";
+    const std::string path = request.target.substr(0, request.target.find('?'));
+    const std::string id = path.substr(prefix.size(), path.find('/', prefix.size()) - prefix.size());
+    if (id == "arrow") {
+        response.headers.push_back(std::string("Content-Type: ") + kArrowStreamContentType);
+        response.body = ArrowStreamBody();
+    } else if (id == "json") {
+        response.headers.push_back("Content-Type: application/json");
+        response.body = JsonRowsBody();
+    } else if (id == "garbled") {
+        response.headers.push_back(std::string("Content-Type: ") + kArrowStreamContentType);
+        response.body = "not an arrow stream";
+    } else if (id == "bigtime") {
+        response.headers.push_back("Content-Type: application/json");
+        response.body = R"({"rows": [{"timestamp_ms": 1732831200000}, {"timestamp_ms": 9223372036854775808}]})";
+    } else {
+        response.status = 404;
+        response.headers.push_back("Content-Type: application/json");
+        response.body = R"({"detail": "dataset not found"})";
+    }
+    return response;
+}
+
+std::shared_ptr<arrow::Table> Fetch(const std::string& id, std::string* error, int limit = 0, int64_t offset = 0) {
+    std::shared_ptr<arrow::Table> table;
+    if (!RestClient::Instance().FetchDatasetOhlcvTable(id, &table, error, limit, offset)) {
+        return nullptr;
+    }
+    return table->CombineChunks().ValueOrDie();
+}
+
+// Both formats carry the same timestamp_ms and close values
+void CheckBars(const std::shared_ptr<arrow::Table>& table, const std::string& label) {
+    const auto millis = table->GetColumnByName("timestamp_ms");
+    const auto close = table->GetColumnByName("close");
+    Expect(table->num_rows() == kRows, label + ": six rows");
+    Expect(millis && millis->type()->id() == arrow::Type::INT64, label + ": int64 timestamp_ms");
+    Expect(close && close->type()->id() == arrow::Type::DOUBLE, label + ": float64 close");
+    Expect(table->GetColumnByName("timestamp") != nullptr, label + ": the source timestamp column is kept");
+    if (!millis || !close || table->num_rows() != kRows) return;
+    const auto& times = static_cast<const arrow::Int64Array&>(*millis->chunk(0));
+    const auto& closes = static_cast<const arrow::DoubleArray&>(*close->chunk(0));
+    bool same = true;
+    for (int row = 0; row < kRows; ++row) {
+        same = same && times.Value(row) == kFirstMillis + row * 3600000LL && closes.Value(row) == CloseAt(row);
+    }
+    Expect(same, label + ": every timestamp and close matches");
+    const auto symbol = table->GetColumnByName("symbol");
+    Expect(symbol && symbol->type()->id() == arrow::Type::STRING &&
+               static_cast<const arrow::StringArray&>(*symbol->chunk(0)).GetView(5) == "NQ",
+           label + ": utf8 symbol");
+}
+
+void CheckArrowStream() {
+    std::string error;
+    const auto table = Fetch("arrow", &error, 500, 1000);
+    Expect(table != nullptr, "fetch the Arrow IPC stream: " + error);
+    if (table) CheckBars(table, "arrow");
+
+    std::vector<StubRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        requests = g_requests;
+    }
+    Expect(requests.size() == 1, "one request");
+    if (requests.empty()) return;
+    Expect(requests.back().target == "/api/datasets/arrow/ohlcv?limit=500&offset=1000",
+           "limit and offset are sent: " + requests.back().target);
+    const auto accept = requests.back().headers.find("accept");
+    Expect(accept != requests.back().headers.end() && accept->second.find(kArrowStreamContentType) == 0 &&
+               accept->second.find("application/json") != std::string::npos,
+           "Accept prefers Arrow IPC and allows JSON");
+}
+
+void CheckJsonRows() {
+    std::string error;
+    const auto table = Fetch("json", &error);
+    Expect(table != nullptr, "fetch the JSON rows: " + error);
+    if (!table) return;
+    CheckBars(table, "json");
+
+    // volume: missing and null rows are nulls; a uint64 beyond int64 in a
+    // numeric column stays a number
+    const auto volume = table->GetColumnByName("volume");
+    Expect(volume && volume->type()->id() == arrow::Type::DOUBLE, "json: float64 volume");
+    if (!volume) return;
+    const auto& values = static_cast<const arrow::DoubleArray&>(*volume->chunk(0));
+    Expect(values.IsNull(0) && values.IsNull(1) && values.IsNull(4), "json: missing and null volumes are nulls");
+    Expect(values.Value(2) == 12.0 && values.Value(5) == 3.5, "json: integer and fractional volumes");
+    Expect(values.Value(3) == 18446744073709551615.0, "json: a uint64 volume is kept as a double");
+}
+
+void CheckErrors() {
+    std::string error;
+    Expect(!Fetch("bigtime", &error), "a timestamp beyond int64 fails the fetch");
+    Expect(error.find("int64") != std::string::npos, "error names the out of range timestamp: " + error);
+
+    error.clear();
+    Expect(!Fetch("garbled", &error) && !error.empty(), "a garbled Arrow stream is an error");
+
+    error.clear();
+    Expect(!Fetch("missing", &error), "an unknown dataset fails");
+    Expect(error.find("HTTP 404") != std::string::npos && error.find("dataset not found") != std::string::npos,
+           "error carries the status and body: " + error);
+}
+
+} // namespace
+
+int main() {
+    HttpStub stub(Datasets);
+    RestClient::Instance().SetBaseUrl(stub.Url());
+
+    CheckArrowStream();
+    CheckJsonRows();
+    CheckErrors();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " dataset table checks failed\n";
+        return 1;
+    }
+    std::cout << "Dataset table: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,203 @@
+// Runs HttpTransport against a local HTTP stub. Checks that pooled handles
+// keep their connections across Perform() calls and threads, that
+// PerformAll() runs a batch concurrently up to max_host_connections and
+// returns responses in request order, and that transport errors are
+// reported. Exits non-zero on any mismatch.
+#include "Stage1HttpTransport.h"
+#include "tests/test_support.h"
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace stage1;
+using namespace test_support;
+
+namespace {
+
+int g_failures = 0;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+// Echoes method, target, one header and the body; /missing is a 404 and
+// /slow/... takes 200 ms
+StubResponse Echo(const StubRequest& request) {
+    StubResponse response;
+    if (request.target.rfind("/slow/", 0) == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    response.status = request.target == "/missing" ? 404 : 200;
+    response.headers.push_back("Content-Type: text/plain");
+    const auto key = request.headers.find("x-key");
+    response.body = request.method + " " + request.target + " " +
+                    (key == request.headers.end() ? std::string("-") : key->second) + " " + request.body;
+    return response;
+}
+
+HttpTransportOptions PlainOptions() {
+    HttpTransportOptions options;
+    options.http2 = false;
+    options.compression = false;
+    return options;
+}
+
+HttpRequest Get(const HttpStub& stub, const std::string& path) {
+    HttpRequest request;
+    request.url = stub.Url() + path;
+    return request;
+}
+
+void CheckSequentialReuse() {
+    HttpStub stub(Echo);
+    HttpTransport transport(PlainOptions());
+    int reused = 0;
+    for (int i = 0; i < 20; ++i) {
+        HttpRequest request = Get(stub, "/item/" + std::to_string(i));
+        if (i % 2) {
+            request.method = "POST";
+            request.body = "payload " + std::to_string(i);
+            request.headers.push_back("X-Key: k" + std::to_string(i));
+        }
+        HttpResponse response;
+        const bool performed = transport.Perform(request, &response);
+        Expect(performed, "request " + std::to_string(i) + ": " + response.error);
+        const std::string expected = i % 2
+            ? "POST /item/" + std::to_string(i) + " k" + std::to_string(i) + " payload " + std::to_string(i)
+            : "GET /item/" + std::to_string(i) + " - ";
+        Expect(response.status == 200 && response.body == expected, "response " + std::to_string(i) + ": " + response.body);
+        Expect(response.content_type == "text/plain", "content type is reported");
+        if (i % 2) {
+            Expect(response.timing.bytes_sent == static_cast<int64_t>(request.body.size()), "bytes sent are reported");
+        }
+        reused += response.timing.reused_connection ? 1 : 0;
+    }
+    Expect(stub.Connections() == 1, "sequential requests share one connection (" +
+                                         std::to_string(stub.Connections()) + " opened)");
+    Expect(reused == 19, "every request after the first reports a reused connection");
+    Expect(transport.Stats().requests == 20 && transport.Stats().reused_connections == 19, "stats count the reuse");
+
+    // An HTTP error status is a response, not a transport failure, and
+    // does not cost the connection
+    HttpResponse missing;
+    Expect(transport.Perform(Get(stub, "/missing"), &missing) && missing.status == 404, "404 is returned as a response");
+    Expect(stub.Connections() == 1, "a 404 keeps the connection");
+}
+
+void CheckWithoutPool() {
+    HttpStub stub(Echo);
+    HttpTransportOptions options = PlainOptions();
+    options.max_idle_handles = 0;
+    HttpTransport transport(options);
+    for (int i = 0; i < 5; ++i) {
+        HttpResponse response;
+        transport.Perform(Get(stub, "/"), &response);
+    }
+    Expect(stub.Connections() == 5, "without pooled handles every request connects again");
+}
+
+void CheckThreadedReuse() {
+    HttpStub stub(Echo);
+    HttpTransport transport(PlainOptions());
+    const int threads = 4;
+    const int perThread = 25;
+    std::atomic<int> bad{ 0 };
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                const std::string path = "/t" + std::to_string(t) + "/" + std::to_string(i);
+                HttpResponse response;
+                if (!transport.Perform(Get(stub, path), &response) || response.body != "GET " + path + " - ") {
+                    ++bad;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    Expect(bad.load() == 0, "concurrent Perform() calls get their own responses");
+    Expect(stub.Connections() <= threads, "threads reuse pooled connections (" +
+                                              std::to_string(stub.Connections()) + " opened)");
+    Expect(transport.Stats().reused_connections >= threads * perThread - threads, "all but the first per handle reuse");
+}
+
+void CheckPerformAll() {
+    HttpStub stub(Echo);
+    HttpTransportOptions options = PlainOptions();
+    options.max_host_connections = 6;
+    HttpTransport transport(options);
+
+    std::vector<HttpRequest> requests;
+    for (int i = 0; i < 12; ++i) {
+        requests.push_back(Get(stub, "/slow/" + std::to_string(i)));
+    }
+    requests[5].url = stub.Url() + "/missing";
+
+    std::vector<HttpResponse> responses;
+    auto start = std::chrono::steady_clock::now();
+    Expect(transport.PerformAll(requests, &responses), "batch succeeds");
+    const double ms = MillisSince(start);
+    Expect(responses.size() == requests.size(), "one response per request");
+    bool ordered = true;
+    for (size_t i = 0; i < responses.size(); ++i) {
+        const std::string path = requests[i].url.substr(stub.Url().size());
+        ordered = ordered && responses[i].body == "GET " + path + " - ";
+    }
+    Expect(ordered, "responses come back in request order");
+    Expect(responses[5].status == 404, "a 404 in a batch is returned as a response");
+    Expect(stub.MaxConcurrent() == 6, "the batch runs max_host_connections requests at once (" +
+                                          std::to_string(stub.MaxConcurrent()) + " seen)");
+    Expect(ms < 1200.0, "11 slow requests finish in about two rounds (" + std::to_string(ms) + " ms)");
+    Expect(stub.Connections() == 6, "the batch opens one connection per concurrent request");
+
+    // A second batch reuses those connections
+    const auto before = transport.Stats().reused_connections;
+    Expect(transport.PerformAll(requests, &responses), "second batch succeeds");
+    Expect(stub.Connections() == 6, "the second batch opens no new connections (" +
+                                        std::to_string(stub.Connections()) + " total)");
+    Expect(transport.Stats().reused_connections - before == 12, "every request of the second batch reuses a connection");
+}
+
+void CheckTransportErrors() {
+    int port = 0;
+    {
+        HttpStub stub(Echo);
+        port = stub.Port();
+    }
+    HttpTransport transport(PlainOptions());
+    HttpRequest request;
+    request.url = "http://127.0.0.1:" + std::to_string(port) + "/";
+    HttpResponse response;
+    Expect(!transport.Perform(request, &response) && !response.error.empty(), "a refused connection is an error");
+
+    HttpStub stub(Echo);
+    std::vector<HttpResponse> responses;
+    Expect(!transport.PerformAll({ Get(stub, "/a"), request, Get(stub, "/b") }, &responses),
+           "a batch with a refused request fails");
+    Expect(responses.size() == 3 && responses[0].body == "GET /a - " && !responses[1].error.empty() &&
+               responses[2].body == "GET /b - ",
+           "the other requests of the batch still complete");
+    Expect(transport.Stats().failures == 2, "failures are counted");
+}
+
+} // namespace
+
+int main() {
+    CheckSequentialReuse();
+    CheckWithoutPool();
+    CheckThreadedReuse();
+    CheckPerformAll();
+    CheckTransportErrors();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " HttpTransport checks failed\n";
+        return 1;
+    }
+    std::cout << "HttpTransport: all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,200 @@
+// Drives RowUploader against an in-process stand-in for the append endpoint
+// (this file replaces Stage1RestClient.cpp at link time). Checks that every
+// row lands exactly once and in order, and that only failures which provably
+// left the rows unstored are retried. Exits non-zero on any mismatch.
+#include "Stage1RowUploader.h"
+
+#include <charconv>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace stage1 {
+
+namespace {
+
+// What the stand-in does with one post: store the rows or not, and which
+// status (0 for a transport error) and bytes-sent count the client sees
+struct Outcome {
+    bool store = true;
+    long status = 200;
+    int64_t bytes_sent = -1;        // -1: the whole body
+};
+
+std::mutex g_mutex;
+std::function<Outcome(int call)> g_script;
+std::vector<std::string> g_stored;  // Bodies in the order the endpoint kept them
+std::map<std::string, int> g_posts; // Posts per Idempotency-Key
+int g_calls = 0;
+thread_local HttpTiming t_lastTiming;
+
+} // namespace
+
+RestClient& RestClient::Instance() {
+    static RestClient client;
+    return client;
+}
+
+RestClient::RestClient() {}
+RestClient::~RestClient() {}
+
+HttpTiming RestClient::LastRequestTiming() {
+    return t_lastTiming;
+}
+
+bool RestClient::AppendDatasetRowBatch(const std::string&,
+                                       const std::string& body,
+                                       AppendTarget,
+                                       const std::string& idempotencyKey,
+                                       long* httpStatus,
+                                       std::string* error) {
+    Outcome outcome;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        outcome = g_script ? g_script(g_calls) : Outcome();
+        ++g_calls;
+        ++g_posts[idempotencyKey];
+        if (outcome.store) {
+            g_stored.push_back(body);
+        }
+    }
+    t_lastTiming = HttpTiming();
+    t_lastTiming.bytes_sent = outcome.bytes_sent < 0 ? static_cast<int64_t>(body.size()) : outcome.bytes_sent;
+    if (httpStatus) *httpStatus = outcome.status;
+    if (outcome.status >= 200 && outcome.status < 300) {
+        return true;
+    }
+    if (error) *error = outcome.status == 0 ? "Transport error" : "HTTP " + std::to_string(outcome.status);
+    return false;
+}
+
+} // namespace stage1
+
+using namespace stage1;
+
+namespace {
+
+int g_failures = 0;
+
+void Expect(bool condition, const std::string& what) {
+    if (!condition) {
+        ++g_failures;
+        std::cerr << "FAIL " << what << "\n";
+    }
+}
+
+void Reset(std::function<Outcome(int call)> script) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_script = std::move(script);
+    g_stored.clear();
+    g_posts.clear();
+    g_calls = 0;
+}
+
+// Every 1000th row is skipped by the serializer, as filtered rows would be
+const RowBatchSerializer kSerialize = [](int64_t begin, int64_t end, std::string* out, std::string*) -> int64_t {
+    int64_t written = 0;
+    char digits[24];
+    for (int64_t i = begin; i < end; ++i) {
+        if (i % 1000 == 999) {
+            continue;
+        }
+        if (written > 0) out->push_back(',');
+        out->append("{\"timestamp\":");
+        out->append(digits, std::to_chars(digits, digits + sizeof(digits), 1700000000000 + i * 60000).ptr);
+        out->push_back('}');
+        ++written;
+    }
+    return written;
+};
+
+// Timestamps of the stored rows, in the order the endpoint kept them
+std::vector<int64_t> StoredTimestamps() {
+    std::vector<int64_t> timestamps;
+    const std::string field = "\"timestamp\":";
+    for (const auto& body : g_stored) {
+        for (size_t pos = body.find(field); pos != std::string::npos; pos = body.find(field, pos)) {
+            pos += field.size();
+            int64_t value = 0;
+            std::from_chars(body.data() + pos, body.data() + body.size(), value);
+            timestamps.push_back(value);
+        }
+    }
+    return timestamps;
+}
+
+bool AllRowsInOrder(int64_t sourceRows) {
+    const auto timestamps = StoredTimestamps();
+    size_t next = 0;
+    for (int64_t i = 0; i < sourceRows; ++i) {
+        if (i % 1000 == 999) continue;
+        if (next >= timestamps.size() || timestamps[next++] != 1700000000000 + i * 60000) return false;
+    }
+    return next == timestamps.size();
+}
+
+bool Upload(int64_t sourceRows, int64_t* rowsSent, RowUploadProgress* progress, std::string* error) {
+    RowUploadOptions options;
+    options.batch_rows = 2500;
+    options.retry_backoff_ms = 1;
+    RowUploader uploader(RestClient::AppendTarget::Indicators, options);
+    const bool ok = uploader.Upload("dataset", sourceRows, kSerialize, rowsSent, error);
+    *progress = uploader.Progress();
+    return ok;
+}
+
+} // namespace
+
+int main() {
+    const int64_t rows = 100000;
+    const int64_t kept = rows - rows / 1000;
+    int64_t sent = 0;
+    RowUploadProgress progress;
+    std::string error;
+
+    Reset(nullptr);
+    Expect(Upload(rows, &sent, &progress, &error), "clean upload succeeds: " + error);
+    Expect(sent == kept && AllRowsInOrder(rows), "clean upload stores every row once, in order");
+    Expect(progress.retries == 0 && progress.batches_sent == 40, "clean upload sends 40 batches without retries");
+
+    // Refused connections and 429/503 leave nothing stored and are retried
+    Reset([](int call) {
+        Outcome outcome;
+        if (call % 4 == 1) outcome = Outcome{ false, 0, 0 };
+        if (call % 4 == 2) outcome = Outcome{ false, 503, -1 };
+        if (call % 7 == 3) outcome = Outcome{ false, 429, -1 };
+        return outcome;
+    });
+    Expect(Upload(rows, &sent, &progress, &error), "upload with retryable failures succeeds: " + error);
+    Expect(sent == kept && AllRowsInOrder(rows), "retried batches are stored once, in order");
+    Expect(progress.retries > 0, "retryable failures are retried");
+
+    // A timeout after the body went out may have been applied; not resent
+    Reset([](int call) { return call == 5 ? Outcome{ true, 0, -1 } : Outcome(); });
+    Expect(!Upload(rows, &sent, &progress, &error), "timeout after sending fails the upload");
+    Expect(g_calls == 6 && progress.retries == 0, "timeout after sending is not retried");
+    Expect(StoredTimestamps().size() == static_cast<size_t>(6 * 2500 - 15), "no batch after the failed one is posted");
+
+    // Neither is a 500 or a 408
+    for (long status : { 500L, 408L, 502L }) {
+        Reset([status](int call) { return call == 2 ? Outcome{ false, status, -1 } : Outcome(); });
+        Expect(!Upload(rows, &sent, &progress, &error), "HTTP " + std::to_string(status) + " fails the upload");
+        Expect(g_calls == 3 && progress.retries == 0, "HTTP " + std::to_string(status) + " is not retried");
+    }
+
+    // Retries stop after max_attempts, all under the batch's key
+    Reset([](int call) { return call == 0 ? Outcome() : Outcome{ false, 503, -1 }; });
+    Expect(!Upload(rows, &sent, &progress, &error), "persistent 503 fails the upload");
+    Expect(g_calls == 1 + 4 && progress.retries == 3, "a batch is posted at most max_attempts times");
+    Expect(g_posts.size() == 2, "retries reuse the batch's Idempotency-Key");
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " RowUploader checks failed\n";
+        return 1;
+    }
+    std::cout << "RowUploader: all checks passed\n";
+    return 0;
+}
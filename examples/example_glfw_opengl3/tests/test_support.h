@@ -0,0 +1,445 @@
+#pragma once
+
+// Local stand-ins for the servers the network code talks to: a raw TCP sink
+// for ILP and a small HTTP/1.1 server. Both listen on an ephemeral
+// 127.0.0.1 port and stop (closing every connection) when destroyed. POSIX
+// only, like the Makefile that builds the tests.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace test_support {
+
+inline double MillisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Polls condition every few milliseconds until it holds or timeoutMs passes
+inline bool WaitUntil(const std::function<bool()>& condition, int timeoutMs) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    return true;
+}
+
+// Listening socket plus the threads serving its connections
+class LocalServer {
+public:
+    LocalServer(const LocalServer&) = delete;
+    LocalServer& operator=(const LocalServer&) = delete;
+
+    int Port() const { return m_port; }
+    int Connections() const { return m_connections.load(); }
+
+protected:
+    LocalServer() {
+        m_listen = socket(AF_INET, SOCK_STREAM, 0);
+        const int yes = 1;
+        setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        if (bind(m_listen, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(m_listen, 64) != 0) {
+            std::cerr << "Cannot listen on 127.0.0.1: " << std::strerror(errno) << "\n";
+            std::exit(2);
+        }
+        socklen_t length = sizeof(address);
+        getsockname(m_listen, reinterpret_cast<sockaddr*>(&address), &length);
+        m_port = ntohs(address.sin_port);
+    }
+
+    ~LocalServer() { Stop(); }
+
+    // Derived constructors call this once they are fully set up
+    void StartAccepting() {
+        m_acceptor = std::thread([this]() { AcceptLoop(); });
+    }
+
+    // Derived destructors call this first, so no thread sees a half-destroyed object
+    void Stop() {
+        if (m_stopping.exchange(true)) {
+            return;
+        }
+        m_wake.notify_all();
+        if (m_acceptor.joinable()) {
+            m_acceptor.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int fd : m_open) {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+        close(m_listen);
+    }
+
+    virtual void Serve(int fd, int index) = 0;
+
+    bool Stopping() const { return m_stopping.load(); }
+
+    // Sleeps, but returns early (false) once the server is stopping
+    bool Sleep(int ms) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return !m_wake.wait_for(lock, std::chrono::milliseconds(ms), [&]() { return m_stopping.load(); });
+    }
+
+    // Waits for up to timeoutMs for fd to become readable; false on timeout or stop
+    bool WaitReadable(int fd, int timeoutMs) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!m_stopping.load()) {
+            pollfd entry{ fd, POLLIN, 0 };
+            if (poll(&entry, 1, 20) > 0) {
+                return true;
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Closes with RST instead of FIN
+    static void Reset(int fd) {
+        linger option{ 1, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_LINGER, &option, sizeof(option));
+        shutdown(fd, SHUT_RDWR);
+    }
+
+private:
+    void AcceptLoop() {
+        while (!m_stopping.load()) {
+            pollfd entry{ m_listen, POLLIN, 0 };
+            if (poll(&entry, 1, 20) <= 0) {
+                continue;
+            }
+            const int fd = accept(m_listen, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            const int index = m_connections.fetch_add(1);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_open.push_back(fd);
+            m_threads.emplace_back([this, fd, index]() {
+                Serve(fd, index);
+                std::lock_guard<std::mutex> closeLock(m_mutex);
+                m_open.erase(std::find(m_open.begin(), m_open.end(), fd));
+                close(fd);
+            });
+        }
+    }
+
+    int m_listen = -1;
+    int m_port = 0;
+    std::atomic<bool> m_stopping{ false };
+    std::atomic<int> m_connections{ 0 };
+    std::thread m_acceptor;
+    std::vector<std::thread> m_threads;
+    std::vector<int> m_open;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+};
+
+// Records the bytes of every connection, in accept order. Reading can be
+// paused to push back on the sender, and a connection can be reset after a
+// given number of bytes.
+class TcpSink : public LocalServer {
+public:
+    // Bytes a connection may read before it is reset; -1 never, 0 at once
+    using ResetPolicy = std::function<int64_t(int connection)>;
+
+    explicit TcpSink(ResetPolicy policy = nullptr)
+        : m_policy(std::move(policy)) {
+        StartAccepting();
+    }
+
+    ~TcpSink() { Stop(); }
+
+    void SetPaused(bool paused) { m_paused.store(paused); }
+
+    int64_t BytesReceived() const { return m_bytes.load(); }
+
+    // Connections that reached end of stream or were reset
+    int Finished() const { return m_finished.load(); }
+
+    // Waits until every accepted connection has finished
+    bool WaitFinished(int timeoutMs) {
+        return WaitUntil([&]() { return Finished() == Connections(); }, timeoutMs);
+    }
+
+    std::vector<std::string> Received() {
+        std::lock_guard<std::mutex> lock(m_dataMutex);
+        std::vector<std::string> data;
+        for (const auto& [index, bytes] : m_data) {
+            data.push_back(bytes);
+        }
+        return data;
+    }
+
+    std::string ReceivedAll() {
+        std::string all;
+        for (const auto& bytes : Received()) {
+            all += bytes;
+        }
+        return all;
+    }
+
+protected:
+    void Serve(int fd, int index) override {
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            m_data[index];
+        }
+        const int64_t resetAfter = m_policy ? m_policy(index) : -1;
+        int64_t read = 0;
+        std::vector<char> buffer(64 * 1024);
+        while (!Stopping()) {
+            if (resetAfter >= 0 && read >= resetAfter) {
+                Reset(fd);
+                break;
+            }
+            if (m_paused.load()) {
+                Sleep(2);
+                continue;
+            }
+            if (!WaitReadable(fd, 50)) {
+                continue;
+            }
+            size_t want = buffer.size();
+            if (resetAfter >= 0) {
+                want = static_cast<size_t>(std::min<int64_t>(want, resetAfter - read));
+            }
+            const ssize_t got = recv(fd, buffer.data(), want, 0);
+            if (got <= 0) {
+                break;
+            }
+            read += got;
+            m_bytes += got;
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            m_data[index].append(buffer.data(), static_cast<size_t>(got));
+        }
+        ++m_finished;
+    }
+
+private:
+    ResetPolicy m_policy;
+    std::atomic<bool> m_paused{ false };
+    std::atomic<int64_t> m_bytes{ 0 };
+    std::atomic<int> m_finished{ 0 };
+    std::mutex m_dataMutex;
+    std::map<int, std::string> m_data;
+};
+
+struct StubRequest {
+    std::string method;
+    std::string target;                 // Path and query
+    std::map<std::string, std::string> headers;  // Lower-case names
+    std::string body;
+    int connection = 0;                 // Accept order of the connection
+};
+
+struct StubResponse {
+    int status = 200;
+    std::vector<std::string> headers;   // "Name: value"
+    std::string body;                   // Sent with Content-Length...
+    std::vector<std::string> chunks;    // ...unless these are given (chunked)
+    int chunk_delay_ms = 0;             // Pause before every chunk after the first
+    bool close = false;                 // Close the connection afterwards
+    bool drop = false;                  // Close it without answering at all
+};
+
+// Minimal HTTP/1.1 server: keep-alive, Content-Length request bodies and
+// chunked or fixed-length responses. The handler runs on the connection's
+// thread, so concurrent requests run concurrently.
+class HttpStub : public LocalServer {
+public:
+    using Handler = std::function<StubResponse(const StubRequest&)>;
+
+    explicit HttpStub(Handler handler, int sendBufferBytes = 0)
+        : m_handler(std::move(handler)),
+          m_sendBuffer(sendBufferBytes) {
+        StartAccepting();
+    }
+
+    ~HttpStub() { Stop(); }
+
+    std::string Url() const { return "http://127.0.0.1:" + std::to_string(Port()); }
+    int Requests() const { return m_requests.load(); }
+    int MaxConcurrent() const { return m_maxConcurrent.load(); }
+    int64_t BodyBytesSent() const { return m_bodyBytes.load(); }
+
+protected:
+    void Serve(int fd, int index) override {
+        if (m_sendBuffer > 0) {
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &m_sendBuffer, sizeof(m_sendBuffer));
+        }
+        std::string pending;
+        while (!Stopping()) {
+            StubRequest request;
+            request.connection = index;
+            if (!ReadRequest(fd, &pending, &request)) {
+                return;
+            }
+            const int concurrent = ++m_concurrent;
+            int seen = m_maxConcurrent.load();
+            while (concurrent > seen && !m_maxConcurrent.compare_exchange_weak(seen, concurrent)) {
+            }
+            ++m_requests;
+            StubResponse response = m_handler(request);
+            --m_concurrent;
+            if (response.drop || !WriteResponse(fd, response) || response.close) {
+                return;
+            }
+        }
+    }
+
+private:
+    bool ReadMore(int fd, std::string* pending) {
+        char buffer[16 * 1024];
+        while (!Stopping()) {
+            if (!WaitReadable(fd, 50)) {
+                continue;
+            }
+            const ssize_t got = recv(fd, buffer, sizeof(buffer), 0);
+            if (got <= 0) {
+                return false;
+            }
+            pending->append(buffer, static_cast<size_t>(got));
+            return true;
+        }
+        return false;
+    }
+
+    bool ReadRequest(int fd, std::string* pending, StubRequest* request) {
+        size_t headerEnd;
+        while ((headerEnd = pending->find("\r\n\r\n")) == std::string::npos) {
+            if (!ReadMore(fd, pending)) {
+                return false;
+            }
+        }
+        const std::string head = pending->substr(0, headerEnd);
+        pending->erase(0, headerEnd + 4);
+
+        size_t lineEnd = head.find("\r\n");
+        const std::string requestLine = head.substr(0, lineEnd);
+        const size_t firstSpace = requestLine.find(' ');
+        const size_t secondSpace = requestLine.find(' ', firstSpace + 1);
+        request->method = requestLine.substr(0, firstSpace);
+        request->target = requestLine.substr(firstSpace + 1, secondSpace - firstSpace - 1);
+        while (lineEnd != std::string::npos) {
+            const size_t start = lineEnd + 2;
+            lineEnd = head.find("\r\n", start);
+            const std::string line = head.substr(start, lineEnd == std::string::npos ? std::string::npos : lineEnd - start);
+            const size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(),
+                           [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+            request->headers[name] = line.substr(line.find_first_not_of(' ', colon + 1));
+        }
+
+        const auto length = request->headers.find("content-length");
+        const size_t bodyBytes = length == request->headers.end() ? 0 : std::stoul(length->second);
+        while (pending->size() < bodyBytes) {
+            if (!ReadMore(fd, pending)) {
+                return false;
+            }
+        }
+        request->body = pending->substr(0, bodyBytes);
+        pending->erase(0, bodyBytes);
+        return true;
+    }
+
+    bool SendAll(int fd, const std::string& data, bool body) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            if (Stopping()) {
+                return false;
+            }
+            pollfd entry{ fd, POLLOUT, 0 };
+            if (poll(&entry, 1, 20) <= 0) {
+                continue;
+            }
+            const ssize_t wrote = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (wrote <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(wrote);
+            if (body) {
+                m_bodyBytes += wrote;
+            }
+        }
+        return true;
+    }
+
+    bool WriteResponse(int fd, const StubResponse& response) {
+        std::string head = "HTTP/1.1 " + std::to_string(response.status) + " Stub\r\n";
+        for (const auto& header : response.headers) {
+            head += header + "\r\n";
+        }
+        const bool chunked = !response.chunks.empty();
+        head += chunked ? std::string("Transfer-Encoding: chunked\r\n")
+                        : "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        if (response.close) {
+            head += "Connection: close\r\n";
+        }
+        head += "\r\n";
+        if (!chunked) {
+            return SendAll(fd, head, false) && SendAll(fd, response.body, true);
+        }
+        if (!SendAll(fd, head, false)) {
+            return false;
+        }
+        for (size_t i = 0; i < response.chunks.size(); ++i) {
+            if (i > 0 && response.chunk_delay_ms > 0 && !Sleep(response.chunk_delay_ms)) {
+                return false;
+            }
+            const auto& chunk = response.chunks[i];
+            if (chunk.empty()) {
+                continue;
+            }
+            char size[32];
+            std::snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+            if (!SendAll(fd, size, false) || !SendAll(fd, chunk, true) || !SendAll(fd, "\r\n", false)) {
+                return false;
+            }
+        }
+        return SendAll(fd, "0\r\n\r\n", false);
+    }
+
+    Handler m_handler;
+    int m_sendBuffer = 0;
+    std::atomic<int> m_requests{ 0 };
+    std::atomic<int> m_concurrent{ 0 };
+    std::atomic<int> m_maxConcurrent{ 0 };
+    std::atomic<int64_t> m_bodyBytes{ 0 };
+};
+
+} // namespace test_support
@@ -0,0 +1,94 @@
+#include "timestamp_index.h"
+#include <arrow/array.h>
+#include <arrow/compute/api.h>
+#include <algorithm>
+
+namespace chronosflow {
+
+namespace {
+
+// Column values cast to int64, flattened across chunks
+arrow::Status append_int64(const std::shared_ptr<arrow::ChunkedArray>& column,
+                           std::vector<int64_t>& out, bool& has_nulls) {
+    out.clear();
+    out.reserve(column->length());
+    for (const auto& chunk : column->chunks()) {
+        std::shared_ptr<arrow::Array> array = chunk;
+        if (array->type_id() != arrow::Type::INT64) {
+            arrow::compute::CastOptions cast_opts = arrow::compute::CastOptions::Unsafe(arrow::int64());
+            ARROW_ASSIGN_OR_RAISE(auto cast, arrow::compute::Cast(arrow::Datum(array), cast_opts));
+            array = cast.make_array();
+        }
+        auto ints = std::static_pointer_cast<arrow::Int64Array>(array);
+        if (ints->null_count() > 0) {
+            has_nulls = true;
+        }
+        const int64_t* values = ints->raw_values();
+        out.insert(out.end(), values, values + ints->length());
+    }
+    return arrow::Status::OK();
+}
+
+} // namespace
+
+TimestampIndex::TimestampIndex(std::vector<int64_t> keys, bool has_nulls)
+    : keys_(std::move(keys)) {
+    sorted_ = !has_nulls && std::is_sorted(keys_.begin(), keys_.end());
+}
+
+arrow::Result<std::shared_ptr<const TimestampIndex>> TimestampIndex::from_tssb_columns(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::string& date_column,
+    const std::string& time_column) {
+
+    if (!table) {
+        return arrow::Status::Invalid("No data available");
+    }
+    auto date = table->GetColumnByName(date_column);
+    auto time = table->GetColumnByName(time_column);
+    if (!date || !time) {
+        return arrow::Status::Invalid("TSSB date/time columns not found");
+    }
+
+    bool has_nulls = false;
+    std::vector<int64_t> keys;
+    std::vector<int64_t> times;
+    ARROW_RETURN_NOT_OK(append_int64(date, keys, has_nulls));
+    ARROW_RETURN_NOT_OK(append_int64(time, times, has_nulls));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = keys[i] * kTssbDateMultiplier + times[i];
+    }
+
+    return std::shared_ptr<const TimestampIndex>(new TimestampIndex(std::move(keys), has_nulls));
+}
+
+arrow::Result<std::shared_ptr<const TimestampIndex>> TimestampIndex::from_column(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::string& column) {
+
+    if (!table) {
+        return arrow::Status::Invalid("No data available");
+    }
+    auto values = table->GetColumnByName(column);
+    if (!values) {
+        return arrow::Status::Invalid("Timestamp column not found: ", column);
+    }
+
+    bool has_nulls = false;
+    std::vector<int64_t> keys;
+    ARROW_RETURN_NOT_OK(append_int64(values, keys, has_nulls));
+    return std::shared_ptr<const TimestampIndex>(new TimestampIndex(std::move(keys), has_nulls));
+}
+
+std::pair<int64_t, int64_t> TimestampIndex::row_range(int64_t start, int64_t end) const {
+    auto first = std::lower_bound(keys_.begin(), keys_.end(), start);
+    auto last = std::upper_bound(first, keys_.end(), end);
+    return { first - keys_.begin(), last - keys_.begin() };
+}
+
+int64_t TimestampIndex::asof_row(int64_t key) const {
+    auto it = std::upper_bound(keys_.begin(), keys_.end(), key);
+    return static_cast<int64_t>(it - keys_.begin()) - 1;
+}
+
+} // namespace chronosflow
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <arrow/result.h>
+#include <arrow/table.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace chronosflow {
+
+// Int64 row keys of a dataframe (TSSB date * 1e6 + time, or a unix timestamp
+// column) with a one-time monotonicity check.
+//
+// When the keys are non-decreasing and null-free, time-range selection is two
+// binary searches and as-of lookups are one. Otherwise is_sorted() is false
+// and callers fall back to filtering.
+class TimestampIndex {
+public:
+    static constexpr int64_t kTssbDateMultiplier = 1000000LL;
+
+    // Keys from TSSB date (YYYYMMDD) and time (HHMMSS) columns
+    static arrow::Result<std::shared_ptr<const TimestampIndex>> from_tssb_columns(
+        const std::shared_ptr<arrow::Table>& table,
+        const std::string& date_column,
+        const std::string& time_column);
+
+    // Keys from a single integer or timestamp column
+    static arrow::Result<std::shared_ptr<const TimestampIndex>> from_column(
+        const std::shared_ptr<arrow::Table>& table,
+        const std::string& column);
+
+    int64_t size() const { return static_cast<int64_t>(keys_.size()); }
+    bool is_sorted() const { return sorted_; }
+    const std::vector<int64_t>& keys() const { return keys_; }
+
+    // Rows [first, last) with start <= key <= end. Requires is_sorted().
+    std::pair<int64_t, int64_t> row_range(int64_t start, int64_t end) const;
+
+    // Last row whose key is <= key, or -1 if none. Requires is_sorted().
+    int64_t asof_row(int64_t key) const;
+
+private:
+    TimestampIndex(std::vector<int64_t> keys, bool has_nulls);
+
+    std::vector<int64_t> keys_;
+    bool sorted_ = false;
+};
+
+} // namespace chronosflow
@@ -0,0 +1,443 @@
+#include "tssb_text_parser.h"
+
+#include <arrow/builder.h>
+#include <arrow/chunked_array.h>
+#include <arrow/type.h>
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CHRONOSFLOW_TSSB_SSE2 1
+#endif
+
+namespace chronosflow {
+
+namespace {
+
+constexpr std::size_t kMinBlockBytes = 1 << 20;
+constexpr std::size_t kInferenceSampleBytes = 1 << 16;
+
+// Ordered by generality; a column only ever moves up
+enum class ColumnKind : uint8_t { Int64 = 0, Float64 = 1, Utf8 = 2 };
+
+// --- Byte classification ---
+
+// Bit i is set when p[i] ends a field: newline, delimiter, or (whitespace
+// mode) any space, tab or carriage return.
+inline uint64_t structural_mask_scalar(const char* p, std::size_t n, char delimiter, bool whitespace) {
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const char c = p[i];
+        const bool hit = whitespace
+            ? (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+            : (c == delimiter || c == '\n');
+        mask |= static_cast<uint64_t>(hit) << i;
+    }
+    return mask;
+}
+
+inline uint64_t structural_mask64(const char* p, char delimiter, bool whitespace) {
+#ifdef CHRONOSFLOW_TSSB_SSE2
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i delim = _mm_set1_epi8(whitespace ? ' ' : delimiter);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    uint64_t mask = 0;
+    for (int lane = 0; lane < 4; ++lane) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * lane));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, newline), _mm_cmpeq_epi8(bytes, delim));
+        if (whitespace) {
+            hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(bytes, tab), _mm_cmpeq_epi8(bytes, cr)));
+        }
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hits))) << (16 * lane);
+    }
+    return mask;
+#else
+    return structural_mask_scalar(p, 64, delimiter, whitespace);
+#endif
+}
+
+// Splits lines into fields using the structural masks. Only the set bits are
+// visited, so the cost is per field rather than per byte.
+class LineTokenizer {
+public:
+    explicit LineTokenizer(char delimiter)
+        : delimiter_(delimiter), whitespace_(delimiter == ' ') {}
+
+    // Calls on_line(fields) for every non-blank line in [begin, end);
+    // stops at the first non-OK status.
+    template<typename OnLine>
+    arrow::Status run(const char* begin, const char* end, OnLine&& on_line) {
+        fields_.clear();
+        const char* field_start = begin;
+        for (const char* p = begin; p < end; p += 64) {
+            const std::size_t n = std::min<std::size_t>(64, static_cast<std::size_t>(end - p));
+            uint64_t mask = n == 64
+                ? structural_mask64(p, delimiter_, whitespace_)
+                : structural_mask_scalar(p, n, delimiter_, whitespace_);
+            while (mask != 0) {
+                const char* hit = p + std::countr_zero(mask);
+                mask &= mask - 1;
+                const bool line_end = *hit == '\n';
+                end_field(field_start, hit, line_end);
+                field_start = hit + 1;
+                if (line_end && !fields_.empty()) {
+                    ARROW_RETURN_NOT_OK(on_line(fields_));
+                    fields_.clear();
+                }
+            }
+        }
+        // Last line without a trailing newline
+        end_field(field_start, end, true);
+        if (!fields_.empty()) {
+            ARROW_RETURN_NOT_OK(on_line(fields_));
+            fields_.clear();
+        }
+        return arrow::Status::OK();
+    }
+
+private:
+    void end_field(const char* start, const char* stop, bool line_end) {
+        if (whitespace_) {
+            // Runs of whitespace are one separator
+            if (stop > start) fields_.emplace_back(start, static_cast<std::size_t>(stop - start));
+            return;
+        }
+        if (line_end) {
+            if (stop > start && stop[-1] == '\r') --stop;
+            if (fields_.empty() && stop == start) return;  // Blank line
+        }
+        fields_.emplace_back(start, static_cast<std::size_t>(stop - start));
+    }
+
+    char delimiter_;
+    bool whitespace_;
+    std::vector<std::string_view> fields_;
+};
+
+// --- Value parsing ---
+
+std::string_view trim_spaces(std::string_view token) {
+    while (!token.empty() && (token.front() == ' ' || token.front() == '\t')) token.remove_prefix(1);
+    while (!token.empty() && (token.back() == ' ' || token.back() == '\t')) token.remove_suffix(1);
+    return token;
+}
+
+// Arrow CSV's default null spellings
+bool is_null_token(std::string_view token) {
+    static constexpr std::string_view kNullValues[] = {
+        "", "NA", "N/A", "n/a", "NaN", "nan", "-NaN", "-nan", "NULL", "null",
+        "#N/A", "#N/A N/A", "#NA", "1.#IND", "-1.#IND", "1.#QNAN", "-1.#QNAN"
+    };
+    for (const auto& null_value : kNullValues) {
+        if (token == null_value) return true;
+    }
+    return false;
+}
+
+bool parse_int64(std::string_view token, int64_t& out) {
+    if (!token.empty() && token.front() == '+') token.remove_prefix(1);
+    const char* last = token.data() + token.size();
+    auto [ptr, ec] = std::from_chars(token.data(), last, out);
+    return ec == std::errc() && ptr == last && !token.empty();
+}
+
+// Value of a well-formed decimal that from_chars reports as out of range:
+// +-inf when its magnitude is at least 1 (overflow), +-0 otherwise
+double out_of_range_float64(std::string_view token) {
+    const bool negative = token.front() == '-';
+    if (negative) token.remove_prefix(1);
+
+    // Decimal exponent of the leading significant digit, before any e/E part
+    bool seen_point = false;
+    bool seen_digit = false;
+    int64_t integer_digits = 0;
+    int64_t leading_zeros = 0;
+    std::size_t i = 0;
+    for (; i < token.size() && token[i] != 'e' && token[i] != 'E'; ++i) {
+        const char ch = token[i];
+        if (ch == '.') {
+            seen_point = true;
+        } else if (!seen_point) {
+            if (seen_digit || ch != '0') {
+                seen_digit = true;
+                ++integer_digits;
+            }
+        } else if (!seen_digit) {
+            if (ch == '0') ++leading_zeros;
+            else seen_digit = true;
+        }
+    }
+    int64_t magnitude = integer_digits > 0 ? integer_digits - 1 : -leading_zeros - 1;
+
+    if (i < token.size()) {
+        std::string_view exponent = token.substr(i + 1);
+        if (!exponent.empty() && exponent.front() == '+') exponent.remove_prefix(1);
+        int64_t value = 0;
+        auto [ptr, ec] = std::from_chars(exponent.data(), exponent.data() + exponent.size(), value);
+        if (ec == std::errc::result_out_of_range) {
+            magnitude = exponent.front() == '-' ? -1 : 1;   // Dwarfs the digit count
+        } else if (ec == std::errc() && ptr == exponent.data() + exponent.size()) {
+            magnitude += value;
+        }
+    }
+
+    const double result = magnitude >= 0 ? std::numeric_limits<double>::infinity() : 0.0;
+    return negative ? -result : result;
+}
+
+bool parse_float64(std::string_view token, double& out) {
+    if (!token.empty() && token.front() == '+') token.remove_prefix(1);
+    const char* last = token.data() + token.size();
+    auto [ptr, ec] = std::from_chars(token.data(), last, out, std::chars_format::general);
+    if (ec == std::errc::result_out_of_range && ptr == last) {
+        // 1e400 or 1e-400 is still a number; keep the column numeric
+        out = out_of_range_float64(token);
+        return true;
+    }
+    return ec == std::errc() && ptr == last && !token.empty();
+}
+
+// Narrowest kind that can hold the token (nulls fit every kind)
+ColumnKind token_kind(std::string_view raw) {
+    const auto token = trim_spaces(raw);
+    int64_t i;
+    double d;
+    if (parse_int64(token, i) || is_null_token(token)) return ColumnKind::Int64;
+    if (parse_float64(token, d)) return ColumnKind::Float64;
+    return ColumnKind::Utf8;
+}
+
+// --- Block parsing ---
+
+struct ParsedBlock {
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    std::vector<ColumnKind> required;   // Kinds this block's values need
+    arrow::Status status;
+};
+
+class BlockParser {
+public:
+    BlockParser(const std::vector<ColumnKind>& kinds, char delimiter, int64_t expected_rows)
+        : kinds_(kinds), required_(kinds), tokenizer_(delimiter) {
+        builders_.reserve(kinds.size());
+        for (ColumnKind kind : kinds) {
+            switch (kind) {
+                case ColumnKind::Int64: builders_.push_back(std::make_unique<arrow::Int64Builder>()); break;
+                case ColumnKind::Float64: builders_.push_back(std::make_unique<arrow::DoubleBuilder>()); break;
+                case ColumnKind::Utf8: builders_.push_back(std::make_unique<arrow::StringBuilder>()); break;
+            }
+            (void)builders_.back()->Reserve(expected_rows);
+        }
+    }
+
+    ParsedBlock parse(const char* begin, const char* end) {
+        ParsedBlock block;
+        block.status = tokenizer_.run(begin, end, [this](const std::vector<std::string_view>& fields) {
+            return append_row(fields);
+        });
+        if (block.status.ok()) {
+            block.arrays.resize(builders_.size());
+            for (std::size_t c = 0; c < builders_.size() && block.status.ok(); ++c) {
+                block.status = builders_[c]->Finish(&block.arrays[c]);
+            }
+        }
+        block.required = std::move(required_);
+        return block;
+    }
+
+private:
+    arrow::Status append_row(const std::vector<std::string_view>& fields) {
+        if (fields.size() != kinds_.size()) {
+            std::string line(fields.front().data(),
+                             static_cast<std::size_t>(fields.back().data() + fields.back().size() - fields.front().data()));
+            if (line.size() > 80) line = line.substr(0, 80) + "...";
+            return arrow::Status::Invalid("TSSB parse error: Expected ", kinds_.size(),
+                                          " columns, got ", fields.size(), ": ", line);
+        }
+
+        for (std::size_t c = 0; c < fields.size(); ++c) {
+            switch (kinds_[c]) {
+                case ColumnKind::Int64: {
+                    auto& builder = static_cast<arrow::Int64Builder&>(*builders_[c]);
+                    const auto token = trim_spaces(fields[c]);
+                    int64_t value;
+                    if (parse_int64(token, value)) {
+                        ARROW_RETURN_NOT_OK(builder.Append(value));
+                    } else {
+                        if (!is_null_token(token)) promote(c, token_kind(token));
+                        ARROW_RETURN_NOT_OK(builder.AppendNull());
+                    }
+                    break;
+                }
+                case ColumnKind::Float64: {
+                    auto& builder = static_cast<arrow::DoubleBuilder&>(*builders_[c]);
+                    const auto token = trim_spaces(fields[c]);
+                    double value = 0.0;
+                    const bool numeric = parse_float64(token, value);
+                    // NaN spellings are all in the null list
+                    if (numeric && !std::isnan(value)) {
+                        ARROW_RETURN_NOT_OK(builder.Append(value));
+                    } else {
+                        if (!numeric && !is_null_token(token)) promote(c, ColumnKind::Utf8);
+                        ARROW_RETURN_NOT_OK(builder.AppendNull());
+                    }
+                    break;
+                }
+                case ColumnKind::Utf8: {
+                    auto& builder = static_cast<arrow::StringBuilder&>(*builders_[c]);
+                    ARROW_RETURN_NOT_OK(builder.Append(fields[c].data(), static_cast<int32_t>(fields[c].size())));
+                    break;
+                }
+            }
+        }
+        return arrow::Status::OK();
+    }
+
+    void promote(std::size_t column, ColumnKind kind) {
+        required_[column] = std::max(required_[column], kind);
+    }
+
+    const std::vector<ColumnKind>& kinds_;
+    std::vector<ColumnKind> required_;
+    std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders_;
+    LineTokenizer tokenizer_;
+};
+
+// Newline-aligned [begin, end) ranges of roughly equal size
+std::vector<std::pair<const char*, const char*>> split_blocks(const char* begin, const char* end) {
+    const std::size_t size = static_cast<std::size_t>(end - begin);
+    const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t target = std::max(kMinBlockBytes, size / (threads * 4) + 1);
+
+    std::vector<std::pair<const char*, const char*>> blocks;
+    const char* start = begin;
+    while (start < end) {
+        const char* stop = start + std::min(target, static_cast<std::size_t>(end - start));
+        if (stop < end) {
+            const void* newline = std::memchr(stop, '\n', static_cast<std::size_t>(end - stop));
+            stop = newline ? static_cast<const char*>(newline) + 1 : end;
+        }
+        blocks.emplace_back(start, stop);
+        start = stop;
+    }
+    return blocks;
+}
+
+std::shared_ptr<arrow::DataType> arrow_type(ColumnKind kind) {
+    switch (kind) {
+        case ColumnKind::Int64: return arrow::int64();
+        case ColumnKind::Float64: return arrow::float64();
+        case ColumnKind::Utf8: return arrow::utf8();
+    }
+    return arrow::utf8();
+}
+
+} // namespace
+
+bool TssbTextParser::supports(const arrow::Buffer& buffer) {
+    return std::memchr(buffer.data(), '"', static_cast<std::size_t>(buffer.size())) == nullptr;
+}
+
+arrow::Result<std::shared_ptr<arrow::Table>> TssbTextParser::parse(
+    const std::shared_ptr<arrow::Buffer>& buffer,
+    char delimiter,
+    bool has_header) {
+
+    const char* data = reinterpret_cast<const char*>(buffer->data());
+    const char* end = data + buffer->size();
+
+    // First non-blank line gives the column count (and names, with a header)
+    std::vector<std::string> names;
+    const char* body = data;
+    LineTokenizer tokenizer(delimiter);
+    while (body < end && names.empty()) {
+        const void* newline = std::memchr(body, '\n', static_cast<std::size_t>(end - body));
+        const char* line_end = newline ? static_cast<const char*>(newline) + 1 : end;
+        ARROW_RETURN_NOT_OK(tokenizer.run(body, line_end, [&](const std::vector<std::string_view>& fields) {
+            for (std::size_t c = 0; c < fields.size(); ++c) {
+                names.push_back(has_header ? std::string(fields[c]) : "f" + std::to_string(c));
+            }
+            return arrow::Status::OK();
+        }));
+        if (names.empty() || has_header) body = line_end;
+    }
+    if (names.empty()) {
+        return arrow::Status::Invalid("Empty CSV file");
+    }
+
+    // Initial column kinds from a sample of whole lines
+    std::vector<ColumnKind> kinds(names.size(), ColumnKind::Int64);
+    int64_t sample_rows = 0;
+    const char* sample_end = body + std::min(kInferenceSampleBytes, static_cast<std::size_t>(end - body));
+    if (sample_end < end) {
+        const char* last_newline = sample_end;
+        while (last_newline > body && last_newline[-1] != '\n') --last_newline;
+        sample_end = last_newline > body ? last_newline : sample_end;
+    }
+    ARROW_RETURN_NOT_OK(tokenizer.run(body, sample_end, [&](const std::vector<std::string_view>& fields) {
+        ++sample_rows;
+        for (std::size_t c = 0; c < fields.size() && c < kinds.size(); ++c) {
+            if (kinds[c] != ColumnKind::Utf8) kinds[c] = std::max(kinds[c], token_kind(fields[c]));
+        }
+        return arrow::Status::OK();
+    }));
+    const double bytes_per_row = sample_rows > 0
+        ? static_cast<double>(sample_end - body) / static_cast<double>(sample_rows)
+        : 64.0;
+
+    const auto blocks = split_blocks(body, end);
+    std::vector<std::size_t> block_ids(blocks.size());
+    std::iota(block_ids.begin(), block_ids.end(), 0);
+
+    // A value the sample did not anticipate widens its column and the file is
+    // parsed again; each column can widen at most twice.
+    std::vector<ParsedBlock> parsed(blocks.size());
+    while (true) {
+        std::for_each(std::execution::par, block_ids.begin(), block_ids.end(), [&](std::size_t b) {
+            const auto [block_begin, block_end] = blocks[b];
+            const auto expected_rows = static_cast<int64_t>((block_end - block_begin) / bytes_per_row * 1.1) + 16;
+            BlockParser parser(kinds, delimiter, expected_rows);
+            parsed[b] = parser.parse(block_begin, block_end);
+        });
+
+        std::vector<ColumnKind> required = kinds;
+        for (const auto& block : parsed) {
+            ARROW_RETURN_NOT_OK(block.status);
+            for (std::size_t c = 0; c < required.size(); ++c) {
+                required[c] = std::max(required[c], block.required[c]);
+            }
+        }
+        if (required == kinds) break;
+        kinds = std::move(required);
+    }
+
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    fields.reserve(names.size());
+    columns.reserve(names.size());
+    for (std::size_t c = 0; c < names.size(); ++c) {
+        const auto type = arrow_type(kinds[c]);
+        arrow::ArrayVector chunks;
+        for (const auto& block : parsed) {
+            if (block.arrays[c]->length() > 0) chunks.push_back(block.arrays[c]);
+        }
+        fields.push_back(arrow::field(names[c], type));
+        columns.push_back(std::make_shared<arrow::ChunkedArray>(std::move(chunks), type));
+    }
+    return arrow::Table::Make(arrow::schema(std::move(fields)), std::move(columns));
+}
+
+} // namespace chronosflow
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <arrow/buffer.h>
+#include <arrow/result.h>
+#include <arrow/table.h>
+#include <memory>
+
+namespace chronosflow {
+
+// Parallel parser for TSSB text files (header line plus delimited numeric rows).
+//
+// The buffer is split into newline-aligned blocks that are tokenized in
+// parallel. Field boundaries are found 64 bytes at a time from SSE2 byte
+// classification masks, and each block appends directly into typed Arrow
+// builders, so every block becomes one chunk of the output columns.
+//
+// Delimiter ' ' means "any run of spaces and tabs"; leading and trailing
+// whitespace on a line is ignored. Other delimiters split exactly, so
+// consecutive delimiters produce empty (null) fields.
+//
+// Column types follow the Arrow CSV reader's inference for the types TSSB
+// files use: int64 if every value is an integer, else float64 if every value
+// is numeric, else utf8. Empty fields and the usual NA spellings are null in
+// numeric columns; a column with no values at all is int64. Quoted fields
+// are not supported; supports() reports whether the buffer can be parsed here.
+class TssbTextParser {
+public:
+    static bool supports(const arrow::Buffer& buffer);
+
+    static arrow::Result<std::shared_ptr<arrow::Table>> parse(
+        const std::shared_ptr<arrow::Buffer>& buffer,
+        char delimiter,
+        bool has_header);
+};
+
+} // namespace chronosflow